@@ -13,6 +13,8 @@
   *            - Periodic update and message handling
   *            - Handshake and connection tracking
   *            - Sending of all registered TX packets
+  *            - Incremental per-signal RX statistics
+  *            - Consistent multi-packet signal groups
   *
   * @note    This module is designed to be initialized once via @ref uCAN_Init(),
   *          and started with @ref uCAN_Start() before use.
@@ -35,6 +37,7 @@
 #ifndef UCAN
 #define UCAN
 
+#include "ucan_config.h"
 #include "ucan_macros.h"
 #include "ucan_types.h"
 
@@ -67,11 +70,253 @@ UCAN_StatusTypeDef uCAN_SendAll(UCAN_HandleTypeDef* ucan);
   */
 UCAN_StatusTypeDef uCAN_Update(UCAN_HandleTypeDef* ucan);
 
+#if UCAN_CFG_HANDSHAKE
 /**
   * @brief  Performs handshake evaluation with all clients.
   * @param  ucan Pointer to the uCAN handle.
   * @retval Status of the handshake operation.
   */
 UCAN_StatusTypeDef uCAN_Handshake(UCAN_HandleTypeDef* ucan);
+#endif
+
+#if UCAN_CFG_HAS_MASTER
+/**
+  * @brief  Reads the latest health record reported by a client in its handshake response.
+  * @param  ucan     Pointer to the uCAN handle.
+  * @param  clientId CAN identifier of the client.
+  * @param  diag     Output health record.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_GetClientDiag(UCAN_HandleTypeDef* ucan, uint32_t clientId, UCAN_ClientDiag* diag);
+#endif
+
+#if UCAN_CFG_HAS_MEMBERSHIP
+/**
+  * @brief  Checks whether a client is ACTIVE in the shared membership view.
+  * @param  ucan     Pointer to the uCAN handle.
+  * @param  clientId CAN identifier of the client.
+  * @retval UCAN_OK if active, UCAN_NO_CONNECTION if absent.
+  */
+UCAN_StatusTypeDef uCAN_IsClientActive(UCAN_HandleTypeDef* ucan, uint32_t clientId);
+#endif
+
+#if UCAN_CFG_STATS
+/**
+  * @brief  Reads a consistent snapshot of a signal's running statistics.
+  * @param  ucan   Pointer to the uCAN handle.
+  * @param  stats  Statistics block bound to an RX signal.
+  * @param  result Output snapshot.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_GetSignalStats(UCAN_HandleTypeDef* ucan, UCAN_SignalStats* stats, UCAN_SignalStatsResult* result);
+
+/**
+  * @brief  Requests a restart of a signal's statistics window.
+  * @param  ucan  Pointer to the uCAN handle.
+  * @param  stats Statistics block bound to an RX signal.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_ResetSignalStats(UCAN_HandleTypeDef* ucan, UCAN_SignalStats* stats);
+#endif
+
+/**
+  * @brief  Copies the latest complete set of a signal group into the bound variables.
+  * @param  ucan  Pointer to the uCAN handle.
+  * @param  group Signal group to read.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_ReadGroup(UCAN_HandleTypeDef* ucan, UCAN_SignalGroup* group);
+
+
+#if UCAN_CFG_MONITOR
+/**
+  * @brief  Copies captured frames out of the monitor ring, oldest first.
+  * @param  ucan      Pointer to the uCAN handle.
+  * @param  frames    Destination array.
+  * @param  maxFrames Capacity of the destination array.
+  * @param  count     Output number of frames copied.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_MonitorRead(UCAN_HandleTypeDef* ucan, UCAN_MonitorFrame* frames, uint32_t maxFrames, uint32_t* count);
+
+/**
+  * @brief  Returns the oldest contiguous run of captured frames without copying.
+  * @param  ucan   Pointer to the uCAN handle.
+  * @param  frames Output pointer to the first frame.
+  * @param  count  Output number of frames in the run.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_MonitorPeek(UCAN_HandleTypeDef* ucan, const UCAN_MonitorFrame** frames, uint32_t* count);
+
+/**
+  * @brief  Releases frames obtained with uCAN_MonitorPeek().
+  * @param  ucan  Pointer to the uCAN handle.
+  * @param  count Number of frames consumed.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_MonitorRelease(UCAN_HandleTypeDef* ucan, uint32_t count);
+
+/**
+  * @brief  Encodes captured frames into a compact log buffer and frees their slots.
+  * @param  ucan  Pointer to the uCAN handle.
+  * @param  log   Encoder context of the log stream.
+  * @param  out   Destination buffer.
+  * @param  space Free bytes in the destination buffer.
+  * @param  used  Output number of bytes written.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_MonitorDrainToLog(UCAN_HandleTypeDef* ucan, UCAN_LogContext* log, uint8_t* out, uint32_t space, uint32_t* used);
+#endif
+
+
+#if UCAN_CFG_HW_TIMESTAMP
+/**
+  * @brief  Records the hardware transmit confirmation of a TX mailbox.
+  * @param  ucan    Pointer to the uCAN handle.
+  * @param  mailbox Completed mailbox (CAN_TX_MAILBOXx).
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_TxComplete(UCAN_HandleTypeDef* ucan, uint32_t mailbox);
+
+/**
+  * @brief  Reads the hardware timing (last time, period, jitter) of a packet.
+  * @param  ucan   Pointer to the uCAN handle.
+  * @param  id     CAN identifier of a TX or RX packet.
+  * @param  result Output snapshot in microseconds.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_GetPacketTiming(UCAN_HandleTypeDef* ucan, uint32_t id, UCAN_PacketTimingResult* result);
+#endif
+
+#if UCAN_CFG_SCHEDULE
+/**
+  * @brief  Runs the time-triggered transmit schedule from a timer interrupt.
+  * @param  ucan   Pointer to the uCAN handle.
+  * @param  nextUs Output microseconds until the next call is needed.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_ScheduleTick(UCAN_HandleTypeDef* ucan, uint32_t* nextUs);
+#endif
+
+/**
+  * @brief  Sends one TX packet immediately, critical packets may use the reserved mailboxes.
+  * @param  ucan Pointer to the uCAN handle.
+  * @param  id   CAN identifier of a TX packet.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_Send(UCAN_HandleTypeDef* ucan, uint32_t id);
+
+#if UCAN_CFG_OVERLAY
+/**
+  * @brief  Copies the latest payload of an overlay packet into a caller struct.
+  * @param  ucan Pointer to the uCAN handle.
+  * @param  id   CAN identifier of an RX or TX overlay packet.
+  * @param  dst  Destination struct.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_OverlayRead(UCAN_HandleTypeDef* ucan, uint32_t id, void* dst);
+
+/**
+  * @brief  Publishes a new payload for a double-buffered TX overlay packet.
+  * @param  ucan Pointer to the uCAN handle.
+  * @param  id   CAN identifier of a TX overlay packet.
+  * @param  src  Source struct.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_OverlayWrite(UCAN_HandleTypeDef* ucan, uint32_t id, const void* src);
+#endif
+
+/**
+  * @brief  Reads the health and traffic counters of one bus.
+  * @param  ucan   Pointer to the uCAN handle.
+  * @param  bus    0 for the primary controller, 1 for the redundant one.
+  * @param  health Output snapshot.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_GetBusHealth(UCAN_HandleTypeDef* ucan, uint32_t bus, UCAN_BusHealth* health);
+
+#if UCAN_CFG_LATENCY
+/**
+  * @brief  Marks the instant at which the value of a traced TX packet was sampled.
+  * @param  ucan Pointer to the uCAN handle.
+  * @param  id   CAN identifier of a traced TX packet.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_LatencySample(UCAN_HandleTypeDef* ucan, uint32_t id);
+
+/**
+  * @brief  Marks the use of the latest value of a traced RX packet.
+  * @param  ucan Pointer to the uCAN handle.
+  * @param  id   CAN identifier of a traced RX packet.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_LatencyUse(UCAN_HandleTypeDef* ucan, uint32_t id);
+
+/**
+  * @brief  Reads the sample-to-use latency statistics of a traced RX packet.
+  * @param  ucan   Pointer to the uCAN handle.
+  * @param  id     CAN identifier of a traced RX packet.
+  * @param  result Output statistics per stage and histogram of the total.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_GetLatency(UCAN_HandleTypeDef* ucan, uint32_t id, UCAN_LatencyResult* result);
+#endif
+
+/**
+  * @brief  Processes a batch of frames received outside the controller's RX FIFO.
+  * @param  ucan   Pointer to the uCAN handle.
+  * @param  frames Frames in arrival order.
+  * @param  count  Number of frames.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_UpdateBatch(UCAN_HandleTypeDef* ucan, const UCAN_MonitorFrame* frames, uint32_t count);
+
+#if UCAN_CFG_TRIGGER
+/**
+  * @brief  Copies trigger hits out of the event queue, oldest first.
+  * @param  ucan      Pointer to the uCAN handle.
+  * @param  events    Destination array.
+  * @param  maxEvents Capacity of the destination array.
+  * @param  count     Output number of events copied.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_ReadEvents(UCAN_HandleTypeDef* ucan, UCAN_TriggerEvent* events, uint32_t maxEvents, uint32_t* count);
+#endif
+#if UCAN_CFG_HANDSHAKE
+/**
+  * @brief  Reads the capabilities negotiated with a peer.
+  * @param  ucan   Pointer to the uCAN handle.
+  * @param  peerId CAN identifier of a client (master) or of the master (client).
+  * @param  caps   Output capability record.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_GetPeerCaps(UCAN_HandleTypeDef* ucan, uint32_t peerId, UCAN_PeerCaps* caps);
+#endif
+#if UCAN_CFG_FAULT
+/**
+  * @brief  Starts, restarts or stops (plan NULL) a fault injection scenario.
+  * @param  ucan Pointer to the uCAN handle.
+  * @param  plan Scenario to run.
+  * @retval Status of the operation.
+  */
+UCAN_StatusTypeDef uCAN_FaultStart(UCAN_HandleTypeDef* ucan, UCAN_FaultPlan* plan);
+
+/**
+  * @brief  Drives the running fault scenario and updates its detection and recovery figures.
+  * @param  ucan Pointer to the uCAN handle.
+  * @retval UCAN_OK once the scenario is over, UCAN_BUSY while it runs.
+  */
+UCAN_StatusTypeDef uCAN_FaultPoll(UCAN_HandleTypeDef* ucan);
+#endif
+#if UCAN_CFG_LAZY
+/**
+  * @brief  Decodes the last received frame of a lazy RX packet into its bound variables.
+  * @param  ucan Pointer to the uCAN handle.
+  * @param  id   CAN identifier of the packet.
+  * @param  time Optional output reception time, may be NULL.
+  * @retval UCAN_OK if new values were written, UCAN_NO_CHANGED_VAL if nothing arrived since the last call.
+  */
+UCAN_StatusTypeDef uCAN_Unpack(UCAN_HandleTypeDef* ucan, uint32_t id, UCAN_Time* time);
+#endif
 
 #endif
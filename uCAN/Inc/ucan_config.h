@@ -0,0 +1,280 @@
+/**
+  ******************************************************************************
+  * @file    ucan_config.h
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Compile-time configuration of the uCAN library.
+  *
+  * This header collects the switches that decide which parts of uCAN are
+  * compiled into the firmware. Features that are switched off are removed by
+  * the preprocessor, so they cost neither flash nor cycles in the hot path.
+  *
+  * The defaults keep the core feature set. Switches that need extra wiring
+  * in the application or cost RAM on every frame (trace hook, hardware
+  * timestamps, latency trailer, export, HAL callbacks, fault injection)
+  * default to off. To change a value, define it before this header is seen,
+  * typically through the compiler command line or the IDE's preprocessor
+  * symbols, e.g.:
+  *
+  *     -DUCAN_CFG_ROLE=UCAN_CFG_ROLE_CLIENT -DUCAN_CFG_STATS=0
+  *
+  * Key Categories:
+  *  - **Role:** `UCAN_CFG_ROLE` fixes the node role at compile time and drops
+  *    the handshake code of the other roles.
+  *
+  *  - **Features:** `UCAN_CFG_HANDSHAKE`, `UCAN_CFG_MEMBERSHIP`, `UCAN_CFG_STATS`,
+  *    `UCAN_CFG_TRACE`, `UCAN_CFG_MONITOR`, `UCAN_CFG_HW_TIMESTAMP`,
+  *    `UCAN_CFG_SCHEDULE`, `UCAN_CFG_OVERLAY`, `UCAN_CFG_REDUNDANT`,
+  *    `UCAN_CFG_LATENCY`, `UCAN_CFG_TRIGGER` and `UCAN_CFG_LAZY` enable or
+  *    remove whole subsystems.
+  *
+  *  - **Validation:** `UCAN_CFG_VALIDATION` selects how much checking is done
+  *    at startup and on every API call.
+  *
+  *  - **Transmit:** `UCAN_CFG_RESERVED_MAILBOXES` keeps TX mailboxes free for
+  *    critical packets.
+  *
+  *  - **Receive:** `UCAN_CFG_RX_INDEX` replaces the binary search of received
+  *    identifiers by a direct lookup.
+  *
+  *  - **Integration:** `UCAN_CFG_HAL_CALLBACKS` lets uCAN take the HAL CAN
+  *    callbacks instead of application glue code, `UCAN_CFG_EXPORT` publishes
+  *    received frames to other programs through shared memory.
+  *
+  *  - **Testing:** `UCAN_CFG_FAULT` adds the fault injection layer used to
+  *    measure detection and recovery times; keep it out of production builds.
+  *
+  *  - **Limits:** `UCAN_CFG_MAX_PACKETS`, `UCAN_CFG_MAX_CLIENTS` and
+  *    `UCAN_GROUP_MAX_MEMBERS` bound configuration sizes.
+  *
+  * @see     uCAN GitHub repository: https://github.com/hamza-enes-balahoroglu/uCAN.git
+  *
+  *
+  *                          _____          _   _
+  *                         / ____|   /\   | \ | |
+  *                   _   _| |       /  \  |  \| |
+  *                  | | | | |      / /\ \ | . ` |
+  *                  | |_| | |____ / ____ \| |\  |
+  *                   \____|\_____/_/    \_\_| \_|
+  *
+  ******************************************************************************
+  */
+
+#ifndef UCAN_CONFIG
+#define UCAN_CONFIG
+
+#define UCAN_CFG_ROLE_RUNTIME			0U		/*!< Role taken from UCAN_NodeInfo.role at runtime, code for all roles is kept */
+#define UCAN_CFG_ROLE_MASTER			1U		/*!< Node is always a master, client handshake code is removed */
+#define UCAN_CFG_ROLE_CLIENT			2U		/*!< Node is always a client, master handshake code is removed */
+#define UCAN_CFG_ROLE_NONE				3U		/*!< Node takes no part in handshakes, all handshake code is removed */
+
+#define UCAN_CFG_VALIDATION_NONE		0U		/*!< No readiness check on API calls, no startup configuration checks */
+#define UCAN_CFG_VALIDATION_READY		1U		/*!< Single-comparison readiness check on every API call */
+#define UCAN_CFG_VALIDATION_FULL		2U		/*!< Readiness check plus full configuration validation in uCAN_Start() */
+
+/**
+  * @brief Role of the node, one of the UCAN_CFG_ROLE_xxx values.
+  */
+#ifndef UCAN_CFG_ROLE
+#define UCAN_CFG_ROLE					UCAN_CFG_ROLE_RUNTIME
+#endif
+
+/**
+  * @brief Handshake (ping/pong connection tracking) support, 1 = enabled, 0 = removed.
+  * @note  When disabled, uCAN_Handshake() is not available and unknown IDs are
+  *        reported as UCAN_ERROR_UNKNOWN_ID by uCAN_Update().
+  */
+#ifndef UCAN_CFG_HANDSHAKE
+#define UCAN_CFG_HANDSHAKE				1U
+#endif
+
+/**
+  * @brief Membership broadcast of active clients by the master, 1 = enabled, 0 = removed.
+  * @note  Requires UCAN_CFG_HANDSHAKE.
+  */
+#ifndef UCAN_CFG_MEMBERSHIP
+#define UCAN_CFG_MEMBERSHIP				1U
+#endif
+
+/**
+  * @brief Per-signal RX statistics (UCAN_SignalStats), 1 = enabled, 0 = removed.
+  */
+#ifndef UCAN_CFG_STATS
+#define UCAN_CFG_STATS					1U
+#endif
+
+/**
+  * @brief Event trace hook (uCAN_TraceHook()), 1 = enabled, 0 = removed.
+  */
+#ifndef UCAN_CFG_TRACE
+#define UCAN_CFG_TRACE					0U
+#endif
+
+/**
+  * @brief Listen-only bus monitor (UCAN_Monitor capture ring), 1 = enabled, 0 = removed.
+  */
+#ifndef UCAN_CFG_MONITOR
+#define UCAN_CFG_MONITOR				1U
+#endif
+
+/**
+  * @brief Hardware (TTCM) timestamps of RX frames and TX confirmations, 1 = enabled, 0 = removed.
+  * @note  uCAN_Start() switches the controller to time triggered communication mode
+  *        and enables the TX mailbox empty interrupt, whose callback must reach
+  *        uCAN_TxComplete() (application glue or UCAN_CFG_HAL_CALLBACKS).
+  */
+#ifndef UCAN_CFG_HW_TIMESTAMP
+#define UCAN_CFG_HW_TIMESTAMP			0U
+#endif
+
+/**
+  * @brief Time-triggered transmit schedule (UCAN_Schedule), 1 = enabled, 0 = removed.
+  */
+#ifndef UCAN_CFG_SCHEDULE
+#define UCAN_CFG_SCHEDULE				1U
+#endif
+
+/**
+  * @brief Struct-overlay packet binding (UCAN_PacketConfig.overlay), 1 = enabled, 0 = removed.
+  */
+#ifndef UCAN_CFG_OVERLAY
+#define UCAN_CFG_OVERLAY				1U
+#endif
+
+/**
+  * @brief Redundant dual-bus operation (UCAN_HandleTypeDef.hcanRedundant), 1 = enabled, 0 = removed.
+  */
+#ifndef UCAN_CFG_REDUNDANT
+#define UCAN_CFG_REDUNDANT				1U
+#endif
+
+/**
+  * @brief End-to-end latency tracing of selected packets (UCAN_PacketConfig.latency), 1 = enabled, 0 = removed.
+  * @note  Traced packets carry a UCAN_LATENCY_TRAILER_DLC byte trailer, producer and
+  *        consumer must both be built with this switch.
+  */
+#ifndef UCAN_CFG_LATENCY
+#define UCAN_CFG_LATENCY				0U
+#endif
+
+/**
+  * @brief Signal triggers evaluated in the RX path (UCAN_Data.trigger), 1 = enabled, 0 = removed.
+  */
+#ifndef UCAN_CFG_TRIGGER
+#define UCAN_CFG_TRIGGER				1U
+#endif
+
+/**
+  * @brief Lazily decoded RX packets (UCAN_PacketConfig.lazy), 1 = enabled, 0 = removed.
+  * @note  A lazy packet keeps its last raw frame in a slot; the bound variables
+  *        are only written by uCAN_Unpack().
+  */
+#ifndef UCAN_CFG_LAZY
+#define UCAN_CFG_LAZY					1U
+#endif
+
+/**
+  * @brief Shared-memory export of received frames (UCAN_Export), 1 = enabled, 0 = removed.
+  * @note  Every RX frame is also copied into its slot of the export region, see
+  *        ucan_export.h for the layout and the reader functions.
+  */
+#ifndef UCAN_CFG_EXPORT
+#define UCAN_CFG_EXPORT					0U
+#endif
+
+/**
+  * @brief Direct RX lookup of standard IDs (UCAN_IdIndex), 1 = enabled, 0 = binary search only.
+  * @note  Costs 384 bytes per handle and makes the packet lookup of every
+  *        received frame independent of the number of RX packets.
+  */
+#ifndef UCAN_CFG_RX_INDEX
+#define UCAN_CFG_RX_INDEX				1U
+#endif
+
+/**
+  * @brief HAL CAN callback integration, 1 = uCAN handles the callbacks, 0 = application calls uCAN.
+  * @note  With USE_HAL_CAN_REGISTER_CALLBACKS the callbacks are registered per
+  *        controller in uCAN_Start(), otherwise uCAN defines the HAL's weak
+  *        HAL_CAN_xxxCallback() functions, which the application must then not
+  *        define itself.
+  */
+#ifndef UCAN_CFG_HAL_CALLBACKS
+#define UCAN_CFG_HAL_CALLBACKS			0U
+#endif
+
+/**
+  * @brief Fault injection between uCAN and the HAL (UCAN_FaultPlan), 1 = enabled, 0 = removed.
+  * @note  Meant for robustness tests and recovery benchmarks. It adds a check
+  *        to every received and queued frame and to every timebase read.
+  */
+#ifndef UCAN_CFG_FAULT
+#define UCAN_CFG_FAULT					0U
+#endif
+
+/**
+  * @brief Number of TX mailboxes (0 to 2) that only critical packets may use.
+  * @note  Bulk frames are queued only while more than this many of the three
+  *        mailboxes are free, so a critical frame always finds one empty.
+  *        Off by default, as it lowers the number of bulk frames in flight.
+  */
+#ifndef UCAN_CFG_RESERVED_MAILBOXES
+#define UCAN_CFG_RESERVED_MAILBOXES		0U
+#endif
+
+/**
+  * @brief Validation level, one of the UCAN_CFG_VALIDATION_xxx values.
+  */
+#ifndef UCAN_CFG_VALIDATION
+#define UCAN_CFG_VALIDATION				UCAN_CFG_VALIDATION_FULL
+#endif
+
+/**
+  * @brief Maximum number of packets accepted in a single TX or RX holder.
+  */
+#ifndef UCAN_CFG_MAX_PACKETS
+#define UCAN_CFG_MAX_PACKETS			64U
+#endif
+
+/**
+  * @brief Maximum number of clients in UCAN_NodeInfo.clients (sizes the membership bitmap).
+  */
+#ifndef UCAN_CFG_MAX_CLIENTS
+#define UCAN_CFG_MAX_CLIENTS			64U
+#endif
+
+/**
+  * @brief Maximum number of RX packets in one signal group.
+  */
+#ifndef UCAN_GROUP_MAX_MEMBERS
+#define UCAN_GROUP_MAX_MEMBERS			4
+#endif
+
+/* Derived switches --------------------------------------------------------*/
+
+/** @brief Master handshake code is compiled in. */
+#define UCAN_CFG_HAS_MASTER				(UCAN_CFG_HANDSHAKE && \
+										((UCAN_CFG_ROLE == UCAN_CFG_ROLE_RUNTIME) || (UCAN_CFG_ROLE == UCAN_CFG_ROLE_MASTER)))
+
+/** @brief Client handshake code is compiled in. */
+#define UCAN_CFG_HAS_CLIENT				(UCAN_CFG_HANDSHAKE && \
+										((UCAN_CFG_ROLE == UCAN_CFG_ROLE_RUNTIME) || (UCAN_CFG_ROLE == UCAN_CFG_ROLE_CLIENT)))
+
+/** @brief Membership broadcast code is compiled in. */
+#define UCAN_CFG_HAS_MEMBERSHIP			(UCAN_CFG_HANDSHAKE && UCAN_CFG_MEMBERSHIP)
+
+#if (UCAN_CFG_ROLE > UCAN_CFG_ROLE_NONE)
+#error "UCAN_CFG_ROLE must be one of the UCAN_CFG_ROLE_xxx values"
+#endif
+
+#if (UCAN_CFG_VALIDATION > UCAN_CFG_VALIDATION_FULL)
+#error "UCAN_CFG_VALIDATION must be one of the UCAN_CFG_VALIDATION_xxx values"
+#endif
+
+#if (UCAN_CFG_RESERVED_MAILBOXES > 2)
+#error "UCAN_CFG_RESERVED_MAILBOXES must be between 0 and 2"
+#endif
+
+#if (UCAN_GROUP_MAX_MEMBERS < 1) || (UCAN_GROUP_MAX_MEMBERS > 8)
+#error "UCAN_GROUP_MAX_MEMBERS must be between 1 and 8"
+#endif
+
+#endif
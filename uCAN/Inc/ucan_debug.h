@@ -59,6 +59,77 @@ UCAN_StatusTypeDef uCAN_Debug_CheckPacketConfig(UCAN_PacketConfig* configList, U
   */
 UCAN_StatusTypeDef uCAN_Debug_FinalizePacket(UCAN_PacketConfig* configPackets, UCAN_PacketHolder* packetHolder);
 
+/**
+  * @brief [INTERNAL] Resolve and validate signal group members against the RX holder.
+  * @param ucan Pointer to UCAN_HandleTypeDef holding the groups.
+  * @retval UCAN_StatusTypeDef UCAN_OK if all groups are valid, error code otherwise.
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeGroups(UCAN_HandleTypeDef* ucan);
+
+#if UCAN_CFG_RX_INDEX
+/**
+  * @brief [INTERNAL] Build the direct ID lookup of a sorted packet holder.
+  * @param packetHolder Pointer to the finalized UCAN_PacketHolder.
+  * @param index Storage of the lookup.
+  * @retval UCAN_StatusTypeDef UCAN_OK if success (binary search is kept for unsuitable IDs).
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeIndex(UCAN_PacketHolder* packetHolder, UCAN_IdIndex* index);
+#endif
+
+#if UCAN_CFG_LATENCY
+/**
+  * @brief [INTERNAL] Validate traced packets and clear their latency blocks.
+  * @param ucan Pointer to UCAN_HandleTypeDef with finalized packet holders.
+  * @retval UCAN_StatusTypeDef UCAN_OK if all traced packets are valid, error code otherwise.
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeLatency(UCAN_HandleTypeDef* ucan);
+#endif
+
+#if UCAN_CFG_TRIGGER
+/**
+  * @brief [INTERNAL] Validate the RX triggers and bind them to the event queue.
+  * @param ucan Pointer to UCAN_HandleTypeDef with finalized packet holders.
+  * @retval UCAN_StatusTypeDef UCAN_OK if all triggers are valid, error code otherwise.
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeTriggers(UCAN_HandleTypeDef* ucan);
+#endif
+
+#if UCAN_CFG_EXPORT
+/**
+  * @brief [INTERNAL] Write the RX packet layout into the export region and bind the slots.
+  * @param ucan Pointer to UCAN_HandleTypeDef with finalized packet holders.
+  * @param rxList RX packet configuration list the holder was built from.
+  * @retval UCAN_StatusTypeDef UCAN_OK if the layout was written or export is disabled, error code otherwise.
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeExport(UCAN_HandleTypeDef* ucan, UCAN_PacketConfig* rxList);
+#endif
+
+/**
+  * @brief [INTERNAL] Compute an 8-bit hash of the finalized TX/RX packet configuration.
+  * @param ucan Pointer to UCAN_HandleTypeDef with finalized packet holders.
+  * @retval uint8_t Configuration hash (CRC-8).
+  */
+uint8_t uCAN_Debug_ConfigHash(UCAN_HandleTypeDef* ucan);
+
+#if UCAN_CFG_HW_TIMESTAMP
+/**
+  * @brief [INTERNAL] Derive the hardware timebase from the CAN bit timing.
+  * @param clock Pointer to the hardware clock state.
+  * @param hcan Pointer to the initialized HAL CAN handle.
+  * @param tick Current time in milliseconds from the handle timebase.
+  */
+void uCAN_Debug_FinalizeClock(UCAN_HwClock* clock, CAN_HandleTypeDef* hcan, uint32_t tick);
+#endif
+
+#if UCAN_CFG_SCHEDULE
+/**
+  * @brief [INTERNAL] Compile and validate the time-triggered transmit schedule.
+  * @param ucan Pointer to UCAN_HandleTypeDef with finalized packet holders.
+  * @retval UCAN_StatusTypeDef UCAN_OK if the schedule is valid, error code otherwise.
+  */
+UCAN_StatusTypeDef uCAN_Debug_CompileSchedule(UCAN_HandleTypeDef* ucan);
+#endif
+
 /**
   * @brief [INTERNAL] Sort and finalize UCAN node information client list.
   * @param node Pointer to UCAN_NodeInfo to finalize.
@@ -66,6 +137,20 @@ UCAN_StatusTypeDef uCAN_Debug_FinalizePacket(UCAN_PacketConfig* configPackets, U
   */
 UCAN_StatusTypeDef uCAN_Debug_FinalizeNodeInfo(UCAN_NodeInfo* node);
 
+/**
+  * @brief [INTERNAL] Validate and prepare the timebase of a handle.
+  * @param timebase Pointer to the UCAN_Timebase to finalize.
+  * @retval UCAN_StatusTypeDef UCAN_OK if success, UCAN_INVALID_PARAM for an unusable frequency.
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeTimebase(UCAN_Timebase* timebase);
+
+/**
+  * @brief [INTERNAL] Bind the primary and redundant controllers to the buses of a handle.
+  * @param ucan Pointer to the UCAN_HandleTypeDef to finalize.
+  * @retval UCAN_StatusTypeDef UCAN_OK if success, UCAN_INVALID_PARAM for an invalid controller pair.
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeBuses(UCAN_HandleTypeDef* ucan);
+
 /**
  * @brief [INTERNAL] Validate UCAN node information for correctness and duplicates.
  * @param node Pointer to UCAN_NodeInfo to check.
@@ -0,0 +1,204 @@
+/**
+  ******************************************************************************
+  * @file    ucan_export.h
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Shared-memory export of the latest received frames.
+  *
+  * Describes a self-contained memory region into which uCAN publishes every
+  * received RX frame, and the functions that write and read it. Other
+  * programs map the same memory and read the current values without a CAN
+  * socket, a decoder of their own, copies through uCAN or system calls.
+  *
+  * This header and ucan_export.c depend only on the C standard library, so
+  * the same sources build into the firmware (writer) and into reader
+  * programs. The region holds offsets only, no pointers, so it may be mapped
+  * at a different address in every reader, e.g. a POSIX shared-memory object
+  * on a Linux gateway or a shared SRAM bank between two cores.
+  *
+  * Region layout:
+  *  - **Header:** UCAN_ExportHeader, "uCX" followed by UCAN_EXPORT_VERSION,
+  *    the layout generation and the offsets and sizes of the two tables.
+  *
+  *  - **Descriptors:** one UCAN_ExportDesc per RX packet, sorted by
+  *    identifier, with the DLC and the byte offset and size of every signal.
+  *
+  *  - **Slots:** one UCAN_ExportSlot per RX packet, same order, with the
+  *    latest payload and its reception time.
+  *
+  * Every slot is a seqlock: its sequence counter is odd while the writer
+  * updates it, and a reader retries if the counter was odd or moved during
+  * its copy. The header generation works the same way for the layout, which
+  * is rebuilt by every uCAN_Start(). There is a single writer, readers never
+  * write, so any number of them can read at the same time.
+  *
+  * @see     uCAN GitHub repository: https://github.com/hamza-enes-balahoroglu/uCAN.git
+  *
+  *
+  *                          _____          _   _
+  *                         / ____|   /\   | \ | |
+  *                   _   _| |       /  \  |  \| |
+  *                  | | | | |      / /\ \ | . ` |
+  *                  | |_| | |____ / ____ \| |\  |
+  *                   \____|\_____/_/    \_\_| \_|
+  *
+  ******************************************************************************
+  */
+
+#ifndef UCAN_EXPORT
+#define UCAN_EXPORT
+
+#include <stdint.h>
+
+#define UCAN_EXPORT_VERSION				1U		/*!< Version byte written after the "uCX" magic */
+
+#define UCAN_EXPORT_MAX_SIGNALS			8U		/*!< Signals described per packet, one per payload byte at most */
+
+#define UCAN_EXPORT_READ_RETRIES		16U		/*!< Attempts to copy a consistent slot before a reader gives up */
+
+/**
+  * @brief Full memory barrier between the slot counter and the slot contents.
+  * @note  A DMB on Cortex-M and a fence on the host with GCC and Clang. Define
+  *        it before this header is seen for other compilers.
+  */
+#ifndef UCAN_EXPORT_FENCE
+#define UCAN_EXPORT_FENCE()				__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+/**
+  * @brief Size in bytes of a region exporting `count` RX packets.
+  */
+#define UCAN_EXPORT_REGION_SIZE(count)	(sizeof(UCAN_ExportHeader) + \
+										 (uint32_t)(count) * (sizeof(UCAN_ExportDesc) + sizeof(UCAN_ExportSlot)))
+
+/**
+  * @brief  Header at the start of an export region.
+  */
+typedef struct {
+    uint8_t magic[3];						/*!< "uCX" */
+    uint8_t version;						/*!< UCAN_EXPORT_VERSION */
+    volatile uint32_t generation;			/*!< Odd while the layout is written, changes with every new layout */
+    uint32_t count;							/*!< Number of descriptors and slots */
+    uint32_t descOffset;					/*!< Offset of the descriptor table from the region start */
+    uint32_t slotOffset;					/*!< Offset of the slot table from the region start */
+    uint32_t descSize;						/*!< sizeof(UCAN_ExportDesc) of the writer */
+    uint32_t slotSize;						/*!< sizeof(UCAN_ExportSlot) of the writer */
+    uint32_t frequency;						/*!< Counts per second of UCAN_ExportSlot.time */
+} UCAN_ExportHeader;
+
+/**
+  * @brief  Position of one signal in the payload.
+  */
+typedef struct {
+    uint8_t offset;							/*!< First payload byte of the signal */
+    uint8_t size;							/*!< Size in bytes (1, 2 or 4), unsigned little-endian */
+} UCAN_ExportSignal;
+
+/**
+  * @brief  Layout descriptor of one exported RX packet.
+  */
+typedef struct {
+    uint32_t id;							/*!< CAN identifier of the packet */
+    uint8_t dlc;							/*!< Number of payload bytes bound by the packet */
+    uint8_t signalCount;					/*!< Entries used in signals, 0 for overlay or handler-only packets */
+    uint8_t reserved[2];					/*!< Zero */
+    UCAN_ExportSignal signals[UCAN_EXPORT_MAX_SIGNALS];	/*!< Signals in configuration order */
+} UCAN_ExportDesc;
+
+/**
+  * @brief  Latest frame of one exported RX packet.
+  */
+typedef struct {
+    volatile uint32_t seq;					/*!< Odd while written, 0 if no frame yet */
+    uint8_t dlc;							/*!< Number of bytes received */
+    uint8_t reserved[3];					/*!< Zero */
+    uint64_t time;							/*!< Reception time in counts of UCAN_ExportHeader.frequency */
+    uint8_t data[8];						/*!< Payload, bytes beyond dlc are undefined */
+} UCAN_ExportSlot;
+
+/**
+  * @brief  Consistent copy of a slot, as returned by uCAN_ExportRead().
+  */
+typedef struct {
+    uint32_t seq;							/*!< Sequence number, grows by 2 with every frame */
+    uint8_t dlc;							/*!< Number of bytes received */
+    uint64_t time;							/*!< Reception time in counts of UCAN_ExportHeader.frequency */
+    uint8_t data[8];						/*!< Payload */
+} UCAN_ExportFrame;
+
+/**
+  * @brief  Starts a new layout: marks the region as being rebuilt and clears both tables.
+  * @param  region    Region memory, 8-byte aligned.
+  * @param  size      Size of the region in bytes.
+  * @param  count     Number of RX packets to export.
+  * @param  frequency Counts per second of the reception times.
+  * @retval Bytes used, 0 if the region is misaligned or too small.
+  */
+uint32_t uCAN_ExportBegin(void* region, uint32_t size, uint32_t count, uint32_t frequency);
+
+/**
+  * @brief  Publishes the layout written since uCAN_ExportBegin().
+  * @param  region Region memory.
+  */
+void uCAN_ExportCommit(void* region);
+
+/**
+  * @brief  Returns the descriptor of a packet.
+  * @param  region Region memory.
+  * @param  index  Packet index below UCAN_ExportHeader.count.
+  * @retval Pointer to the descriptor.
+  */
+UCAN_ExportDesc* uCAN_ExportDescriptor(void* region, uint32_t index);
+
+/**
+  * @brief  Returns the slot of a packet.
+  * @param  region Region memory.
+  * @param  index  Packet index below UCAN_ExportHeader.count.
+  * @retval Pointer to the slot.
+  */
+UCAN_ExportSlot* uCAN_ExportSlotAt(void* region, uint32_t index);
+
+/**
+  * @brief  Writes a received frame into its slot.
+  * @param  slot Slot of the packet.
+  * @param  data Payload, 8 bytes of storage.
+  * @param  dlc  Number of payload bytes (0 to 8).
+  * @param  time Reception time.
+  */
+void uCAN_ExportPublish(UCAN_ExportSlot* slot, const uint8_t data[], uint8_t dlc, uint64_t time);
+
+/**
+  * @brief  Validates a mapped region.
+  * @param  region Region memory.
+  * @param  size   Number of bytes mapped.
+  * @retval Current layout generation, 0 if the region is invalid or being rebuilt.
+  */
+uint32_t uCAN_ExportOpen(const void* region, uint32_t size);
+
+/**
+  * @brief  Finds the packet index of an identifier.
+  * @param  region Region memory, validated with uCAN_ExportOpen().
+  * @param  id     CAN identifier.
+  * @retval Packet index, -1 if the identifier is not exported.
+  */
+int32_t uCAN_ExportFind(const void* region, uint32_t id);
+
+/**
+  * @brief  Copies the latest frame of a packet.
+  * @param  region Region memory, validated with uCAN_ExportOpen().
+  * @param  index  Packet index.
+  * @param  frame  Output frame.
+  * @retval 1 if a frame was copied, 0 if none was received yet, -1 if the
+  *         slot kept changing or the index is out of range.
+  */
+int32_t uCAN_ExportRead(const void* region, uint32_t index, UCAN_ExportFrame* frame);
+
+/**
+  * @brief  Decodes one signal of a copied frame.
+  * @param  desc   Descriptor of the packet.
+  * @param  frame  Frame copied with uCAN_ExportRead().
+  * @param  signal Signal index below desc->signalCount.
+  * @retval Unsigned value of the signal, 0 for an invalid index.
+  */
+uint32_t uCAN_ExportSignalValue(const UCAN_ExportDesc* desc, const UCAN_ExportFrame* frame, uint32_t signal);
+
+#endif
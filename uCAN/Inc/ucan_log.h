@@ -0,0 +1,131 @@
+/**
+  ******************************************************************************
+  * @file    ucan_log.h
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Compact binary log format for captured CAN traffic.
+  *
+  * Encodes frames captured by the bus monitor into a byte stream that is much
+  * smaller than fixed-size records, and decodes that stream back into frames.
+  *
+  * This header and ucan_log.c depend only on the C standard library, so the
+  * same sources build into the firmware (encoder) and into host tools
+  * (decoder).
+  *
+  * Stream layout:
+  *  - **Header:** 4 bytes, "uCL" followed by UCAN_LOG_VERSION.
+  *
+  *  - **Record tag (1 byte):** bits 0-3 DLC, bit 4 hardware timestamp present,
+  *    bit 5 remote frame, bit 6 extended ID, bit 7 dictionary hit.
+  *
+  *  - **Time delta:** milliseconds since the previous record as an unsigned
+  *    LEB128 varint (one byte for gaps below 128 ms).
+  *
+  *  - **Identifier:** one dictionary slot byte on a hit, otherwise the raw ID
+  *    (2 bytes standard, 4 bytes extended, little-endian). Encoder and decoder
+  *    update identical direct-mapped dictionaries, so no table is stored.
+  *
+  *  - **Hardware timestamp:** 2 bytes little-endian, only if tag bit 4 is set.
+  *
+  *  - **Payload:** DLC bytes, none for remote frames.
+  *
+  * A periodic standard frame with 8 data bytes takes 11 bytes instead of the
+  * 20 bytes of a UCAN_MonitorFrame.
+  *
+  * @see     uCAN GitHub repository: https://github.com/hamza-enes-balahoroglu/uCAN.git
+  *
+  *
+  *                          _____          _   _
+  *                         / ____|   /\   | \ | |
+  *                   _   _| |       /  \  |  \| |
+  *                  | | | | |      / /\ \ | . ` |
+  *                  | |_| | |____ / ____ \| |\  |
+  *                   \____|\_____/_/    \_\_| \_|
+  *
+  ******************************************************************************
+  */
+
+#ifndef UCAN_LOG
+#define UCAN_LOG
+
+#include <stdint.h>
+
+#define UCAN_LOG_VERSION				1U		/*!< Version byte written in the stream header */
+
+#define UCAN_LOG_HEADER_SIZE			4U		/*!< Size of the stream header in bytes */
+
+#define UCAN_LOG_MAX_RECORD				20U		/*!< Largest encoded record: tag, 5-byte delta, 4-byte ID, timestamp, 8 data bytes */
+
+#define UCAN_LOG_DICT_BITS				6U		/*!< log2 of the identifier dictionary size, at most 8 */
+
+#define UCAN_LOG_DICT_SIZE				(1U << UCAN_LOG_DICT_BITS)	/*!< Number of identifier dictionary slots */
+
+#define UCAN_MONITOR_FLAG_EXT			0x01U	/*!< Monitor frame flag: identifier is a 29-bit extended ID */
+
+#define UCAN_MONITOR_FLAG_RTR			0x02U	/*!< Monitor frame flag: remote transmission request, no payload */
+
+/**
+  * @brief  One CAN frame captured by the bus monitor or read back from a log.
+  */
+typedef struct {
+    uint32_t id;							/*!< Standard or extended identifier of the frame */
+    uint32_t tick;							/*!< Reception time (in ms) from the handle timebase */
+    uint16_t timestamp;						/*!< Hardware timestamp (CAN bit times) latched by the controller */
+    uint8_t dlc;							/*!< Data length code (0-8) */
+    uint8_t flags;							/*!< UCAN_MONITOR_FLAG_xxx bits (extended ID, remote frame) */
+    uint8_t data[8];						/*!< Frame payload, bytes beyond dlc are undefined */
+} UCAN_MonitorFrame;
+
+/**
+  * @brief  State shared by the log encoder and decoder.
+  * @note   Initialize with uCAN_LogInit(). One context per stream and
+  *         direction; encoder and decoder evolve identical dictionaries.
+  */
+typedef struct {
+    uint32_t lastTick;						/*!< [INTERNAL] Tick of the previous record */
+    uint32_t dict[UCAN_LOG_DICT_SIZE];		/*!< [INTERNAL] Direct-mapped identifier dictionary */
+    uint8_t hwTimestamps;					/*!< Encoder only: non-zero stores the hardware timestamp of every record */
+} UCAN_LogContext;
+
+/**
+  * @brief  Resets a log context to the start-of-stream state.
+  * @param  ctx Pointer to the log context.
+  */
+void uCAN_LogInit(UCAN_LogContext* ctx);
+
+/**
+  * @brief  Writes the stream header.
+  * @param  out   Destination buffer.
+  * @param  space Free bytes in the destination buffer.
+  * @retval Number of bytes written, 0 if the buffer is too small.
+  */
+uint32_t uCAN_LogWriteHeader(uint8_t* out, uint32_t space);
+
+/**
+  * @brief  Validates the stream header.
+  * @param  in  Source buffer.
+  * @param  len Number of bytes available.
+  * @retval Number of header bytes, 0 if the header is missing or of another version.
+  */
+uint32_t uCAN_LogReadHeader(const uint8_t* in, uint32_t len);
+
+/**
+  * @brief  Appends one frame to the stream.
+  * @param  ctx   Pointer to the encoder context.
+  * @param  frame Frame to encode.
+  * @param  out   Destination buffer.
+  * @param  space Free bytes in the destination buffer.
+  * @retval Number of bytes written, 0 if the record does not fit (context unchanged).
+  */
+uint32_t uCAN_LogEncode(UCAN_LogContext* ctx, const UCAN_MonitorFrame* frame, uint8_t* out, uint32_t space);
+
+/**
+  * @brief  Reads one frame from the stream.
+  * @param  ctx   Pointer to the decoder context.
+  * @param  in    Source buffer positioned at a record.
+  * @param  len   Number of bytes available.
+  * @param  frame Output frame.
+  * @retval Bytes consumed, 0 if the record is incomplete, -1 if the stream is malformed.
+  */
+int32_t uCAN_LogDecode(UCAN_LogContext* ctx, const uint8_t* in, uint32_t len, UCAN_MonitorFrame* frame);
+
+#endif
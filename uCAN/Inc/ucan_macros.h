@@ -10,7 +10,7 @@
   * the development process.
   *
   * Key Categories:
-  *  - **Handshake Logic:** Macros such as `UCAN_HANDSHAKE_TICK_DIFF`,
+  *  - **Handshake Logic:** Macros such as `UCAN_TIME_SINCE`,
   *    `UCAN_HANDSHAKE_IS_TIMEOUT`, and `UCAN_HANDSHAKE_IS_LOST` define how
   *    handshake response timing is interpreted to detect delays or lost clients.
   *
@@ -23,6 +23,9 @@
   *  - **Status Check Macro:** `UCAN_CHECK_READY()` provides a compact and
   *    readable way to validate the state of a `uCAN` instance before proceeding.
   *
+  *  - **Configuration Helpers:** `UCAN_NODE_IS_MASTER()`, `UCAN_NODE_IS_CLIENT()`
+  *    and `UCAN_TRACE()` resolve the switches of ucan_config.h.
+  *
   * Usage of these macros increases code readability and consistency while
   * reducing repeated boilerplate checks.
   *
@@ -52,84 +55,253 @@
 
 #define UCAN_HANDSHAKE_RESPONSE_VALUE  	0x5AU	/*!< Value sent back by the Client in response to a handshake request */
 
+#define UCAN_HANDSHAKE_ANNOUNCE_VALUE  	0x5BU	/*!< Value sent unsolicited by a Client right after startup (boot announcement) */
+
+#define UCAN_HANDSHAKE_CAPS_VALUE     	0x5CU	/*!< Value sent back by a Client instead of the response when the ping requests its capabilities */
+
+#define UCAN_ANNOUNCE_BACKOFF_MAX_MS  	16  	/*!< Upper bound (ms) of the randomized delay before a Client's boot announcement */
+
+#define UCAN_MEMBERSHIP_VALUE         	0xC3U 	/*!< First byte of a membership broadcast sent by the Master */
+
+#define UCAN_MEMBERSHIP_INTERVAL_MS   	500  	/*!< Interval (ms) at which the Master broadcasts the membership bitmap */
+
+#define UCAN_MEMBERSHIP_BITS_PER_FRAME 	40  	/*!< Client bits per broadcast frame (bytes 3..7) */
+
+#define UCAN_MEMBERSHIP_CHUNK         	1		/*!< Membership broadcast byte: chunk index */
+
+#define UCAN_MEMBERSHIP_HASH          	2		/*!< Membership broadcast byte: hash of the master's client list */
+
+#define UCAN_MEMBERSHIP_BITS          	3		/*!< Membership broadcast byte: first byte of client bits */
+
+#define UCAN_PONG_DIAG_DLC            	8		/*!< Length of a handshake response carrying diagnostics */
+
+#define UCAN_PONG_CPU_LOAD            	1		/*!< Pong byte: CPU load in percent */
+
+#define UCAN_PONG_TEC                 	2		/*!< Pong byte: transmit error counter */
+
+#define UCAN_PONG_REC                 	3		/*!< Pong byte: receive error counter */
+
+#define UCAN_PONG_DROPPED             	4		/*!< Pong byte: dropped frame count, saturated to 255 */
+
+#define UCAN_PONG_UPTIME              	5		/*!< Pong bytes 5..6: uptime in seconds, little-endian, saturated to 65535 */
+
+#define UCAN_PONG_CONFIG_HASH         	7		/*!< Pong byte: hash of the packet configuration */
+
+#define UCAN_PROTOCOL_VERSION         	1		/*!< Handshake protocol version sent in pings and capability frames */
+
+#define UCAN_PING_DLC                 	7		/*!< Length of a ping carrying version, capabilities, flags and the client asked for capabilities */
+
+#define UCAN_PING_VERSION             	1		/*!< Ping byte: protocol version of the master */
+
+#define UCAN_PING_CAPS                	2		/*!< Ping bytes 2..3: capabilities of the master, little-endian */
+
+#define UCAN_PING_FLAGS               	4		/*!< Ping byte: UCAN_PING_FLAG_xxx */
+
+#define UCAN_PING_FLAG_CAPS_REQUEST   	0x01U	/*!< Ping flag: the client named at UCAN_PING_CAPS_ID answers with a capability frame instead of a response */
+
+#define UCAN_PING_CAPS_ID             	5		/*!< Ping bytes 5..6: CAN ID of the client asked for its capabilities, little-endian */
+
+#define UCAN_CAPS_DLC                 	4		/*!< Length of a capability frame */
+
+#define UCAN_CAPS_VERSION             	1		/*!< Capability frame byte: protocol version of the client */
+
+#define UCAN_CAPS_BITS                	2		/*!< Capability frame bytes 2..3: capabilities of the client, little-endian */
+
+#define UCAN_CAPS_LEGACY_MISSES       	3		/*!< Plain responses to capability requests after which a client is taken as version 0 */
+
+#define UCAN_CAP_DIAG                 	0x0001U	/*!< Responses carry the health record */
+#define UCAN_CAP_MEMBERSHIP           	0x0002U	/*!< Membership broadcasts are sent or understood */
+#define UCAN_CAP_HW_TIMESTAMP         	0x0004U	/*!< Hardware timestamps, round trips are measured */
+#define UCAN_CAP_LATENCY              	0x0008U	/*!< Latency trailers of traced packets are sent and understood */
+#define UCAN_CAP_REDUNDANT            	0x0010U	/*!< Node can drive a redundant second bus */
+#define UCAN_CAP_EXT_ID               	0x0020U	/*!< Packets with 29-bit identifiers (never set by this implementation) */
+#define UCAN_CAP_FD                   	0x0040U	/*!< CAN FD frames (never set by this implementation, bxCAN is classic CAN only) */
+#define UCAN_CAP_APP(n)               	(0x0100U << (n))	/*!< Application defined capability n (0..7), from UCAN_NodeInfo.appCaps */
+
+/** @brief Capabilities of this build, the application bits are added at runtime. */
+#define UCAN_CAPS_BUILTIN             	(UCAN_CAP_DIAG | \
+										 (UCAN_CFG_HAS_MEMBERSHIP ? UCAN_CAP_MEMBERSHIP : 0U) | \
+										 (UCAN_CFG_HW_TIMESTAMP ? UCAN_CAP_HW_TIMESTAMP : 0U) | \
+										 (UCAN_CFG_LATENCY ? UCAN_CAP_LATENCY : 0U) | \
+										 (UCAN_CFG_REDUNDANT ? UCAN_CAP_REDUNDANT : 0U))
+
+/** @brief Capabilities advertised by a node. */
+#define UCAN_CAPS_LOCAL(node)         	((uint16_t)(UCAN_CAPS_BUILTIN | ((uint16_t)(node)->appCaps << 8)))
+
 #define UCAN_HANDSHAKE_INTERVAL_MS    	500  	/*!< Interval (ms) at which the Master sends handshake pings */
 
 #define UCAN_HANDSHAKE_TIMEOUT_MS     	700 	/*!< Max time (ms) to wait for a Client response before considering it "delayed" (with 200ms tolerance) */
 
 #define UCAN_HANDSHAKE_LOST_MS       	2000  	/*!< If no response is received within this time (ms), the connection is considered lost */
 
+#define UCAN_STATS_READ_RETRIES       	4  		/*!< Attempts to read a consistent statistics snapshot before giving up */
+
+#define UCAN_GROUP_READ_RETRIES       	4  		/*!< Attempts to copy a consistent signal group before giving up */
+
+#define UCAN_TX_LATCH_RETRIES         	4  		/*!< Lock-free attempts to capture a consistent TX set before masking interrupts */
+
+#define UCAN_TIMING_READ_RETRIES      	4  		/*!< Attempts to read a consistent packet timing snapshot before giving up */
+
+#define UCAN_DIAG_READ_RETRIES        	4  		/*!< Attempts to copy a consistent client health record before giving up */
+
+#define UCAN_OVERLAY_READ_RETRIES     	4  		/*!< Attempts to copy a consistent double-buffered overlay before giving up */
+
+#define UCAN_RAW_READ_RETRIES         	4  		/*!< Attempts to copy a consistent raw slot of a lazy packet before giving up */
+
+#define UCAN_REDUNDANT_WINDOW_MS      	2		/*!< Max time (ms) between the two copies of one frame on a redundant pair */
+
+#define UCAN_REDUNDANT_SEQ_SPAN       	8U		/*!< Max frames a bus may lag behind the other one for the rolling counter to recognize its copies */
+
+#define UCAN_REDUNDANT_SILENCE_MS     	1000	/*!< Time (ms) a bus may stay silent while the other one carries traffic before it counts as degraded */
+
+#define UCAN_REDUNDANT_FILTER_BANK    	14		/*!< First filter bank of the redundant (slave) controller */
+
+#define UCAN_CAN_INSTANCES            	3U		/*!< bxCAN controllers of the largest STM32F4 devices (CAN1 to CAN3) */
+
+#define UCAN_DEDUP_EMPTY              	0xFFU	/*!< UCAN_DedupEntry.bus value of an unused slot */
+
+#define UCAN_DEDUP_KEY_EXT            	0x80000000U	/*!< Keeps standard and extended IDs apart in the duplicate filter */
+
+#define UCAN_LATENCY_TRAILER_DLC      	4U		/*!< Bytes of the latency trailer appended to a traced packet's payload */
+
+#define UCAN_LATENCY_SEQ              	0		/*!< Trailer byte: frame sequence number of the producer */
+
+#define UCAN_LATENCY_STAMP            	1		/*!< Trailer bytes 1..2: queue time, low 16 bits of the timebase in us, little-endian */
+
+#define UCAN_LATENCY_AGE              	3		/*!< Trailer byte: producer stage in UCAN_LATENCY_AGE_UNIT_US, saturated to 255 */
+
+#define UCAN_LATENCY_AGE_UNIT_US      	64		/*!< Resolution (us) of the producer stage carried in the trailer */
+
+#define UCAN_FAULT_SETTLE_MS          	UCAN_HANDSHAKE_LOST_MS	/*!< Time (ms) an undetected fault episode stays open after its last window, so a late detection is still counted */
+
+#define UCAN_FAULT_STATE_IDLE         	0U		/*!< UCAN_FaultMetric.state: no fault episode open */
+
+#define UCAN_FAULT_STATE_OPEN         	1U		/*!< UCAN_FaultMetric.state: episode open, not yet detected */
+
+#define UCAN_FAULT_STATE_DETECTED     	2U		/*!< UCAN_FaultMetric.state: episode open and reported by the monitor */
+
+#define UCAN_FAULT_STATE_CLEARED      	0x80U	/*!< UCAN_FaultMetric.state flag: every fault window of the episode has ended */
+
+#define UCAN_LATENCY_READ_RETRIES     	4  		/*!< Attempts to read a consistent latency record before giving up */
+
+#define UCAN_BATCH_CHUNK              	16		/*!< Frames classified at once by uCAN_UpdateBatch() */
+
+#define UCAN_SCHEDULE_MAX_REPEAT      	64		/*!< Largest cycle repeat of a schedule window (power of two) */
+
 /**
-  * @brief Calculates the time difference between when the handshake was sent and when a response was received.
+  * @brief Worst-case length in bit times of a standard data frame with `dlc` bytes.
   *
-  * @note  Handles timer overflow by wrapping around UINT32_MAX.
+  * @note  47 fixed bits (frame fields plus interframe space) and 8 bits per data
+  *        byte, plus the maximum number of stuff bits.
   */
-#define UCAN_HANDSHAKE_TICK_DIFF(sentTick, responseTick) \
-    (((sentTick) <= (responseTick)) ? ((responseTick) - (sentTick)) : (UINT32_MAX - (responseTick) + (sentTick) + 1U))
+#define UCAN_FRAME_BITS(dlc)            (47U + 8U * (dlc) + (34U + 8U * (dlc) - 1U) / 4U)
+
+/**
+  * @brief Time elapsed from `then` to `now` on the 64-bit timebase.
+  *
+  * @note  64-bit times do not wrap. The result is 0 if `then` is not in the past,
+  *        which happens when an interrupt records an event after `now` was sampled.
+  */
+#define UCAN_TIME_SINCE(now, then) \
+    (((now) > (then)) ? ((now) - (then)) : 0U)
 
 /**
   * @brief Determines if a client response is considered "timed out" but not yet fully "lost".
   *
-  * @note  Used to detect slow or delayed responses before marking as disconnected.
+  * @note  `age` is the time since the client's last response, `timeout` and `lost`
+  *        are UCAN_HANDSHAKE_TIMEOUT_MS and UCAN_HANDSHAKE_LOST_MS on the same timebase.
   */
-#define UCAN_HANDSHAKE_IS_TIMEOUT(sentTick, responseTick) \
-    (UCAN_HANDSHAKE_TICK_DIFF((sentTick), (responseTick)) > UCAN_HANDSHAKE_TIMEOUT_MS && \
-     UCAN_HANDSHAKE_TICK_DIFF((sentTick), (responseTick)) < UCAN_HANDSHAKE_LOST_MS)
+#define UCAN_HANDSHAKE_IS_TIMEOUT(age, timeout, lost) \
+    ((age) > (timeout) && (age) < (lost))
 
 /**
   * @brief Determines if the client is considered "lost" due to no response within allowed window.
   *
   * @note  Use this to flag the client as disconnected from the network.
   */
-#define UCAN_HANDSHAKE_IS_LOST(sentTick, responseTick) \
-    (UCAN_HANDSHAKE_TICK_DIFF((sentTick), (responseTick)) >= UCAN_HANDSHAKE_LOST_MS)
+#define UCAN_HANDSHAKE_IS_LOST(age, lost) \
+    ((age) >= (lost))
 
 /**
   * @brief  Checks if the given UCAN handler is ready for operation.
   *
-  * @note   This macro performs a series of sanity checks on the `ucan` pointer
-  *         and its internal status. If any error or uninitialized condition is
-  *         detected, it returns the corresponding UCAN_StatusTypeDef error code.
+  * @note   This macro performs a sanity check on the `ucan` pointer and its
+  *         internal status. Every failed initialization or startup step leaves
+  *         its error code in `status`, and only a successfully initialized
+  *         handle holds UCAN_OK, so a single comparison covers all cases. If
+  *         the handle is not ready, the stored status is returned as is.
   *
   *         Typical use case is at the beginning of any UCAN function to avoid
   *         executing logic on an invalid or misconfigured instance.
   *
-  *         Errors checked:
-  *         - Null pointer
+  *         Errors reported:
+  *         - Null pointer (UCAN_INVALID_PARAM)
   *         - Not initialized
-  *         - General error
-  *         - Duplicate ID
-  *         - Filter configuration failure
-  *         - CAN peripheral start failure
-  *         - Notification setup failure
-  *         - Missing required values
+  *         - Any error left by uCAN_Init() or uCAN_Start()
+  *
+  *         Compiled out entirely with UCAN_CFG_VALIDATION_NONE.
   */
+#if (UCAN_CFG_VALIDATION >= UCAN_CFG_VALIDATION_READY)
 #define UCAN_CHECK_READY(ucan)                                      \
     do {                                                            \
         if ((ucan) == NULL) {                                       \
             return UCAN_INVALID_PARAM;                              \
         }                                                           \
-        if ((ucan)->status == UCAN_NOT_INITIALIZED) {               \
-            return UCAN_NOT_INITIALIZED;                            \
-        }                                                           \
-        if ((ucan)->status == UCAN_ERROR) {                         \
-            return UCAN_ERROR;                                      \
-        }                                                           \
-        if ((ucan)->status == UCAN_ERROR_DUPLICATE_ID) {            \
-            return UCAN_ERROR_DUPLICATE_ID;                         \
-        }                                                           \
-        if ((ucan)->status == UCAN_ERROR_FILTER_CONFIG) {           \
-            return UCAN_ERROR_FILTER_CONFIG;                        \
-        }                                                           \
-        if ((ucan)->status == UCAN_ERROR_CAN_START) {               \
-            return UCAN_ERROR_CAN_START;                            \
-        }                                                           \
-        if ((ucan)->status == UCAN_ERROR_CAN_NOTIFICATION) {        \
-            return UCAN_ERROR_CAN_NOTIFICATION;                     \
-        }                                                           \
-        if ((ucan)->status == UCAN_MISSING_VAL) {                   \
-            return UCAN_MISSING_VAL;                                \
+        if ((ucan)->status != UCAN_OK) {                            \
+            return (ucan)->status;                                  \
         }                                                           \
     } while (0)
+#else
+#define UCAN_CHECK_READY(ucan)          ((void)(ucan))
+#endif
+
+/**
+  * @brief  Evaluates whether a node acts as master / client.
+  *
+  * @note   With a role fixed through UCAN_CFG_ROLE these fold into constants,
+  *         so role checks cost nothing at runtime.
+  */
+#if (UCAN_CFG_ROLE == UCAN_CFG_ROLE_RUNTIME)
+#define UCAN_NODE_IS_MASTER(node)       ((node)->role == UCAN_ROLE_MASTER)
+#define UCAN_NODE_IS_CLIENT(node)       ((node)->role == UCAN_ROLE_CLIENT)
+#else
+#define UCAN_NODE_IS_MASTER(node)       (UCAN_CFG_ROLE == UCAN_CFG_ROLE_MASTER)
+#define UCAN_NODE_IS_CLIENT(node)       (UCAN_CFG_ROLE == UCAN_CFG_ROLE_CLIENT)
+#endif
+
+/**
+  * @brief  Reports an event to the user trace hook.
+  *
+  * @note   Expands to nothing unless UCAN_CFG_TRACE is enabled.
+  */
+#if UCAN_CFG_TRACE
+/**
+  * @brief  User trace hook, called from the context of the traced operation.
+  * @param  event Event being reported.
+  * @param  arg   Event argument (CAN ID or status code).
+  * @note   A weak empty implementation is provided by the library.
+  */
+void uCAN_TraceHook(UCAN_TraceEvent event, uint32_t arg);
+
+#define UCAN_TRACE(event, arg)          uCAN_TraceHook((event), (uint32_t)(arg))
+#else
+#define UCAN_TRACE(event, arg)          ((void)0)
+#endif
+
+/**
+  * @brief  Tests / sets / clears the membership bit of the client at a given index.
+  * @param  node:  Pointer to UCAN_NodeInfo.
+  * @param  index: Position of the client in the (sorted) clients array.
+  * @note   O(1), no bounds check.
+  */
+#define UCAN_MEMBERSHIP_GET(node, index) \
+    ((((node)->membership[(index) >> 5]) >> ((index) & 31U)) & 1U)
+
+#define UCAN_MEMBERSHIP_SET(node, index) \
+    ((node)->membership[(index) >> 5] |= (1UL << ((index) & 31U)))
+
+#define UCAN_MEMBERSHIP_CLEAR(node, index) \
+    ((node)->membership[(index) >> 5] &= ~(1UL << ((index) & 31U)))
 
 /**
   * @brief  Calculates the number of packets in a static UCAN_PacketConfig list.
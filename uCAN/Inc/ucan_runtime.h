@@ -34,46 +34,415 @@
 
 /**
   * @brief [INTERNAL] Sends a single UCAN packet over CAN bus.
-  * @param hcan Pointer to the HAL CAN handle.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
   * @param packet Pointer to the packet to send.
   * @retval UCAN_StatusTypeDef Status of the transmission operation.
   */
-UCAN_StatusTypeDef uCAN_Runtime_SendPacket(CAN_HandleTypeDef* hcan, UCAN_Packet* packet);
+UCAN_StatusTypeDef uCAN_Runtime_SendPacket(UCAN_Bus* buses, UCAN_Packet* packet);
 
+/**
+  * @brief [INTERNAL] Sends a raw standard data frame of the bulk class over CAN bus.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param id Standard CAN identifier.
+  * @param dlc Number of payload bytes (0 to 8).
+  * @param data Pointer to the payload bytes.
+  * @retval UCAN_StatusTypeDef Status of the transmission operation.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SendFrame(UCAN_Bus* buses, uint32_t id, uint8_t dlc, uint8_t data[]);
+
+/**
+  * @brief [INTERNAL] Sends a raw standard data frame using any free mailbox, including reserved ones.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param id Standard CAN identifier.
+  * @param dlc Number of payload bytes (0 to 8).
+  * @param data Pointer to the payload bytes.
+  * @retval UCAN_StatusTypeDef Status of the transmission operation.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SendCriticalFrame(UCAN_Bus* buses, uint32_t id, uint8_t dlc, uint8_t data[]);
+
+/**
+  * @brief [INTERNAL] Captures a consistent copy of all TX payloads into the packets' staging area.
+  * @param txHolder Pointer to the TX packet holder.
+  * @param tick Timestamp in milliseconds recorded as the latch instant.
+  * @retval UCAN_StatusTypeDef Status of the latch operation.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_LatchPackets(UCAN_PacketHolder* txHolder, uint32_t tick);
+
+/**
+  * @brief [INTERNAL] Reads the timebase and extends the counter to 64 bits.
+  * @param timebase Pointer to the finalized timebase.
+  * @retval UCAN_Time Current time in counts.
+  */
+UCAN_Time uCAN_Runtime_Now(UCAN_Timebase* timebase);
+
+/**
+  * @brief [INTERNAL] Converts a time to milliseconds, truncated to 32 bits.
+  * @param timebase Pointer to the finalized timebase.
+  * @param time Time in counts.
+  * @retval uint32_t Milliseconds.
+  */
+uint32_t uCAN_Runtime_TimeToMs(const UCAN_Timebase* timebase, UCAN_Time time);
+
+/**
+  * @brief [INTERNAL] Converts a duration in milliseconds to timebase counts.
+  * @param timebase Pointer to the finalized timebase.
+  * @param ms Duration in milliseconds.
+  * @retval UCAN_Time Duration in counts.
+  */
+UCAN_Time uCAN_Runtime_MsToTime(const UCAN_Timebase* timebase, uint32_t ms);
+
+/**
+  * @brief [INTERNAL] Converts a time to microseconds.
+  * @param timebase Pointer to the finalized timebase.
+  * @param time Time in counts.
+  * @retval uint64_t Microseconds.
+  */
+uint64_t uCAN_Runtime_TimeToUs(const UCAN_Timebase* timebase, UCAN_Time time);
+
+/**
+  * @brief [INTERNAL] Reads a 64-bit time written by an interrupt without tearing.
+  * @param time Pointer to the time.
+  * @retval UCAN_Time Consistent copy of the time.
+  */
+UCAN_Time uCAN_Runtime_LoadTime(const volatile UCAN_Time* time);
+
+#if UCAN_CFG_OVERLAY
+/**
+  * @brief [INTERNAL] Writes a payload into the overlay struct of a packet.
+  * @param packet Packet with a bound overlay.
+  * @param data Payload of packet->dlc bytes.
+  */
+void uCAN_Runtime_StoreOverlay(UCAN_Packet* packet, const uint8_t data[]);
+
+/**
+  * @brief [INTERNAL] Copies the current payload out of the overlay struct of a packet.
+  * @param packet Packet with a bound overlay.
+  * @param data Output buffer of at least packet->dlc bytes.
+  * @retval UCAN_StatusTypeDef UCAN_OK, or UCAN_BUSY if the overlay kept changing.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_LoadOverlay(const UCAN_Packet* packet, uint8_t data[]);
+#endif
+
+#if UCAN_CFG_LAZY
+/**
+  * @brief [INTERNAL] Stores a received frame in the raw slot of a lazy packet.
+  * @param slot Raw slot of the packet.
+  * @param aData Received payload, 8 bytes of storage.
+  * @param time Reception time on the handle's timebase.
+  */
+void uCAN_Runtime_StoreRaw(UCAN_RawSlot* slot, const uint8_t aData[], UCAN_Time time);
+
+/**
+  * @brief [INTERNAL] Copies the last frame out of the raw slot of a lazy packet.
+  * @param slot Raw slot of the packet.
+  * @param data Output buffer of 8 bytes.
+  * @param time Output reception time, may be NULL.
+  * @param seq Output sequence number of the copied frame.
+  * @retval UCAN_StatusTypeDef UCAN_OK, or UCAN_BUSY if the slot kept changing.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_LoadRaw(const UCAN_RawSlot* slot, uint8_t data[], UCAN_Time* time, uint32_t* seq);
+#endif
+
+#if UCAN_CFG_HAS_MASTER
 /**
   * @brief [INTERNAL] Sends a handshake request ("ping") from the master node.
-  * @param hcan Pointer to the HAL CAN handle.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
   * @param node Pointer to the UCAN node structure.
   * @retval UCAN_StatusTypeDef Status of the ping transmission.
   */
-UCAN_StatusTypeDef uCAN_Runtime_SendPing(CAN_HandleTypeDef* hcan, UCAN_NodeInfo* node);
+UCAN_StatusTypeDef uCAN_Runtime_SendPing(UCAN_Bus* buses, UCAN_NodeInfo* node);
+#endif
+
+#if UCAN_CFG_HAS_MEMBERSHIP && UCAN_CFG_HAS_MASTER
+/**
+  * @brief [INTERNAL] Broadcasts the master's bitmap of active clients.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param node Pointer to the UCAN node structure.
+  * @retval UCAN_StatusTypeDef Status of the broadcast.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SendMembership(UCAN_Bus* buses, UCAN_NodeInfo* node);
+#endif
 
+#if UCAN_CFG_HAS_MEMBERSHIP && UCAN_CFG_HAS_CLIENT
+/**
+  * @brief [INTERNAL] Applies one received membership broadcast chunk to the local view.
+  * @param node Pointer to the UCAN node structure.
+  * @param aData Pointer to the received data bytes.
+  * @param dlc Number of received data bytes.
+  * @retval UCAN_StatusTypeDef Status of the update.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_UpdateMembership(UCAN_NodeInfo* node, uint8_t aData[], uint8_t dlc);
+#endif
+
+#if UCAN_CFG_HAS_CLIENT
 /**
   * @brief [INTERNAL] Sends a handshake response ("pong") from a client node.
-  * @param hcan Pointer to the HAL CAN handle.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
   * @param node Pointer to the UCAN node structure.
   * @retval UCAN_StatusTypeDef Status of the reply transmission.
   */
-UCAN_StatusTypeDef uCAN_Runtime_SendPong(CAN_HandleTypeDef* hcan, UCAN_NodeInfo* node);
+UCAN_StatusTypeDef uCAN_Runtime_SendPong(UCAN_Bus* buses, UCAN_NodeInfo* node);
+
+/**
+  * @brief [INTERNAL] Schedules a client's boot announcement after a randomized backoff.
+  * @param node Pointer to the UCAN node structure.
+  */
+void uCAN_Runtime_ScheduleAnnounce(UCAN_NodeInfo* node);
+
+/**
+  * @brief [INTERNAL] Sends a pending boot announcement once its backoff has elapsed.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param node Pointer to the UCAN node structure.
+  * @retval UCAN_StatusTypeDef Status of the announcement.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SendAnnounce(UCAN_Bus* buses, UCAN_NodeInfo* node);
+
+/**
+  * @brief [INTERNAL] Sends the client's reply to the last ping, or retries one that found no mailbox.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param node Pointer to the UCAN node structure.
+  * @retval UCAN_StatusTypeDef Status of the reply transmission.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SendReply(UCAN_Bus* buses, UCAN_NodeInfo* node);
+#endif
+
+/**
+  * @brief [INTERNAL] Finds the packet with the given ID in a packet holder.
+  * @param holder Pointer to a finalized packet holder.
+  * @param id CAN identifier to look up.
+  * @retval UCAN_Packet* Matching packet, NULL if none.
+  */
+UCAN_Packet* uCAN_Runtime_FindPacket(UCAN_PacketHolder* holder, uint32_t id);
 
 /**
   * @brief [INTERNAL] Updates received packet data based on CAN ID.
   * @param rxHolder Pointer to the RX packet holder.
   * @param StdId Standard CAN ID of the received message.
   * @param aData Pointer to the received data bytes.
+  * @param dlc Number of received data bytes.
+  * @param timestamp Reception timestamp in milliseconds.
+  * @param time Reception time on the handle's timebase.
+  * @param hwTime Extended hardware reception time in bit times.
   * @retval UCAN_StatusTypeDef Status of the update operation.
   */
-UCAN_StatusTypeDef uCAN_Runtime_UpdatePacket(UCAN_PacketHolder* rxHolder, uint32_t StdId, uint8_t aData[]);
+UCAN_StatusTypeDef uCAN_Runtime_UpdatePacket(UCAN_PacketHolder* rxHolder, uint32_t StdId, uint8_t aData[], uint8_t dlc, uint32_t timestamp, UCAN_Time time, uint64_t hwTime);
 
+/**
+  * @brief [INTERNAL] Hands a received frame to its RX packet.
+  * @param packet RX packet the frame belongs to.
+  * @param aData Pointer to the received data bytes.
+  * @param dlc Number of received data bytes.
+  * @param timestamp Reception timestamp in milliseconds.
+  * @param time Reception time on the handle's timebase.
+  * @param hwTime Extended hardware reception time in bit times, 0 if none.
+  * @retval UCAN_StatusTypeDef Status of the update operation.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_DeliverPacket(UCAN_Packet* packet, const uint8_t aData[], uint8_t dlc, uint32_t timestamp, UCAN_Time time, uint64_t hwTime);
+
+#if UCAN_CFG_HANDSHAKE
 /**
   * @brief [INTERNAL] Processes handshake messages based on node role.
   * @param node Pointer to the UCAN node info.
-  * @param hcan Pointer to the HAL CAN handle.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
   * @param StdId Standard CAN ID of the received handshake message.
   * @param aData Pointer to the received data bytes.
+  * @param dlc Number of received data bytes.
+  * @param hwTime Extended hardware reception time in bit times.
   * @retval UCAN_StatusTypeDef Status of the handshake processing.
   */
-UCAN_StatusTypeDef uCAN_Runtime_UpdateHandshake(UCAN_NodeInfo* node, CAN_HandleTypeDef* hcan, uint32_t StdId, uint8_t aData[]);
+UCAN_StatusTypeDef uCAN_Runtime_UpdateHandshake(UCAN_NodeInfo* node, UCAN_Bus* buses, uint32_t StdId, uint8_t aData[], uint8_t dlc, uint64_t hwTime);
+#endif
+
+/**
+  * @brief [INTERNAL] Extracts a single signal value from a raw CAN payload.
+  * @param aData Pointer to the payload bytes.
+  * @param offset Byte offset of the signal inside the payload.
+  * @param type Data type of the signal.
+  * @retval uint32_t Decoded signal value.
+  */
+uint32_t uCAN_Runtime_DecodeSignal(const uint8_t aData[], uint8_t offset, UCAN_DataType type);
+
+#if UCAN_CFG_STATS
+/**
+  * @brief [INTERNAL] Feeds a received payload into all statistics blocks of a packet.
+  * @param stats Head of the packet's statistics list (may be NULL).
+  * @param aData Pointer to the received data bytes.
+  * @param time Reception time on the handle's timebase.
+  */
+void uCAN_Runtime_UpdateStats(UCAN_SignalStats* stats, const uint8_t aData[], UCAN_Time time);
+#endif
+
+#if UCAN_CFG_TRIGGER
+/**
+  * @brief [INTERNAL] Evaluates all triggers of a packet and queues their hits.
+  * @param trigger Head of the packet's trigger list (may be NULL).
+  * @param id CAN identifier of the packet.
+  * @param aData Pointer to the received data bytes.
+  * @param time Reception time on the handle's timebase.
+  */
+void uCAN_Runtime_EvaluateTriggers(UCAN_Trigger* trigger, uint32_t id, const uint8_t aData[], UCAN_Time time);
+#endif
+
+/**
+  * @brief [INTERNAL] Stores a received member frame into its signal group.
+  * @param group Pointer to the signal group.
+  * @param index Position of the member packet inside the group.
+  * @param aData Pointer to the received data bytes.
+  * @param dlc Number of payload bytes to store.
+  */
+void uCAN_Runtime_UpdateGroup(UCAN_SignalGroup* group, uint8_t index, const uint8_t aData[], uint8_t dlc);
+
+#if UCAN_CFG_MONITOR
+/**
+  * @brief [INTERNAL] Copies a received frame into the monitor capture ring.
+  * @param monitor Pointer to the monitor state.
+  * @param header Pointer to the HAL RX header of the frame.
+  * @param aData Pointer to the received data bytes.
+  * @param tick Reception timestamp in milliseconds.
+  * @retval UCAN_StatusTypeDef UCAN_OK, or UCAN_BUSY if the ring was full and the frame was dropped.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_CaptureFrame(UCAN_Monitor* monitor, const CAN_RxHeaderTypeDef* header, const uint8_t aData[], uint32_t tick);
+#endif
+
+#if UCAN_CFG_REDUNDANT
+/**
+  * @brief [INTERNAL] Recognizes the later copy of a frame received on both buses of a redundant pair.
+  * @param table Duplicate filter of the handle (UCAN_DEDUP_SIZE slots).
+  * @param rxHolder RX packets of the handle, for the rolling counter of the frame's packet.
+  * @param bus Index of the bus the frame was received on.
+  * @param header Pointer to the HAL RX header of the frame.
+  * @param aData Pointer to the received data bytes.
+  * @param now Reception time on the handle timebase.
+  * @param window Longest time between two copies of one frame, in timebase counts.
+  * @retval uint8_t Non-zero if the frame is a duplicate and must be discarded.
+  */
+uint8_t uCAN_Runtime_IsDuplicate(UCAN_DedupEntry table[], UCAN_PacketHolder* rxHolder, uint8_t bus, const CAN_RxHeaderTypeDef* header, const uint8_t aData[], UCAN_Time now, UCAN_Time window);
+#endif
+
+#if UCAN_CFG_LATENCY
+/**
+  * @brief [INTERNAL] Appends the latency trailer to the payload of a traced TX packet.
+  * @param latency Latency block of the packet.
+  * @param data Payload buffer of 8 bytes, the trailer is written after dlc bytes.
+  * @param dlc Number of bound payload bytes.
+  * @param latchTime Time at which the payload was latched, 0 if it is read at send time.
+  * @retval uint8_t Length of the frame including the trailer.
+  */
+uint8_t uCAN_Runtime_StampLatency(UCAN_LatencyStats* latency, uint8_t data[], uint8_t dlc, UCAN_Time latchTime);
+
+/**
+  * @brief [INTERNAL] Records the latency stages of a received traced frame.
+  * @param latency Latency block of the RX packet.
+  * @param trailer Pointer to the trailer bytes.
+  * @param time Reception time on the handle's timebase.
+  */
+void uCAN_Runtime_RecordLatency(UCAN_LatencyStats* latency, const uint8_t trailer[], UCAN_Time time);
+
+/**
+  * @brief [INTERNAL] Adds the last received frame of a traced packet to its latency statistics.
+  * @param latency Latency block of the RX packet.
+  * @param now Time at which the value is used.
+  * @retval UCAN_StatusTypeDef UCAN_OK, UCAN_NO_CHANGED_VAL if no new frame, UCAN_BUSY if no consistent copy.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_UseLatency(UCAN_LatencyStats* latency, UCAN_Time now);
+#endif
+
+#if UCAN_CFG_HW_TIMESTAMP
+/**
+  * @brief [INTERNAL] Places a 16-bit hardware timestamp on the 64-bit timebase.
+  * @param clock Pointer to the hardware clock state.
+  * @param raw 16-bit TTCM timestamp of the event.
+  * @param tick HAL tick (ms) at which the event is processed.
+  * @retval uint64_t Extended time in bit times.
+  */
+uint64_t uCAN_Runtime_ExtendTimestamp(UCAN_HwClock* clock, uint16_t raw, uint32_t tick);
+
+/**
+  * @brief [INTERNAL] Records a timed event (RX frame or TX confirmation) of a packet.
+  * @param timing Pointer to the packet's timing block.
+  * @param time Extended time of the event in bit times.
+  */
+void uCAN_Runtime_UpdateTiming(UCAN_PacketTiming* timing, uint64_t time);
+
+/**
+  * @brief [INTERNAL] Converts bit times of the hardware timebase to microseconds.
+  * @param clock Pointer to the hardware clock state.
+  * @param bits Duration in bit times.
+  * @retval uint64_t Duration in microseconds.
+  */
+uint64_t uCAN_Runtime_BitsToUs(const UCAN_HwClock* clock, uint64_t bits);
+#endif
+
+#if UCAN_CFG_SCHEDULE
+/**
+  * @brief [INTERNAL] Starts a basic cycle on reception of the reference message.
+  * @param schedule Pointer to the schedule.
+  * @param aData Pointer to the received data bytes.
+  * @param dlc Number of received data bytes.
+  * @retval UCAN_StatusTypeDef Status of the synchronization.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SyncSchedule(UCAN_Schedule* schedule, uint8_t aData[], uint8_t dlc);
+
+/**
+  * @brief [INTERNAL] Sends the reference message (time master) and all due windows.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param schedule Pointer to the schedule.
+  * @param nextUs Output time until the next window or cycle.
+  * @retval UCAN_StatusTypeDef Status of the schedule step.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_RunSchedule(UCAN_Bus* buses, UCAN_Schedule* schedule, uint32_t* nextUs);
+#endif
+
+#if UCAN_CFG_FAULT
+/**
+  * @brief [INTERNAL] Resets a fault scenario and starts its clock.
+  * @param plan Pointer to the scenario.
+  * @param timebase Pointer to the finalized timebase.
+  */
+void uCAN_Runtime_FaultStart(UCAN_FaultPlan* plan, UCAN_Timebase* timebase);
+
+/**
+  * @brief [INTERNAL] Ends the injected clock drift of a stopped scenario.
+  * @param timebase Pointer to the finalized timebase.
+  */
+void uCAN_Runtime_FaultStop(UCAN_Timebase* timebase);
+
+/**
+  * @brief [INTERNAL] Opens and closes the step windows of a fault scenario.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param plan Pointer to the running scenario.
+  * @param timebase Pointer to the finalized timebase.
+  * @retval UCAN_Time Current time without injected drift.
+  */
+UCAN_Time uCAN_Runtime_FaultUpdate(UCAN_Bus* buses, UCAN_FaultPlan* plan, UCAN_Timebase* timebase);
+
+/**
+  * @brief [INTERNAL] Tells whether the running scenario holds a bus in bus-off.
+  * @param plan Pointer to the running scenario.
+  * @param bus Index of the bus.
+  * @retval uint8_t 1 if the bus is held in bus-off.
+  */
+uint8_t uCAN_Runtime_FaultBusOff(const UCAN_FaultPlan* plan, uint8_t bus);
+
+/**
+  * @brief [INTERNAL] Applies the running scenario to a received frame.
+  * @param plan Pointer to the running scenario.
+  * @param bus Index of the bus the frame came from.
+  * @param header Header of the frame.
+  * @param data Payload of the frame, corrupted in place.
+  * @retval uint8_t 1 if the frame must be discarded.
+  */
+uint8_t uCAN_Runtime_FaultRx(UCAN_FaultPlan* plan, uint8_t bus, const CAN_RxHeaderTypeDef* header, uint8_t data[]);
+
+/**
+  * @brief [INTERNAL] Applies the running scenario to a frame about to be queued.
+  * @param plan Pointer to the running scenario.
+  * @param bus Index of the bus the frame is queued on.
+  * @param id CAN identifier of the frame.
+  * @retval uint8_t 1 if the frame must be swallowed.
+  */
+uint8_t uCAN_Runtime_FaultTx(UCAN_FaultPlan* plan, uint8_t bus, uint32_t id);
+#endif
 
 /**
   * @brief [INTERNAL] Compare two UCAN_Packet structures by their CAN IDs.
@@ -28,6 +28,37 @@
 #define UCAN_TYPES
 
 #include "stm32f4xx_hal.h"
+#include "ucan_config.h"
+#include "ucan_log.h"
+#include "ucan_export.h"
+
+#define UCAN_MEMBERSHIP_WORDS			((UCAN_CFG_MAX_CLIENTS + 31U) / 32U)	/*!< 32-bit words in the membership bitmap */
+
+#define UCAN_GROUP_NO_SEQUENCE			0xFFU	/*!< UCAN_SignalGroup.seqByte value for groups without sequence counter */
+
+#define UCAN_SEQ_BYTE(n)				((uint8_t)((n) + 1U))	/*!< UCAN_PacketConfig.seqByte value naming payload byte n as rolling counter */
+
+#define UCAN_BUS_COUNT					(UCAN_CFG_REDUNDANT ? 2U : 1U)	/*!< Controllers driven by one handle */
+
+#define UCAN_DEDUP_BITS					5U		/*!< log2 of the number of duplicate filter slots */
+
+#define UCAN_DEDUP_SIZE					(1U << UCAN_DEDUP_BITS)	/*!< Number of duplicate filter slots */
+
+#define UCAN_BUS_FLAG_RX				0x01U	/*!< UCAN_Bus.flags: lastRxTime holds a received frame */
+
+#define UCAN_FAULT_MAX_STEPS			32U		/*!< Maximum number of steps in a UCAN_FaultPlan */
+
+#define UCAN_FAULT_ANY_ID				0xFFFFFFFFU	/*!< UCAN_FaultStep.id value matching every frame */
+
+#define UCAN_STD_ID_COUNT				2048U	/*!< Number of 11-bit standard identifiers */
+
+#define UCAN_LATENCY_BUCKETS			16U		/*!< Latency histogram buckets, bucket k counts [2^k, 2^(k+1)) us, the last one everything above */
+
+#define UCAN_CLIENT_FLAG_RESPONDED		0x01U	/*!< UCAN_Client.flags: responseTime holds a received response */
+
+#define UCAN_NODE_TIME_SENT				0x01U	/*!< UCAN_NodeInfo.timeFlags: sentTime holds a sent ping (master) or received ping (client) */
+#define UCAN_NODE_TIME_PING_HW			0x02U	/*!< UCAN_NodeInfo.timeFlags: pingTime holds the hardware time of the last ping */
+#define UCAN_NODE_TIME_MEMBERSHIP		0x04U	/*!< UCAN_NodeInfo.timeFlags: membershipTime holds a broadcast applied from the master (client) */
 
 /**
   * @brief  Data type definition for CAN payload items.
@@ -64,7 +95,7 @@ typedef enum {
     UCAN_TIMEOUT          		= 0x06U,	/*!< Operation timed out */
     UCAN_INVALID_PARAM    		= 0x07U,	/*!< Invalid parameter passed to function */
     UCAN_BUSY             		= 0x08U,  	/*!< CAN bus is busy, try again later */
-    UCAN_ERROR_DUPLICATE_ID		= 0x09U,	/*!< Duplicate ID detected in client or packet list */
+    UCAN_ERROR_DUPLICATE_ID		= 0x09U,	/*!< Duplicate ID detected in client or packet list, or CAN controller already taken by another handle */
     UCAN_ERROR_FILTER_CONFIG	= 0x0AU, 	/*!< Failed to configure CAN filter settings */
     UCAN_ERROR_CAN_START		= 0x0BU, 	/*!< Error occurred while starting the CAN peripheral */
     UCAN_ERROR_CAN_NOTIFICATION	= 0x0CU, 	/*!< Failed to activate CAN RX/TX/FIFO notifications */
@@ -72,6 +103,40 @@ typedef enum {
 } UCAN_StatusTypeDef;
 
 
+/**
+  * @brief  Point in time on the 64-bit uCAN timebase, in counts of UCAN_Timebase.frequency.
+  * @note   At 168 MHz it takes more than 3000 years to wrap, so times are
+  *         compared and subtracted directly.
+  */
+typedef uint64_t UCAN_Time;
+
+/**
+  * @brief  Free-running 32-bit counter read by the timebase, e.g. DWT->CYCCNT or a 1 MHz timer.
+  */
+typedef uint32_t (*UCAN_CounterSource)(void);
+
+/**
+  * @brief  Shared timebase of a uCAN handle.
+  * @note   read and frequency are set by the user before uCAN_Init(); with
+  *         read left NULL, HAL_GetTick() (1 kHz) is used. The counter is
+  *         extended to 64 bits lock-free: the epoch word holds the number of
+  *         wraps and the top counter bit of the last extension, and is
+  *         replaced with a single store. The timebase must be read at least
+  *         once per half counter period, which every uCAN_Update(),
+  *         uCAN_SendAll() and uCAN_Handshake() call does.
+  */
+typedef struct {
+    UCAN_CounterSource read;				/*!< Counter read function, NULL for HAL_GetTick() */
+    uint32_t frequency;						/*!< Counter frequency in Hz, a multiple of 1000 (ignored if read is NULL) */
+    uint32_t countsPerMs;					/*!< [INTERNAL] Counts per millisecond */
+    volatile uint32_t epoch;				/*!< [INTERNAL] Wrap count << 1 | top counter bit at the last extension */
+#if UCAN_CFG_FAULT
+    volatile int32_t driftPpm;				/*!< [INTERNAL] Injected clock drift in parts per million, 0 if none */
+    volatile UCAN_Time driftStart;			/*!< [INTERNAL] Undrifted time the current drift window started */
+    volatile int64_t driftOffset;			/*!< [INTERNAL] Drift accumulated by finished drift windows, in counts */
+#endif
+} UCAN_Timebase;
+
 /**
   * @brief  Connection status definitions for uCAN communication.
   * @note   Indicates the state of a node’s connection on the CAN bus.
@@ -83,6 +148,113 @@ typedef enum {
     UCAN_CONN_TIMEOUT   	= 0x03U			/*!< No response received within the expected timeframe */
 } UCAN_ConnectionStatusTypeDef;
 
+/**
+  * @brief  Running statistics of a single RX signal.
+  * @note   Bound to a signal through UCAN_Data.stats and updated incrementally
+  *         (Welford's algorithm) by the RX path every time the owning packet
+  *         is received. Only windowSize is set by the user, all other fields
+  *         are maintained by uCAN and must be read with uCAN_GetSignalStats().
+  */
+typedef struct UCAN_SignalStats {
+    uint32_t windowSize;					/*!< Samples per window, statistics restart once reached (0 = never) */
+    volatile uint32_t seq;					/*!< [INTERNAL] Update sequence counter, odd while the RX path is writing */
+    volatile uint8_t resetRequest;			/*!< [INTERNAL] Set by uCAN_ResetSignalStats(), applied on the next sample */
+    uint8_t offset;							/*!< [INTERNAL] Byte offset of the signal inside the CAN payload */
+    UCAN_DataType type;						/*!< [INTERNAL] Type of the observed signal */
+    uint32_t count;							/*!< [INTERNAL] Number of samples in the current window */
+    uint32_t min;							/*!< [INTERNAL] Smallest sample in the current window */
+    uint32_t max;							/*!< [INTERNAL] Largest sample in the current window */
+    float mean;								/*!< [INTERNAL] Running mean of the current window */
+    float m2;								/*!< [INTERNAL] Sum of squared deviations from the mean */
+    UCAN_Time firstTime;					/*!< [INTERNAL] Reception time of the first sample in the window */
+    UCAN_Time lastTime;						/*!< [INTERNAL] Reception time of the latest sample */
+    struct UCAN_SignalStats* next;			/*!< [INTERNAL] Next statistics block attached to the same packet */
+} UCAN_SignalStats;
+
+/**
+  * @brief  Consistent snapshot of a UCAN_SignalStats block.
+  * @note   Filled by uCAN_GetSignalStats().
+  */
+typedef struct {
+    uint32_t count;							/*!< Number of samples in the current window */
+    uint32_t min;							/*!< Smallest sample */
+    uint32_t max;							/*!< Largest sample */
+    float mean;								/*!< Mean of all samples */
+    float variance;							/*!< Sample variance (0 with fewer than two samples) */
+    float rateHz;							/*!< Average arrival rate in frames per second */
+} UCAN_SignalStatsResult;
+
+/**
+  * @brief  Conditions a UCAN_Trigger can watch for.
+  */
+typedef enum {
+    UCAN_TRIGGER_ABOVE     	= 0x00U,		/*!< Value rises above threshold, re-armed once it is back at threshold - hysteresis */
+    UCAN_TRIGGER_BELOW     	= 0x01U,		/*!< Value falls below threshold, re-armed once it is back at threshold + hysteresis */
+    UCAN_TRIGGER_DELTA     	= 0x02U,		/*!< Value moved by at least threshold (any change if 0) since the last event */
+    UCAN_TRIGGER_RISING    	= 0x03U,		/*!< Bit `bit` of the value changes from 0 to 1 */
+    UCAN_TRIGGER_FALLING   	= 0x04U			/*!< Bit `bit` of the value changes from 1 to 0 */
+} UCAN_TriggerCondition;
+
+/**
+  * @brief  Declarative condition on a single RX signal.
+  * @note   Bound to a signal through UCAN_Data.trigger and evaluated by the RX
+  *         path every time the owning packet is received, so a hit is seen
+  *         with the latency of the receive interrupt. Each hit is queued as a
+  *         UCAN_TriggerEvent in UCAN_HandleTypeDef.events. ABOVE and BELOW
+  *         fire on the first frame if it already meets the condition; DELTA,
+  *         RISING and FALLING compare against the previous frame. Only
+  *         condition, threshold, hysteresis and bit are set by the user.
+  */
+typedef struct UCAN_Trigger {
+    UCAN_TriggerCondition condition;		/*!< Condition to watch for */
+    uint32_t threshold;						/*!< Limit (ABOVE, BELOW) or smallest change (DELTA) */
+    uint32_t hysteresis;					/*!< ABOVE, BELOW: distance the value must move back before the trigger fires again */
+    uint8_t bit;							/*!< RISING, FALLING: bit number inside the signal */
+    volatile uint32_t hits;					/*!< Number of times the trigger fired since uCAN_Start() */
+    uint8_t offset;							/*!< [INTERNAL] Byte offset of the signal inside the CAN payload */
+    UCAN_DataType type;						/*!< [INTERNAL] Type of the watched signal */
+    uint8_t armed;							/*!< [INTERNAL] ABOVE, BELOW: non-zero while the trigger may fire */
+    uint8_t primed;							/*!< [INTERNAL] Non-zero once reference holds a received value */
+    uint32_t reference;						/*!< [INTERNAL] Previous value (edges) or value of the last event (DELTA) */
+    struct UCAN_EventQueue* queue;			/*!< [INTERNAL] Event queue of the owning handle */
+    struct UCAN_Trigger* next;				/*!< [INTERNAL] Next trigger attached to the same packet */
+} UCAN_Trigger;
+
+/**
+  * @brief  Trigger hit, as queued by the RX path and returned by uCAN_ReadEvents().
+  */
+typedef struct {
+    UCAN_Trigger* trigger;					/*!< Trigger that fired */
+    uint32_t id;							/*!< CAN identifier of the packet that carried the signal */
+    uint32_t value;							/*!< Signal value that fired the trigger */
+    UCAN_Time time;							/*!< Reception time on the handle timebase */
+} UCAN_TriggerEvent;
+
+/**
+  * @brief  Queue of trigger hits.
+  * @note   events and size are set by the user before uCAN_Start() and are
+  *         required as soon as a trigger is bound. Single-producer /
+  *         single-consumer ring like UCAN_Monitor: the RX path appends, the
+  *         application drains it with uCAN_ReadEvents().
+  */
+typedef struct UCAN_EventQueue {
+    UCAN_TriggerEvent* events;				/*!< User storage for the ring, NULL if no trigger is bound */
+    uint32_t size;							/*!< Number of entries in events, must be a power of two */
+    volatile uint32_t head;					/*!< [INTERNAL] Free-running write index, advanced by the RX path */
+    volatile uint32_t tail;					/*!< [INTERNAL] Free-running read index, advanced by the reader */
+    volatile uint32_t overruns;				/*!< Hits lost because the ring was full */
+} UCAN_EventQueue;
+
+/**
+  * @brief  Events reported to uCAN_TraceHook() when UCAN_CFG_TRACE is enabled.
+  */
+typedef enum {
+    UCAN_TRACE_RX          	= 0x00U,		/*!< Frame received, argument is the CAN ID */
+    UCAN_TRACE_TX          	= 0x01U,		/*!< Frame queued for transmission, argument is the CAN ID */
+    UCAN_TRACE_HANDSHAKE   	= 0x02U,		/*!< Handshake message processed, argument is the sender ID */
+    UCAN_TRACE_ERROR       	= 0x03U			/*!< Operation failed, argument is the UCAN_StatusTypeDef code */
+} UCAN_TraceEvent;
+
 /**
   * @brief  Structure to represent a generic data item in the CAN payload.
   * @note   Only supports unsigned integer types (uint8_t, uint16_t, uint32_t).
@@ -91,8 +263,90 @@ typedef enum {
 typedef struct {
     void* ptr;								/*!< Pointer to the data value (e.g., &some_u8_var) */
     UCAN_DataType type;						/*!< Type of the data (UCAN_U8, UCAN_U16, UCAN_U32) */
+    UCAN_SignalStats* stats;				/*!< Optional statistics block updated on reception (RX only, may be NULL) */
+    UCAN_Trigger* trigger;					/*!< Optional trigger evaluated on reception (RX only, may be NULL) */
 } UCAN_Data;
 
+/**
+  * @brief  Callback invoked from the RX path when a packet is received.
+  * @param  payload Pointer to the received bytes (valid only during the call).
+  * @param  dlc     Number of received payload bytes.
+  * @param  ts      Reception timestamp (in ms).
+  * @param  ctx     User context registered with the handler.
+  * @note   Runs in the context of uCAN_Update(), usually the CAN RX interrupt.
+  */
+typedef void (*UCAN_PacketHandler)(const uint8_t* payload, uint8_t dlc, uint32_t ts, void* ctx);
+
+#if UCAN_CFG_LATENCY
+/**
+  * @brief  Stages of the sample-to-use latency of a traced packet.
+  */
+typedef enum {
+    UCAN_LATENCY_PRODUCER = 0x00U,			/*!< Producer sample to frame queued in a TX mailbox */
+    UCAN_LATENCY_BUS,						/*!< Frame queued to frame received: mailbox wait, arbitration, transfer, RX interrupt entry */
+    UCAN_LATENCY_CONSUMER,					/*!< Frame received to value used by the consumer */
+    UCAN_LATENCY_TOTAL,						/*!< Producer sample to value used */
+    UCAN_LATENCY_STAGES						/*!< Number of stages */
+} UCAN_LatencyStage;
+
+/**
+  * @brief  Running minimum, maximum and sum of one latency stage, in microseconds.
+  */
+typedef struct {
+    uint32_t min;							/*!< [INTERNAL] Smallest latency */
+    uint32_t max;							/*!< [INTERNAL] Largest latency */
+    uint64_t sum;							/*!< [INTERNAL] Sum of all latencies */
+} UCAN_LatencySpan;
+
+/**
+  * @brief  Latency tracing state of one traced packet.
+  * @note   Bound to a TX or RX packet through UCAN_PacketConfig.latency and
+  *         cleared by uCAN_Start(). On a TX packet it numbers the frames and
+  *         holds the sample time marked with uCAN_LatencySample(). On an RX
+  *         packet it holds the stages of the last received frame (written by
+  *         the RX path, odd seq while writing) and the statistics of all
+  *         frames used so far (written by uCAN_LatencyUse()).
+  */
+typedef struct {
+    UCAN_Timebase* timebase;				/*!< [INTERNAL] Timebase of the owning handle, set by uCAN_Start() */
+    uint8_t txSeq;							/*!< [INTERNAL] Sequence number of the next frame (TX) */
+    volatile uint8_t sampled;				/*!< [INTERNAL] Non-zero if sampleTime holds a marked sample (TX) */
+    volatile UCAN_Time sampleTime;			/*!< [INTERNAL] Sample time marked by uCAN_LatencySample() (TX) */
+    uint8_t rxSeq;							/*!< [INTERNAL] Sequence number of the last received frame (RX) */
+    volatile uint32_t frames;				/*!< [INTERNAL] Traced frames received (RX) */
+    volatile uint32_t lost;					/*!< [INTERNAL] Frames missing from the received sequence (RX) */
+    volatile uint32_t seq;					/*!< [INTERNAL] Odd while the RX path records a frame, +2 per frame (RX) */
+    uint32_t producerUs;					/*!< [INTERNAL] Producer stage of the last received frame (RX) */
+    uint32_t busUs;							/*!< [INTERNAL] Bus stage of the last received frame (RX) */
+    UCAN_Time rxTime;						/*!< [INTERNAL] Reception time of the last received frame (RX) */
+    uint32_t usedSeq;						/*!< [INTERNAL] seq of the last frame used (RX) */
+    uint32_t count;							/*!< [INTERNAL] Frames used (RX) */
+    UCAN_LatencySpan spans[UCAN_LATENCY_STAGES];	/*!< [INTERNAL] Per-stage statistics of the used frames (RX) */
+    uint32_t histogram[UCAN_LATENCY_BUCKETS];		/*!< [INTERNAL] Distribution of the total latency (RX) */
+} UCAN_LatencyStats;
+
+/**
+  * @brief  Latency of one stage, in microseconds.
+  */
+typedef struct {
+    uint32_t minUs;							/*!< Smallest latency */
+    uint32_t maxUs;							/*!< Largest latency */
+    uint32_t meanUs;						/*!< Mean latency */
+} UCAN_LatencySpanResult;
+
+/**
+  * @brief  Snapshot of the latency statistics of a traced RX packet.
+  * @note   Filled by uCAN_GetLatency().
+  */
+typedef struct {
+    uint32_t count;							/*!< Frames used, i.e. samples in the statistics */
+    uint32_t frames;						/*!< Traced frames received */
+    uint32_t lost;							/*!< Frames missing from the producer's sequence */
+    UCAN_LatencySpanResult stage[UCAN_LATENCY_STAGES];	/*!< Statistics per UCAN_LatencyStage */
+    uint32_t histogram[UCAN_LATENCY_BUCKETS];			/*!< Distribution of the total latency, see UCAN_LATENCY_BUCKETS */
+} UCAN_LatencyResult;
+#endif
+
 /**
   * @brief  User-defined configuration for binding application variables to CAN messages.
   * @note   This structure is passed to uCAN_Start() to register signal mappings.
@@ -103,19 +357,154 @@ typedef struct {
     uint32_t id;                    		/*!< CAN identifier associated with the signal group */
     uint8_t item_count;             		/*!< Number of data items (max 8) */
     UCAN_Data items[8];             		/*!< Array of data pointers and their types from the application */
+    UCAN_PacketHandler handler;				/*!< Optional RX handler, may replace item binding (item_count = 0) */
+    void* context;							/*!< User context passed to the handler */
+    uint8_t critical;						/*!< TX only: non-zero puts the packet in the critical class that may use the reserved mailboxes */
+#if UCAN_CFG_OVERLAY
+    void* overlay;							/*!< Optional packed struct mapped 1:1 onto the payload, replaces the items (item_count = 0) */
+    uint8_t overlaySize;					/*!< Size of the overlay struct in bytes (1 to 8), becomes the DLC */
+    uint8_t overlayDouble;					/*!< Non-zero if overlay points to two structs used as front and back buffer */
+#endif
+#if UCAN_CFG_LATENCY
+    UCAN_LatencyStats* latency;				/*!< Optional latency tracing block, NULL if the packet is not traced */
+#endif
+#if UCAN_CFG_LAZY
+    uint8_t lazy;							/*!< RX only: non-zero keeps the raw frame on reception, the items are written by uCAN_Unpack() */
+#endif
+#if UCAN_CFG_REDUNDANT
+    uint8_t seqByte;						/*!< RX only: UCAN_SEQ_BYTE(n) if payload byte n holds a rolling counter for the duplicate filter, 0 if none */
+#endif
 } UCAN_PacketConfig;
 
+#if UCAN_CFG_LAZY
+/**
+  * @brief  Last raw frame of a lazily decoded RX packet.
+  * @note   The RX path stores the payload as two words and the reception time
+  *         while seq is odd, so a reception costs the same whatever the
+  *         number of signals. uCAN_Unpack() copies the slot out and retries
+  *         if a frame arrived meanwhile.
+  */
+typedef struct {
+    volatile uint32_t seq;					/*!< [INTERNAL] Odd while the slot is written, 0 if no frame yet */
+    uint32_t word[2];						/*!< [INTERNAL] Payload bytes 0 to 3 and 4 to 7 */
+    UCAN_Time time;							/*!< [INTERNAL] Reception time on the handle timebase */
+    uint32_t readSeq;						/*!< [INTERNAL] seq of the frame last unpacked */
+} UCAN_RawSlot;
+#endif
+
+#if UCAN_CFG_HW_TIMESTAMP
+/**
+  * @brief  Hardware timing of a packet, updated on every RX frame or TX confirmation.
+  * @note   Times are in CAN bit times on the extended 64-bit hardware timebase
+  *         (see UCAN_HwClock). Read through uCAN_GetPacketTiming().
+  */
+typedef struct {
+    volatile uint32_t seq;					/*!< [INTERNAL] Odd while the block is being written */
+    uint32_t count;							/*!< [INTERNAL] Number of events recorded */
+    uint64_t time;							/*!< [INTERNAL] Time of the last event */
+    uint32_t period;						/*!< [INTERNAL] Interval between the last two events */
+    uint32_t periodMin;						/*!< [INTERNAL] Smallest interval seen */
+    uint32_t periodMax;						/*!< [INTERNAL] Largest interval seen */
+} UCAN_PacketTiming;
+
+/**
+  * @brief  Snapshot of a packet's hardware timing, in microseconds.
+  */
+typedef struct {
+    uint32_t count;							/*!< Number of frames (RX) or confirmations (TX) recorded */
+    uint64_t timeUs;						/*!< Hardware time of the last event */
+    uint32_t periodUs;						/*!< Interval between the last two events */
+    uint32_t periodMinUs;					/*!< Smallest interval seen */
+    uint32_t periodMaxUs;					/*!< Largest interval seen */
+    uint32_t jitterUs;						/*!< Peak-to-peak period jitter (periodMaxUs - periodMinUs) */
+} UCAN_PacketTimingResult;
+#endif
+
 /**
   * @brief  Internal representation of a raw CAN packet.
   * @note   Used by the uCAN core to construct and transmit actual CAN frames.
   *         Each byte in the payload is mapped to an external variable via pointers.
   */
-typedef struct {
+typedef struct UCAN_Packet {
     uint32_t id;             				/*!< CAN identifier to be used for transmission */
     uint8_t dlc;              				/*!< Data length code (number of payload bytes: 0 to 8) */
     uint8_t* bits[8];         				/*!< Pointers to individual bytes forming the payload */
+#if UCAN_CFG_STATS
+    UCAN_SignalStats* stats;				/*!< List of statistics blocks bound to signals of this packet */
+#endif
+#if UCAN_CFG_TRIGGER
+    UCAN_Trigger* triggers;					/*!< List of triggers bound to signals of this packet */
+#endif
+    struct UCAN_SignalGroup* group;			/*!< Signal group this RX packet belongs to, NULL if ungrouped */
+    uint8_t groupIndex;						/*!< Position of this packet inside its signal group */
+    UCAN_PacketHandler handler;				/*!< RX handler invoked with the raw payload, NULL if none */
+    void* context;							/*!< User context passed to the handler */
+    uint8_t latched[8];						/*!< TX staging copy of the payload captured by the latch step */
+    uint8_t critical;						/*!< Non-zero if the packet may use the reserved TX mailboxes */
+#if UCAN_CFG_OVERLAY
+    uint8_t* overlay;						/*!< Bound overlay struct (pair of structs if double-buffered), NULL for per-byte binding */
+    uint8_t overlayDouble;					/*!< Non-zero if the overlay is double-buffered */
+    volatile uint32_t overlaySeq;			/*!< [INTERNAL] Odd while a buffer is written, (overlaySeq >> 1) & 1 selects the front buffer */
+#endif
+#if UCAN_CFG_LATENCY
+    UCAN_LatencyStats* latency;				/*!< Latency tracing block, the frame carries a trailer after dlc bytes, NULL if not traced */
+#endif
+#if UCAN_CFG_LAZY
+    uint8_t lazy;							/*!< Non-zero if received frames go to raw instead of the bound bytes */
+    UCAN_RawSlot raw;						/*!< [INTERNAL] Last received frame of a lazy packet */
+#endif
+#if UCAN_CFG_EXPORT
+    UCAN_ExportSlot* exportSlot;			/*!< [INTERNAL] Slot of the packet in the export region, NULL if not exported */
+#endif
+#if UCAN_CFG_SCHEDULE
+    uint8_t scheduled;						/*!< [INTERNAL] Non-zero if sent by the schedule instead of uCAN_SendAll() */
+#endif
+#if UCAN_CFG_REDUNDANT
+    uint8_t seqByte;						/*!< [INTERNAL] UCAN_SEQ_BYTE() of the rolling counter checked by the duplicate filter, 0 to compare payloads */
+#endif
+#if UCAN_CFG_HW_TIMESTAMP
+    UCAN_PacketTiming timing;				/*!< Hardware timestamps of RX frames or TX confirmations */
+#endif
 } UCAN_Packet;
 
+/**
+  * @brief  Set of RX packets published to the application as one consistent unit.
+  * @note   Frames of grouped packets are not written to the bound variables
+  *         on reception. They are assembled into the back buffer instead and
+  *         the buffers are swapped once every member frame has arrived (with
+  *         the same sequence counter, if one is configured). The application
+  *         copies the latest complete set into its variables with
+  *         uCAN_ReadGroup(). Only ids, memberCount and seqByte are set by the
+  *         user, all other fields are maintained by uCAN.
+  */
+typedef struct UCAN_SignalGroup {
+    uint32_t ids[UCAN_GROUP_MAX_MEMBERS];	/*!< CAN identifiers of the member RX packets */
+    uint8_t memberCount;					/*!< Number of member packets (1 to UCAN_GROUP_MAX_MEMBERS) */
+    uint8_t seqByte;						/*!< Payload byte holding the sequence counter, UCAN_GROUP_NO_SEQUENCE if none */
+    UCAN_Packet* packets[UCAN_GROUP_MAX_MEMBERS];	/*!< [INTERNAL] Resolved member packets */
+    uint8_t frames[2][UCAN_GROUP_MAX_MEMBERS][8];	/*!< [INTERNAL] Front and back payload buffers */
+    uint8_t pendingMask;					/*!< [INTERNAL] Members received for the set being assembled */
+    uint8_t pendingSeq;						/*!< [INTERNAL] Sequence counter of the set being assembled */
+    volatile uint8_t front;					/*!< [INTERNAL] Index of the buffer holding the last complete set */
+    volatile uint32_t commitSeq;			/*!< [INTERNAL] Number of sets published so far */
+    uint32_t readSeq;						/*!< [INTERNAL] Last set copied out by uCAN_ReadGroup() */
+} UCAN_SignalGroup;
+
+#if UCAN_CFG_RX_INDEX
+/**
+  * @brief  Direct lookup of RX packets by standard identifier.
+  * @note   bits has one bit per standard ID, set for every RX packet. Since the
+  *         RX packets are sorted by ID, the index of a packet is the number of
+  *         set bits below its own: rank[] holds that count for the start of
+  *         every word, the rest is the population count of the masked word.
+  *         Built by uCAN_Start(), 384 bytes in total.
+  */
+typedef struct {
+    uint32_t bits[UCAN_STD_ID_COUNT / 32U];	/*!< [INTERNAL] Bit id set if id is an RX packet */
+    uint16_t rank[UCAN_STD_ID_COUNT / 32U];	/*!< [INTERNAL] RX packets with an ID below the first ID of each word */
+} UCAN_IdIndex;
+#endif
+
 /**
   * @brief  Container structure for managing multiple CAN packets.
   * @note   Holds the number of active packets and a pointer to an array of UCAN_Packet.
@@ -124,16 +513,63 @@ typedef struct {
 typedef struct {
     uint32_t count;          				/*!< Number of CAN packets stored in the holder */
     UCAN_Packet* packets;    				/*!< Pointer to an array of UCAN_Packet structures */
+    uint32_t latchTick;						/*!< Timestamp (in ms) at which the TX set was last latched */
+    uint32_t pending;						/*!< [INTERNAL] Next packet of a uCAN_SendAll() round interrupted by full mailboxes, 0 if none */
+#if UCAN_CFG_RX_INDEX
+    UCAN_IdIndex* index;					/*!< [INTERNAL] Direct ID lookup, NULL if packets are found by binary search */
+#endif
+#if UCAN_CFG_LATENCY
+    UCAN_Time latchTime;					/*!< [INTERNAL] Latch instant on the handle timebase, sample time of traced TX packets */
+#endif
 } UCAN_PacketHolder;
 
+/**
+  * @brief  Health record piggybacked by a client on its handshake response.
+  * @note   Decoded by the master from every 8-byte pong, see UCAN_PONG_xxx
+  *         in ucan_macros.h for the wire layout.
+  */
+typedef struct {
+    uint8_t valid;							/*!< Non-zero once a diagnostic pong has been received */
+    uint8_t cpuLoad;						/*!< CPU load of the client in percent */
+    uint8_t tec;							/*!< CAN transmit error counter of the client */
+    uint8_t rec;							/*!< CAN receive error counter of the client */
+    uint8_t droppedFrames;					/*!< Frames dropped by the client (saturates at 255) */
+    uint8_t configHash;						/*!< Hash of the client's packet configuration */
+    uint16_t uptime;						/*!< Client uptime in seconds (saturates at 65535) */
+#if UCAN_CFG_HW_TIMESTAMP
+    uint32_t rttUs;							/*!< Handshake round trip (ping sent to response received), 0 if unknown */
+#endif
+} UCAN_ClientDiag;
+
+/**
+  * @brief  Capabilities of a peer, negotiated in the handshake.
+  * @note   Recorded by the master for every client and by a client for its
+  *         master. common is the set both nodes support and the basis for
+  *         choosing how to talk to that peer, see UCAN_CAP_xxx.
+  */
+typedef struct {
+    uint8_t valid;							/*!< Non-zero once the capabilities of the peer are known */
+    uint8_t version;						/*!< Protocol version of the peer, 0 if it predates capability negotiation */
+    uint16_t caps;							/*!< UCAN_CAP_xxx bits advertised by the peer */
+    uint16_t common;						/*!< Bits advertised by both this node and the peer */
+    uint8_t misses;							/*!< [INTERNAL] Plain responses to capability requests in a row */
+} UCAN_PeerCaps;
+
 /**
   * @brief  Represents a single client node in the CAN network.
   * @note   Stores the unique ID, last response time, and current connection status of the client.
   */
 typedef struct {
     uint32_t id;                		 	/*!< Unique identifier for a specific client node */
-    uint32_t responseTick;      		 	/*!< Timestamp (in ms) of the last received response from the client */
+    volatile UCAN_Time responseTime;		/*!< Time of the last received response, valid if UCAN_CLIENT_FLAG_RESPONDED is set */
+    volatile uint8_t flags;					/*!< UCAN_CLIENT_FLAG_xxx validity flags */
     UCAN_ConnectionStatusTypeDef status;	/*!< Current connection status of the client node */
+    UCAN_ClientDiag diag;					/*!< Latest health data reported by the client (master only) */
+    volatile uint32_t diagSeq;				/*!< [INTERNAL] Odd while diag or rtt is being written */
+    UCAN_PeerCaps caps;						/*!< Capabilities reported by the client (master only) */
+#if UCAN_CFG_HW_TIMESTAMP
+    uint32_t rtt;							/*!< [INTERNAL] Last handshake round trip in CAN bit times */
+#endif
 } UCAN_Client;
 
 /**
@@ -144,13 +580,262 @@ typedef struct {
     UCAN_NodeRole role;						/*!< Role of this node on the CAN bus (Master, Client, None) */
     uint32_t selfId;						/*!< CAN identifier assigned to this node */
     uint32_t masterId;						/*!< CAN identifier of the master node */
-    uint32_t sentTick;						/*!< Timestamp (in ms) of the last message sent by this node */
+    UCAN_Time sentTime;						/*!< Time of the last ping sent (master) or received (client), valid if UCAN_NODE_TIME_SENT is set */
+    uint8_t timeFlags;						/*!< UCAN_NODE_TIME_xxx validity flags */
+    UCAN_Timebase* timebase;				/*!< [INTERNAL] Timebase of the owning handle, set by uCAN_Init() */
     UCAN_Client* clients;					/*!< Pointer to array of known clients in the network */
     uint32_t clientCount;					/*!< Number of clients in the clientIdList array */
+    uint8_t cpuLoad;						/*!< CPU load in percent, set by the application and reported in pongs */
+    uint8_t appCaps;						/*!< Application capability bits, advertised as UCAN_CAP_APP(0..7) */
+#if UCAN_CFG_HAS_CLIENT
+    UCAN_PeerCaps masterCaps;				/*!< Capabilities announced by the master in its pings (client only) */
+#endif
+#if UCAN_CFG_HAS_MASTER
+    UCAN_Client* capsRequested;				/*!< [INTERNAL] Client the last ping asked for its capabilities, NULL if none */
+#endif
+    uint8_t configHash;						/*!< Hash of the packet configuration, computed by uCAN_Start() */
+    uint32_t droppedFrames;					/*!< Frames lost to RX FIFO overruns or failed transfers */
+    UCAN_Time announceTime;					/*!< Time at which the boot announcement is due */
+    uint8_t announcePending;				/*!< Non-zero until the boot announcement has been sent */
+#if UCAN_CFG_HAS_CLIENT
+    uint8_t replyPending;					/*!< [INTERNAL] First byte of a ping reply that found no free mailbox, 0 if none */
+#endif
+#if UCAN_CFG_HAS_MEMBERSHIP
+    uint32_t membership[UCAN_MEMBERSHIP_WORDS];	/*!< Bitmap of ACTIVE clients, bit i = clients[i] (sorted by ID) */
+    UCAN_Time membershipTime;				/*!< Time of the last membership broadcast sent (master) or applied (client) */
+    uint8_t clientsHash;					/*!< Hash of the sorted client list, computed by uCAN_Init() and carried in membership broadcasts */
+#endif
+#if UCAN_CFG_HW_TIMESTAMP && UCAN_CFG_HAS_MASTER
+    uint64_t pingTime;						/*!< [INTERNAL] Hardware time at which the last ping left the controller, valid if UCAN_NODE_TIME_PING_HW is set */
+#endif
 } UCAN_NodeInfo;
 
 
 
+#if UCAN_CFG_MONITOR
+/**
+  * @brief  Listen-only bus monitor state.
+  * @note   frames and size are set by the user before uCAN_Start(). A non-NULL
+  *         frames pointer switches the node into monitor mode: the controller
+  *         is put in silent mode, every frame on the bus is accepted and each
+  *         one is copied into this single-producer / single-consumer ring.
+  */
+typedef struct {
+    UCAN_MonitorFrame* frames;				/*!< User storage for the ring, NULL disables the monitor */
+    uint32_t size;							/*!< Number of entries in frames, must be a power of two */
+    volatile uint32_t head;					/*!< [INTERNAL] Free-running write index, advanced by uCAN_Update() */
+    volatile uint32_t tail;					/*!< [INTERNAL] Free-running read index, advanced by the reader */
+    volatile uint32_t overruns;				/*!< Frames lost because the ring was full */
+} UCAN_Monitor;
+#endif
+
+#if UCAN_CFG_EXPORT
+/**
+  * @brief  Shared-memory export region.
+  * @note   region and size are set by the user before uCAN_Start(), which
+  *         writes the layout of all RX packets into the region. From then on
+  *         every received frame is copied into its slot, see ucan_export.h.
+  */
+typedef struct {
+    void* region;							/*!< User memory of UCAN_EXPORT_REGION_SIZE(RX packets) bytes, 8-byte aligned, NULL disables the export */
+    uint32_t size;							/*!< Size of region in bytes */
+} UCAN_Export;
+#endif
+
+#if UCAN_CFG_HW_TIMESTAMP
+/**
+  * @brief  Extension of the 16-bit TTCM counter of the controller to 64 bits.
+  * @note   The counter advances once per CAN bit time and wraps every 65536
+  *         bits (65.5 ms at 1 Mbit/s). Each event is placed on the 64-bit
+  *         timebase by predicting the counter from the elapsed timebase
+  *         milliseconds and taking the nearest value with the hardware low
+  *         bits, so arbitrarily long gaps between events are handled.
+  */
+typedef struct {
+    uint64_t last;							/*!< [INTERNAL] Extended time of the last event, in bit times */
+    uint32_t lastTick;						/*!< [INTERNAL] HAL tick (ms) at which the last event was extended */
+    uint32_t bitRate;						/*!< [INTERNAL] CAN bit rate in bit/s, derived from BTR and PCLK1 */
+    uint32_t nsPerBit;						/*!< [INTERNAL] Duration of one bit time in nanoseconds */
+} UCAN_HwClock;
+#endif
+
+#if UCAN_CFG_SCHEDULE
+/**
+  * @brief  Free-running microsecond time source, e.g. a 32-bit timer clocked at 1 MHz.
+  */
+typedef uint32_t (*UCAN_TimeSource)(void);
+
+/**
+  * @brief  One transmit window of the time-triggered schedule.
+  * @note   id, offsetUs, repeat and cycleOffset are set by the user; the
+  *         remaining fields are filled by uCAN_Start() and the schedule runtime.
+  */
+typedef struct {
+    uint32_t id;							/*!< TX packet sent in this window */
+    uint32_t offsetUs;						/*!< Window start relative to the reference message */
+    uint8_t repeat;							/*!< Window is used every repeat-th basic cycle (1, 2, 4 ... UCAN_SCHEDULE_MAX_REPEAT) */
+    uint8_t cycleOffset;					/*!< Basic cycle, modulo repeat, in which the window is used */
+    UCAN_Packet* packet;					/*!< [INTERNAL] Resolved TX packet */
+    uint32_t lengthUs;						/*!< [INTERNAL] Worst-case duration of the packet's frame */
+    uint32_t lastLateUs;					/*!< Delay between window start and the last send */
+    uint32_t maxLateUs;						/*!< Largest send delay seen (schedule jitter) */
+    uint32_t missed;						/*!< Windows skipped because the tick came after the window closed */
+} UCAN_ScheduleWindow;
+
+/**
+  * @brief  TTCAN-like time-triggered transmit schedule.
+  * @note   The time master sends the reference message at the start of every
+  *         basic cycle; every node sends its TX packets only inside its own
+  *         windows relative to that message. referenceId, cycleUs, timeMaster,
+  *         nowUs, windows and windowCount are set by the user before uCAN_Start().
+  */
+typedef struct {
+    uint32_t referenceId;					/*!< CAN identifier of the reference message */
+    uint32_t cycleUs;						/*!< Length of the basic cycle */
+    uint8_t timeMaster;						/*!< Non-zero if this node sends the reference message */
+    UCAN_TimeSource nowUs;					/*!< Microsecond time source shared with the timer that calls uCAN_ScheduleTick(), NULL for the handle's timebase */
+    UCAN_ScheduleWindow* windows;			/*!< Transmit windows of this node */
+    uint32_t windowCount;					/*!< Number of windows */
+    uint32_t refLengthUs;					/*!< [INTERNAL] Worst-case duration of the reference message */
+    UCAN_Timebase* timebase;				/*!< [INTERNAL] Handle timebase, used when nowUs is NULL */
+    volatile uint32_t syncSeq;				/*!< [INTERNAL] Odd while a reference is being recorded */
+    volatile uint32_t cycleStartUs;			/*!< [INTERNAL] Time source value at the start of the current cycle */
+    volatile uint8_t cycleCount;			/*!< [INTERNAL] Basic cycle counter carried by the reference message */
+    uint32_t seenSeq;						/*!< [INTERNAL] syncSeq of the cycle the windows are walked for */
+    uint32_t nextWindow;					/*!< [INTERNAL] Next window to fire in the current cycle */
+    uint32_t cycles;						/*!< Basic cycles started (master) or references received (client) */
+} UCAN_Schedule;
+#endif
+
+#if UCAN_CFG_FAULT
+/**
+  * @brief  Kind of fault injected by a UCAN_FaultStep.
+  */
+typedef enum {
+    UCAN_FAULT_DROP_RX     	= 0x00U,		/*!< Received frames are discarded before uCAN sees them */
+    UCAN_FAULT_DROP_TX     	= 0x01U,		/*!< Frames are reported as sent but never queued */
+    UCAN_FAULT_CORRUPT_RX  	= 0x02U,		/*!< Received payload byte (param >> 8) is XORed with (param & 0xFF), 0xFF if zero */
+    UCAN_FAULT_BABBLE      	= 0x03U,		/*!< Each uCAN_FaultPoll() fills free mailboxes with up to param (at least 1) frames of id, 0x000 for UCAN_FAULT_ANY_ID */
+    UCAN_FAULT_BUS_OFF     	= 0x04U,		/*!< Bus behaves as bus-off: nothing is queued, nothing is received */
+    UCAN_FAULT_CLOCK_DRIFT 	= 0x05U			/*!< Handle timebase runs (int32_t)param ppm fast (positive) or slow (negative) */
+} UCAN_FaultKind;
+
+/**
+  * @brief  One timed step of a fault scenario.
+  * @note   The step is active from startMs to startMs + durationMs after
+  *         uCAN_FaultStart(). DROP_RX, DROP_TX and CORRUPT_RX hit the frames
+  *         with a matching id on the buses in busMask, and of those only
+  *         every `every`-th one. BUS_OFF and BABBLE use busMask, CLOCK_DRIFT
+  *         neither. Steps may overlap.
+  */
+typedef struct {
+    UCAN_FaultKind kind;					/*!< Fault to inject */
+    uint32_t startMs;						/*!< Start of the window, relative to uCAN_FaultStart() */
+    uint32_t durationMs;					/*!< Length of the window */
+    uint8_t busMask;						/*!< Bit n selects bus[n], 0 for all buses */
+    uint32_t id;							/*!< CAN identifier the step applies to, UCAN_FAULT_ANY_ID for all */
+    uint32_t every;							/*!< Hit every n-th matching frame, 0 or 1 for every frame */
+    uint32_t param;							/*!< Kind specific parameter, see UCAN_FaultKind */
+    volatile uint32_t seen;					/*!< [INTERNAL] Matching frames seen in the window */
+    volatile uint32_t hits;					/*!< Frames this step dropped, corrupted or babbled, 0 for BUS_OFF and CLOCK_DRIFT */
+} UCAN_FaultStep;
+
+/**
+  * @brief  Detection and recovery figures of one health monitor.
+  * @note   A fault episode opens when the first step becomes active and
+  *         closes once no step is active and the monitor reports healthy
+  *         again. Detection time runs from the start of the episode to the
+  *         first unhealthy report, recovery time from the end of the last
+  *         window to the first healthy report after it.
+  */
+typedef struct {
+    uint32_t episodes;						/*!< Fault episodes seen */
+    uint32_t detected;						/*!< Episodes the monitor reported as unhealthy */
+    uint32_t recovered;						/*!< Detected episodes the monitor recovered from */
+    uint32_t lastDetectUs;					/*!< Detection time of the last detected episode */
+    uint32_t worstDetectUs;					/*!< Longest detection time */
+    uint32_t lastRecoverUs;					/*!< Recovery time of the last recovered episode */
+    uint32_t worstRecoverUs;				/*!< Longest recovery time */
+    uint8_t state;							/*!< [INTERNAL] UCAN_FAULT_STATE_xxx of the current episode */
+    UCAN_Time faultTime;					/*!< [INTERNAL] Start of the current episode */
+    UCAN_Time clearTime;					/*!< [INTERNAL] End of the last fault window of the current episode */
+} UCAN_FaultMetric;
+
+/**
+  * @brief  Scripted fault scenario and its results.
+  * @note   Set up by the user and handed to uCAN_FaultStart(). The injection
+  *         hooks sit where uCAN calls the HAL, so the same scenario runs on
+  *         target and on a host build against a stub HAL. Step windows and
+  *         monitors are evaluated by uCAN_FaultPoll(), which sets the
+  *         resolution of the measured times.
+  */
+typedef struct {
+    UCAN_FaultStep* steps;					/*!< Scenario steps */
+    uint32_t stepCount;						/*!< Number of steps, at most UCAN_FAULT_MAX_STEPS */
+    volatile uint32_t injected;				/*!< Frames dropped, corrupted or babbled by all steps */
+    UCAN_FaultMetric connection;			/*!< Handshake monitor: all clients active (master) or pinged in time (client) */
+    UCAN_FaultMetric bus;					/*!< Bus monitor: every wired bus reported as UCAN_BUS_OK */
+    volatile uint32_t active;				/*!< [INTERNAL] Bit n set while steps[n] is in its window */
+    UCAN_Time startTime;					/*!< [INTERNAL] Time of uCAN_FaultStart() */
+} UCAN_FaultPlan;
+#endif
+
+/**
+  * @brief  Health of one bus, as judged from its controller and its traffic.
+  */
+typedef enum {
+    UCAN_BUS_OK = 0x00U,					/*!< Bus works normally */
+    UCAN_BUS_DEGRADED,						/*!< Controller error passive, or bus silent while the other bus carries traffic */
+    UCAN_BUS_FAILED							/*!< Controller bus-off, frames are no longer queued on this bus */
+} UCAN_BusStatusTypeDef;
+
+/**
+  * @brief  One controller driven by a handle and its traffic counters.
+  * @note   bus[0] is the controller in UCAN_HandleTypeDef.hcan, bus[1] the
+  *         redundant one. Set up by uCAN_Init(), read with uCAN_GetBusHealth().
+  */
+typedef struct {
+    CAN_HandleTypeDef* hcan;				/*!< [INTERNAL] Controller of this bus, NULL if not wired */
+    volatile UCAN_Time lastRxTime;			/*!< [INTERNAL] Time of the last received frame, valid if UCAN_BUS_FLAG_RX is set */
+    volatile uint8_t flags;					/*!< [INTERNAL] UCAN_BUS_FLAG_xxx validity flags */
+    volatile uint32_t rxFrames;				/*!< [INTERNAL] Frames received on this bus */
+    volatile uint32_t rxDuplicates;			/*!< [INTERNAL] Received frames discarded as copies of a frame taken from the other bus */
+    volatile uint32_t txFrames;				/*!< [INTERNAL] Frames queued on this bus */
+    volatile uint32_t txSkipped;			/*!< [INTERNAL] Frames sent on the other bus only, because this one was bus-off or full */
+#if UCAN_CFG_FAULT
+    UCAN_FaultPlan* fault;					/*!< [INTERNAL] Running fault scenario, NULL if none */
+#endif
+} UCAN_Bus;
+
+/**
+  * @brief  Snapshot of the health of one bus, filled by uCAN_GetBusHealth().
+  */
+typedef struct {
+    UCAN_BusStatusTypeDef status;			/*!< Health of the bus */
+    uint8_t tec;							/*!< Transmit error counter of the controller */
+    uint8_t rec;							/*!< Receive error counter of the controller */
+    uint32_t silentMs;						/*!< Time since the last received frame, 0xFFFFFFFF if none yet */
+    uint32_t rxFrames;						/*!< Frames received on this bus */
+    uint32_t rxDuplicates;					/*!< Frames discarded because the other bus delivered them first */
+    uint32_t txFrames;						/*!< Frames queued on this bus */
+    uint32_t txSkipped;						/*!< Frames that went out on the other bus only */
+} UCAN_BusHealth;
+
+#if UCAN_CFG_REDUNDANT
+/**
+  * @brief  Slot of the duplicate filter of a redundant pair.
+  * @note   Holds the last frame accepted for an identifier hash, so the later
+  *         copy of the same frame arriving on the other bus can be recognized.
+  */
+typedef struct {
+    uint32_t key;							/*!< [INTERNAL] Identifier, with UCAN_DEDUP_KEY_EXT set for extended frames */
+    UCAN_Time time;							/*!< [INTERNAL] Time the frame was accepted */
+    uint8_t bus;							/*!< [INTERNAL] Bus the frame was accepted from, UCAN_DEDUP_EMPTY if the slot is unused */
+    uint8_t dlc;							/*!< [INTERNAL] Data length code of the frame */
+    uint8_t data[8];						/*!< [INTERNAL] Payload of the frame */
+} UCAN_DedupEntry;
+#endif
+
 /**
   * @brief  Configuration structure for uCAN module transmit and receive packets.
   * @note   Holds pointers to user-defined arrays of transmit and receive packet configurations.
@@ -168,9 +853,39 @@ typedef struct {
 typedef struct {
     CAN_HandleTypeDef* hcan;				/*!< Pointer to the STM32 HAL CAN handle */
     CAN_FilterTypeDef filter;				/*!< CAN filter configuration used for message filtering */
+#if UCAN_CFG_REDUNDANT
+    CAN_HandleTypeDef* hcanRedundant;		/*!< Optional second controller wired to a redundant bus, NULL for single-bus operation */
+    CAN_FilterTypeDef filterRedundant;		/*!< Filter of the redundant controller, on its own filter banks */
+    UCAN_DedupEntry dedup[UCAN_DEDUP_SIZE];	/*!< [INTERNAL] Duplicate filter of the redundant pair */
+#endif
+    UCAN_Bus bus[UCAN_BUS_COUNT];			/*!< [INTERNAL] Controllers frames are sent to and received from */
     UCAN_NodeInfo node;						/*!< Information about this node and its clients */
     UCAN_PacketHolder txHolder;    			/*!< Container for transmit CAN packets */
     UCAN_PacketHolder rxHolder;				/*!< Container for receive CAN packets */
+#if UCAN_CFG_RX_INDEX
+    UCAN_IdIndex rxIndex;					/*!< [INTERNAL] Direct ID lookup of the RX packets */
+#endif
+    UCAN_SignalGroup* groups;				/*!< Optional array of multi-packet signal groups */
+    uint32_t groupCount;					/*!< Number of signal groups in the groups array */
+    UCAN_Timebase timebase;					/*!< Timebase shared by handshakes, deadlines, statistics and the schedule */
+#if UCAN_CFG_TRIGGER
+    UCAN_EventQueue events;					/*!< Queue of trigger hits, see UCAN_Trigger */
+#endif
+#if UCAN_CFG_MONITOR
+    UCAN_Monitor monitor;					/*!< Optional listen-only capture ring, see UCAN_Monitor */
+#endif
+#if UCAN_CFG_EXPORT
+    UCAN_Export exports;					/*!< Optional shared-memory export of received frames, see UCAN_Export */
+#endif
+#if UCAN_CFG_SCHEDULE
+    UCAN_Schedule* schedule;				/*!< Optional time-triggered transmit schedule, NULL for event-driven sending */
+#endif
+#if UCAN_CFG_FAULT
+    UCAN_FaultPlan* fault;					/*!< [INTERNAL] Running fault scenario, set by uCAN_FaultStart() */
+#endif
+#if UCAN_CFG_HW_TIMESTAMP
+    UCAN_HwClock clock;						/*!< [INTERNAL] Extended hardware timebase */
+#endif
     UCAN_StatusTypeDef status;				/*!< Current status of the uCAN module */
 } UCAN_HandleTypeDef;
 
@@ -50,6 +50,8 @@
   *         assigned to FIFO 0, and is enabled by default.
   *         All filter ID and mask fields are zero, so it
   *         accepts all CAN messages (no filtering).
+  *         On devices with two controllers, the filter banks from
+  *         UCAN_REDUNDANT_FILTER_BANK on belong to the second one.
   */
 static const CAN_FilterTypeDef defaultFilterConfig = {
     .FilterMode = CAN_FILTERMODE_IDMASK,
@@ -59,17 +61,186 @@ static const CAN_FilterTypeDef defaultFilterConfig = {
     .FilterMaskIdHigh = 0x0000,
     .FilterMaskIdLow = 0x0000,
     .FilterScale = CAN_FILTERSCALE_32BIT,
-    .FilterActivation = CAN_FILTER_ENABLE
+    .FilterActivation = CAN_FILTER_ENABLE,
+    .SlaveStartFilterBank = UCAN_REDUNDANT_FILTER_BANK
 };
 
+#if UCAN_CFG_HAL_CALLBACKS
+/**
+  * @brief  Handle driving each CAN controller, indexed by uCAN_InstanceIndex().
+  *
+  * @note   Written by uCAN_Start() before the interrupts of the controller are
+  *         enabled, read by the HAL callbacks. One entry per controller, so a
+  *         callback finds its handle without searching. An entry is never
+  *         handed to a second handle, see uCAN_RegisterController().
+  */
+static UCAN_HandleTypeDef* uCAN_Registry[UCAN_CAN_INSTANCES];
+
+/**
+  * @brief  Map a CAN controller to its registry slot.
+  * @param  instance CAN controller registers (CAN1, CAN2 or CAN3).
+  * @retval uint32_t Registry slot of the controller.
+  */
+static uint32_t uCAN_InstanceIndex(const CAN_TypeDef* instance)
+{
+#if defined(CAN3)
+    if (instance == CAN3)
+    {
+        return 2U;
+    }
+#endif
+#if defined(CAN2)
+    if (instance == CAN2)
+    {
+        return 1U;
+    }
+#endif
+    (void)instance;
+    return 0U;
+}
+
+/**
+  * @brief  Find the handle driving a HAL CAN handle.
+  * @param  hcan HAL CAN handle passed to a callback.
+  * @retval UCAN_HandleTypeDef* Registered handle, NULL if the controller is not driven by uCAN.
+  */
+static UCAN_HandleTypeDef* uCAN_Lookup(const CAN_HandleTypeDef* hcan)
+{
+    UCAN_HandleTypeDef* ucan = uCAN_Registry[uCAN_InstanceIndex(hcan->Instance)];
+
+    if (ucan == NULL)
+    {
+        return NULL;
+    }
+
+#if UCAN_CFG_REDUNDANT
+    if (ucan->hcanRedundant == hcan)
+    {
+        return ucan;
+    }
+#endif
+
+    return (ucan->hcan == hcan) ? ucan : NULL;
+}
+
+/**
+  * @brief  RX FIFO 0 message pending: receive through the owning handle.
+  * @param  hcan HAL CAN handle of the controller.
+  */
+static void uCAN_HalRxFifo0Callback(CAN_HandleTypeDef* hcan)
+{
+    UCAN_HandleTypeDef* ucan = uCAN_Lookup(hcan);
+
+    if (ucan != NULL)
+    {
+        (void)uCAN_Update(ucan);
+    }
+}
+
+#if UCAN_CFG_HW_TIMESTAMP
+/**
+  * @brief  TX mailbox complete: record the confirmation of the primary controller.
+  * @param  hcan    HAL CAN handle of the controller.
+  * @param  mailbox Completed mailbox (CAN_TX_MAILBOXx).
+  */
+static void uCAN_HalTxCallback(CAN_HandleTypeDef* hcan, uint32_t mailbox)
+{
+    UCAN_HandleTypeDef* ucan = uCAN_Lookup(hcan);
+
+    // Hardware times come from the primary controller only
+    if (ucan != NULL && ucan->hcan == hcan)
+    {
+        (void)uCAN_TxComplete(ucan, mailbox);
+    }
+}
+
+static void uCAN_HalTxMailbox0Callback(CAN_HandleTypeDef* hcan) { uCAN_HalTxCallback(hcan, CAN_TX_MAILBOX0); }
+static void uCAN_HalTxMailbox1Callback(CAN_HandleTypeDef* hcan) { uCAN_HalTxCallback(hcan, CAN_TX_MAILBOX1); }
+static void uCAN_HalTxMailbox2Callback(CAN_HandleTypeDef* hcan) { uCAN_HalTxCallback(hcan, CAN_TX_MAILBOX2); }
+#endif
+
+/**
+  * @brief  Error reported by the HAL: account for lost frames and clear the error.
+  * @param  hcan HAL CAN handle of the controller.
+  *
+  * @note   With the overrun interrupt enabled, the HAL clears the overrun flag
+  *         before uCAN_Update() can see it, so the loss is counted here.
+  */
+static void uCAN_HalErrorCallback(CAN_HandleTypeDef* hcan)
+{
+    UCAN_HandleTypeDef* ucan = uCAN_Lookup(hcan);
+
+    if (ucan == NULL)
+    {
+        return;
+    }
+
+    if (HAL_CAN_GetError(hcan) & CAN_ERROR_RX_FOV0)
+    {
+        ucan->node.droppedFrames++;
+    }
+
+    UCAN_TRACE(UCAN_TRACE_ERROR, UCAN_ERROR);
+    HAL_CAN_ResetError(hcan);
+}
+
+/**
+  * @brief  Enter a controller into the registry and route its HAL callbacks to uCAN.
+  * @param  ucan    Handle driving the controller.
+  * @param  hcan    HAL CAN handle of the controller.
+  * @param  primary Non-zero for the primary controller (TX confirmations).
+  * @retval UCAN_StatusTypeDef UCAN_OK, UCAN_ERROR_DUPLICATE_ID if another handle already
+  *         drives the controller, or UCAN_ERROR_CAN_NOTIFICATION if the HAL refused a callback.
+  * @note   A handle may register its controllers again, e.g. when uCAN_Start() is retried.
+  */
+static UCAN_StatusTypeDef uCAN_RegisterController(UCAN_HandleTypeDef* ucan, CAN_HandleTypeDef* hcan, uint8_t primary)
+{
+    UCAN_HandleTypeDef** slot = &uCAN_Registry[uCAN_InstanceIndex(hcan->Instance)];
+
+    // The callbacks of a controller can only reach one handle
+    if (*slot != NULL && *slot != ucan)
+    {
+        return UCAN_ERROR_DUPLICATE_ID;
+    }
+
+    *slot = ucan;
+
+#if (USE_HAL_CAN_REGISTER_CALLBACKS == 1U)
+    // Callbacks of this controller only, the HAL must not be started yet
+    if (HAL_CAN_RegisterCallback(hcan, HAL_CAN_RX_FIFO0_MSG_PENDING_CB_ID, uCAN_HalRxFifo0Callback) != HAL_OK ||
+        HAL_CAN_RegisterCallback(hcan, HAL_CAN_ERROR_CB_ID, uCAN_HalErrorCallback) != HAL_OK)
+    {
+        return UCAN_ERROR_CAN_NOTIFICATION;
+    }
+
+#if UCAN_CFG_HW_TIMESTAMP
+    if (primary &&
+        (HAL_CAN_RegisterCallback(hcan, HAL_CAN_TX_MAILBOX0_COMPLETE_CB_ID, uCAN_HalTxMailbox0Callback) != HAL_OK ||
+         HAL_CAN_RegisterCallback(hcan, HAL_CAN_TX_MAILBOX1_COMPLETE_CB_ID, uCAN_HalTxMailbox1Callback) != HAL_OK ||
+         HAL_CAN_RegisterCallback(hcan, HAL_CAN_TX_MAILBOX2_COMPLETE_CB_ID, uCAN_HalTxMailbox2Callback) != HAL_OK))
+    {
+        return UCAN_ERROR_CAN_NOTIFICATION;
+    }
+#endif
+#endif
+
+    (void)primary;
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_HAL_CALLBACKS */
+
 /**
   * @brief  Initialize the uCAN peripheral handle and its parameters.
   * @param  ucan Pointer to the UCAN handle structure.
   * @retval UCAN_StatusTypeDef Status of the initialization:
   *         - UCAN_OK: Initialization successful
-  *         - UCAN_INVALID_PARAM: Invalid input parameters (null pointers)
+  *         - UCAN_INVALID_PARAM: Invalid input parameters (null pointers, more
+  *           than UCAN_CFG_MAX_CLIENTS clients, or a node role that contradicts
+  *           UCAN_CFG_ROLE)
+  *         - UCAN_ERROR_DUPLICATE_ID: Client list contains the same ID twice
   *
-  * @note   If CAN filter is disabled in the handle, default filter
+  * @note   The client list is sorted by ID in place.
+  *         If CAN filter is disabled in the handle, default filter
   *         configuration is assigned automatically.
   *         This function does not start CAN hardware; it only prepares
   *         the internal state.
@@ -82,12 +253,67 @@ UCAN_StatusTypeDef uCAN_Init(UCAN_HandleTypeDef* ucan)
         return UCAN_INVALID_PARAM;
     }
 
+#if (UCAN_CFG_ROLE == UCAN_CFG_ROLE_MASTER)
+    // Role fixed at compile time must match the handle
+    if (ucan->node.role != UCAN_ROLE_MASTER) return UCAN_INVALID_PARAM;
+#elif (UCAN_CFG_ROLE == UCAN_CFG_ROLE_CLIENT)
+    if (ucan->node.role != UCAN_ROLE_CLIENT) return UCAN_INVALID_PARAM;
+#elif (UCAN_CFG_ROLE == UCAN_CFG_ROLE_NONE)
+    if (ucan->node.role != UCAN_ROLE_NONE) return UCAN_INVALID_PARAM;
+#endif
+
+    // Client list must fit the membership bitmap
+    if (ucan->node.clientCount > UCAN_CFG_MAX_CLIENTS)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+#if (UCAN_CFG_VALIDATION >= UCAN_CFG_VALIDATION_FULL)
+    // Reject duplicate client IDs
+    UCAN_StatusTypeDef nodeCheck = uCAN_Debug_CheckNodeInfo(&ucan->node);
+
+    if (nodeCheck != UCAN_OK)
+    {
+        return nodeCheck;
+    }
+#endif
+
+    // Counter source and its wrap tracking, shared by all time measurements
+    UCAN_StatusTypeDef timebaseStatus = uCAN_Debug_FinalizeTimebase(&ucan->timebase);
+
+    if (timebaseStatus != UCAN_OK)
+    {
+        return timebaseStatus;
+    }
+
+    ucan->node.timebase = &ucan->timebase;
+
+    // Primary and optional redundant controller
+    UCAN_StatusTypeDef busStatus = uCAN_Debug_FinalizeBuses(ucan);
+
+    if (busStatus != UCAN_OK)
+    {
+        return busStatus;
+    }
+
+    // Sort clients by ID for lookups and identical membership bit order on every node
+    uCAN_Debug_FinalizeNodeInfo(&ucan->node);
+
     // Assign default filter config if filter is disabled
     if (ucan->filter.FilterActivation == CAN_FILTER_DISABLE)
     {
         ucan->filter = defaultFilterConfig;
     }
 
+#if UCAN_CFG_REDUNDANT
+    // Same default for the redundant controller, on its own filter banks
+    if (ucan->hcanRedundant != NULL && ucan->filterRedundant.FilterActivation == CAN_FILTER_DISABLE)
+    {
+        ucan->filterRedundant = defaultFilterConfig;
+        ucan->filterRedundant.FilterBank = UCAN_REDUNDANT_FILTER_BANK;
+    }
+#endif
+
     // Mark status as OK, init done
     ucan->status = UCAN_OK;
 
@@ -101,17 +327,20 @@ UCAN_StatusTypeDef uCAN_Init(UCAN_HandleTypeDef* ucan)
   * @retval UCAN_StatusTypeDef Status of the start operation:
   *         - UCAN_OK: Started successfully
   *         - UCAN_INVALID_PARAM: Handle not ready or invalid
-  *         - UCAN_ERROR_DUPLICATE_ID: Duplicate packet IDs detected
+  *         - UCAN_ERROR_DUPLICATE_ID: Duplicate packet IDs detected, or with
+  *           UCAN_CFG_HAL_CALLBACKS a controller already driven by another handle
   *         - UCAN_ERROR_FILTER_CONFIG: CAN filter configuration failed
   *         - UCAN_ERROR_CAN_START: CAN peripheral start failed
   *         - UCAN_ERROR_CAN_NOTIFICATION: Activation of CAN notifications failed
   *
   * @note   This function performs:
-  *         - Validation of TX/RX packet configurations
+  *         - Validation of TX/RX packet configurations (UCAN_CFG_VALIDATION_FULL)
   *         - Finalization of packet holders
-  *         - Duplicate packet ID check
+  *         - Duplicate packet ID check (UCAN_CFG_VALIDATION_FULL)
+  *         - Resolution of multi-packet signal groups
   *         - CAN filter configuration and peripheral start
   *         - Activation of RX FIFO 0 message pending interrupt
+  *         - Scheduling of the boot announcement on client nodes
   *
   *         @b Important: Calling @ref uCAN_Init() alone is not sufficient to start
   *         the communication system. The @ref uCAN_Start() function must be called
@@ -124,6 +353,7 @@ UCAN_StatusTypeDef uCAN_Start(UCAN_HandleTypeDef* ucan, UCAN_Config* config)
     // Check if uCAN handle is ready for start
     UCAN_CHECK_READY(ucan);
 
+#if (UCAN_CFG_VALIDATION >= UCAN_CFG_VALIDATION_FULL)
     // Validate TX packet list config
     UCAN_StatusTypeDef txListCheck = uCAN_Debug_CheckPacketConfig(config->txPacketList, &ucan->txHolder);
     // Validate RX packet list config
@@ -140,18 +370,163 @@ UCAN_StatusTypeDef uCAN_Start(UCAN_HandleTypeDef* ucan, UCAN_Config* config)
         ucan->status = rxListCheck;
         return rxListCheck;
     }
+#endif
 
     // Finalize TX packet holder setup
     uCAN_Debug_FinalizePacket(config->txPacketList, &ucan->txHolder);
     // Finalize RX packet holder setup
     uCAN_Debug_FinalizePacket(config->rxPacketList, &ucan->rxHolder);
 
+#if (UCAN_CFG_VALIDATION >= UCAN_CFG_VALIDATION_FULL)
     // Check for duplicate packet IDs across holders
     if (uCAN_Debug_CheckUniquePackets(ucan) != UCAN_OK)
     {
         ucan->status = UCAN_ERROR_DUPLICATE_ID;
         return UCAN_ERROR_DUPLICATE_ID;
     }
+#endif
+
+    // Fingerprint of the packet layout, reported in handshake responses
+    ucan->node.configHash = uCAN_Debug_ConfigHash(ucan);
+
+#if UCAN_CFG_RX_INDEX
+    // Direct ID lookup of the RX packets for the receive path
+    uCAN_Debug_FinalizeIndex(&ucan->rxHolder, &ucan->rxIndex);
+#endif
+
+    // Link multi-packet signal groups to their RX packets
+    UCAN_StatusTypeDef groupCheck = uCAN_Debug_FinalizeGroups(ucan);
+
+    if (groupCheck != UCAN_OK)
+    {
+        ucan->status = groupCheck;
+        return groupCheck;
+    }
+
+#if UCAN_CFG_LATENCY
+    // Bind latency blocks of traced packets to the timebase
+    UCAN_StatusTypeDef latencyCheck = uCAN_Debug_FinalizeLatency(ucan);
+
+    if (latencyCheck != UCAN_OK)
+    {
+        ucan->status = latencyCheck;
+        return latencyCheck;
+    }
+#endif
+
+#if UCAN_CFG_TRIGGER
+    // Arm signal triggers and bind them to the event queue
+    UCAN_StatusTypeDef triggerCheck = uCAN_Debug_FinalizeTriggers(ucan);
+
+    if (triggerCheck != UCAN_OK)
+    {
+        ucan->status = triggerCheck;
+        return triggerCheck;
+    }
+#endif
+
+#if UCAN_CFG_EXPORT
+    // Publish the RX packet layout to the shared-memory export region
+    UCAN_StatusTypeDef exportCheck = uCAN_Debug_FinalizeExport(ucan, config->rxPacketList);
+
+    if (exportCheck != UCAN_OK)
+    {
+        ucan->status = exportCheck;
+        return exportCheck;
+    }
+#endif
+
+#if UCAN_CFG_SCHEDULE
+    // Bind schedule windows to their TX packets and validate the timing
+    UCAN_StatusTypeDef scheduleCheck = uCAN_Debug_CompileSchedule(ucan);
+
+    if (scheduleCheck != UCAN_OK)
+    {
+        ucan->status = scheduleCheck;
+        return scheduleCheck;
+    }
+#endif
+
+#if UCAN_CFG_MONITOR
+    if (ucan->monitor.frames != NULL)
+    {
+        uint32_t size = ucan->monitor.size;
+
+        // Ring size must be a power of two, a monitor never transmits
+        if (size == 0U || (size & (size - 1U)) != 0U || ucan->node.role != UCAN_ROLE_NONE)
+        {
+            ucan->status = UCAN_INVALID_PARAM;
+            return UCAN_INVALID_PARAM;
+        }
+
+        ucan->monitor.head = 0;
+        ucan->monitor.tail = 0;
+        ucan->monitor.overruns = 0;
+
+        // Listen only (no ACK, no error frames), latch hardware timestamps
+        ucan->hcan->Init.Mode = CAN_MODE_SILENT;
+        ucan->hcan->Init.TimeTriggeredMode = ENABLE;
+
+        if (HAL_CAN_Init(ucan->hcan) != HAL_OK)
+        {
+            ucan->status = UCAN_ERROR_CAN_START;
+            return UCAN_ERROR_CAN_START;
+        }
+
+        // Capture every identifier on the bus
+        ucan->filter = defaultFilterConfig;
+
+#if UCAN_CFG_REDUNDANT
+        if (ucan->hcanRedundant != NULL)
+        {
+            // The redundant bus is captured as well, also without ACK
+            ucan->hcanRedundant->Init.Mode = CAN_MODE_SILENT;
+
+            if (HAL_CAN_Init(ucan->hcanRedundant) != HAL_OK)
+            {
+                ucan->status = UCAN_ERROR_CAN_START;
+                return UCAN_ERROR_CAN_START;
+            }
+
+            ucan->filterRedundant = defaultFilterConfig;
+            ucan->filterRedundant.FilterBank = UCAN_REDUNDANT_FILTER_BANK;
+        }
+#endif
+    }
+#endif
+
+#if UCAN_CFG_HW_TIMESTAMP
+    // Hardware timestamps need time triggered communication mode
+    if (ucan->hcan->Init.TimeTriggeredMode != ENABLE)
+    {
+        ucan->hcan->Init.TimeTriggeredMode = ENABLE;
+
+        if (HAL_CAN_Init(ucan->hcan) != HAL_OK)
+        {
+            ucan->status = UCAN_ERROR_CAN_START;
+            return UCAN_ERROR_CAN_START;
+        }
+    }
+
+    uCAN_Debug_FinalizeClock(&ucan->clock, ucan->hcan, uCAN_Runtime_TimeToMs(&ucan->timebase, uCAN_Runtime_Now(&ucan->timebase)));
+#endif
+
+#if UCAN_CFG_HAL_CALLBACKS
+    // Route the HAL callbacks of the controllers to this handle before they start
+    UCAN_StatusTypeDef registerCheck = uCAN_RegisterController(ucan, ucan->hcan, 1U);
+#if UCAN_CFG_REDUNDANT
+    if (registerCheck == UCAN_OK && ucan->hcanRedundant != NULL)
+    {
+        registerCheck = uCAN_RegisterController(ucan, ucan->hcanRedundant, 0U);
+    }
+#endif
+
+    if (registerCheck != UCAN_OK)
+    {
+        ucan->status = registerCheck;
+        return registerCheck;
+    }
+#endif
 
     // Configure CAN hardware filter with current filter settings
     if (HAL_CAN_ConfigFilter(ucan->hcan, &ucan->filter) != HAL_OK)
@@ -174,20 +549,102 @@ UCAN_StatusTypeDef uCAN_Start(UCAN_HandleTypeDef* ucan, UCAN_Config* config)
         return UCAN_ERROR_CAN_NOTIFICATION;
     }
 
+#if UCAN_CFG_REDUNDANT
+    if (ucan->hcanRedundant != NULL)
+    {
+        // Second controller of the redundant pair, receives into FIFO 0 like the first
+        if (HAL_CAN_ConfigFilter(ucan->hcanRedundant, &ucan->filterRedundant) != HAL_OK)
+        {
+            ucan->status = UCAN_ERROR_FILTER_CONFIG;
+            return UCAN_ERROR_FILTER_CONFIG;
+        }
+
+        if (HAL_CAN_Start(ucan->hcanRedundant) != HAL_OK)
+        {
+            ucan->status = UCAN_ERROR_CAN_START;
+            return UCAN_ERROR_CAN_START;
+        }
+
+        if (HAL_CAN_ActivateNotification(ucan->hcanRedundant, CAN_IT_RX_FIFO0_MSG_PENDING) != HAL_OK)
+        {
+            ucan->status = UCAN_ERROR_CAN_NOTIFICATION;
+            return UCAN_ERROR_CAN_NOTIFICATION;
+        }
+    }
+#endif
+
+#if UCAN_CFG_HW_TIMESTAMP
+    // TX mailbox completion interrupt, delivers transmit confirmations to uCAN_TxComplete()
+    if (HAL_CAN_ActivateNotification(ucan->hcan, CAN_IT_TX_MAILBOX_EMPTY) != HAL_OK)
+    {
+        ucan->status = UCAN_ERROR_CAN_NOTIFICATION;
+        return UCAN_ERROR_CAN_NOTIFICATION;
+    }
+#endif
+
+#if UCAN_CFG_HAS_CLIENT
+    // Announce this client to the master after a short randomized backoff
+    if (UCAN_NODE_IS_CLIENT(&ucan->node))
+    {
+        uCAN_Runtime_ScheduleAnnounce(&ucan->node);
+    }
+#endif
+
     // All init steps succeeded
     return UCAN_OK;
 }
 
+/**
+  * @brief  Queue the handshake frames that are due on this node.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  *
+  * @note   A client sends its boot announcement once the backoff has elapsed
+  *         and retries a ping reply that found no free mailbox in the RX
+  *         path; a master sends its ping once the interval has elapsed. Each
+  *         frame stays due until it is queued.
+  */
+static void uCAN_SendHandshakeFrames(UCAN_HandleTypeDef* ucan)
+{
+#if UCAN_CFG_HAS_CLIENT
+    uCAN_Runtime_SendAnnounce(ucan->bus, &ucan->node);
+    uCAN_Runtime_SendReply(ucan->bus, &ucan->node);
+#endif
+
+#if UCAN_CFG_HAS_MASTER
+    if (UCAN_NODE_IS_MASTER(&ucan->node))
+    {
+        uCAN_Runtime_SendPing(ucan->bus, &ucan->node);
+    }
+#endif
+
+    (void)ucan;
+}
+
 /**
   * @brief  Send all queued TX packets over the CAN bus and transmit a ping.
   * @param  ucan Pointer to the initialized UCAN handle.
   * @retval UCAN_StatusTypeDef Status of the send operation:
   *         - UCAN_OK: All packets and ping sent successfully
   *         - UCAN_ERROR: Failed to send one or more packets
+  *         - UCAN_BUSY: the mailboxes filled up and the round continues on
+  *           the next call, or a double-buffered overlay was being written by
+  *           a preempted context and nothing was sent
   *
-  * @note   This function iterates over all packets in the TX holder and sends
+  * @note   The payloads of all TX packets are first latched into a staging
+  *         copy at a single instant (see uCAN_Runtime_LatchPackets()), so a
+  *         variable updated by an interrupt cannot go out torn and all packets
+  *         of the burst reflect the same sampling time.
+  *         This function then iterates over all packets in the TX holder and sends
   *         them sequentially. Afterward, it sends a ping message to announce
-  *         node presence.
+  *         node presence. Handshake frames that found no free mailbox are
+  *         retried before the next round is latched, so a TX set that fills
+  *         the mailboxes on every call cannot starve them.
+  *         Bulk packets only use mailboxes beyond the UCAN_CFG_RESERVED_MAILBOXES
+  *         kept for critical packets. When none is left, the round stops with
+  *         UCAN_BUSY and the next call resumes it from the same latched
+  *         payloads instead of latching a new set.
+  *         Traced packets (UCAN_CFG_LATENCY) carry the latch instant as
+  *         their sample time, unless uCAN_LatencySample() marked another one.
   *         The function assumes the CAN peripheral is started and ready.
   */
 UCAN_StatusTypeDef uCAN_SendAll(UCAN_HandleTypeDef* ucan)
@@ -195,62 +652,222 @@ UCAN_StatusTypeDef uCAN_SendAll(UCAN_HandleTypeDef* ucan)
     // Verify that the UCAN handle is ready
     UCAN_CHECK_READY(ucan);
 
-    // Loop through all TX packets and send them
-    for (uint32_t i = 0; i < ucan->txHolder.count; i++)
+    // Capture the whole TX set at one sampling instant, unless a round is still in progress
+    if (ucan->txHolder.pending == 0)
+    {
+        // Handshake frames left over from the last round go ahead of the new one
+        uCAN_SendHandshakeFrames(ucan);
+
+        UCAN_Time latchTime = uCAN_Runtime_Now(&ucan->timebase);
+        UCAN_StatusTypeDef latchStatus = uCAN_Runtime_LatchPackets(&ucan->txHolder, uCAN_Runtime_TimeToMs(&ucan->timebase, latchTime));
+
+        if (latchStatus != UCAN_OK)
+        {
+            return latchStatus;
+        }
+
+#if UCAN_CFG_LATENCY
+        ucan->txHolder.latchTime = latchTime;
+#endif
+    }
+
+    // Loop through all TX packets and send their latched payloads
+    for (uint32_t i = ucan->txHolder.pending; i < ucan->txHolder.count; i++)
     {
-        if (uCAN_Runtime_SendPacket(ucan->hcan, &ucan->txHolder.packets[i]) != UCAN_OK)
+        UCAN_Packet* packet = &ucan->txHolder.packets[i];
+
+#if UCAN_CFG_SCHEDULE
+        // Packets with a schedule window are only sent inside it
+        if (packet->scheduled)
+        {
+            continue;
+        }
+#endif
+
+        uint8_t dlc = packet->dlc;
+
+#if UCAN_CFG_LATENCY
+        if (packet->latency != NULL)
+        {
+            // Latched payload, sampled at the latch instant unless marked
+            dlc = uCAN_Runtime_StampLatency(packet->latency, packet->latched, dlc, ucan->txHolder.latchTime);
+        }
+#endif
+
+        UCAN_StatusTypeDef sendStatus = packet->critical ?
+            uCAN_Runtime_SendCriticalFrame(ucan->bus, packet->id, dlc, packet->latched) :
+            uCAN_Runtime_SendFrame(ucan->bus, packet->id, dlc, packet->latched);
+
+        if (sendStatus == UCAN_BUSY)
+        {
+            // No mailbox for this packet's class, resume here on the next call
+            ucan->txHolder.pending = i;
+            return UCAN_BUSY;
+        }
+
+        if (sendStatus != UCAN_OK)
         {
-            // Stop and return error on first failure
+            // Count the lost frame, stop and return error on first failure
+            ucan->node.droppedFrames++;
+            ucan->txHolder.pending = 0;
             return UCAN_ERROR;
         }
+
+#if UCAN_CFG_LATENCY
+        if (packet->latency != NULL)
+        {
+            // Frame is on its way, the next one gets a new number and sample
+            packet->latency->txSeq++;
+            packet->latency->sampled = 0;
+        }
+#endif
     }
 
-    // Send node presence ping after all packets are sent
-    uCAN_Runtime_SendPing(ucan->hcan, &ucan->node);
+    ucan->txHolder.pending = 0;
+
+    // Announcement, ping reply or node presence ping after all packets are sent
+    uCAN_SendHandshakeFrames(ucan);
 
     return UCAN_OK;
 }
 
 /**
-  * @brief  Process incoming CAN message, update RX packets or handle handshake.
-  * @param  ucan Pointer to the initialized UCAN handle.
-  * @retval UCAN_StatusTypeDef Status of the update operation:
-  *         - UCAN_OK: Message processed successfully
-  *         - UCAN_ERROR: CAN receive failure or unknown error
-  *         - UCAN_ERROR_UNKNOWN_ID: Received unknown packet ID (may trigger handshake)
-  *         - Other handshake related error codes if handshake update fails
-  *
-  * @note   This function reads one message from CAN RX FIFO0,
-  *         attempts to update RX packet data, and if the packet ID
-  *         is unknown, tries to process it as a handshake message.
-  *
-  *         It expects the CAN peripheral to be started and interrupts enabled.
+  * @brief  Receive and process frames of one bus.
+  * @param  ucan  Pointer to the initialized UCAN handle.
+  * @param  index Index of the bus in ucan->bus.
+  * @retval UCAN_StatusTypeDef Status of the update, see uCAN_Update().
   *
-  *         Recommended usage: Call this function inside the CAN RX FIFO0 interrupt
-  *         handler (e.g., in CANx_RX0_IRQHandler) to handle received messages
-  *         immediately upon arrival.
+  * @note   Hardware timestamps come from the primary controller only; frames
+  *         taken from the redundant bus carry none. On a redundant pair, the
+  *         later copy of a frame is counted and discarded before it reaches
+  *         the RX packets, the handshake or the schedule.
   */
-UCAN_StatusTypeDef uCAN_Update(UCAN_HandleTypeDef* ucan)
+static UCAN_StatusTypeDef uCAN_ReceiveBus(UCAN_HandleTypeDef* ucan, uint8_t index)
 {
-    // Ensure handle and CAN peripheral are ready
-    UCAN_CHECK_READY(ucan);
-
+    UCAN_Bus* bus = &ucan->bus[index];
     CAN_RxHeaderTypeDef rxHeader;
     uint8_t data[8];
 
+    // Account for frames lost to a FIFO overrun since the last call
+    if (__HAL_CAN_GET_FLAG(bus->hcan, CAN_FLAG_FOV0))
+    {
+        __HAL_CAN_CLEAR_FLAG(bus->hcan, CAN_FLAG_FOV0);
+        ucan->node.droppedFrames++;
+    }
+
+#if UCAN_CFG_MONITOR
+    if (ucan->monitor.frames != NULL)
+    {
+        // Empty the whole FIFO, back-to-back frames at full bus load arrive faster than one per interrupt
+        while (HAL_CAN_GetRxFifoFillLevel(bus->hcan, CAN_RX_FIFO0) > 0U)
+        {
+            if (HAL_CAN_GetRxMessage(bus->hcan, CAN_RX_FIFO0, &rxHeader, data) != HAL_OK)
+            {
+                ucan->node.droppedFrames++;
+                UCAN_TRACE(UCAN_TRACE_ERROR, UCAN_ERROR);
+                return UCAN_ERROR;
+            }
+
+            UCAN_Time now = uCAN_Runtime_Now(&ucan->timebase);
+            uint32_t tick = uCAN_Runtime_TimeToMs(&ucan->timebase, now);
+#if UCAN_CFG_HW_TIMESTAMP
+            uint64_t hwTime = (index == 0U) ? uCAN_Runtime_ExtendTimestamp(&ucan->clock, (uint16_t)rxHeader.Timestamp, tick) : 0U;
+#else
+            uint64_t hwTime = 0;
+#endif
+            UCAN_TRACE(UCAN_TRACE_RX, rxHeader.StdId);
+
+            bus->rxFrames++;
+            bus->lastRxTime = now;
+            __DMB();
+            bus->flags |= UCAN_BUS_FLAG_RX;
+
+            // Raw traffic of every bus, copies included
+            uCAN_Runtime_CaptureFrame(&ucan->monitor, &rxHeader, data, tick);
+
+#if UCAN_CFG_REDUNDANT
+            if (uCAN_Runtime_IsDuplicate(ucan->dedup, &ucan->rxHolder, index, &rxHeader, data, now, uCAN_Runtime_MsToTime(&ucan->timebase, UCAN_REDUNDANT_WINDOW_MS)))
+            {
+                bus->rxDuplicates++;
+                continue;
+            }
+#endif
+
+            // Configured RX packets keep updating, unknown IDs are expected here
+            if (rxHeader.IDE == CAN_ID_STD && rxHeader.RTR == CAN_RTR_DATA)
+            {
+                (void)uCAN_Runtime_UpdatePacket(&ucan->rxHolder, rxHeader.StdId, data, (uint8_t)rxHeader.DLC, tick, now, hwTime);
+            }
+        }
+
+        return UCAN_OK;
+    }
+#endif
+
     // Receive one CAN message from RX FIFO 0
-    if (HAL_CAN_GetRxMessage(ucan->hcan, CAN_RX_FIFO0, &rxHeader, data) != HAL_OK)
+    if (HAL_CAN_GetRxMessage(bus->hcan, CAN_RX_FIFO0, &rxHeader, data) != HAL_OK)
     {
+        ucan->node.droppedFrames++;
+        UCAN_TRACE(UCAN_TRACE_ERROR, UCAN_ERROR);
         return UCAN_ERROR;
     }
 
+#if UCAN_CFG_FAULT
+    // Frame lost or damaged by the running fault scenario
+    if (bus->fault != NULL && uCAN_Runtime_FaultRx(bus->fault, index, &rxHeader, data))
+    {
+        return UCAN_OK;
+    }
+#endif
+
+    UCAN_Time now = uCAN_Runtime_Now(&ucan->timebase);
+    uint32_t tick = uCAN_Runtime_TimeToMs(&ucan->timebase, now);
+#if UCAN_CFG_HW_TIMESTAMP
+    // Place the 16-bit hardware timestamp on the 64-bit timebase
+    uint64_t hwTime = (index == 0U) ? uCAN_Runtime_ExtendTimestamp(&ucan->clock, (uint16_t)rxHeader.Timestamp, tick) : 0U;
+#else
+    uint64_t hwTime = 0;
+#endif
+
+    UCAN_TRACE(UCAN_TRACE_RX, rxHeader.StdId);
+
+    // Bus is alive, record the time before marking it valid
+    bus->rxFrames++;
+    bus->lastRxTime = now;
+    __DMB();
+    bus->flags |= UCAN_BUS_FLAG_RX;
+
+#if UCAN_CFG_REDUNDANT
+    // Later copy of a frame already taken from the other bus
+    if (uCAN_Runtime_IsDuplicate(ucan->dedup, &ucan->rxHolder, index, &rxHeader, data, now, uCAN_Runtime_MsToTime(&ucan->timebase, UCAN_REDUNDANT_WINDOW_MS)))
+    {
+        bus->rxDuplicates++;
+        return UCAN_OK;
+    }
+#endif
+
+#if UCAN_CFG_SCHEDULE
+    // Reference message starts the next basic cycle
+    if (ucan->schedule != NULL && rxHeader.IDE == CAN_ID_STD && rxHeader.StdId == ucan->schedule->referenceId)
+    {
+        return uCAN_Runtime_SyncSchedule(ucan->schedule, data, (uint8_t)rxHeader.DLC);
+    }
+#endif
+
+    // Remote frames carry no payload for packets or the handshake
+    if (rxHeader.RTR == CAN_RTR_REMOTE)
+    {
+        return UCAN_OK;
+    }
+
     // Update RX packet data based on received CAN ID
-    UCAN_StatusTypeDef packetStatus = uCAN_Runtime_UpdatePacket(&ucan->rxHolder, rxHeader.StdId, data);
+    UCAN_StatusTypeDef packetStatus = uCAN_Runtime_UpdatePacket(&ucan->rxHolder, rxHeader.StdId, data, (uint8_t)rxHeader.DLC, tick, now, hwTime);
 
+#if UCAN_CFG_HANDSHAKE
     // If packet ID unknown, try to handle as handshake message
     if (packetStatus == UCAN_ERROR_UNKNOWN_ID)
     {
-        UCAN_StatusTypeDef handshakeStatus = uCAN_Runtime_UpdateHandshake(&ucan->node, ucan->hcan, rxHeader.StdId, data);
+        UCAN_StatusTypeDef handshakeStatus = uCAN_Runtime_UpdateHandshake(&ucan->node, ucan->bus, rxHeader.StdId, data, (uint8_t)rxHeader.DLC, hwTime);
 
         if (handshakeStatus != UCAN_OK)
         {
@@ -258,7 +875,9 @@ UCAN_StatusTypeDef uCAN_Update(UCAN_HandleTypeDef* ucan)
             return handshakeStatus;
         }
     }
-    else if (packetStatus != UCAN_OK)
+    else
+#endif
+    if (packetStatus != UCAN_OK)
     {
         // Known packet, but error occurred during update
         return packetStatus;
@@ -269,23 +888,93 @@ UCAN_StatusTypeDef uCAN_Update(UCAN_HandleTypeDef* ucan)
 }
 
 /**
-  * @brief  Evaluate handshake responses from all clients and update connection status.
+  * @brief  Process incoming CAN message, update RX packets or handle handshake.
   * @param  ucan Pointer to the initialized UCAN handle.
-  * @retval UCAN_StatusTypeDef
+  * @retval UCAN_StatusTypeDef Status of the update operation:
+  *         - UCAN_OK: Message processed successfully
+  *         - UCAN_ERROR: CAN receive failure or unknown error
+  *         - UCAN_ERROR_UNKNOWN_ID: Received unknown packet ID (may trigger handshake)
+  *         - Other handshake related error codes if handshake update fails
+  *
+  * @note   This function reads one message from CAN RX FIFO0,
+  *         attempts to update RX packet data (and calls the packet's
+  *         handler, if registered), and if the packet ID
+  *         is unknown, tries to process it as a handshake message.
+  *
+  *         It expects the CAN peripheral to be started and interrupts enabled.
+  *
+  *         Recommended usage: Call this function inside the CAN RX FIFO0 interrupt
+  *         handler (e.g., in CANx_RX0_IRQHandler) to handle received messages
+  *         immediately upon arrival.
+  *
+  *         With a redundant controller, call it from the RX FIFO0 interrupts
+  *         of both controllers, configured with the same priority. Each call
+  *         serves every controller with a pending frame; whichever copy of a
+  *         frame arrives first is processed, the later one is discarded.
+
+  *         With UCAN_CFG_HAL_CALLBACKS, HAL_CAN_IRQHandler() calls it through
+  *         the RX FIFO 0 message pending callback instead.
+  */
+UCAN_StatusTypeDef uCAN_Update(UCAN_HandleTypeDef* ucan)
+{
+    // Ensure handle and CAN peripheral are ready
+    UCAN_CHECK_READY(ucan);
+
+#if UCAN_CFG_REDUNDANT
+    if (ucan->bus[1].hcan != NULL)
+    {
+        UCAN_StatusTypeDef status = UCAN_OK;
+
+        // Either interrupt may find frames on both controllers
+        for (uint8_t b = 0; b < UCAN_BUS_COUNT; b++)
+        {
+            if (HAL_CAN_GetRxFifoFillLevel(ucan->bus[b].hcan, CAN_RX_FIFO0) == 0U)
+            {
+                continue;
+            }
+
+            UCAN_StatusTypeDef busStatus = uCAN_ReceiveBus(ucan, b);
+
+            if (busStatus != UCAN_OK)
+            {
+                status = busStatus;
+            }
+        }
+
+        return status;
+    }
+#endif
+
+    return uCAN_ReceiveBus(ucan, 0);
+}
+
+/**
+  * @brief  Evaluate handshake responses from all clients and update connection status.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @retval UCAN_StatusTypeDef
   *         - UCAN_OK: All clients responded within valid time
   *         - UCAN_ERROR: One or more clients failed handshake or timed out
   *
   * @note   Iterates through all clients in the node. For each client:
-  *         - Checks if responseTick is zero (no response)
-  *         - Compares sentTick and responseTick to determine timeout or lost status
+  *         - Checks UCAN_CLIENT_FLAG_RESPONDED (no response yet)
+  *         - Compares the age of responseTime against the current time to
+  *           determine timeout or lost status, so a client that stops
+  *           answering is detected even if no further pings are sent
   *         - Updates client's connection status accordingly
   *         - Accumulates error flag if any client is not active
   *
+  *         On a master with UCAN_CFG_MEMBERSHIP enabled, the resulting set of
+  *         active clients is broadcast every UCAN_MEMBERSHIP_INTERVAL_MS so
+  *         that all nodes share the same membership view.
+  *
   *         If handshake mechanism is enabled, this function must be called
   *         periodically (e.g., inside a main loop or timer callback).
   *         Otherwise, client connection status fields will not be updated,
   *         and connection loss or timeout conditions will not be detected.
+  *
+  *         Not available when UCAN_CFG_HANDSHAKE is disabled.
   */
+#if UCAN_CFG_HANDSHAKE
 UCAN_StatusTypeDef uCAN_Handshake(UCAN_HandleTypeDef* ucan)
 {
     // Ensure handle is ready
@@ -293,29 +982,47 @@ UCAN_StatusTypeDef uCAN_Handshake(UCAN_HandleTypeDef* ucan)
 
     UCAN_StatusTypeDef connectionErrorFlag = UCAN_OK;
 
+#if UCAN_CFG_HAS_CLIENT
+    // Boot announcement, once its backoff has elapsed
+    uCAN_Runtime_SendAnnounce(ucan->bus, &ucan->node);
+
+    // Ping reply that found no free mailbox in the RX path
+    uCAN_Runtime_SendReply(ucan->bus, &ucan->node);
+#endif
+
+    UCAN_Time now = uCAN_Runtime_Now(&ucan->timebase);
+    UCAN_Time timeout = uCAN_Runtime_MsToTime(&ucan->timebase, UCAN_HANDSHAKE_TIMEOUT_MS);
+    UCAN_Time lost = uCAN_Runtime_MsToTime(&ucan->timebase, UCAN_HANDSHAKE_LOST_MS);
+
     // Iterate through clients to check handshake status
     for (uint32_t i = 0; i < ucan->node.clientCount; i++)
     {
         // No response received from client yet
-        if (ucan->node.clients[i].responseTick == 0)
+        if (!(ucan->node.clients[i].flags & UCAN_CLIENT_FLAG_RESPONDED))
         {
             connectionErrorFlag = UCAN_ERROR;
             continue;
         }
+        __DMB();
 
         UCAN_ConnectionStatusTypeDef status;
+        UCAN_Time age = UCAN_TIME_SINCE(now, uCAN_Runtime_LoadTime(&ucan->node.clients[i].responseTime));
 
-        // Check if response timed out compared to sentTick
-        if (UCAN_HANDSHAKE_IS_TIMEOUT(ucan->node.sentTick, ucan->node.clients[i].responseTick))
+        // Check if the last response is older than the timeout
+        if (UCAN_HANDSHAKE_IS_TIMEOUT(age, timeout, lost))
         {
             status = UCAN_CONN_TIMEOUT;
             connectionErrorFlag = UCAN_ERROR;
         }
         // Check if connection is lost
-        else if (UCAN_HANDSHAKE_IS_LOST(ucan->node.sentTick, ucan->node.clients[i].responseTick))
+        else if (UCAN_HANDSHAKE_IS_LOST(age, lost))
         {
             status = UCAN_CONN_LOST;
             connectionErrorFlag = UCAN_ERROR;
+
+            // Client may come back with other firmware, negotiate again
+            ucan->node.clients[i].caps.valid = 0;
+            ucan->node.clients[i].caps.misses = 0;
         }
         else
         {
@@ -326,5 +1033,1639 @@ UCAN_StatusTypeDef uCAN_Handshake(UCAN_HandleTypeDef* ucan)
         ucan->node.clients[i].status = status;
     }
 
+#if UCAN_CFG_HAS_MEMBERSHIP && UCAN_CFG_HAS_MASTER
+    if (UCAN_NODE_IS_MASTER(&ucan->node))
+    {
+        // Rebuild bitmap of active clients
+        for (uint32_t i = 0; i < ucan->node.clientCount; i++)
+        {
+            if (ucan->node.clients[i].status == UCAN_CONN_ACTIVE)
+            {
+                UCAN_MEMBERSHIP_SET(&ucan->node, i);
+            }
+            else
+            {
+                UCAN_MEMBERSHIP_CLEAR(&ucan->node, i);
+            }
+        }
+
+        // Share it with every node once per interval
+        if (UCAN_TIME_SINCE(now, ucan->node.membershipTime) >= uCAN_Runtime_MsToTime(&ucan->timebase, UCAN_MEMBERSHIP_INTERVAL_MS))
+        {
+            // A broadcast that found no free mailbox is repeated on the next call
+            if (uCAN_Runtime_SendMembership(ucan->bus, &ucan->node) == UCAN_OK)
+            {
+                ucan->node.membershipTime = now;
+            }
+        }
+    }
+#endif
+
     return connectionErrorFlag;
 }
+#endif /* UCAN_CFG_HANDSHAKE */
+
+#if UCAN_CFG_STATS
+/**
+  * @brief  Read a consistent snapshot of the running statistics of an RX signal.
+  * @param  ucan   Pointer to the initialized UCAN handle.
+  * @param  stats  Statistics block bound to a signal via UCAN_Data.stats.
+  * @param  result Output snapshot.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Snapshot copied
+  *         - UCAN_INVALID_PARAM: Null pointer input
+  *         - UCAN_NO_CHANGED_VAL: No sample received in the current window yet
+  *         - UCAN_BUSY: RX path kept updating the block, try again later
+  *
+  * @note   Cost is O(1) regardless of how many samples were accumulated.
+  *         The block is written from the RX interrupt; the read is retried
+  *         (up to UCAN_STATS_READ_RETRIES times) if an update interleaves,
+  *         so interrupts never need to be disabled.
+  */
+UCAN_StatusTypeDef uCAN_GetSignalStats(UCAN_HandleTypeDef* ucan, UCAN_SignalStats* stats, UCAN_SignalStatsResult* result)
+{
+    // Ensure handle is ready
+    UCAN_CHECK_READY(ucan);
+
+    if (stats == NULL || result == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    for (uint32_t attempt = 0; attempt < UCAN_STATS_READ_RETRIES; attempt++)
+    {
+        uint32_t seq = stats->seq;
+
+        // Writer in progress, retry
+        if (seq & 1U)
+        {
+            continue;
+        }
+        __DMB();
+
+        uint32_t count = stats->count;
+        uint32_t min = stats->min;
+        uint32_t max = stats->max;
+        float mean = stats->mean;
+        float m2 = stats->m2;
+        UCAN_Time span = stats->lastTime - stats->firstTime;
+
+        __DMB();
+        if (stats->seq != seq)
+        {
+            // Block changed while copying, retry
+            continue;
+        }
+
+        if (count == 0)
+        {
+            return UCAN_NO_CHANGED_VAL;
+        }
+
+        result->count = count;
+        result->min = min;
+        result->max = max;
+        result->mean = mean;
+        result->variance = (count > 1) ? (m2 / (float)(count - 1)) : 0.0f;
+        result->rateHz = (count > 1 && span != 0) ? ((float)(count - 1) * (float)ucan->timebase.frequency / (float)span) : 0.0f;
+
+        return UCAN_OK;
+    }
+
+    return UCAN_BUSY;
+}
+
+/**
+  * @brief  Restart the statistics window of an RX signal.
+  * @param  ucan  Pointer to the initialized UCAN handle.
+  * @param  stats Statistics block bound to a signal via UCAN_Data.stats.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Reset requested
+  *         - UCAN_INVALID_PARAM: Null pointer input
+  *
+  * @note   The reset is applied by the RX path together with the next sample,
+  *         so the block is only ever written from one context.
+  */
+UCAN_StatusTypeDef uCAN_ResetSignalStats(UCAN_HandleTypeDef* ucan, UCAN_SignalStats* stats)
+{
+    // Ensure handle is ready
+    UCAN_CHECK_READY(ucan);
+
+    if (stats == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    stats->resetRequest = 1;
+
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_STATS */
+
+/**
+  * @brief  Copy the latest complete set of a signal group into the bound variables.
+  * @param  ucan  Pointer to the initialized UCAN handle.
+  * @param  group Signal group registered in ucan->groups.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: A new set was copied into the application variables
+  *         - UCAN_NO_CHANGED_VAL: No set was published since the last call
+  *         - UCAN_INVALID_PARAM: Null pointer input
+  *         - UCAN_BUSY: Sets kept being published during the copy, try again later
+  *
+  * @note   Call from the application context (main loop). The RX interrupt only
+  *         writes the back buffer, so the copy is consistent without disabling
+  *         interrupts; it is retried (up to UCAN_GROUP_READ_RETRIES times) if a
+  *         new set is published while copying. The set is first copied into a
+  *         local snapshot and only scattered into the application variables
+  *         once it is known to be complete, so on UCAN_BUSY they still hold
+  *         the previous set.
+  */
+UCAN_StatusTypeDef uCAN_ReadGroup(UCAN_HandleTypeDef* ucan, UCAN_SignalGroup* group)
+{
+    // Ensure handle is ready
+    UCAN_CHECK_READY(ucan);
+
+    if (group == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    for (uint32_t attempt = 0; attempt < UCAN_GROUP_READ_RETRIES; attempt++)
+    {
+        uint32_t commit = group->commitSeq;
+
+        // Nothing new since last read
+        if (commit == group->readSeq)
+        {
+            return UCAN_NO_CHANGED_VAL;
+        }
+        __DMB();
+
+        uint8_t front = group->front;
+        uint8_t frames[UCAN_GROUP_MAX_MEMBERS][8];
+
+        // Snapshot the front buffer, the application variables stay untouched until it is known consistent
+        for (uint8_t k = 0; k < group->memberCount; k++)
+        {
+            for (uint8_t i = 0; i < group->packets[k]->dlc; i++)
+            {
+                frames[k][i] = group->frames[front][k][i];
+            }
+        }
+
+        __DMB();
+        if (group->commitSeq != commit)
+        {
+            // A set was published while copying, the snapshot may mix two sets
+            continue;
+        }
+
+        // Scatter every member frame into its bound variables
+        for (uint8_t k = 0; k < group->memberCount; k++)
+        {
+            UCAN_Packet* packet = group->packets[k];
+
+            for (uint8_t i = 0; i < packet->dlc; i++)
+            {
+                *(packet->bits[i]) = frames[k][i];
+            }
+        }
+
+        group->readSeq = commit;
+        return UCAN_OK;
+    }
+
+    return UCAN_BUSY;
+}
+
+
+#if UCAN_CFG_HAS_MASTER
+/**
+  * @brief  Read the latest health record reported by a client.
+  * @param  ucan     Pointer to the initialized UCAN handle (master).
+  * @param  clientId CAN identifier of the client.
+  * @param  diag     Output health record.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Record copied
+  *         - UCAN_INVALID_PARAM: Null pointer input
+  *         - UCAN_ERROR_UNKNOWN_ID: clientId is not in the client list
+  *         - UCAN_NO_CONNECTION: The client has not sent a diagnostic pong yet
+  *         - UCAN_BUSY: The record kept being updated during the copy, retry
+  *
+  * @note   Clients fill the otherwise unused bytes of their handshake response
+  *         with CPU load, TEC/REC, dropped frame count, uptime and configuration
+  *         hash. The master decodes them on reception, so this call only copies,
+  *         retrying if a response is decoded meanwhile.
+  */
+UCAN_StatusTypeDef uCAN_GetClientDiag(UCAN_HandleTypeDef* ucan, uint32_t clientId, UCAN_ClientDiag* diag)
+{
+    // Ensure handle is ready
+    UCAN_CHECK_READY(ucan);
+
+    if (diag == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_Client clientKey = {.id = clientId};
+    UCAN_Client* client = bsearch(&clientKey, ucan->node.clients, ucan->node.clientCount, sizeof(UCAN_Client), uCAN_Runtime_CompareClientId);
+
+    if (client == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    for (uint32_t attempt = 0; attempt < UCAN_DIAG_READ_RETRIES; attempt++)
+    {
+        uint32_t seq = client->diagSeq;
+
+        // Pong being decoded, retry
+        if (seq & 1U)
+        {
+            continue;
+        }
+        __DMB();
+
+        UCAN_ClientDiag copy = client->diag;
+#if UCAN_CFG_HW_TIMESTAMP
+        uint32_t rtt = client->rtt;
+#endif
+
+        __DMB();
+        if (client->diagSeq != seq)
+        {
+            // Record changed while copying, retry
+            continue;
+        }
+
+        if (!copy.valid)
+        {
+            return UCAN_NO_CONNECTION;
+        }
+
+        *diag = copy;
+#if UCAN_CFG_HW_TIMESTAMP
+        diag->rttUs = (uint32_t)uCAN_Runtime_BitsToUs(&ucan->clock, rtt);
+#endif
+
+        return UCAN_OK;
+    }
+
+    return UCAN_BUSY;
+}
+#endif /* UCAN_CFG_HAS_MASTER */
+
+#if UCAN_CFG_HANDSHAKE
+/**
+  * @brief  Read the capabilities negotiated with a peer.
+  * @param  ucan   Pointer to the initialized UCAN handle.
+  * @param  peerId CAN identifier of a client (on a master) or of the master (on a client).
+  * @param  caps   Output capability record.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Record copied
+  *         - UCAN_INVALID_PARAM: Null pointer input
+  *         - UCAN_ERROR_UNKNOWN_ID: peerId is not a peer of this node
+  *         - UCAN_NO_CONNECTION: The peer has not reported its capabilities yet
+  *
+  * @note   The master asks clients for their capabilities with a flag in its
+  *         pings, clients learn the master's from every ping. caps->common is
+  *         the set both sides support, use it to pick the mode of talking to
+  *         that peer (e.g. application defined faster rates via UCAN_CAP_APP()).
+  */
+UCAN_StatusTypeDef uCAN_GetPeerCaps(UCAN_HandleTypeDef* ucan, uint32_t peerId, UCAN_PeerCaps* caps)
+{
+    // Ensure handle is ready
+    UCAN_CHECK_READY(ucan);
+
+    if (caps == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_PeerCaps* record = NULL;
+
+#if UCAN_CFG_HAS_MASTER
+    if (UCAN_NODE_IS_MASTER(&ucan->node))
+    {
+        UCAN_Client clientKey = {.id = peerId};
+        UCAN_Client* client = bsearch(&clientKey, ucan->node.clients, ucan->node.clientCount, sizeof(UCAN_Client), uCAN_Runtime_CompareClientId);
+
+        if (client != NULL)
+        {
+            record = &client->caps;
+        }
+    }
+#endif
+#if UCAN_CFG_HAS_CLIENT
+    if (UCAN_NODE_IS_CLIENT(&ucan->node) && peerId == ucan->node.masterId)
+    {
+        record = &ucan->node.masterCaps;
+    }
+#endif
+#if !UCAN_CFG_HAS_MASTER && !UCAN_CFG_HAS_CLIENT
+    // No peers without a handshake role
+    (void)peerId;
+#endif
+
+    if (record == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    if (!record->valid)
+    {
+        return UCAN_NO_CONNECTION;
+    }
+
+    // Record is complete once valid is seen
+    __DMB();
+    *caps = *record;
+
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_HANDSHAKE */
+
+
+#if UCAN_CFG_HAS_MEMBERSHIP
+/**
+  * @brief  Query the membership view for a client.
+  * @param  ucan     Pointer to the initialized UCAN handle.
+  * @param  clientId CAN identifier of the client.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Client is ACTIVE according to the master
+  *         - UCAN_NO_CONNECTION: Client is absent, or (other nodes) no broadcast
+  *           was applied within UCAN_HANDSHAKE_LOST_MS
+  *         - UCAN_ERROR_UNKNOWN_ID: clientId is not in the client list
+  *
+  * @note   On the master the view is refreshed by uCAN_Handshake(), on other
+  *         nodes by the master's periodic membership broadcast. When the master
+  *         goes silent, or only sends broadcasts for a different client list,
+  *         the view of other nodes expires and every peer reads as absent. The view is a
+  *         bitmap indexed by client position, so once the position is known the
+  *         test is O(1); resolving the ID is a binary search over the client list.
+  *         Use it to skip traffic towards peers that are absent.
+  */
+UCAN_StatusTypeDef uCAN_IsClientActive(UCAN_HandleTypeDef* ucan, uint32_t clientId)
+{
+    // Ensure handle is ready
+    UCAN_CHECK_READY(ucan);
+
+    UCAN_Client clientKey = {.id = clientId};
+    UCAN_Client* client = bsearch(&clientKey, ucan->node.clients, ucan->node.clientCount, sizeof(UCAN_Client), uCAN_Runtime_CompareClientId);
+
+    if (client == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    if (!UCAN_NODE_IS_MASTER(&ucan->node))
+    {
+        // View taken from the master's broadcasts, stale once they stop
+        if (!(ucan->node.timeFlags & UCAN_NODE_TIME_MEMBERSHIP) ||
+            UCAN_TIME_SINCE(uCAN_Runtime_Now(&ucan->timebase), ucan->node.membershipTime) >= uCAN_Runtime_MsToTime(&ucan->timebase, UCAN_HANDSHAKE_LOST_MS))
+        {
+            return UCAN_NO_CONNECTION;
+        }
+    }
+
+    uint32_t index = (uint32_t)(client - ucan->node.clients);
+
+    return UCAN_MEMBERSHIP_GET(&ucan->node, index) ? UCAN_OK : UCAN_NO_CONNECTION;
+}
+#endif /* UCAN_CFG_HAS_MEMBERSHIP */
+
+#if UCAN_CFG_MONITOR
+/**
+  * @brief  Copy captured frames out of the monitor ring.
+  * @param  ucan      Pointer to the initialized UCAN handle (monitor mode).
+  * @param  frames    Destination array.
+  * @param  maxFrames Capacity of the destination array.
+  * @param  count     Output number of frames copied.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: At least one frame was copied
+  *         - UCAN_NO_CHANGED_VAL: The ring is empty
+  *         - UCAN_INVALID_PARAM: Null pointer input or monitor not enabled
+  *
+  * @note   Frames are returned oldest first. Must be called from a single
+  *         context; the RX interrupt may keep filling the ring meanwhile.
+  */
+UCAN_StatusTypeDef uCAN_MonitorRead(UCAN_HandleTypeDef* ucan, UCAN_MonitorFrame* frames, uint32_t maxFrames, uint32_t* count)
+{
+    // Ensure handle and CAN peripheral are ready
+    UCAN_CHECK_READY(ucan);
+
+    if (frames == NULL || count == NULL || ucan->monitor.frames == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_Monitor* monitor = &ucan->monitor;
+    uint32_t mask = monitor->size - 1U;
+    uint32_t tail = monitor->tail;
+    uint32_t available = monitor->head - tail;
+
+    // Entries up to head are complete once head is seen
+    __DMB();
+
+    uint32_t n = (available < maxFrames) ? available : maxFrames;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        frames[i] = monitor->frames[(tail + i) & mask];
+    }
+
+    // Copies are done before the slots are handed back
+    __DMB();
+    monitor->tail = tail + n;
+
+    *count = n;
+
+    return (n != 0U) ? UCAN_OK : UCAN_NO_CHANGED_VAL;
+}
+
+/**
+  * @brief  Get the oldest contiguous run of captured frames without copying.
+  * @param  ucan   Pointer to the initialized UCAN handle (monitor mode).
+  * @param  frames Output pointer to the first frame inside the ring.
+  * @param  count  Output number of contiguous frames available at frames.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: count frames are available
+  *         - UCAN_NO_CHANGED_VAL: The ring is empty
+  *         - UCAN_INVALID_PARAM: Null pointer input or monitor not enabled
+  *
+  * @note   Intended for bulk transfers (DMA to UART, SD card writes). The run
+  *         stops at the end of the ring storage, the remainder is returned by
+  *         the next call. The frames stay valid until uCAN_MonitorRelease().
+  */
+UCAN_StatusTypeDef uCAN_MonitorPeek(UCAN_HandleTypeDef* ucan, const UCAN_MonitorFrame** frames, uint32_t* count)
+{
+    // Ensure handle and CAN peripheral are ready
+    UCAN_CHECK_READY(ucan);
+
+    if (frames == NULL || count == NULL || ucan->monitor.frames == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_Monitor* monitor = &ucan->monitor;
+    uint32_t index = monitor->tail & (monitor->size - 1U);
+    uint32_t available = monitor->head - monitor->tail;
+    uint32_t untilEnd = monitor->size - index;
+
+    // Entries up to head are complete once head is seen
+    __DMB();
+
+    *frames = &monitor->frames[index];
+    *count = (available < untilEnd) ? available : untilEnd;
+
+    return (*count != 0U) ? UCAN_OK : UCAN_NO_CHANGED_VAL;
+}
+
+/**
+  * @brief  Hand frames obtained with uCAN_MonitorPeek() back to the ring.
+  * @param  ucan  Pointer to the initialized UCAN handle (monitor mode).
+  * @param  count Number of frames consumed, at most the count returned by the peek.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: The frames were released
+  *         - UCAN_INVALID_PARAM: Monitor not enabled or count exceeds the captured frames
+  */
+UCAN_StatusTypeDef uCAN_MonitorRelease(UCAN_HandleTypeDef* ucan, uint32_t count)
+{
+    // Ensure handle and CAN peripheral are ready
+    UCAN_CHECK_READY(ucan);
+
+    UCAN_Monitor* monitor = &ucan->monitor;
+
+    if (monitor->frames == NULL || count > (monitor->head - monitor->tail))
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    // Reader is done with the slots before they are reused
+    __DMB();
+    monitor->tail += count;
+
+    return UCAN_OK;
+}
+
+/**
+  * @brief  Move captured frames from the monitor ring into a log buffer.
+  * @param  ucan  Pointer to the initialized UCAN handle (monitor mode).
+  * @param  log   Encoder context of the log stream (see ucan_log.h).
+  * @param  out   Destination buffer, e.g. the next block of a file or UART DMA buffer.
+  * @param  space Free bytes in the destination buffer.
+  * @param  used  Output number of bytes written.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: At least one frame was appended
+  *         - UCAN_NO_CHANGED_VAL: The ring is empty
+  *         - UCAN_BUSY: The next record does not fit into the remaining space
+  *         - UCAN_INVALID_PARAM: Null pointer input or monitor not enabled
+  *
+  * @note   Records are encoded straight from the ring slots and each slot is
+  *         released only after its record was written, so no frame is lost
+  *         when the buffer fills up. Call again with a fresh buffer until
+  *         UCAN_NO_CHANGED_VAL is returned.
+  */
+UCAN_StatusTypeDef uCAN_MonitorDrainToLog(UCAN_HandleTypeDef* ucan, UCAN_LogContext* log, uint8_t* out, uint32_t space, uint32_t* used)
+{
+    // Ensure handle and CAN peripheral are ready
+    UCAN_CHECK_READY(ucan);
+
+    if (log == NULL || out == NULL || used == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    const UCAN_MonitorFrame* frames;
+    uint32_t count;
+    uint32_t written = 0;
+    UCAN_StatusTypeDef status = UCAN_NO_CHANGED_VAL;
+
+    *used = 0;
+
+    // At most two contiguous runs: up to the end of the ring, then the wrapped part
+    while (uCAN_MonitorPeek(ucan, &frames, &count) == UCAN_OK)
+    {
+        uint32_t encoded = 0;
+
+        while (encoded < count)
+        {
+            uint32_t len = uCAN_LogEncode(log, &frames[encoded], &out[written], space - written);
+
+            if (len == 0U)
+            {
+                break;
+            }
+
+            written += len;
+            encoded++;
+        }
+
+        uCAN_MonitorRelease(ucan, encoded);
+        *used = written;
+
+        if (encoded < count)
+        {
+            // Buffer full, the remaining frames stay in the ring
+            return UCAN_BUSY;
+        }
+
+        status = UCAN_OK;
+    }
+
+    return status;
+}
+#endif /* UCAN_CFG_MONITOR */
+
+#if UCAN_CFG_HW_TIMESTAMP
+/**
+  * @brief  Record the hardware transmit confirmation of a TX mailbox.
+  * @param  ucan    Pointer to the initialized UCAN handle.
+  * @param  mailbox Completed mailbox (CAN_TX_MAILBOX0, CAN_TX_MAILBOX1 or CAN_TX_MAILBOX2).
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Confirmation recorded for a TX packet or the handshake ping
+  *         - UCAN_INVALID_PARAM: Unknown mailbox value
+  *         - UCAN_ERROR_UNKNOWN_ID: The mailbox carried a frame that is not a TX packet
+  *
+  * @note   Call from the HAL_CAN_TxMailboxxCompleteCallback() functions, which
+  *         UCAN_CFG_HAL_CALLBACKS does on its own. The timestamp is the TTCM
+  *         counter latched by the controller at the SOF of the frame, so it
+  *         does not include interrupt latency.
+  */
+UCAN_StatusTypeDef uCAN_TxComplete(UCAN_HandleTypeDef* ucan, uint32_t mailbox)
+{
+    // Ensure handle and CAN peripheral are ready
+    UCAN_CHECK_READY(ucan);
+
+    uint32_t index;
+
+    switch (mailbox)
+    {
+        case CAN_TX_MAILBOX0: index = 0; break;
+        case CAN_TX_MAILBOX1: index = 1; break;
+        case CAN_TX_MAILBOX2: index = 2; break;
+        default: return UCAN_INVALID_PARAM;
+    }
+
+    // The identifier register keeps the sent ID after transmission
+    uint32_t tir = ucan->hcan->Instance->sTxMailBox[index].TIR;
+
+    if (tir & CAN_TI0R_IDE)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    uint32_t id = (tir & CAN_TI0R_STID) >> CAN_TI0R_STID_Pos;
+    uint16_t raw = (uint16_t)HAL_CAN_GetTxTimestamp(ucan->hcan, mailbox);
+    uint64_t hwTime = uCAN_Runtime_ExtendTimestamp(&ucan->clock, raw, uCAN_Runtime_TimeToMs(&ucan->timebase, uCAN_Runtime_Now(&ucan->timebase)));
+
+#if UCAN_CFG_HAS_MASTER
+    // Handshake ping, reference point of the client round trips
+    if (UCAN_NODE_IS_MASTER(&ucan->node) && id == ucan->node.selfId)
+    {
+        ucan->node.pingTime = hwTime;
+        ucan->node.timeFlags |= UCAN_NODE_TIME_PING_HW;
+        return UCAN_OK;
+    }
+#endif
+
+    UCAN_Packet packetKey = {.id = id};
+    UCAN_Packet* packet = bsearch(&packetKey, ucan->txHolder.packets, ucan->txHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+
+    if (packet == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    uCAN_Runtime_UpdateTiming(&packet->timing, hwTime);
+
+    return UCAN_OK;
+}
+
+/**
+  * @brief  Read the hardware timing of a TX or RX packet.
+  * @param  ucan   Pointer to the initialized UCAN handle.
+  * @param  id     CAN identifier of the packet.
+  * @param  result Output snapshot, in microseconds.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Snapshot copied
+  *         - UCAN_NO_CHANGED_VAL: No frame or confirmation recorded yet
+  *         - UCAN_INVALID_PARAM: Null pointer input
+  *         - UCAN_ERROR_UNKNOWN_ID: No TX or RX packet with this ID
+  *         - UCAN_BUSY: The packet kept being updated during the copy, try again later
+  *
+  * @note   RX packets are timed at frame reception, TX packets at transmit
+  *         confirmation (see uCAN_TxComplete()). The period extremes cover the
+  *         whole run since uCAN_Start().
+  */
+UCAN_StatusTypeDef uCAN_GetPacketTiming(UCAN_HandleTypeDef* ucan, uint32_t id, UCAN_PacketTimingResult* result)
+{
+    // Ensure handle is ready
+    UCAN_CHECK_READY(ucan);
+
+    if (result == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_Packet packetKey = {.id = id};
+    UCAN_Packet* packet = bsearch(&packetKey, ucan->rxHolder.packets, ucan->rxHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+
+    if (packet == NULL)
+    {
+        packet = bsearch(&packetKey, ucan->txHolder.packets, ucan->txHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+    }
+
+    if (packet == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    UCAN_PacketTiming* timing = &packet->timing;
+
+    for (uint32_t attempt = 0; attempt < UCAN_TIMING_READ_RETRIES; attempt++)
+    {
+        uint32_t seq = timing->seq;
+
+        // Writer in progress, retry
+        if (seq & 1U)
+        {
+            continue;
+        }
+        __DMB();
+
+        UCAN_PacketTiming copy = *timing;
+
+        __DMB();
+        if (timing->seq != seq)
+        {
+            // Block changed while copying, retry
+            continue;
+        }
+
+        if (copy.count == 0)
+        {
+            return UCAN_NO_CHANGED_VAL;
+        }
+
+        result->count = copy.count;
+        result->timeUs = uCAN_Runtime_BitsToUs(&ucan->clock, copy.time);
+        result->periodUs = (uint32_t)uCAN_Runtime_BitsToUs(&ucan->clock, copy.period);
+        result->periodMinUs = (uint32_t)uCAN_Runtime_BitsToUs(&ucan->clock, copy.periodMin);
+        result->periodMaxUs = (uint32_t)uCAN_Runtime_BitsToUs(&ucan->clock, copy.periodMax);
+        result->jitterUs = result->periodMaxUs - result->periodMinUs;
+
+        return UCAN_OK;
+    }
+
+    return UCAN_BUSY;
+}
+#endif /* UCAN_CFG_HW_TIMESTAMP */
+
+#if UCAN_CFG_SCHEDULE
+/**
+  * @brief  Run the time-triggered transmit schedule.
+  * @param  ucan   Pointer to the initialized UCAN handle with a schedule.
+  * @param  nextUs Output microseconds until the schedule needs the next call.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Due windows sent (time master: reference message sent at cycle start)
+  *         - UCAN_NO_CONNECTION: Client has no valid cycle reference, nothing was sent
+  *         - UCAN_BUSY: A reference message was being recorded, call again
+  *         - UCAN_ERROR: A frame could not be queued
+  *         - UCAN_INVALID_PARAM: Null pointer input or no schedule configured
+  *
+  * @note   Call from a timer interrupt using the same time source as the
+  *         schedule: either periodically (the tick period adds to the send
+  *         jitter) or as a one-shot timer reprogrammed with `*nextUs`. Clients
+  *         should also call it right after uCAN_Update() in the RX interrupt,
+  *         so windows early in the cycle are not missed.
+  */
+UCAN_StatusTypeDef uCAN_ScheduleTick(UCAN_HandleTypeDef* ucan, uint32_t* nextUs)
+{
+    // Ensure handle and CAN peripheral are ready
+    UCAN_CHECK_READY(ucan);
+
+    if (ucan->schedule == NULL || nextUs == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    return uCAN_Runtime_RunSchedule(ucan->bus, ucan->schedule, nextUs);
+}
+#endif /* UCAN_CFG_SCHEDULE */
+
+/**
+  * @brief  Send a single TX packet immediately with its current variable values.
+  *
+  * The payload is latched like a TX set of uCAN_SendAll(), so a multi-byte
+  * variable updated by an interrupt is never sent torn.
+  *
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @param  id   CAN identifier of a TX packet.
+  * @retval UCAN_StatusTypeDef Status of the send operation:
+  *         - UCAN_OK: Frame queued in a mailbox
+  *         - UCAN_BUSY: No mailbox available to the packet's class, or a
+  *           double-buffered overlay was being written by a preempted context
+  *         - UCAN_ERROR_UNKNOWN_ID: No TX packet with this ID
+  *         - UCAN_ERROR: HAL CAN transmission failed
+  *
+  * @note   Intended for event-driven frames such as emergency messages. A
+  *         packet configured with `critical` set may use the reserved
+  *         mailboxes (UCAN_CFG_RESERVED_MAILBOXES set to 1 or 2), so the call
+  *         never waits behind a bulk burst of uCAN_SendAll(): while at most
+  *         UCAN_CFG_RESERVED_MAILBOXES critical frames are pending, a mailbox
+  *         is guaranteed free and the frame is queued in a constant number of
+  *         register accesses. The HAL transmit path is not reentrant, so
+  *         call this function from the same priority level as uCAN_SendAll().
+  */
+UCAN_StatusTypeDef uCAN_Send(UCAN_HandleTypeDef* ucan, uint32_t id)
+{
+    UCAN_CHECK_READY(ucan);
+
+    UCAN_Packet packetKey = {.id = id};
+    UCAN_Packet* packet = bsearch(&packetKey, ucan->txHolder.packets, ucan->txHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+
+    if (packet == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    return uCAN_Runtime_SendPacket(ucan->bus, packet);
+}
+
+#if UCAN_CFG_OVERLAY
+/**
+  * @brief  Copy the latest payload of an overlay packet into a caller struct.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @param  id   CAN identifier of an RX or TX packet bound to an overlay.
+  * @param  dst  Destination struct of the overlay's size.
+  * @retval UCAN_StatusTypeDef Status of the read:
+  *         - UCAN_OK: Payload copied
+  *         - UCAN_BUSY: Payload kept changing, retry later
+  *         - UCAN_ERROR_UNKNOWN_ID: No packet with this ID
+  *         - UCAN_INVALID_PARAM: NULL pointer or packet without overlay
+  *
+  * @note   For double-buffered overlays the copy is never torn, even if a
+  *         frame arrives while copying. Direct overlays are copied as they are
+  *         and give no such guarantee.
+  */
+UCAN_StatusTypeDef uCAN_OverlayRead(UCAN_HandleTypeDef* ucan, uint32_t id, void* dst)
+{
+    UCAN_CHECK_READY(ucan);
+
+    if (dst == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_Packet packetKey = {.id = id};
+    UCAN_Packet* packet = bsearch(&packetKey, ucan->rxHolder.packets, ucan->rxHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+
+    if (packet == NULL)
+    {
+        packet = bsearch(&packetKey, ucan->txHolder.packets, ucan->txHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+    }
+
+    if (packet == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    if (packet->overlay == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    return uCAN_Runtime_LoadOverlay(packet, (uint8_t*)dst);
+}
+
+/**
+  * @brief  Publish a new payload for a double-buffered TX overlay packet.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @param  id   CAN identifier of a TX packet with a double-buffered overlay.
+  * @param  src  Source struct of the overlay's size.
+  * @retval UCAN_StatusTypeDef Status of the write:
+  *         - UCAN_OK: Payload published
+  *         - UCAN_ERROR_UNKNOWN_ID: No TX packet with this ID
+  *         - UCAN_INVALID_PARAM: NULL pointer or packet without double-buffered overlay
+  *
+  * @note   The payload is written into the back buffer and becomes visible to
+  *         uCAN_SendAll() / uCAN_Send() as a whole. Only one context may write
+  *         a given packet.
+  */
+UCAN_StatusTypeDef uCAN_OverlayWrite(UCAN_HandleTypeDef* ucan, uint32_t id, const void* src)
+{
+    UCAN_CHECK_READY(ucan);
+
+    if (src == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_Packet packetKey = {.id = id};
+    UCAN_Packet* packet = bsearch(&packetKey, ucan->txHolder.packets, ucan->txHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+
+    if (packet == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    if (packet->overlay == NULL || !packet->overlayDouble)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    uCAN_Runtime_StoreOverlay(packet, (const uint8_t*)src);
+
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_OVERLAY */
+
+/**
+  * @brief  Read the health and traffic counters of one bus.
+  * @param  ucan   Pointer to the initialized UCAN handle.
+  * @param  bus    0 for the primary controller, 1 for the redundant one.
+  * @param  health Output snapshot.
+  * @retval UCAN_StatusTypeDef Status of the query:
+  *         - UCAN_OK: Snapshot filled
+  *         - UCAN_INVALID_PARAM: NULL pointer or no controller on this bus
+  *
+  * @note   A bus-off controller is FAILED and no longer gets frames queued.
+  *         An error passive controller is DEGRADED, and so is a bus that
+  *         received nothing for UCAN_REDUNDANT_SILENCE_MS while the other
+  *         bus of the pair did. Counters are updated by the RX and TX paths
+  *         and are read without locking.
+  */
+UCAN_StatusTypeDef uCAN_GetBusHealth(UCAN_HandleTypeDef* ucan, uint32_t bus, UCAN_BusHealth* health)
+{
+    UCAN_CHECK_READY(ucan);
+
+    if (health == NULL || bus >= UCAN_BUS_COUNT || ucan->bus[bus].hcan == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_Bus* self = &ucan->bus[bus];
+    uint32_t esr = self->hcan->Instance->ESR;
+    UCAN_Time now = uCAN_Runtime_Now(&ucan->timebase);
+    UCAN_Time silence = uCAN_Runtime_MsToTime(&ucan->timebase, UCAN_REDUNDANT_SILENCE_MS);
+    UCAN_Time age = 0;
+    uint8_t heard = (self->flags & UCAN_BUS_FLAG_RX) != 0U;
+
+    if (heard)
+    {
+        __DMB();
+        age = UCAN_TIME_SINCE(now, uCAN_Runtime_LoadTime(&self->lastRxTime));
+    }
+
+    health->tec = (uint8_t)((esr & CAN_ESR_TEC) >> CAN_ESR_TEC_Pos);
+    health->rec = (uint8_t)((esr & CAN_ESR_REC) >> CAN_ESR_REC_Pos);
+    health->silentMs = 0xFFFFFFFFU;
+
+    if (heard)
+    {
+        uint64_t ms = age / ucan->timebase.countsPerMs;
+        health->silentMs = (ms < 0xFFFFFFFFU) ? (uint32_t)ms : 0xFFFFFFFEU;
+    }
+
+    uint8_t busOff = (esr & CAN_ESR_BOFF) != 0U;
+
+#if UCAN_CFG_FAULT
+    // Bus-off held by the running fault scenario
+    if (self->fault != NULL && uCAN_Runtime_FaultBusOff(self->fault, (uint8_t)bus))
+    {
+        busOff = 1;
+    }
+#endif
+
+    if (busOff)
+    {
+        health->status = UCAN_BUS_FAILED;
+    }
+    else if (esr & CAN_ESR_EPVF)
+    {
+        health->status = UCAN_BUS_DEGRADED;
+    }
+    else
+    {
+        health->status = UCAN_BUS_OK;
+
+#if UCAN_CFG_REDUNDANT
+        UCAN_Bus* other = &ucan->bus[bus ^ 1U];
+
+        // Silent while the other bus of the pair carries traffic
+        if ((!heard || age > silence) && other->hcan != NULL && (other->flags & UCAN_BUS_FLAG_RX))
+        {
+            __DMB();
+
+            if (UCAN_TIME_SINCE(now, uCAN_Runtime_LoadTime(&other->lastRxTime)) <= silence)
+            {
+                health->status = UCAN_BUS_DEGRADED;
+            }
+        }
+#else
+        (void)silence;
+#endif
+    }
+
+    health->rxFrames = self->rxFrames;
+    health->rxDuplicates = self->rxDuplicates;
+    health->txFrames = self->txFrames;
+    health->txSkipped = self->txSkipped;
+
+    return UCAN_OK;
+}
+
+#if UCAN_CFG_LATENCY
+/**
+  * @brief  Marks the instant at which the value of a traced TX packet was sampled.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @param  id   CAN identifier of a traced TX packet.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Sample time recorded
+  *         - UCAN_ERROR_UNKNOWN_ID: No TX packet with this ID
+  *         - UCAN_INVALID_PARAM: Packet is not traced
+  *
+  * @note   Call it right after the application wrote the packet's variables
+  *         (e.g. after reading the sensor). The next frame of the packet
+  *         reports the time from here to its transmission as the producer
+  *         stage. Without a mark, the sample instant is the latch of
+  *         uCAN_SendAll() or the call of uCAN_Send().
+  */
+UCAN_StatusTypeDef uCAN_LatencySample(UCAN_HandleTypeDef* ucan, uint32_t id)
+{
+    UCAN_CHECK_READY(ucan);
+
+    UCAN_Packet packetKey = {.id = id};
+    UCAN_Packet* packet = bsearch(&packetKey, ucan->txHolder.packets, ucan->txHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+
+    if (packet == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    if (packet->latency == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    // Time first, the flag tells the TX path it is valid
+    packet->latency->sampleTime = uCAN_Runtime_Now(&ucan->timebase);
+    __DMB();
+    packet->latency->sampled = 1;
+
+    return UCAN_OK;
+}
+
+/**
+  * @brief  Marks the use of the latest value of a traced RX packet.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @param  id   CAN identifier of a traced RX packet.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Latency of the latest frame added to the statistics
+  *         - UCAN_NO_CHANGED_VAL: No frame received since the last use
+  *         - UCAN_ERROR_UNKNOWN_ID: No RX packet with this ID
+  *         - UCAN_INVALID_PARAM: Packet is not traced
+  *         - UCAN_BUSY: Frame record kept changing, try again
+  *
+  * @note   Call it where the application acts on the value, e.g. in the
+  *         control loop right before the received variables are read. The
+  *         time from reception to here is the consumer stage. Each frame is
+  *         counted on its first use only. Call it from the same context as
+  *         uCAN_GetLatency().
+  */
+UCAN_StatusTypeDef uCAN_LatencyUse(UCAN_HandleTypeDef* ucan, uint32_t id)
+{
+    UCAN_CHECK_READY(ucan);
+
+    UCAN_Packet packetKey = {.id = id};
+    UCAN_Packet* packet = bsearch(&packetKey, ucan->rxHolder.packets, ucan->rxHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+
+    if (packet == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    if (packet->latency == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    return uCAN_Runtime_UseLatency(packet->latency, uCAN_Runtime_Now(&ucan->timebase));
+}
+
+/**
+  * @brief  Reads the sample-to-use latency statistics of a traced RX packet.
+  * @param  ucan   Pointer to the initialized UCAN handle.
+  * @param  id     CAN identifier of a traced RX packet.
+  * @param  result Output statistics per stage and histogram of the total.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Snapshot filled
+  *         - UCAN_ERROR_UNKNOWN_ID: No RX packet with this ID
+  *         - UCAN_INVALID_PARAM: NULL result or packet is not traced
+  *
+  * @note   Stages are reported in microseconds. The bus stage compares the
+  *         producer's queue stamp with the local reception time, so it is
+  *         only meaningful when both nodes run their timebase from a common,
+  *         synchronized clock. The producer and consumer stages are measured
+  *         on one node each and are always valid.
+  */
+UCAN_StatusTypeDef uCAN_GetLatency(UCAN_HandleTypeDef* ucan, uint32_t id, UCAN_LatencyResult* result)
+{
+    UCAN_CHECK_READY(ucan);
+
+    if (result == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_Packet packetKey = {.id = id};
+    UCAN_Packet* packet = bsearch(&packetKey, ucan->rxHolder.packets, ucan->rxHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+
+    if (packet == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    UCAN_LatencyStats* latency = packet->latency;
+
+    if (latency == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    result->count = latency->count;
+    result->frames = latency->frames;
+    result->lost = latency->lost;
+
+    for (uint8_t i = 0; i < UCAN_LATENCY_STAGES; i++)
+    {
+        const UCAN_LatencySpan* span = &latency->spans[i];
+
+        result->stage[i].minUs = (latency->count != 0U) ? span->min : 0U;
+        result->stage[i].maxUs = (latency->count != 0U) ? span->max : 0U;
+        result->stage[i].meanUs = (latency->count != 0U) ? (uint32_t)(span->sum / latency->count) : 0U;
+    }
+
+    for (uint8_t k = 0; k < UCAN_LATENCY_BUCKETS; k++)
+    {
+        result->histogram[k] = latency->histogram[k];
+    }
+
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_LATENCY */
+
+/**
+  * @brief  Process a batch of frames received outside the controller's RX FIFO.
+  * @param  ucan   Pointer to the initialized UCAN handle.
+  * @param  frames Frames in arrival order, e.g. a DMA buffer, a gateway queue or a log replay.
+  * @param  count  Number of frames.
+  * @retval UCAN_StatusTypeDef Status of the batch:
+  *         - UCAN_OK: All frames processed
+  *         - UCAN_INVALID_PARAM: frames is NULL
+  *         - UCAN_ERROR_UNKNOWN_ID / handshake errors: Last failure of a frame,
+  *           the remaining frames are still processed
+  *
+  * @note   Frames are taken UCAN_BATCH_CHUNK at a time: all identifiers of a
+  *         chunk are classified first in one tight loop over the RX lookup
+  *         (see UCAN_CFG_RX_INDEX), then the frames are delivered to their
+  *         packets, or to the handshake if unknown, in their original order.
+  *         Reception times are derived from each frame's tick. Frames carry
+  *         no hardware time and do not drive the transmit schedule; extended
+  *         and remote frames are skipped, as in uCAN_Update(). Call it from the context that runs
+  *         uCAN_Update(), or with the RX interrupt masked.
+  */
+UCAN_StatusTypeDef uCAN_UpdateBatch(UCAN_HandleTypeDef* ucan, const UCAN_MonitorFrame* frames, uint32_t count)
+{
+    UCAN_CHECK_READY(ucan);
+
+    if (frames == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_StatusTypeDef status = UCAN_OK;
+    UCAN_Time now = uCAN_Runtime_Now(&ucan->timebase);
+    uint32_t nowMs = uCAN_Runtime_TimeToMs(&ucan->timebase, now);
+    UCAN_Packet* targets[UCAN_BATCH_CHUNK];
+
+    for (uint32_t base = 0; base < count; base += UCAN_BATCH_CHUNK)
+    {
+        const UCAN_MonitorFrame* chunk = &frames[base];
+        uint32_t n = (count - base < UCAN_BATCH_CHUNK) ? (count - base) : UCAN_BATCH_CHUNK;
+
+        // Classify the whole chunk first
+        for (uint32_t i = 0; i < n; i++)
+        {
+            targets[i] = (chunk[i].flags & (UCAN_MONITOR_FLAG_EXT | UCAN_MONITOR_FLAG_RTR)) ? NULL : uCAN_Runtime_FindPacket(&ucan->rxHolder, chunk[i].id);
+        }
+
+        // Deliver in arrival order
+        for (uint32_t i = 0; i < n; i++)
+        {
+            const UCAN_MonitorFrame* frame = &chunk[i];
+
+            // No payload to deliver
+            if (frame->flags & (UCAN_MONITOR_FLAG_EXT | UCAN_MONITOR_FLAG_RTR))
+            {
+                continue;
+            }
+
+            // Place the frame's tick on the timebase, a tick from the future counts as now
+            uint32_t ageMs = nowMs - frame->tick;
+            UCAN_Time age = (ageMs < 0x80000000U) ? uCAN_Runtime_MsToTime(&ucan->timebase, ageMs) : 0U;
+            UCAN_Time time = now - ((age < now) ? age : now);
+
+            UCAN_TRACE(UCAN_TRACE_RX, frame->id);
+
+            if (targets[i] != NULL)
+            {
+                (void)uCAN_Runtime_DeliverPacket(targets[i], frame->data, frame->dlc, frame->tick, time, 0U);
+                continue;
+            }
+
+#if UCAN_CFG_HANDSHAKE
+            uint8_t data[8];
+
+            for (uint8_t k = 0; k < 8U; k++)
+            {
+                data[k] = frame->data[k];
+            }
+
+            UCAN_StatusTypeDef handshakeStatus = uCAN_Runtime_UpdateHandshake(&ucan->node, ucan->bus, frame->id, data, frame->dlc, 0U);
+
+            if (handshakeStatus != UCAN_OK)
+            {
+                status = handshakeStatus;
+            }
+#else
+            status = UCAN_ERROR_UNKNOWN_ID;
+#endif
+        }
+    }
+
+    return status;
+}
+
+#if UCAN_CFG_TRIGGER
+/**
+  * @brief  Copy trigger hits out of the event queue.
+  * @param  ucan      Pointer to the initialized UCAN handle.
+  * @param  events    Destination array.
+  * @param  maxEvents Capacity of the destination array.
+  * @param  count     Output number of events copied.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: At least one event was copied
+  *         - UCAN_NO_CHANGED_VAL: No trigger has fired since the last call
+  *         - UCAN_INVALID_PARAM: Null pointer input or no event queue
+  *
+  * @note   Events are returned oldest first. Replaces polling the signals:
+  *         the conditions are checked by the RX path as each frame arrives.
+  *         Must be called from a single context.
+  */
+UCAN_StatusTypeDef uCAN_ReadEvents(UCAN_HandleTypeDef* ucan, UCAN_TriggerEvent* events, uint32_t maxEvents, uint32_t* count)
+{
+    // Ensure handle and CAN peripheral are ready
+    UCAN_CHECK_READY(ucan);
+
+    if (events == NULL || count == NULL || ucan->events.events == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_EventQueue* queue = &ucan->events;
+    uint32_t mask = queue->size - 1U;
+    uint32_t tail = queue->tail;
+    uint32_t available = queue->head - tail;
+
+    // Entries up to head are complete once head is seen
+    __DMB();
+
+    uint32_t n = (available < maxEvents) ? available : maxEvents;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        events[i] = queue->events[(tail + i) & mask];
+    }
+
+    // Copies are done before the slots are handed back
+    __DMB();
+    queue->tail = tail + n;
+
+    *count = n;
+
+    return (n != 0U) ? UCAN_OK : UCAN_NO_CHANGED_VAL;
+}
+#endif
+
+#if UCAN_CFG_FAULT
+/**
+  * @brief  Tells whether the handshake of the node looks healthy.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @retval uint8_t 1 if every client is active (master) or the last ping is
+  *         younger than UCAN_HANDSHAKE_TIMEOUT_MS (client), 1 without handshake.
+  */
+static uint8_t uCAN_FaultConnectionOk(UCAN_HandleTypeDef* ucan)
+{
+#if UCAN_CFG_HAS_MASTER
+    if (UCAN_NODE_IS_MASTER(&ucan->node))
+    {
+        for (uint32_t i = 0; i < ucan->node.clientCount; i++)
+        {
+            if (ucan->node.clients[i].status != UCAN_CONN_ACTIVE)
+            {
+                return 0;
+            }
+        }
+    }
+#endif
+
+#if UCAN_CFG_HAS_CLIENT
+    if (UCAN_NODE_IS_CLIENT(&ucan->node))
+    {
+        if (!(ucan->node.timeFlags & UCAN_NODE_TIME_SENT))
+        {
+            return 0;
+        }
+        __DMB();
+
+        UCAN_Time now = uCAN_Runtime_Now(&ucan->timebase);
+
+        return UCAN_TIME_SINCE(now, uCAN_Runtime_LoadTime(&ucan->node.sentTime)) <=
+               uCAN_Runtime_MsToTime(&ucan->timebase, UCAN_HANDSHAKE_TIMEOUT_MS);
+    }
+#endif
+
+    (void)ucan;
+    return 1;
+}
+
+/**
+  * @brief  Tells whether every wired bus is reported as UCAN_BUS_OK.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @retval uint8_t 1 if all buses are healthy.
+  */
+static uint8_t uCAN_FaultBusOk(UCAN_HandleTypeDef* ucan)
+{
+    for (uint32_t b = 0; b < UCAN_BUS_COUNT; b++)
+    {
+        UCAN_BusHealth health;
+
+        if (ucan->bus[b].hcan == NULL)
+        {
+            continue;
+        }
+
+        if (uCAN_GetBusHealth(ucan, b, &health) != UCAN_OK || health.status != UCAN_BUS_OK)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+  * @brief  Advances the fault episode of one monitor.
+  * @param  metric   Pointer to the monitor's figures.
+  * @param  timebase Pointer to the handle timebase.
+  * @param  now      Current time without injected drift.
+  * @param  faulted  1 while a fault step is active.
+  * @param  healthy  1 while the monitor reports healthy.
+  */
+static void uCAN_FaultTrack(UCAN_FaultMetric* metric, const UCAN_Timebase* timebase, UCAN_Time now, uint8_t faulted, uint8_t healthy)
+{
+    uint8_t phase = metric->state & (uint8_t)~UCAN_FAULT_STATE_CLEARED;
+
+    if (phase == UCAN_FAULT_STATE_IDLE)
+    {
+        if (!faulted)
+        {
+            return;
+        }
+
+        // First window of a new episode
+        metric->episodes++;
+        metric->faultTime = now;
+        metric->state = UCAN_FAULT_STATE_OPEN;
+        phase = UCAN_FAULT_STATE_OPEN;
+    }
+
+    if (phase == UCAN_FAULT_STATE_OPEN && !healthy)
+    {
+        uint64_t us = uCAN_Runtime_TimeToUs(timebase, now - metric->faultTime);
+
+        metric->lastDetectUs = (us < 0xFFFFFFFFU) ? (uint32_t)us : 0xFFFFFFFFU;
+        if (metric->lastDetectUs > metric->worstDetectUs)
+        {
+            metric->worstDetectUs = metric->lastDetectUs;
+        }
+
+        metric->detected++;
+        metric->state = (metric->state & UCAN_FAULT_STATE_CLEARED) | UCAN_FAULT_STATE_DETECTED;
+        phase = UCAN_FAULT_STATE_DETECTED;
+    }
+
+    if (faulted)
+    {
+        // A window is (again) open, recovery is timed from its end
+        metric->state = phase;
+        return;
+    }
+
+    if (!(metric->state & UCAN_FAULT_STATE_CLEARED))
+    {
+        metric->clearTime = now;
+        metric->state |= UCAN_FAULT_STATE_CLEARED;
+    }
+
+    if (!healthy)
+    {
+        return;
+    }
+
+    if (phase == UCAN_FAULT_STATE_DETECTED)
+    {
+        uint64_t us = uCAN_Runtime_TimeToUs(timebase, now - metric->clearTime);
+
+        metric->lastRecoverUs = (us < 0xFFFFFFFFU) ? (uint32_t)us : 0xFFFFFFFFU;
+        if (metric->lastRecoverUs > metric->worstRecoverUs)
+        {
+            metric->worstRecoverUs = metric->lastRecoverUs;
+        }
+
+        metric->recovered++;
+    }
+    else if (UCAN_TIME_SINCE(now, metric->clearTime) < uCAN_Runtime_MsToTime(timebase, UCAN_FAULT_SETTLE_MS))
+    {
+        // Not seen yet, the monitor may still be on its way
+        return;
+    }
+
+    metric->state = UCAN_FAULT_STATE_IDLE;
+}
+
+/**
+  * @brief  Start, restart or stop a fault injection scenario.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @param  plan Scenario to run, NULL to stop injecting.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Scenario started (or stopped)
+  *         - UCAN_INVALID_PARAM: Too many steps, unknown kind or drift of 1000000 ppm or more
+  *
+  * @note   Step windows are timed from this call. Step counters and both
+  *         monitors are reset, and injected clock drift of a previous
+  *         scenario is kept in the timebase, so time never jumps back.
+  *         Only for test builds, see UCAN_CFG_FAULT.
+  */
+UCAN_StatusTypeDef uCAN_FaultStart(UCAN_HandleTypeDef* ucan, UCAN_FaultPlan* plan)
+{
+    // Ensure handle is ready
+    UCAN_CHECK_READY(ucan);
+
+    if (plan != NULL)
+    {
+        if ((plan->steps == NULL && plan->stepCount != 0U) || plan->stepCount > UCAN_FAULT_MAX_STEPS)
+        {
+            return UCAN_INVALID_PARAM;
+        }
+
+        for (uint32_t n = 0; n < plan->stepCount; n++)
+        {
+            const UCAN_FaultStep* step = &plan->steps[n];
+
+            if (step->kind > UCAN_FAULT_CLOCK_DRIFT ||
+                (step->kind == UCAN_FAULT_CLOCK_DRIFT && ((int32_t)step->param <= -1000000 || (int32_t)step->param >= 1000000)))
+            {
+                return UCAN_INVALID_PARAM;
+            }
+        }
+    }
+
+    // Unhook the running scenario before anything is reset
+    for (uint32_t b = 0; b < UCAN_BUS_COUNT; b++)
+    {
+        ucan->bus[b].fault = NULL;
+    }
+    ucan->fault = NULL;
+    uCAN_Runtime_FaultStop(&ucan->timebase);
+
+    if (plan == NULL)
+    {
+        return UCAN_OK;
+    }
+
+    uCAN_Runtime_FaultStart(plan, &ucan->timebase);
+
+    // Scenario is reset before the hooks see it
+    __DMB();
+    for (uint32_t b = 0; b < UCAN_BUS_COUNT; b++)
+    {
+        ucan->bus[b].fault = plan;
+    }
+    ucan->fault = plan;
+
+    return UCAN_OK;
+}
+
+/**
+  * @brief  Drive the running fault scenario and measure the node's reaction.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @retval UCAN_StatusTypeDef
+  *         - UCAN_OK: Every window has ended and both monitors settled, the results are final
+  *         - UCAN_BUSY: Scenario still running
+  *         - UCAN_INVALID_PARAM: No scenario started
+  *
+  * @note   Opens and closes the step windows, applies clock drift, babbles,
+  *         and updates UCAN_FaultPlan.connection and .bus. Call it
+  *         periodically from the main loop, after uCAN_Handshake(); the call
+  *         period is the resolution of all windows and measured times.
+  */
+UCAN_StatusTypeDef uCAN_FaultPoll(UCAN_HandleTypeDef* ucan)
+{
+    // Ensure handle is ready
+    UCAN_CHECK_READY(ucan);
+
+    UCAN_FaultPlan* plan = ucan->fault;
+
+    if (plan == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_Time now = uCAN_Runtime_FaultUpdate(ucan->bus, plan, &ucan->timebase);
+    uint8_t faulted = (plan->active != 0U);
+    uint32_t elapsedMs = uCAN_Runtime_TimeToMs(&ucan->timebase, now - plan->startTime);
+    uint8_t pending = faulted;
+
+    uCAN_FaultTrack(&plan->connection, &ucan->timebase, now, faulted, uCAN_FaultConnectionOk(ucan));
+    uCAN_FaultTrack(&plan->bus, &ucan->timebase, now, faulted, uCAN_FaultBusOk(ucan));
+
+    // Windows still to come
+    for (uint32_t n = 0; n < plan->stepCount && !pending; n++)
+    {
+        pending = (plan->steps[n].durationMs != 0U && elapsedMs < plan->steps[n].startMs);
+    }
+
+    if (pending || plan->connection.state != UCAN_FAULT_STATE_IDLE || plan->bus.state != UCAN_FAULT_STATE_IDLE)
+    {
+        return UCAN_BUSY;
+    }
+
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_FAULT */
+
+#if UCAN_CFG_LAZY
+/**
+  * @brief  Decode the last received frame of a lazy packet into its bound variables.
+  * @param  ucan Pointer to the initialized UCAN handle.
+  * @param  id   CAN identifier of an RX packet configured with `lazy`.
+  * @param  time Optional output reception time on the handle timebase, may be NULL.
+  * @retval UCAN_StatusTypeDef Status of the decode:
+  *         - UCAN_OK: A new frame was written to the bound variables
+  *         - UCAN_NO_CHANGED_VAL: No frame since the last call, variables untouched
+  *         - UCAN_BUSY: Frames kept arriving while copying, retry later
+  *         - UCAN_ERROR_UNKNOWN_ID: No RX packet with this ID
+  *         - UCAN_INVALID_PARAM: Packet is not lazy
+  *
+  * @note   The RX path of a lazy packet only stores the raw frame, so its
+  *         cost does not grow with the number of signals. The decoding work
+  *         moves here and is only paid for the values actually read.
+  *         Call from a single context per packet.
+  */
+UCAN_StatusTypeDef uCAN_Unpack(UCAN_HandleTypeDef* ucan, uint32_t id, UCAN_Time* time)
+{
+    // Ensure handle is ready
+    UCAN_CHECK_READY(ucan);
+
+    UCAN_Packet* packet = uCAN_Runtime_FindPacket(&ucan->rxHolder, id);
+
+    if (packet == NULL)
+    {
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    if (!packet->lazy)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    uint8_t data[8];
+    uint32_t seq;
+    UCAN_StatusTypeDef status = uCAN_Runtime_LoadRaw(&packet->raw, data, time, &seq);
+
+    if (status != UCAN_OK)
+    {
+        return status;
+    }
+
+    // Nothing received, or this frame was already decoded
+    if (seq == packet->raw.readSeq)
+    {
+        return UCAN_NO_CHANGED_VAL;
+    }
+
+    for (uint8_t i = 0; i < packet->dlc; i++)
+    {
+        *(packet->bits[i]) = data[i];
+    }
+
+    packet->raw.readSeq = seq;
+
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_LAZY */
+
+#if UCAN_CFG_HAL_CALLBACKS && (USE_HAL_CAN_REGISTER_CALLBACKS != 1U)
+/**
+  * @brief  HAL CAN callbacks, replacing the weak defaults of the HAL.
+  *
+  * @note   Every controller ends up here; the registry hands the event to the
+  *         handle driving it and ignores controllers uCAN does not drive. The
+  *         CAN interrupt handlers only need to call HAL_CAN_IRQHandler().
+  */
+void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef* hcan)
+{
+    uCAN_HalRxFifo0Callback(hcan);
+}
+
+void HAL_CAN_ErrorCallback(CAN_HandleTypeDef* hcan)
+{
+    uCAN_HalErrorCallback(hcan);
+}
+
+#if UCAN_CFG_HW_TIMESTAMP
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef* hcan)
+{
+    uCAN_HalTxMailbox0Callback(hcan);
+}
+
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef* hcan)
+{
+    uCAN_HalTxMailbox1Callback(hcan);
+}
+
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef* hcan)
+{
+    uCAN_HalTxMailbox2Callback(hcan);
+}
+#endif
+#endif /* UCAN_CFG_HAL_CALLBACKS */
+
+#if UCAN_CFG_TRACE
+/**
+  * @brief  Default trace hook, does nothing.
+  * @param  event Event being reported.
+  * @param  arg   Event argument (CAN ID or status code).
+  * @note   Override in the application to record uCAN events, e.g. into a
+  *         RAM ring buffer or a SWO/ITM channel. Called from interrupt context
+  *         for RX events, so keep it short.
+  */
+__weak void uCAN_TraceHook(UCAN_TraceEvent event, uint32_t arg)
+{
+    (void)event;
+    (void)arg;
+}
+#endif
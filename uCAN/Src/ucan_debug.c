@@ -33,6 +33,7 @@
   */
 
 #include <stdlib.h>
+#include <string.h>
 #include "ucan_runtime.h"
 #include "ucan_debug.h"
 
@@ -57,6 +58,13 @@ uint8_t uCAN_Debug_Calculate_DLC(UCAN_PacketConfig* pkt)
 {
     uint8_t dlc = 0;
 
+#if UCAN_CFG_OVERLAY
+    // an overlay struct covers the whole payload
+    if (pkt->overlay != NULL) {
+        return pkt->overlaySize;
+    }
+#endif
+
     // loop through all items to accumulate byte sizes
     for (int i = 0; i < pkt->item_count; i++) {
         switch (pkt->items[i].type) {
@@ -84,12 +92,15 @@ uint8_t uCAN_Debug_Calculate_DLC(UCAN_PacketConfig* pkt)
   *         For each packet:
   *           - Ensures pointer is valid
   *           - Validates item types via uCAN_Debug_CheckIsDataType()
-  *           - Calculates and verifies DLC is within valid CAN frame size (1 to 8 bytes)
+  *           - Calculates and verifies DLC is within valid CAN frame size (1 to 8 bytes,
+  *             0 is accepted for packets that only register a handler)
+  *           - Rejects overlay packets that also list items or have no size
+  *           - Rejects lazy overlay packets
   *
   * @param  configList: Pointer to an array of UCAN_PacketConfig structures.
   * @param  packetHolder: Pointer to a UCAN_PacketHolder which includes the packet count.
   * @retval UCAN_OK: All configurations are valid
-  * @retval UCAN_INVALID_PARAM: NULL pointer or invalid packet pointer
+  * @retval UCAN_INVALID_PARAM: NULL pointer, invalid packet pointer or more than UCAN_CFG_MAX_PACKETS packets
   * @retval UCAN_MISSING_VAL: DLC is 0 or exceeds 8 bytes
   *
   * @warning Item types in each packet must be correctly set before calling this function.
@@ -102,6 +113,11 @@ UCAN_StatusTypeDef uCAN_Debug_CheckPacketConfig(UCAN_PacketConfig* configList, U
         return UCAN_INVALID_PARAM;
     }
 
+    // packet count must stay within the compile-time limit
+    if (packetHolder->count > UCAN_CFG_MAX_PACKETS) {
+        return UCAN_INVALID_PARAM;
+    }
+
     // iterate through all packets in the holder
 	for(int i=0; i < packetHolder->count; i++){
 		UCAN_PacketConfig *pkt = &configList[i];
@@ -115,14 +131,39 @@ UCAN_StatusTypeDef uCAN_Debug_CheckPacketConfig(UCAN_PacketConfig* configList, U
 		// verify each item inside the packet has a valid data type
 		uCAN_Debug_CheckIsDataType(pkt);
 
+#if UCAN_CFG_OVERLAY
+		// an overlay replaces the item list and must cover at least one byte
+		if(pkt->overlay != NULL && (pkt->item_count != 0 || pkt->overlaySize == 0))
+		{
+			return UCAN_INVALID_PARAM;
+		}
+#endif
+
+#if UCAN_CFG_LAZY && UCAN_CFG_OVERLAY
+		// an overlay already takes the frame in one copy
+		if(pkt->lazy && pkt->overlay != NULL)
+		{
+			return UCAN_INVALID_PARAM;
+		}
+#endif
+
 		// calculate total DLC for current packet
 		uint8_t dlc = uCAN_Debug_Calculate_DLC(pkt);
 
-		// validate DLC range: must be between 1 and 8 for standard CAN
-		if(dlc > 8 || dlc == 0)
+		// validate DLC range: must be between 1 and 8 for standard CAN,
+		// handler-only packets may have no bound items
+		if(dlc > 8 || (dlc == 0 && pkt->handler == NULL))
 		{
 			return UCAN_MISSING_VAL;
 		}
+
+#if UCAN_CFG_REDUNDANT
+		// rolling counter must be one of the bound bytes
+		if(pkt->seqByte > dlc)
+		{
+			return UCAN_INVALID_PARAM;
+		}
+#endif
 	}
 
 	// All checks passed successfully
@@ -158,6 +199,11 @@ UCAN_StatusTypeDef uCAN_Debug_FinalizePacket(UCAN_PacketConfig* configPackets, U
 
     UCAN_Packet *packets = packetHolder->packets;
 
+    packetHolder->pending = 0;
+#if UCAN_CFG_RX_INDEX
+    packetHolder->index = NULL;
+#endif
+
     // loop through each packet in the holder
     for (uint32_t i = 0; i < packetHolder->count; ++i) {
 
@@ -167,11 +213,71 @@ UCAN_StatusTypeDef uCAN_Debug_FinalizePacket(UCAN_PacketConfig* configPackets, U
         // set packet ID and calculate DLC
         packets[i].id = configPackets[i].id;
         packets[i].dlc = uCAN_Debug_Calculate_DLC(&configPackets[i]);
+#if UCAN_CFG_STATS
+        packets[i].stats = NULL;
+#endif
+#if UCAN_CFG_TRIGGER
+        packets[i].triggers = NULL;
+#endif
+        packets[i].group = NULL;
+        packets[i].groupIndex = 0;
+        packets[i].handler = configPackets[i].handler;
+        packets[i].context = configPackets[i].context;
+        packets[i].critical = configPackets[i].critical;
+#if UCAN_CFG_OVERLAY
+        packets[i].overlay = (uint8_t*)configPackets[i].overlay;
+        packets[i].overlayDouble = configPackets[i].overlayDouble;
+        packets[i].overlaySeq = 0;
+#endif
+#if UCAN_CFG_LATENCY
+        packets[i].latency = configPackets[i].latency;
+#endif
+#if UCAN_CFG_LAZY
+        packets[i].lazy = configPackets[i].lazy;
+        packets[i].raw.seq = 0;
+        packets[i].raw.readSeq = 0;
+#endif
+#if UCAN_CFG_SCHEDULE
+        packets[i].scheduled = 0;
+#endif
+#if UCAN_CFG_REDUNDANT
+        packets[i].seqByte = configPackets[i].seqByte;
+#endif
+#if UCAN_CFG_HW_TIMESTAMP
+        packets[i].timing.seq = 0;
+        packets[i].timing.count = 0;
+#endif
 
         // go through each data item in this config
         while (j < configPackets[i].item_count) {
 
             void* data_ptr = configPackets[i].items[j].ptr;
+#if UCAN_CFG_STATS
+            UCAN_SignalStats* stats = configPackets[i].items[j].stats;
+
+            // attach statistics block to the packet at the signal's byte offset
+            if (stats != NULL)
+            {
+                stats->offset = byte_idx;
+                stats->type = configPackets[i].items[j].type;
+                stats->count = 0;
+                stats->resetRequest = 0;
+                stats->next = packets[i].stats;
+                packets[i].stats = stats;
+            }
+#endif
+#if UCAN_CFG_TRIGGER
+            UCAN_Trigger* trigger = configPackets[i].items[j].trigger;
+
+            // attach trigger to the packet at the signal's byte offset
+            if (trigger != NULL)
+            {
+                trigger->offset = byte_idx;
+                trigger->type = configPackets[i].items[j].type;
+                trigger->next = packets[i].triggers;
+                packets[i].triggers = trigger;
+            }
+#endif
 
             // map each data type into individual byte pointers
             switch (configPackets[i].items[j].type)
@@ -208,6 +314,610 @@ UCAN_StatusTypeDef uCAN_Debug_FinalizePacket(UCAN_PacketConfig* configPackets, U
     return UCAN_OK;
 }
 
+/**
+  * @brief  [INTERNAL] Resolves the member packets of all signal groups and validates them.
+  *
+  * @note   Must be called after the RX holder has been finalized (sorted), since
+  *         member IDs are looked up with a binary search. For each group:
+  *           - memberCount must be between 1 and UCAN_GROUP_MAX_MEMBERS
+  *           - every member ID must be a configured RX packet
+  *           - a packet may belong to a single group only
+  *           - the sequence counter byte must lie inside every member frame
+  *           - overlay and lazy packets cannot be members
+  *
+  *         On success member packets are linked to their group and the group's
+  *         assembly state is cleared.
+  *
+  * @param  ucan Pointer to the UCAN handle structure.
+  * @retval UCAN_OK: All groups are valid (or no group configured)
+  * @retval UCAN_INVALID_PARAM: NULL pointer, invalid member count, overlay or lazy member
+  * @retval UCAN_ERROR_UNKNOWN_ID: Member ID is not an RX packet
+  * @retval UCAN_ERROR_DUPLICATE_ID: Packet listed in more than one group
+  * @retval UCAN_MISSING_VAL: Sequence counter byte outside a member frame
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeGroups(UCAN_HandleTypeDef* ucan)
+{
+	// Null pointer check to prevent invalid memory access
+	if (ucan == NULL)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	// Groups are optional
+	if (ucan->groups == NULL || ucan->groupCount == 0)
+	{
+		return UCAN_OK;
+	}
+
+	for (uint32_t g = 0; g < ucan->groupCount; g++)
+	{
+		UCAN_SignalGroup* group = &ucan->groups[g];
+
+		if (group->memberCount == 0 || group->memberCount > UCAN_GROUP_MAX_MEMBERS)
+		{
+			return UCAN_INVALID_PARAM;
+		}
+
+		for (uint8_t k = 0; k < group->memberCount; k++)
+		{
+			UCAN_Packet packetKey = {.id = group->ids[k]};
+			UCAN_Packet* packet = bsearch(&packetKey, ucan->rxHolder.packets, ucan->rxHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+
+			// member must be a configured RX packet
+			if (packet == NULL)
+			{
+				return UCAN_ERROR_UNKNOWN_ID;
+			}
+
+			// a packet can only be published through one group
+			if (packet->group != NULL)
+			{
+				return UCAN_ERROR_DUPLICATE_ID;
+			}
+
+#if UCAN_CFG_OVERLAY
+			// overlay packets publish through their own buffers
+			if (packet->overlay != NULL)
+			{
+				return UCAN_INVALID_PARAM;
+			}
+#endif
+
+#if UCAN_CFG_LAZY
+			// lazy packets are unpacked on request, not published
+			if (packet->lazy)
+			{
+				return UCAN_INVALID_PARAM;
+			}
+#endif
+
+			// sequence counter must be part of every member frame
+			if (group->seqByte != UCAN_GROUP_NO_SEQUENCE && group->seqByte >= packet->dlc)
+			{
+				return UCAN_MISSING_VAL;
+			}
+
+			packet->group = group;
+			packet->groupIndex = k;
+			group->packets[k] = packet;
+		}
+
+		// start with empty buffers
+		group->pendingMask = 0;
+		group->front = 0;
+		group->commitSeq = 0;
+		group->readSeq = 0;
+	}
+
+	// All checks passed successfully
+	return UCAN_OK;
+}
+
+#if UCAN_CFG_RX_INDEX
+/**
+  * @brief  [INTERNAL] Builds the direct ID lookup of a finalized (sorted) packet holder.
+  *
+  * @note   Sets one bit per packet ID and records, for every 32-ID word, the
+  *         number of packets with a lower ID. The holder keeps using binary
+  *         search if an ID is not a standard identifier or appears twice
+  *         (possible only without full validation), since the bit rank would
+  *         then not match the array position.
+  *
+  * @param  packetHolder Pointer to the sorted packet holder.
+  * @param  index        Storage of the lookup.
+  * @retval UCAN_OK: Lookup built, or binary search kept
+  * @retval UCAN_INVALID_PARAM: NULL pointer
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeIndex(UCAN_PacketHolder* packetHolder, UCAN_IdIndex* index)
+{
+	// Null pointer check to prevent invalid memory access
+	if (packetHolder == NULL || index == NULL)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	packetHolder->index = NULL;
+	memset(index, 0, sizeof(*index));
+
+	for (uint32_t i = 0; i < packetHolder->count; i++)
+	{
+		uint32_t id = packetHolder->packets[i].id;
+
+		// only standard IDs fit, each one once
+		if (id >= UCAN_STD_ID_COUNT || (index->bits[id >> 5] & (1U << (id & 31U))) != 0U)
+		{
+			return UCAN_OK;
+		}
+
+		index->bits[id >> 5] |= 1U << (id & 31U);
+	}
+
+	// packets are sorted, so the rank of a word is the count of lower IDs
+	uint32_t next = 0;
+
+	for (uint32_t w = 0; w < UCAN_STD_ID_COUNT / 32U; w++)
+	{
+		while (next < packetHolder->count && (packetHolder->packets[next].id >> 5) < w)
+		{
+			next++;
+		}
+
+		index->rank[w] = (uint16_t)next;
+	}
+
+	packetHolder->index = index;
+
+	return UCAN_OK;
+}
+#endif
+
+#if UCAN_CFG_LATENCY
+/**
+  * @brief  [INTERNAL] Prepares the latency blocks of all traced TX and RX packets.
+  *
+  * @note   The latency trailer follows the bound payload bytes, so a traced packet
+  *         may bind at most 8 - UCAN_LATENCY_TRAILER_DLC bytes. Every block is
+  *         cleared and bound to the handle's timebase.
+  *
+  * @param  ucan Pointer to the UCAN handle with finalized packet holders.
+  * @retval UCAN_OK: All traced packets are valid (or none is traced)
+  * @retval UCAN_INVALID_PARAM: NULL pointer
+  * @retval UCAN_MISSING_VAL: Payload and trailer exceed 8 bytes
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeLatency(UCAN_HandleTypeDef* ucan)
+{
+	// Null pointer check to prevent invalid memory access
+	if (ucan == NULL)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	UCAN_PacketHolder* holders[2] = {&ucan->txHolder, &ucan->rxHolder};
+
+	for (uint32_t h = 0; h < 2U; h++)
+	{
+		for (uint32_t i = 0; i < holders[h]->count; i++)
+		{
+			UCAN_Packet* packet = &holders[h]->packets[i];
+			UCAN_LatencyStats* latency = packet->latency;
+
+			if (latency == NULL)
+			{
+				continue;
+			}
+
+			// trailer must fit behind the bound bytes
+			if (packet->dlc + UCAN_LATENCY_TRAILER_DLC > 8U)
+			{
+				return UCAN_MISSING_VAL;
+			}
+
+			memset(latency, 0, sizeof(*latency));
+			latency->timebase = &ucan->timebase;
+
+#if UCAN_CFG_REDUNDANT
+			// the trailer's sequence number tells copies apart if no counter is configured
+			if (packet->seqByte == 0U)
+			{
+				packet->seqByte = UCAN_SEQ_BYTE(packet->dlc + UCAN_LATENCY_SEQ);
+			}
+#endif
+		}
+	}
+
+	// All checks passed successfully
+	return UCAN_OK;
+}
+#endif
+
+#if UCAN_CFG_TRIGGER
+/**
+  * @brief  [INTERNAL] Validates the triggers of all RX packets and binds them to the event queue.
+  *
+  * @note   Every trigger is re-armed and forgets its previous value. The
+  *         event queue is required as soon as one trigger is bound.
+  *
+  * @param  ucan Pointer to the UCAN handle with finalized packet holders.
+  * @retval UCAN_OK: All triggers are valid (or none is bound)
+  * @retval UCAN_INVALID_PARAM: NULL pointer, missing or badly sized event queue,
+  *         unknown condition, edge bit outside the signal, or a threshold or
+  *         hysteresis the signal's range cannot fire or re-arm
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeTriggers(UCAN_HandleTypeDef* ucan)
+{
+	// Null pointer check to prevent invalid memory access
+	if (ucan == NULL)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	UCAN_EventQueue* queue = &ucan->events;
+	uint32_t size = queue->size;
+
+	queue->head = 0;
+	queue->tail = 0;
+	queue->overruns = 0;
+
+	for (uint32_t i = 0; i < ucan->rxHolder.count; i++)
+	{
+		for (UCAN_Trigger* trigger = ucan->rxHolder.packets[i].triggers; trigger != NULL; trigger = trigger->next)
+		{
+			// hits need somewhere to go, ring size must be a power of two
+			if (queue->events == NULL || size == 0U || (size & (size - 1U)) != 0U)
+			{
+				return UCAN_INVALID_PARAM;
+			}
+
+			if (trigger->condition > UCAN_TRIGGER_FALLING)
+			{
+				return UCAN_INVALID_PARAM;
+			}
+
+			uint8_t width = (trigger->type == UCAN_U8) ? 8U : (trigger->type == UCAN_U16) ? 16U : 32U;
+
+			// edge bit must lie inside the signal
+			if ((trigger->condition == UCAN_TRIGGER_RISING || trigger->condition == UCAN_TRIGGER_FALLING) &&
+				trigger->bit >= width)
+			{
+				return UCAN_INVALID_PARAM;
+			}
+
+			uint64_t max = (1ULL << width) - 1U;
+
+			// limits must let the signal fire the trigger and move back far enough to re-arm it
+			if ((trigger->condition == UCAN_TRIGGER_ABOVE && (trigger->threshold >= max || trigger->hysteresis > trigger->threshold)) ||
+				(trigger->condition == UCAN_TRIGGER_BELOW && (trigger->threshold == 0U || (uint64_t)trigger->threshold + trigger->hysteresis > max)) ||
+				(trigger->condition == UCAN_TRIGGER_DELTA && trigger->threshold > max))
+			{
+				return UCAN_INVALID_PARAM;
+			}
+
+			trigger->hits = 0;
+			trigger->armed = 1;
+			trigger->primed = 0;
+			trigger->reference = 0;
+			trigger->queue = queue;
+		}
+	}
+
+	// All checks passed successfully
+	return UCAN_OK;
+}
+#endif
+
+#if UCAN_CFG_EXPORT
+/**
+  * @brief  [INTERNAL] Writes the layout of all RX packets into the export region.
+  *
+  * @note   Descriptors and slots follow the sorted RX holder, so readers can
+  *         binary search them by identifier. Overlay and handler-only packets
+  *         are exported without signals. Nothing is exported while
+  *         UCAN_Export.region is NULL.
+  *
+  * @param  ucan   Pointer to the UCAN handle with finalized packet holders.
+  * @param  rxList RX packet configuration list the holder was built from.
+  * @retval UCAN_OK: Layout written (or export disabled)
+  * @retval UCAN_INVALID_PARAM: NULL pointer, misaligned or too small region
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeExport(UCAN_HandleTypeDef* ucan, UCAN_PacketConfig* rxList)
+{
+	// Null pointer check to prevent invalid memory access
+	if (ucan == NULL || rxList == NULL)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	UCAN_PacketHolder* holder = &ucan->rxHolder;
+	void* region = ucan->exports.region;
+
+	for (uint32_t i = 0; i < holder->count; i++)
+	{
+		holder->packets[i].exportSlot = NULL;
+	}
+
+	if (region == NULL)
+	{
+		return UCAN_OK;
+	}
+
+	if (uCAN_ExportBegin(region, ucan->exports.size, holder->count, ucan->timebase.frequency) == 0U)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	for (uint32_t i = 0; i < holder->count; i++)
+	{
+		UCAN_Packet* packet = uCAN_Runtime_FindPacket(holder, rxList[i].id);
+		uint32_t index = (uint32_t)(packet - holder->packets);
+		UCAN_ExportDesc* desc = uCAN_ExportDescriptor(region, index);
+		uint8_t offset = 0;
+
+		desc->id = packet->id;
+		desc->dlc = packet->dlc;
+		desc->signalCount = rxList[i].item_count;
+
+		// signals are packed back to back, in configuration order
+		for (uint8_t j = 0; j < rxList[i].item_count; j++)
+		{
+			uint8_t size = (rxList[i].items[j].type == UCAN_U8) ? 1U : (rxList[i].items[j].type == UCAN_U16) ? 2U : 4U;
+
+			desc->signals[j].offset = offset;
+			desc->signals[j].size = size;
+			offset += size;
+		}
+
+		packet->exportSlot = uCAN_ExportSlotAt(region, index);
+	}
+
+	uCAN_ExportCommit(region);
+
+	// All checks passed successfully
+	return UCAN_OK;
+}
+#endif
+
+/**
+  * @brief  [INTERNAL] Feeds one 32-bit word into a CRC-8 (polynomial 0x07).
+  */
+static uint8_t uCAN_Debug_Crc8Word(uint8_t crc, uint32_t word)
+{
+    for (uint8_t b = 0; b < 4; b++)
+    {
+        crc ^= (uint8_t)(word >> (8U * b));
+
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80U) ? (uint8_t)((crc << 1) ^ 0x07U) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+#if UCAN_CFG_HW_TIMESTAMP || UCAN_CFG_SCHEDULE
+/**
+  * @brief  [INTERNAL] Number of PCLK1 cycles in one nominal CAN bit time.
+  *
+  * @note   Read back from the BTR register (prescaler, BS1, BS2 plus the sync
+  *         segment), so it always matches the bit rate the controller runs at.
+  *
+  * @param  hcan Pointer to the initialized HAL CAN handle.
+  * @retval uint32_t APB1 clock cycles per bit.
+  */
+static uint32_t uCAN_Debug_CyclesPerBit(CAN_HandleTypeDef* hcan)
+{
+	uint32_t btr = hcan->Instance->BTR;
+	uint32_t prescaler = ((btr & CAN_BTR_BRP) >> CAN_BTR_BRP_Pos) + 1U;
+	uint32_t quanta = 1U + (((btr & CAN_BTR_TS1) >> CAN_BTR_TS1_Pos) + 1U) + (((btr & CAN_BTR_TS2) >> CAN_BTR_TS2_Pos) + 1U);
+
+	return prescaler * quanta;
+}
+#endif
+
+#if UCAN_CFG_HW_TIMESTAMP
+/**
+  * @brief  [INTERNAL] Derives the hardware timebase from the CAN bit timing.
+  *
+  * @note   The TTCM counter advances once per nominal bit time, taken from the
+  *         configured bit timing and scaled by the APB1 clock.
+  *
+  * @param  clock Pointer to the hardware clock state to initialize.
+  * @param  hcan  Pointer to the initialized HAL CAN handle.
+  * @param  tick  Current time in milliseconds from the handle timebase.
+  */
+void uCAN_Debug_FinalizeClock(UCAN_HwClock* clock, CAN_HandleTypeDef* hcan, uint32_t tick)
+{
+	uint32_t cyclesPerBit = uCAN_Debug_CyclesPerBit(hcan);
+	uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+
+	clock->bitRate = pclk / cyclesPerBit;
+	clock->nsPerBit = (uint32_t)(((uint64_t)cyclesPerBit * 1000000000U) / pclk);
+	clock->last = 0;
+	clock->lastTick = tick;
+}
+#endif
+
+#if UCAN_CFG_SCHEDULE
+/**
+  * @brief  [INTERNAL] Orders schedule windows by their offset in the cycle.
+  */
+static int uCAN_Debug_CompareWindowOffset(const void* a, const void* b)
+{
+	const UCAN_ScheduleWindow* w1 = (const UCAN_ScheduleWindow*)a;
+	const UCAN_ScheduleWindow* w2 = (const UCAN_ScheduleWindow*)b;
+
+	if (w1->offsetUs < w2->offsetUs) return -1;
+	if (w1->offsetUs > w2->offsetUs) return 1;
+	return 0;
+}
+
+/**
+  * @brief  [INTERNAL] Compiles the transmit schedule into its window table.
+  *
+  * @note   Must be called after the TX holder has been finalized (sorted). The
+  *         windows are sorted by offset and each one is bound to its TX packet.
+  *         Window lengths are the worst-case durations of the frames as
+  *         transmitted (latency trailer and stuff bits included) at the
+  *         configured bit rate. The table is rejected when:
+  *           - the cycle length is missing, or there is no time source and
+  *             the handle timebase runs below 1 MHz
+  *           - the reference ID is also a TX or RX packet
+  *           - a repeat is not a power of two up to UCAN_SCHEDULE_MAX_REPEAT
+  *           - a window ID is not a TX packet
+  *           - a window overlaps the reference message or the previous window
+  *             (also when both are used in different cycles), or ends after
+  *             the basic cycle
+  *
+  *         Only the windows of this node are known here; keeping the windows
+  *         of different nodes apart is up to the network schedule design.
+  *
+  * @param  ucan Pointer to the UCAN handle structure.
+  * @retval UCAN_OK: Schedule compiled (or no schedule configured)
+  * @retval UCAN_INVALID_PARAM: Missing parameter, invalid repeat or overlapping windows
+  * @retval UCAN_ERROR_DUPLICATE_ID: Reference ID used by a packet
+  * @retval UCAN_ERROR_UNKNOWN_ID: Window ID is not a TX packet
+  */
+UCAN_StatusTypeDef uCAN_Debug_CompileSchedule(UCAN_HandleTypeDef* ucan)
+{
+	UCAN_Schedule* schedule = ucan->schedule;
+
+	// Schedule is optional
+	if (schedule == NULL)
+	{
+		return UCAN_OK;
+	}
+
+	if (schedule->cycleUs == 0 || (schedule->windowCount != 0 && schedule->windows == NULL))
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	// without own time source the handle timebase must resolve microseconds
+	if (schedule->nowUs == NULL && ucan->timebase.countsPerMs < 1000U)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	schedule->timebase = &ucan->timebase;
+
+	// reference message must not be mistaken for a packet
+	UCAN_Packet refKey = {.id = schedule->referenceId};
+
+	if (bsearch(&refKey, ucan->txHolder.packets, ucan->txHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId) != NULL ||
+		bsearch(&refKey, ucan->rxHolder.packets, ucan->rxHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId) != NULL)
+	{
+		return UCAN_ERROR_DUPLICATE_ID;
+	}
+
+	uint64_t nsPerBit = ((uint64_t)uCAN_Debug_CyclesPerBit(ucan->hcan) * 1000000000U) / HAL_RCC_GetPCLK1Freq();
+
+	// reference message occupies the start of every cycle
+	schedule->refLengthUs = (uint32_t)((UCAN_FRAME_BITS(1U) * nsPerBit + 999U) / 1000U);
+
+	qsort(schedule->windows, schedule->windowCount, sizeof(UCAN_ScheduleWindow), uCAN_Debug_CompareWindowOffset);
+
+	uint32_t busyUntil = schedule->refLengthUs;
+
+	for (uint32_t i = 0; i < schedule->windowCount; i++)
+	{
+		UCAN_ScheduleWindow* window = &schedule->windows[i];
+
+		if (window->repeat == 0 || window->repeat > UCAN_SCHEDULE_MAX_REPEAT ||
+			(window->repeat & (window->repeat - 1U)) != 0 || window->cycleOffset >= window->repeat)
+		{
+			return UCAN_INVALID_PARAM;
+		}
+
+		UCAN_Packet packetKey = {.id = window->id};
+		UCAN_Packet* packet = bsearch(&packetKey, ucan->txHolder.packets, ucan->txHolder.count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+
+		// window must send a configured TX packet
+		if (packet == NULL)
+		{
+			return UCAN_ERROR_UNKNOWN_ID;
+		}
+
+		uint8_t dlc = packet->dlc;
+
+#if UCAN_CFG_LATENCY
+		// traced packets go out with the latency trailer behind their payload
+		if (packet->latency != NULL)
+		{
+			dlc += UCAN_LATENCY_TRAILER_DLC;
+		}
+#endif
+
+		window->lengthUs = (uint32_t)((UCAN_FRAME_BITS(dlc) * nsPerBit + 999U) / 1000U);
+
+		// windows must not overlap each other or run past the cycle
+		if (window->offsetUs < busyUntil || window->offsetUs + window->lengthUs > schedule->cycleUs)
+		{
+			return UCAN_INVALID_PARAM;
+		}
+
+		busyUntil = window->offsetUs + window->lengthUs;
+
+		window->packet = packet;
+		window->lastLateUs = 0;
+		window->maxLateUs = 0;
+		window->missed = 0;
+		packet->scheduled = 1;
+	}
+
+	// wait for the first cycle
+	schedule->syncSeq = 0;
+	schedule->seenSeq = 0;
+	schedule->cycleStartUs = 0;
+	schedule->cycleCount = 0;
+	schedule->nextWindow = 0;
+	schedule->cycles = 0;
+
+	return UCAN_OK;
+}
+#endif
+
+/**
+  * @brief  [INTERNAL] Computes an 8-bit hash of the finalized packet configuration.
+  *
+  * @note   Covers ID and DLC of every TX and RX packet. Both holders are sorted
+  *         by uCAN_Debug_FinalizePacket() and merged into one ascending ID
+  *         sequence, so the hash depends neither on the order packets were
+  *         listed in nor on their direction: a master and a client sharing the
+  *         same packets, one sending what the other receives, get the same hash.
+  *         Clients report it in their handshake response, allowing the master
+  *         to spot nodes running a different configuration.
+  *
+  * @param  ucan Pointer to the UCAN handle with finalized packet holders.
+  * @retval uint8_t CRC-8 of the configuration.
+  */
+uint8_t uCAN_Debug_ConfigHash(UCAN_HandleTypeDef* ucan)
+{
+    uint8_t crc = 0xFFU;
+    uint32_t tx = 0;
+    uint32_t rx = 0;
+
+    // Merge both sorted lists by ID, each entry as ID followed by DLC
+    while (tx < ucan->txHolder.count || rx < ucan->rxHolder.count)
+    {
+        UCAN_Packet* packet;
+
+        if (rx >= ucan->rxHolder.count ||
+            (tx < ucan->txHolder.count && ucan->txHolder.packets[tx].id < ucan->rxHolder.packets[rx].id))
+        {
+            packet = &ucan->txHolder.packets[tx++];
+        }
+        else
+        {
+            packet = &ucan->rxHolder.packets[rx++];
+        }
+
+        crc = uCAN_Debug_Crc8Word(crc, packet->id);
+        crc = uCAN_Debug_Crc8Word(crc, packet->dlc);
+    }
+
+    return crc;
+}
+
 /**
   * @brief [INTERNAL] Validates the UCAN_NodeInfo structure integrity and correctness.
   *
@@ -259,7 +969,9 @@ UCAN_StatusTypeDef uCAN_Debug_CheckNodeInfo(UCAN_NodeInfo* node)
   * This function validates the input pointer and sorts the array of UCAN_Client
   * structures based on their client IDs using the standard qsort function.
   * Sorting the client list improves lookup efficiency and guarantees a consistent
-  * order for operations like searching and handshake management.
+  * order for operations like searching and handshake management. All recorded
+  * times and capabilities are marked invalid, so no client counts as having
+  * responded yet.
   *
   * @param node Pointer to the UCAN_NodeInfo containing the client array to sort.
   *
@@ -276,9 +988,145 @@ UCAN_StatusTypeDef uCAN_Debug_FinalizeNodeInfo(UCAN_NodeInfo* node)
     // Sort clients array by client ID for deterministic behavior
     qsort(node->clients, node->clientCount, sizeof(UCAN_Client), uCAN_Runtime_CompareClientId);
 
+    // No time recorded yet
+    for (uint32_t i = 0; i < node->clientCount; i++)
+    {
+        node->clients[i].flags = 0;
+        node->clients[i].diagSeq = 0;
+        node->clients[i].caps.valid = 0;
+        node->clients[i].caps.misses = 0;
+    }
+
+    node->timeFlags = 0;
+#if UCAN_CFG_HAS_CLIENT
+    node->masterCaps.valid = 0;
+    node->replyPending = 0;
+#endif
+#if UCAN_CFG_HAS_MASTER
+    node->capsRequested = NULL;
+#endif
+
+#if UCAN_CFG_HAS_MEMBERSHIP
+    // Bit positions of the membership view only mean the same on nodes with the same sorted list
+    uint8_t crc = 0xFFU;
+
+    for (uint32_t i = 0; i < node->clientCount; i++)
+    {
+        crc = uCAN_Debug_Crc8Word(crc, node->clients[i].id);
+    }
+
+    node->clientsHash = crc;
+    memset(node->membership, 0, sizeof(node->membership));
+    node->membershipTime = 0;
+#endif
+
     return UCAN_OK;
 }
 
+/**
+  * @brief [INTERNAL] Validates and prepares the timebase of a handle.
+  *
+  * Without a counter read function HAL_GetTick() is used at 1 kHz. The
+  * frequency must be a whole number of counts per millisecond, so millisecond
+  * intervals convert without rounding. The epoch starts at the current top bit
+  * of the counter, so the first extension does not count a wrap.
+  *
+  * @param timebase Pointer to the timebase to finalize.
+  *
+  * @retval UCAN_OK               Timebase ready.
+  * @retval UCAN_INVALID_PARAM    Null pointer or frequency not a non-zero multiple of 1000 Hz.
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeTimebase(UCAN_Timebase* timebase)
+{
+	// Null pointer check to prevent invalid memory access
+	if (timebase == NULL)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	if (timebase->read == NULL)
+	{
+		timebase->frequency = 1000U;
+	}
+
+	if (timebase->frequency < 1000U || (timebase->frequency % 1000U) != 0U)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	timebase->countsPerMs = timebase->frequency / 1000U;
+
+	uint32_t raw = (timebase->read != NULL) ? timebase->read() : HAL_GetTick();
+	timebase->epoch = raw >> 31;
+
+#if UCAN_CFG_FAULT
+	timebase->driftPpm = 0;
+	timebase->driftStart = 0;
+	timebase->driftOffset = 0;
+#endif
+
+	return UCAN_OK;
+}
+
+/**
+  * @brief [INTERNAL] Binds the controllers of a handle to its buses.
+  *
+  * bus[0] is always the controller in `hcan`. With UCAN_CFG_REDUNDANT, bus[1]
+  * is `hcanRedundant` (NULL for single-bus operation) and the duplicate filter
+  * is emptied. All traffic counters start at zero.
+  *
+  * @param ucan Pointer to the UCAN handle.
+  *
+  * @retval UCAN_OK               Buses ready.
+  * @retval UCAN_INVALID_PARAM    Null pointer, or the redundant controller is the primary one.
+  */
+UCAN_StatusTypeDef uCAN_Debug_FinalizeBuses(UCAN_HandleTypeDef* ucan)
+{
+	// Null pointer check to prevent invalid memory access
+	if (ucan == NULL || ucan->hcan == NULL)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	for (uint32_t b = 0; b < UCAN_BUS_COUNT; b++)
+	{
+		UCAN_Bus* bus = &ucan->bus[b];
+
+		bus->hcan = NULL;
+		bus->flags = 0;
+		bus->rxFrames = 0;
+		bus->rxDuplicates = 0;
+		bus->txFrames = 0;
+		bus->txSkipped = 0;
+#if UCAN_CFG_FAULT
+		bus->fault = NULL;
+#endif
+	}
+
+#if UCAN_CFG_FAULT
+	ucan->fault = NULL;
+#endif
+
+	ucan->bus[0].hcan = ucan->hcan;
+
+#if UCAN_CFG_REDUNDANT
+	// Both copies of every frame would come from the same controller
+	if (ucan->hcanRedundant == ucan->hcan)
+	{
+		return UCAN_INVALID_PARAM;
+	}
+
+	ucan->bus[1].hcan = ucan->hcanRedundant;
+
+	for (uint32_t i = 0; i < UCAN_DEDUP_SIZE; i++)
+	{
+		ucan->dedup[i].bus = UCAN_DEDUP_EMPTY;
+	}
+#endif
+
+	return UCAN_OK;
+}
+
 /**
   * @brief  [INTERNAL] Validates that each item in the packet has a valid data type.
   * @param  pkt Pointer to the UCAN_PacketConfig to check.
@@ -0,0 +1,314 @@
+/**
+  ******************************************************************************
+  * @file    ucan_export.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Writer and reader of the uCAN shared-memory export region.
+  *
+  * See ucan_export.h for the region layout. The code uses no HAL or uCAN
+  * handle types, only the C standard library, and is shared between the
+  * firmware that publishes frames and the programs that map and read them.
+  *
+  * @see     uCAN GitHub repository: https://github.com/hamza-enes-balahoroglu/uCAN.git
+  *
+  *
+  *                          _____          _   _
+  *                         / ____|   /\   | \ | |
+  *                   _   _| |       /  \  |  \| |
+  *                  | | | | |      / /\ \ | . ` |
+  *                  | |_| | |____ / ____ \| |\  |
+  *                   \____|\_____/_/    \_\_| \_|
+  *
+  ******************************************************************************
+  */
+
+
+#include <string.h>
+#include "ucan_export.h"
+
+static const uint8_t exportMagic[3] = { 'u', 'C', 'X' };
+
+/**
+  * @brief  Tells whether a region carries the export magic of this version.
+  * @param  header Header at the start of the region.
+  * @retval 1 if magic and version match.
+  */
+static uint8_t uCAN_Export_HasMagic(const UCAN_ExportHeader* header)
+{
+    return header->magic[0] == exportMagic[0] && header->magic[1] == exportMagic[1] &&
+           header->magic[2] == exportMagic[2] && header->version == UCAN_EXPORT_VERSION;
+}
+
+/**
+  * @brief  Starts a new layout: marks the region as being rebuilt and clears both tables.
+  *
+  * The generation is made odd before anything else changes, so a reader that
+  * validated the old layout notices the rebuild on its next uCAN_ExportOpen().
+  * A region that already held a layout keeps counting its generation.
+  *
+  * @param  region    Region memory, 8-byte aligned.
+  * @param  size      Size of the region in bytes.
+  * @param  count     Number of RX packets to export.
+  * @param  frequency Counts per second of the reception times.
+  * @retval Bytes used, 0 if the region is misaligned or too small.
+  */
+uint32_t uCAN_ExportBegin(void* region, uint32_t size, uint32_t count, uint32_t frequency)
+{
+    UCAN_ExportHeader* header = (UCAN_ExportHeader*)region;
+    uint32_t perPacket = sizeof(UCAN_ExportDesc) + sizeof(UCAN_ExportSlot);
+
+    if (region == NULL || ((uintptr_t)region & 7U) != 0U || size < sizeof(UCAN_ExportHeader) ||
+        count > (size - sizeof(UCAN_ExportHeader)) / perPacket)
+    {
+        return 0;
+    }
+
+    uint32_t generation = uCAN_Export_HasMagic(header) ? header->generation : 0U;
+
+    // Odd: readers keep off while the tables change
+    header->generation = generation | 1U;
+    UCAN_EXPORT_FENCE();
+
+    header->magic[0] = exportMagic[0];
+    header->magic[1] = exportMagic[1];
+    header->magic[2] = exportMagic[2];
+    header->version = UCAN_EXPORT_VERSION;
+    header->count = count;
+    header->descOffset = sizeof(UCAN_ExportHeader);
+    header->slotOffset = sizeof(UCAN_ExportHeader) + count * sizeof(UCAN_ExportDesc);
+    header->descSize = sizeof(UCAN_ExportDesc);
+    header->slotSize = sizeof(UCAN_ExportSlot);
+    header->frequency = frequency;
+
+    memset((uint8_t*)region + sizeof(UCAN_ExportHeader), 0, count * perPacket);
+
+    return sizeof(UCAN_ExportHeader) + count * perPacket;
+}
+
+/**
+  * @brief  Publishes the layout written since uCAN_ExportBegin().
+  * @param  region Region memory.
+  */
+void uCAN_ExportCommit(void* region)
+{
+    UCAN_ExportHeader* header = (UCAN_ExportHeader*)region;
+
+    // Tables are complete before the generation turns even
+    UCAN_EXPORT_FENCE();
+    header->generation = header->generation + 1U;
+}
+
+/**
+  * @brief  Returns the descriptor of a packet.
+  * @param  region Region memory.
+  * @param  index  Packet index below UCAN_ExportHeader.count.
+  * @retval Pointer to the descriptor.
+  */
+UCAN_ExportDesc* uCAN_ExportDescriptor(void* region, uint32_t index)
+{
+    const UCAN_ExportHeader* header = (const UCAN_ExportHeader*)region;
+
+    return (UCAN_ExportDesc*)((uint8_t*)region + header->descOffset) + index;
+}
+
+/**
+  * @brief  Returns the slot of a packet.
+  * @param  region Region memory.
+  * @param  index  Packet index below UCAN_ExportHeader.count.
+  * @retval Pointer to the slot.
+  */
+UCAN_ExportSlot* uCAN_ExportSlotAt(void* region, uint32_t index)
+{
+    const UCAN_ExportHeader* header = (const UCAN_ExportHeader*)region;
+
+    return (UCAN_ExportSlot*)((uint8_t*)region + header->slotOffset) + index;
+}
+
+/**
+  * @brief  Writes a received frame into its slot.
+  *
+  * Odd sequence number, payload and time, even sequence number. The payload
+  * is copied with a constant size, two word stores on a 32-bit core.
+  *
+  * @param  slot Slot of the packet.
+  * @param  data Payload, 8 bytes of storage.
+  * @param  dlc  Number of payload bytes (0 to 8).
+  * @param  time Reception time.
+  *
+  * @note   Single writer: the RX path.
+  */
+void uCAN_ExportPublish(UCAN_ExportSlot* slot, const uint8_t data[], uint8_t dlc, uint64_t time)
+{
+    // Odd: slot is being written
+    uint32_t seq = slot->seq + 1U;
+    slot->seq = seq;
+    UCAN_EXPORT_FENCE();
+
+    slot->dlc = (dlc > 8U) ? 8U : dlc;
+    slot->time = time;
+    memcpy(slot->data, data, sizeof(slot->data));
+
+    // Even again: frame complete
+    UCAN_EXPORT_FENCE();
+    slot->seq = seq + 1U;
+}
+
+/**
+  * @brief  Validates a mapped region.
+  *
+  * Checks the magic, the version, the table entry sizes and that both tables
+  * lie inside the mapping. A reader calls it once after mapping and again
+  * whenever it wants to know whether uCAN was restarted with another layout:
+  * a different generation means descriptors and indices must be looked up
+  * again.
+  *
+  * @param  region Region memory.
+  * @param  size   Number of bytes mapped.
+  * @retval Current layout generation, 0 if the region is invalid or being rebuilt.
+  */
+uint32_t uCAN_ExportOpen(const void* region, uint32_t size)
+{
+    const UCAN_ExportHeader* header = (const UCAN_ExportHeader*)region;
+
+    if (region == NULL || size < sizeof(UCAN_ExportHeader))
+    {
+        return 0;
+    }
+
+    uint32_t generation = header->generation;
+    UCAN_EXPORT_FENCE();
+
+    if (generation == 0U || (generation & 1U) || !uCAN_Export_HasMagic(header) ||
+        header->descSize != sizeof(UCAN_ExportDesc) || header->slotSize != sizeof(UCAN_ExportSlot))
+    {
+        return 0;
+    }
+
+    uint64_t descEnd = (uint64_t)header->descOffset + (uint64_t)header->count * sizeof(UCAN_ExportDesc);
+    uint64_t slotEnd = (uint64_t)header->slotOffset + (uint64_t)header->count * sizeof(UCAN_ExportSlot);
+
+    if (descEnd > size || slotEnd > size)
+    {
+        return 0;
+    }
+
+    // Layout unchanged while it was checked
+    UCAN_EXPORT_FENCE();
+    return (header->generation == generation) ? generation : 0U;
+}
+
+/**
+  * @brief  Finds the packet index of an identifier.
+  *
+  * Descriptors are sorted by identifier, like the RX packets of the handle,
+  * so the lookup is a binary search.
+  *
+  * @param  region Region memory, validated with uCAN_ExportOpen().
+  * @param  id     CAN identifier.
+  * @retval Packet index, -1 if the identifier is not exported.
+  */
+int32_t uCAN_ExportFind(const void* region, uint32_t id)
+{
+    const UCAN_ExportHeader* header = (const UCAN_ExportHeader*)region;
+    const UCAN_ExportDesc* desc = (const UCAN_ExportDesc*)((const uint8_t*)region + header->descOffset);
+    uint32_t low = 0;
+    uint32_t high = header->count;
+
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2U;
+
+        if (desc[mid].id == id)
+        {
+            return (int32_t)mid;
+        }
+
+        if (desc[mid].id < id)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return -1;
+}
+
+/**
+  * @brief  Copies the latest frame of a packet.
+  *
+  * The slot is copied between two reads of its sequence number and the copy
+  * is retried if the number was odd or moved, i.e. if the writer updated the
+  * slot meanwhile. No lock is taken, the writer is never delayed by readers.
+  *
+  * @param  region Region memory, validated with uCAN_ExportOpen().
+  * @param  index  Packet index.
+  * @param  frame  Output frame.
+  * @retval 1 if a frame was copied, 0 if none was received yet, -1 if the
+  *         slot kept changing or the index is out of range.
+  */
+int32_t uCAN_ExportRead(const void* region, uint32_t index, UCAN_ExportFrame* frame)
+{
+    const UCAN_ExportHeader* header = (const UCAN_ExportHeader*)region;
+
+    if (index >= header->count)
+    {
+        return -1;
+    }
+
+    const UCAN_ExportSlot* slot = (const UCAN_ExportSlot*)((const uint8_t*)region + header->slotOffset) + index;
+
+    for (uint32_t attempt = 0; attempt < UCAN_EXPORT_READ_RETRIES; attempt++)
+    {
+        uint32_t seq = slot->seq;
+        UCAN_EXPORT_FENCE();
+
+        if (seq == 0U)
+        {
+            return 0;
+        }
+
+        frame->dlc = slot->dlc;
+        frame->time = slot->time;
+        memcpy(frame->data, slot->data, sizeof(frame->data));
+
+        UCAN_EXPORT_FENCE();
+
+        if (!(seq & 1U) && slot->seq == seq)
+        {
+            frame->seq = seq;
+            return 1;
+        }
+    }
+
+    return -1;
+}
+
+/**
+  * @brief  Decodes one signal of a copied frame.
+  * @param  desc   Descriptor of the packet.
+  * @param  frame  Frame copied with uCAN_ExportRead().
+  * @param  signal Signal index below desc->signalCount.
+  * @retval Unsigned value of the signal, 0 for an invalid index.
+  */
+uint32_t uCAN_ExportSignalValue(const UCAN_ExportDesc* desc, const UCAN_ExportFrame* frame, uint32_t signal)
+{
+    if (signal >= desc->signalCount)
+    {
+        return 0;
+    }
+
+    const UCAN_ExportSignal* sig = &desc->signals[signal];
+    uint32_t value = 0;
+
+    // Little-endian, as uCAN maps the bytes of the bound variables
+    for (uint32_t i = sig->size; i > 0U; i--)
+    {
+        uint32_t byte = sig->offset + i - 1U;
+
+        value = (value << 8) | ((byte < 8U) ? frame->data[byte] : 0U);
+    }
+
+    return value;
+}
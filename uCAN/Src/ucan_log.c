@@ -0,0 +1,314 @@
+/**
+  ******************************************************************************
+  * @file    ucan_log.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Encoder and decoder of the compact uCAN binary log format.
+  *
+  * See ucan_log.h for the stream layout. The code uses no HAL or uCAN handle
+  * types, only the C standard library, and is shared between the firmware and
+  * host-side tools that read recorded logs.
+  *
+  * @see     uCAN GitHub repository: https://github.com/hamza-enes-balahoroglu/uCAN.git
+  *
+  *
+  *                          _____          _   _
+  *                         / ____|   /\   | \ | |
+  *                   _   _| |       /  \  |  \| |
+  *                  | | | | |      / /\ \ | . ` |
+  *                  | |_| | |____ / ____ \| |\  |
+  *                   \____|\_____/_/    \_\_| \_|
+  *
+  ******************************************************************************
+  */
+
+
+#include "ucan_log.h"
+
+#define UCAN_LOG_TAG_DLC_MASK			0x0FU	/*!< Record tag: data length code */
+#define UCAN_LOG_TAG_HW_TIMESTAMP		0x10U	/*!< Record tag: hardware timestamp follows */
+#define UCAN_LOG_TAG_RTR				0x20U	/*!< Record tag: remote frame, no payload */
+#define UCAN_LOG_TAG_EXT				0x40U	/*!< Record tag: extended identifier */
+#define UCAN_LOG_TAG_DICT				0x80U	/*!< Record tag: identifier given as dictionary slot */
+
+#define UCAN_LOG_DICT_EMPTY				0xFFFFFFFFU	/*!< Dictionary slot without identifier */
+#define UCAN_LOG_KEY_EXT				0x80000000U	/*!< Keeps standard and extended IDs apart in the dictionary */
+
+static const uint8_t logMagic[3] = { 'u', 'C', 'L' };
+
+/**
+  * @brief  Dictionary slot of an identifier key (Fibonacci hashing).
+  * @param  key Identifier, with UCAN_LOG_KEY_EXT set for extended frames.
+  * @retval Slot index below UCAN_LOG_DICT_SIZE.
+  */
+static uint32_t uCAN_Log_Slot(uint32_t key)
+{
+    return (key * 2654435761U) >> (32U - UCAN_LOG_DICT_BITS);
+}
+
+/**
+  * @brief  Resets a log context to the start-of-stream state.
+  *
+  * Both sides start with an empty dictionary and a previous tick of zero, so
+  * the first record stores its absolute tick as delta.
+  *
+  * @param  ctx Pointer to the log context.
+  */
+void uCAN_LogInit(UCAN_LogContext* ctx)
+{
+    ctx->lastTick = 0;
+
+    for (uint32_t i = 0; i < UCAN_LOG_DICT_SIZE; i++)
+    {
+        ctx->dict[i] = UCAN_LOG_DICT_EMPTY;
+    }
+}
+
+/**
+  * @brief  Writes the 4-byte stream header.
+  * @param  out   Destination buffer.
+  * @param  space Free bytes in the destination buffer.
+  * @retval Number of bytes written, 0 if the buffer is too small.
+  */
+uint32_t uCAN_LogWriteHeader(uint8_t* out, uint32_t space)
+{
+    if (space < UCAN_LOG_HEADER_SIZE)
+    {
+        return 0;
+    }
+
+    out[0] = logMagic[0];
+    out[1] = logMagic[1];
+    out[2] = logMagic[2];
+    out[3] = UCAN_LOG_VERSION;
+
+    return UCAN_LOG_HEADER_SIZE;
+}
+
+/**
+  * @brief  Validates the stream header.
+  * @param  in  Source buffer.
+  * @param  len Number of bytes available.
+  * @retval Number of header bytes, 0 if the header is missing or of another version.
+  */
+uint32_t uCAN_LogReadHeader(const uint8_t* in, uint32_t len)
+{
+    if (len < UCAN_LOG_HEADER_SIZE ||
+        in[0] != logMagic[0] || in[1] != logMagic[1] || in[2] != logMagic[2] ||
+        in[3] != UCAN_LOG_VERSION)
+    {
+        return 0;
+    }
+
+    return UCAN_LOG_HEADER_SIZE;
+}
+
+/**
+  * @brief  Appends one frame to the stream.
+  *
+  * The record size is computed first, so a record that does not fit leaves
+  * both the buffer and the dictionary untouched and can be retried into the
+  * next buffer.
+  *
+  * @param  ctx   Pointer to the encoder context.
+  * @param  frame Frame to encode.
+  * @param  out   Destination buffer.
+  * @param  space Free bytes in the destination buffer.
+  * @retval Number of bytes written, 0 if the record does not fit.
+  */
+uint32_t uCAN_LogEncode(UCAN_LogContext* ctx, const UCAN_MonitorFrame* frame, uint8_t* out, uint32_t space)
+{
+    uint8_t ext = (frame->flags & UCAN_MONITOR_FLAG_EXT) != 0U;
+    uint8_t rtr = (frame->flags & UCAN_MONITOR_FLAG_RTR) != 0U;
+    uint8_t dlc = (frame->dlc > 8U) ? 8U : frame->dlc;
+    uint8_t payload = rtr ? 0U : dlc;
+
+    uint32_t key = ext ? (frame->id | UCAN_LOG_KEY_EXT) : frame->id;
+    uint32_t slot = uCAN_Log_Slot(key);
+    uint8_t hit = (ctx->dict[slot] == key);
+
+    uint32_t delta = frame->tick - ctx->lastTick;
+    uint32_t deltaLen = 1;
+
+    for (uint32_t rest = delta >> 7; rest != 0U; rest >>= 7)
+    {
+        deltaLen++;
+    }
+
+    uint32_t idLen = hit ? 1U : (ext ? 4U : 2U);
+    uint32_t size = 1U + deltaLen + idLen + (ctx->hwTimestamps ? 2U : 0U) + payload;
+
+    if (size > space)
+    {
+        return 0;
+    }
+
+    uint32_t pos = 0;
+
+    // Record tag
+    out[pos++] = (uint8_t)(dlc |
+                           (ctx->hwTimestamps ? UCAN_LOG_TAG_HW_TIMESTAMP : 0U) |
+                           (rtr ? UCAN_LOG_TAG_RTR : 0U) |
+                           (ext ? UCAN_LOG_TAG_EXT : 0U) |
+                           (hit ? UCAN_LOG_TAG_DICT : 0U));
+
+    // Time delta as LEB128 varint
+    while (delta >= 0x80U)
+    {
+        out[pos++] = (uint8_t)(delta | 0x80U);
+        delta >>= 7;
+    }
+
+    out[pos++] = (uint8_t)delta;
+
+    // Identifier, raw IDs enter the dictionary on both sides
+    if (hit)
+    {
+        out[pos++] = (uint8_t)slot;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < idLen; i++)
+        {
+            out[pos++] = (uint8_t)(frame->id >> (8U * i));
+        }
+
+        ctx->dict[slot] = key;
+    }
+
+    if (ctx->hwTimestamps)
+    {
+        out[pos++] = (uint8_t)frame->timestamp;
+        out[pos++] = (uint8_t)(frame->timestamp >> 8);
+    }
+
+    for (uint8_t i = 0; i < payload; i++)
+    {
+        out[pos++] = frame->data[i];
+    }
+
+    ctx->lastTick = frame->tick;
+
+    return pos;
+}
+
+/**
+  * @brief  Reads one frame from the stream.
+  *
+  * Records are self-delimiting, so a stream is decoded by calling this
+  * function repeatedly and advancing by the returned length. Frames decoded
+  * without a stored hardware timestamp report a timestamp of zero.
+  *
+  * @param  ctx   Pointer to the decoder context.
+  * @param  in    Source buffer positioned at a record.
+  * @param  len   Number of bytes available.
+  * @param  frame Output frame.
+  * @retval Bytes consumed, 0 if the record is incomplete, -1 if the stream is malformed.
+  */
+int32_t uCAN_LogDecode(UCAN_LogContext* ctx, const uint8_t* in, uint32_t len, UCAN_MonitorFrame* frame)
+{
+    uint32_t pos = 0;
+
+    if (len < 2U)
+    {
+        return 0;
+    }
+
+    uint8_t tag = in[pos++];
+    uint8_t dlc = tag & UCAN_LOG_TAG_DLC_MASK;
+    uint8_t ext = (tag & UCAN_LOG_TAG_EXT) != 0U;
+    uint8_t rtr = (tag & UCAN_LOG_TAG_RTR) != 0U;
+
+    if (dlc > 8U)
+    {
+        return -1;
+    }
+
+    // Time delta, at most 5 varint bytes for 32 bits
+    uint32_t delta = 0;
+    uint32_t shift = 0;
+
+    for (;;)
+    {
+        if (pos >= len)
+        {
+            return 0;
+        }
+
+        uint8_t byte = in[pos++];
+
+        // Fifth byte may only carry the top 4 bits
+        if (shift == 28U && byte > 0x0FU)
+        {
+            return -1;
+        }
+
+        delta |= (uint32_t)(byte & 0x7FU) << shift;
+        shift += 7U;
+
+        if ((byte & 0x80U) == 0U)
+        {
+            break;
+        }
+    }
+
+    uint32_t idLen = (tag & UCAN_LOG_TAG_DICT) ? 1U : (ext ? 4U : 2U);
+    uint32_t payload = rtr ? 0U : dlc;
+    uint32_t tsLen = (tag & UCAN_LOG_TAG_HW_TIMESTAMP) ? 2U : 0U;
+
+    if (len - pos < idLen + tsLen + payload)
+    {
+        return 0;
+    }
+
+    uint32_t key;
+
+    if (tag & UCAN_LOG_TAG_DICT)
+    {
+        uint8_t slot = in[pos++];
+
+        if (slot >= UCAN_LOG_DICT_SIZE || ctx->dict[slot] == UCAN_LOG_DICT_EMPTY ||
+            ((ctx->dict[slot] & UCAN_LOG_KEY_EXT) != 0U) != ext)
+        {
+            return -1;
+        }
+
+        key = ctx->dict[slot];
+    }
+    else
+    {
+        key = 0;
+
+        for (uint32_t i = 0; i < idLen; i++)
+        {
+            key |= (uint32_t)in[pos++] << (8U * i);
+        }
+
+        if (ext)
+        {
+            key |= UCAN_LOG_KEY_EXT;
+        }
+
+        ctx->dict[uCAN_Log_Slot(key)] = key;
+    }
+
+    frame->id = key & ~UCAN_LOG_KEY_EXT;
+    frame->tick = ctx->lastTick + delta;
+    frame->dlc = dlc;
+    frame->flags = (uint8_t)((ext ? UCAN_MONITOR_FLAG_EXT : 0U) | (rtr ? UCAN_MONITOR_FLAG_RTR : 0U));
+    frame->timestamp = 0;
+
+    if (tsLen != 0U)
+    {
+        frame->timestamp = (uint16_t)(in[pos] | ((uint16_t)in[pos + 1] << 8));
+        pos += 2U;
+    }
+
+    for (uint32_t i = 0; i < payload; i++)
+    {
+        frame->data[i] = in[pos++];
+    }
+
+    ctx->lastTick = frame->tick;
+
+    return (int32_t)pos;
+}
@@ -33,277 +33,2686 @@
 
 
 #include <stdlib.h>
+#include <string.h>
 #include "ucan_runtime.h"
 
+/**
+  * @brief [INTERNAL] Reads the current payload of a TX packet once.
+  *
+  * Bytes are read through the packet's pointers, or with one copy of the
+  * bound overlay struct. Nothing protects multi-byte values from an update
+  * in the middle of the read; callers compare two reads to detect that.
+  *
+  * @param packet TX packet to read.
+  * @param data   Output buffer of at least `packet->dlc` bytes.
+  *
+  * @retval UCAN_OK              Payload copied.
+  * @retval UCAN_BUSY            The double-buffered overlay kept changing.
+  */
+static UCAN_StatusTypeDef uCAN_Runtime_CapturePacket(const UCAN_Packet* packet, uint8_t data[])
+{
+#if UCAN_CFG_OVERLAY
+    if (packet->overlay != NULL)
+    {
+        // One copy of the bound struct (front buffer if double-buffered)
+        return (uCAN_Runtime_LoadOverlay(packet, data) == UCAN_OK) ? UCAN_OK : UCAN_BUSY;
+    }
+#endif
+
+    for (uint8_t i = 0; i < packet->dlc; i++)
+    {
+        data[i] = *(volatile uint8_t*)packet->bits[i];
+    }
+
+    return UCAN_OK;
+}
+
+/**
+  * @brief [INTERNAL] Checks that a TX packet still holds a captured payload.
+  *
+  * @param packet TX packet to read again.
+  * @param data   Payload captured earlier by uCAN_Runtime_CapturePacket().
+  *
+  * @retval 1 if the packet reads the same bytes, 0 if a variable changed in between.
+  */
+static uint8_t uCAN_Runtime_PacketUnchanged(const UCAN_Packet* packet, const uint8_t data[])
+{
+    uint8_t current[8];
+
+    return (uCAN_Runtime_CapturePacket(packet, current) == UCAN_OK &&
+            memcmp(current, data, packet->dlc) == 0) ? 1U : 0U;
+}
+
+/**
+  * @brief [INTERNAL] Captures a consistent copy of the payload of a single TX packet.
+  *
+  * Same scheme as uCAN_Runtime_LatchPackets() for one packet: the payload is
+  * read, read again and compared, and captured again if a variable changed in
+  * between. After UCAN_TX_LATCH_RETRIES attempts it is read once with
+  * interrupts masked, so a multi-byte value is never sent half updated.
+  *
+  * @param packet TX packet to latch.
+  * @param data   Output buffer of at least `packet->dlc` bytes.
+  *
+  * @retval UCAN_OK              Payload latched consistently.
+  * @retval UCAN_BUSY            A double-buffered overlay was being written by a context this
+  *                              call preempted.
+  */
+static UCAN_StatusTypeDef uCAN_Runtime_LatchPacket(const UCAN_Packet* packet, uint8_t data[])
+{
+    for (uint32_t attempt = 0; attempt < UCAN_TX_LATCH_RETRIES; attempt++)
+    {
+        if (uCAN_Runtime_CapturePacket(packet, data) == UCAN_OK && uCAN_Runtime_PacketUnchanged(packet, data))
+        {
+            return UCAN_OK;
+        }
+    }
+
+    // Variables kept changing, read once more with interrupts masked
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    UCAN_StatusTypeDef status = uCAN_Runtime_CapturePacket(packet, data);
+
+    __set_PRIMASK(primask);
+
+    return status;
+}
+
 /**
   * @brief [INTERNAL] Sends a single CAN packet using the HAL CAN interface.
   *
   * Used internally by the UCAN core to transmit a constructed UCAN_Packet over the CAN bus.
   * This function should not be called directly from user application code. It assumes that
-  * the CAN peripheral (`hcan`) is already initialized and started.
+  * the CAN peripherals in `buses` are already initialized and started.
   *
   * It builds a standard CAN frame using the packet’s ID and data length (`dlc`), and
-  * populates the TX data buffer by dereferencing the individual pointers in the
-  * `packet->bits[]` array. The actual transmission is handled via `HAL_CAN_AddTxMessage()`.
+  * populates the TX data buffer with a consistent copy of the packet's variables, or of
+  * the bound overlay struct, taken by uCAN_Runtime_LatchPacket(). A traced packet
+  * gets its latency trailer appended. Critical packets are handed to `uCAN_Runtime_SendCriticalFrame()`,
+  * all others to `uCAN_Runtime_SendFrame()`.
   *
-  * @param hcan    Pointer to the HAL CAN handle.
+  * @param buses   Buses of the handle (UCAN_BUS_COUNT entries).
   * @param packet  Pointer to the UCAN packet to be transmitted.
   *
   * @retval UCAN_OK              Packet sent successfully.
   * @retval UCAN_INVALID_PARAM   Provided pointer is NULL.
+  * @retval UCAN_BUSY            No mailbox available to the packet's class, or the
+  *                              double-buffered overlay kept changing.
   * @retval UCAN_ERROR           HAL CAN transmission failed.
   */
-UCAN_StatusTypeDef uCAN_Runtime_SendPacket(CAN_HandleTypeDef* hcan, UCAN_Packet* packet)
+UCAN_StatusTypeDef uCAN_Runtime_SendPacket(UCAN_Bus* buses, UCAN_Packet* packet)
 {
-    if (hcan == NULL || packet == NULL)
+    if (buses == NULL || packet == NULL)
     {
         return UCAN_INVALID_PARAM;
     }
 
+    uint8_t data[8];
+
+    // Sample the packet's variables at one instant, an update from an interrupt
+    // must not leave a multi-byte value half old and half new in the frame
+    if (uCAN_Runtime_LatchPacket(packet, data) != UCAN_OK)
+    {
+        return UCAN_BUSY;
+    }
+
+    uint8_t dlc = packet->dlc;
+
+#if UCAN_CFG_LATENCY
+    if (packet->latency != NULL)
+    {
+        // Payload read just now, the sample instant is the send time unless marked
+        dlc = uCAN_Runtime_StampLatency(packet->latency, data, dlc, 0U);
+    }
+#endif
+
+    UCAN_StatusTypeDef status = packet->critical ?
+        uCAN_Runtime_SendCriticalFrame(buses, packet->id, dlc, data) :
+        uCAN_Runtime_SendFrame(buses, packet->id, dlc, data);
+
+#if UCAN_CFG_LATENCY
+    if (status == UCAN_OK && packet->latency != NULL)
+    {
+        // Frame is on its way, the next one gets a new number and sample
+        packet->latency->txSeq++;
+        packet->latency->sampled = 0;
+    }
+#endif
+
+    return status;
+}
+
+/**
+  * @brief [INTERNAL] Queues a raw standard data frame on every usable bus.
+  *
+  * A bus takes the frame if its controller is not bus-off and more than `reserve`
+  * of its mailboxes are free. A bus that cannot take the frame right now is not
+  * waited for; if another bus of a redundant pair queued the frame, it is counted
+  * as skipped on this one. A failed bus therefore costs the other one no latency.
+  *
+  * @param buses   Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param id      Standard CAN identifier.
+  * @param dlc     Number of payload bytes (0 to 8).
+  * @param data    Pointer to the payload bytes.
+  * @param reserve Mailboxes the frame may not take, 0 lets it use any free mailbox.
+  *
+  * @retval UCAN_OK              Frame queued on at least one bus.
+  * @retval UCAN_BUSY            No bus had a mailbox for the frame, nothing was queued.
+  * @retval UCAN_ERROR           HAL CAN transmission failed and no bus took the frame.
+  */
+static UCAN_StatusTypeDef uCAN_Runtime_QueueFrame(UCAN_Bus* buses, uint32_t id, uint8_t dlc, uint8_t data[], uint32_t reserve)
+{
     CAN_TxHeaderTypeDef txHeader;
     uint32_t TxMailbox;
-    uint8_t data[8];
+    UCAN_StatusTypeDef status = UCAN_BUSY;
+    uint8_t missed = 0;
 
     // Construct standard data frame header
-    txHeader.StdId = packet->id;
-    txHeader.DLC   = packet->dlc;
+    txHeader.StdId = id;
+    txHeader.DLC   = dlc;
     txHeader.IDE   = CAN_ID_STD;
     txHeader.RTR   = CAN_RTR_DATA;
+    txHeader.TransmitGlobalTime = DISABLE;
+
+    for (uint32_t b = 0; b < UCAN_BUS_COUNT; b++)
+    {
+        CAN_HandleTypeDef* hcan = buses[b].hcan;
+
+        if (hcan == NULL)
+        {
+            // Redundant controller not wired
+            continue;
+        }
+
+#if UCAN_CFG_FAULT
+        if (buses[b].fault != NULL)
+        {
+            // Bus held in bus-off by the fault scenario
+            if (uCAN_Runtime_FaultBusOff(buses[b].fault, (uint8_t)b))
+            {
+                missed |= (uint8_t)(1U << b);
+                continue;
+            }
+
+            // Frame lost on the way, the caller sees it as queued
+            if (uCAN_Runtime_FaultTx(buses[b].fault, (uint8_t)b, id))
+            {
+                buses[b].txFrames++;
+                status = UCAN_OK;
+                continue;
+            }
+        }
+#endif
+
+        // Bus-off controller, or no mailbox left for this class
+        if ((hcan->Instance->ESR & CAN_ESR_BOFF) || HAL_CAN_GetTxMailboxesFreeLevel(hcan) <= reserve)
+        {
+            missed |= (uint8_t)(1U << b);
+            continue;
+        }
+
+        // Transmit the CAN message
+        if (HAL_CAN_AddTxMessage(hcan, &txHeader, data, &TxMailbox) != HAL_OK)
+        {
+            missed |= (uint8_t)(1U << b);
+
+            if (status == UCAN_BUSY)
+            {
+                status = UCAN_ERROR;
+            }
+            continue;
+        }
 
-    // Copy data bytes from packet pointers
-    for (int i = 0; i < packet->dlc; i++) {
-        data[i] = *(packet->bits[i]);
+        buses[b].txFrames++;
+        status = UCAN_OK;
     }
 
-    // Transmit the CAN message
-    if (HAL_CAN_AddTxMessage(hcan, &txHeader, data, &TxMailbox) != HAL_OK)
+    if (status != UCAN_OK)
     {
-        return UCAN_ERROR;
+        if (status == UCAN_ERROR)
+        {
+            UCAN_TRACE(UCAN_TRACE_ERROR, UCAN_ERROR);
+        }
+        return status;
+    }
+
+    // Went out on the other bus only
+    for (uint32_t b = 0; missed != 0U; b++, missed >>= 1)
+    {
+        if (missed & 1U)
+        {
+            buses[b].txSkipped++;
+        }
     }
 
+    UCAN_TRACE(UCAN_TRACE_TX, id);
+
     return UCAN_OK;
 }
 
 /**
-  * @brief [INTERNAL] Sends a handshake request ("ping") from the master node to all clients.
+  * @brief [INTERNAL] Sends a raw standard data frame of the bulk class.
   *
-  * This function is used internally by the UCAN core to periodically send handshake requests
-  * over the CAN bus. It should only be called by a master node. The function ensures that
-  * handshake pings are only sent if the defined interval (`UCAN_HANDSHAKE_INTERVAL_MS`) has passed
-  * since the last ping.
+  * Transmit helper shared by non-critical packet, latched and handshake transmissions.
+  * The frame is only queued while more than `UCAN_CFG_RESERVED_MAILBOXES` mailboxes are
+  * free, so bulk traffic can never take the mailboxes kept for critical frames.
   *
-  * The handshake packet is a 1-byte CAN message containing a predefined constant
-  * (`UCAN_HANDSHAKE_REQUEST_VALUE`) and is sent with the master's own CAN ID (`node->selfId`).
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param id    Standard CAN identifier.
+  * @param dlc   Number of payload bytes (0 to 8).
+  * @param data  Pointer to the payload bytes.
   *
-  * If the interval condition is met, it creates a UCAN_Packet and transmits it via
-  * `uCAN_Runtime_SendPacket()`. It also updates `node->sentTick` to record the last ping time.
+  * @retval UCAN_OK              Frame queued successfully.
+  * @retval UCAN_INVALID_PARAM   Provided pointer is NULL.
+  * @retval UCAN_BUSY            Only reserved mailboxes are free, nothing was queued.
+  * @retval UCAN_ERROR           HAL CAN transmission failed.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SendFrame(UCAN_Bus* buses, uint32_t id, uint8_t dlc, uint8_t data[])
+{
+    if (buses == NULL || data == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    // Leave the reserved mailboxes to critical frames
+    return uCAN_Runtime_QueueFrame(buses, id, dlc, data, UCAN_CFG_RESERVED_MAILBOXES);
+}
+
+/**
+  * @brief [INTERNAL] Sends a raw standard data frame using any free mailbox.
   *
-  * @param hcan Pointer to the CAN peripheral handle.
-  * @param node Pointer to the UCAN node information structure.
+  * Used directly for critical packets, which may take the reserved mailboxes.
+  * The payload is passed by value in `data`; no application memory is read here.
   *
-  * @retval UCAN_OK              Ping was sent successfully.
-  * @retval UCAN_BUSY            Ping was not sent because the interval hasn't passed.
-  * @retval UCAN_INVALID_PARAM   One or more parameters are NULL.
-  * @retval UCAN_ERROR           Called on a node that is not configured as master.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param id    Standard CAN identifier.
+  * @param dlc   Number of payload bytes (0 to 8).
+  * @param data  Pointer to the payload bytes.
+  *
+  * @retval UCAN_OK              Frame queued successfully.
+  * @retval UCAN_INVALID_PARAM   Provided pointer is NULL.
+  * @retval UCAN_BUSY            All three mailboxes are pending, nothing was queued.
+  * @retval UCAN_ERROR           HAL CAN transmission failed.
   */
-UCAN_StatusTypeDef uCAN_Runtime_SendPing(CAN_HandleTypeDef* hcan, UCAN_NodeInfo* node)
+UCAN_StatusTypeDef uCAN_Runtime_SendCriticalFrame(UCAN_Bus* buses, uint32_t id, uint8_t dlc, uint8_t data[])
 {
-    if(hcan == NULL || node == NULL)
+    if (buses == NULL || data == NULL)
     {
-        // check for null pointers to avoid crash
         return UCAN_INVALID_PARAM;
     }
 
-    if(node->role != UCAN_ROLE_MASTER)
+    return uCAN_Runtime_QueueFrame(buses, id, dlc, data, 0U);
+}
+
+/**
+  * @brief [INTERNAL] Captures a consistent copy of all TX payloads into the packets' staging area.
+  *
+  * Every byte of every TX packet is copied from the application variables into
+  * `packet->latched[]` in one tight pass, then re-read and compared in a second
+  * pass. If any byte changed in between (an interrupt updated a variable during
+  * the capture, possibly tearing a multi-byte value), the whole set is captured
+  * again. If the variables still differ after UCAN_TX_LATCH_RETRIES attempts,
+  * the set is captured once with interrupts masked, which costs one short copy
+  * of all payloads in the critical section but never leaves the TX set unsent.
+  *
+  * When both passes agree, all packets reflect the same sampling instant and
+  * the transmission can proceed from the staging copies while the application
+  * keeps updating its variables.
+  *
+  * @param txHolder Pointer to the TX packet holder.
+  * @param tick     Timestamp in milliseconds recorded as the latch instant.
+  *
+  * @retval UCAN_OK              All payloads latched consistently.
+  * @retval UCAN_INVALID_PARAM   txHolder is NULL.
+  * @retval UCAN_BUSY            A double-buffered overlay was being written by a context this
+  *                              call preempted, so no consistent copy exists yet.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_LatchPackets(UCAN_PacketHolder* txHolder, uint32_t tick)
+{
+    if (txHolder == NULL)
     {
-        // only master nodes can send handshake pings
-        return UCAN_ERROR;
+        return UCAN_INVALID_PARAM;
     }
 
-    // check if handshake interval has elapsed since last ping
-    if(HAL_GetTick() - node->sentTick >= UCAN_HANDSHAKE_INTERVAL_MS)
+    for (uint32_t attempt = 0; attempt < UCAN_TX_LATCH_RETRIES; attempt++)
     {
-        UCAN_Packet packet;
-        uint8_t request = UCAN_HANDSHAKE_REQUEST_VALUE;
+        uint8_t consistent = 1;
+
+        // Capture pass
+        for (uint32_t p = 0; p < txHolder->count; p++)
+        {
+            if (uCAN_Runtime_CapturePacket(&txHolder->packets[p], txHolder->packets[p].latched) != UCAN_OK)
+            {
+                consistent = 0;
+            }
+        }
 
-        packet.id = node->selfId;    // set CAN ID to master's own ID
-        packet.dlc = 1;              // data length = 1 byte
+        // Verification pass, any difference means a concurrent update
+        for (uint32_t p = 0; p < txHolder->count && consistent; p++)
+        {
+            consistent = uCAN_Runtime_PacketUnchanged(&txHolder->packets[p], txHolder->packets[p].latched);
+        }
 
-        packet.bits[0] = &request;   // point to handshake request value
+        if (consistent)
+        {
+            txHolder->latchTick = tick;
+            return UCAN_OK;
+        }
+    }
 
-        node->sentTick = HAL_GetTick();  // update last sent timestamp
+    // Variables kept changing, capture once more with interrupts masked so a
+    // fast writer cannot starve the transmission
+    uint32_t primask = __get_PRIMASK();
+    UCAN_StatusTypeDef status = UCAN_OK;
+    __disable_irq();
 
-        return uCAN_Runtime_SendPacket(hcan, &packet);  // transmit handshake ping
+    for (uint32_t p = 0; p < txHolder->count; p++)
+    {
+        // Only fails if this context preempted a double-buffered overlay writer
+        if (uCAN_Runtime_CapturePacket(&txHolder->packets[p], txHolder->packets[p].latched) != UCAN_OK)
+        {
+            status = UCAN_BUSY;
+        }
     }
 
-    // interval not yet reached, skip sending
-    return UCAN_BUSY;
+    __set_PRIMASK(primask);
+
+    if (status == UCAN_OK)
+    {
+        txHolder->latchTick = tick;
+    }
+
+    return status;
 }
 
 /**
-  * @brief [INTERNAL] Sends a handshake response ("pong") from a client node to the master.
+  * @brief [INTERNAL] Reads the counter and extends it to 64 bits.
   *
-  * This function is intended for internal use within the UCAN core. It transmits a 1-byte
-  * handshake response message from a client node indicating active presence to the master.
-  * Only nodes configured as clients should call this function.
+  * The epoch word is read before the counter. If the counter's top bit was set
+  * at the last extension and is clear now, the counter wrapped and the wrap
+  * count is advanced. The new epoch is written with one 32-bit store, so any
+  * context may call this function without locking: a preempted caller can at
+  * worst store an epoch that another context already stored.
   *
-  * @param hcan Pointer to the HAL CAN handle.
-  * @param node Pointer to the UCAN node structure.
+  * @param timebase Pointer to the finalized timebase.
+  * @retval UCAN_Time Current time in counts.
   *
-  * @retval UCAN_OK              Response packet sent successfully.
-  * @retval UCAN_INVALID_PARAM   Null pointer provided.
-  * @retval UCAN_ERROR           Node is not configured as a client.
+  * @note Must run at least once per half counter period (e.g. every 12.7 s for
+  *       DWT->CYCCNT at 168 MHz), otherwise a wrap is missed.
   */
-UCAN_StatusTypeDef uCAN_Runtime_SendPong(CAN_HandleTypeDef* hcan, UCAN_NodeInfo* node)
+static UCAN_Time uCAN_Runtime_Extend(UCAN_Timebase* timebase)
 {
-    if(hcan == NULL || node == NULL)
+    uint32_t epoch = timebase->epoch;
+    __DMB();
+
+    uint32_t raw = (timebase->read != NULL) ? timebase->read() : HAL_GetTick();
+    uint32_t wraps = epoch >> 1;
+
+    // Top bit went from 1 to 0, the counter wrapped since the last extension
+    if ((epoch & 1U) && !(raw >> 31))
     {
-        // Validate input pointers to prevent null dereference
-        return UCAN_INVALID_PARAM;
+        wraps++;
     }
 
-    if(node->role != UCAN_ROLE_CLIENT)
+    uint32_t next = (wraps << 1) | (raw >> 31);
+
+    if (next != epoch)
     {
-        // Only client nodes are allowed to send handshake responses
-        return UCAN_ERROR;
+        timebase->epoch = next;
     }
 
-    UCAN_Packet packet;
-    uint8_t response = UCAN_HANDSHAKE_RESPONSE_VALUE;
+    return ((UCAN_Time)wraps << 32) | raw;
+}
 
-    packet.id = node->selfId;    // Use the client's own CAN ID
-    packet.dlc = 1;              // Set data length to 1 byte
+/**
+  * @brief [INTERNAL] Reads the timebase and extends the counter to 64 bits.
+  * @param timebase Pointer to the finalized timebase.
+  * @retval UCAN_Time Current time in counts, including injected clock drift.
+  */
+UCAN_Time uCAN_Runtime_Now(UCAN_Timebase* timebase)
+{
+#if UCAN_CFG_FAULT
+    UCAN_Time base = uCAN_Runtime_Extend(timebase);
+    UCAN_Time time = base + (UCAN_Time)timebase->driftOffset;
+    int32_t ppm = timebase->driftPpm;
 
-    packet.bits[0] = &response;  // Point to handshake response constant
+    // Drift of finished windows, plus the share of the running one
+    if (ppm != 0)
+    {
+        time += (UCAN_Time)(((int64_t)(base - timebase->driftStart) * ppm) / 1000000);
+    }
 
-    // Send the handshake response packet over CAN bus
-    return uCAN_Runtime_SendPacket(hcan, &packet);
+    return time;
+#else
+    return uCAN_Runtime_Extend(timebase);
+#endif
 }
 
 /**
-  * @brief [INTERNAL] Updates RX packet data matching the received CAN ID.
-  *
-  * Searches the RX packet list for a packet with the given standard CAN ID (`StdId`).
-  * If found, copies the received data bytes into the packet's data pointers.
-  *
-  * @param rxHolder Pointer to the RX packet holder containing packet array.
-  * @param StdId    Standard CAN ID of the received message.
-  * @param aData    Array of received data bytes.
-  *
-  * @retval UCAN_OK              Packet updated successfully.
-  * @retval UCAN_INVALID_PARAM   rxHolder is NULL.
-  * @retval UCAN_ERROR_UNKNOWN_ID No matching packet found for StdId.
+  * @brief [INTERNAL] Converts a time to milliseconds, truncated to 32 bits like HAL_GetTick().
+  * @param timebase Pointer to the finalized timebase.
+  * @param time     Time in counts.
+  * @retval uint32_t Milliseconds.
   */
-UCAN_StatusTypeDef uCAN_Runtime_UpdatePacket(UCAN_PacketHolder* rxHolder, uint32_t StdId, uint8_t aData[])
+uint32_t uCAN_Runtime_TimeToMs(const UCAN_Timebase* timebase, UCAN_Time time)
 {
-    if(rxHolder == NULL)
+    // HAL_GetTick() fallback needs no division
+    if (timebase->countsPerMs == 1U)
     {
-        // Null pointer guard
-        return UCAN_INVALID_PARAM;
+        return (uint32_t)time;
     }
 
-    // Create search key with received StdId
-    UCAN_Packet packetKey = {.id = StdId};
+    return (uint32_t)(time / timebase->countsPerMs);
+}
 
-    // Search packet array by ID
-    UCAN_Packet* packetFound = bsearch(&packetKey, rxHolder->packets, rxHolder->count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+/**
+  * @brief [INTERNAL] Converts a duration in milliseconds to timebase counts.
+  * @param timebase Pointer to the finalized timebase.
+  * @param ms       Duration in milliseconds.
+  * @retval UCAN_Time Duration in counts.
+  */
+UCAN_Time uCAN_Runtime_MsToTime(const UCAN_Timebase* timebase, uint32_t ms)
+{
+    return (UCAN_Time)ms * timebase->countsPerMs;
+}
 
-    if(packetFound == NULL)
-    {
-        // Packet with StdId not found
-        return UCAN_ERROR_UNKNOWN_ID;
-    }
+/**
+  * @brief [INTERNAL] Converts a time to microseconds.
+  * @param timebase Pointer to the finalized timebase.
+  * @param time     Time in counts.
+  * @retval uint64_t Microseconds.
+  */
+uint64_t uCAN_Runtime_TimeToUs(const UCAN_Timebase* timebase, UCAN_Time time)
+{
+    uint32_t perMs = timebase->countsPerMs;
 
-    // Update packet data bytes from received data
-    for(int i = 0; i < packetFound->dlc; i++) {
-        *(packetFound->bits[i]) = aData[i];
-    }
+    // Whole milliseconds and remainder separately, so the product cannot overflow
+    return (time / perMs) * 1000U + ((time % perMs) * 1000U) / perMs;
+}
 
-    return UCAN_OK;
+/**
+  * @brief [INTERNAL] Reads a 64-bit time written by an interrupt.
+  *
+  * A 64-bit load takes two bus accesses on Cortex-M4. The value is read until two
+  * consecutive reads agree, which rules out a read torn by a higher priority writer.
+  *
+  * @param time Pointer to the time written by another context.
+  * @retval UCAN_Time Consistent copy of the time.
+  */
+UCAN_Time uCAN_Runtime_LoadTime(const volatile UCAN_Time* time)
+{
+    UCAN_Time first;
+    UCAN_Time second;
+
+    do
+    {
+        first = *time;
+        second = *time;
+    } while (first != second);
+
+    return first;
 }
 
 /**
-  * @brief [INTERNAL] Process incoming handshake messages based on node role.
+  * @brief [INTERNAL] Sends a handshake request ("ping") from the master node to all clients.
   *
-  * For master nodes, updates the responseTick of the client matching the received StdId
-  * if the handshake response value matches.
+  * This function is used internally by the UCAN core to periodically send handshake requests
+  * over the CAN bus. It should only be called by a master node. The function ensures that
+  * handshake pings are only sent if the defined interval (`UCAN_HANDSHAKE_INTERVAL_MS`) has passed
+  * since the last ping.
   *
-  * For client nodes, verifies the message is from the master and the handshake request value,
-  * then updates sentTick and sends a handshake reply.
+  * The handshake packet starts with a predefined constant (`UCAN_HANDSHAKE_REQUEST_VALUE`)
+  * and is sent with the master's own CAN ID (`node->selfId`). It also carries the master's
+  * protocol version and capabilities at the `UCAN_PING_xxx` offsets. While an active client's
+  * capabilities are unknown, `UCAN_PING_FLAG_CAPS_REQUEST` and `UCAN_PING_CAPS_ID` ask that
+  * client, and only that one, to answer with a capability frame instead of the usual
+  * response. The other clients keep sending their pongs, so their health records and round
+  * trips stay current. Clients are asked one per ping, in identifier order.
   *
-  * @param node  Pointer to UCAN node info structure.
-  * @param hcan  Pointer to HAL CAN handle.
-  * @param StdId Standard CAN ID of the received message.
-  * @param aData Pointer to received data bytes.
+  * If the interval condition is met, it transmits the request via
+  * `uCAN_Runtime_SendFrame()`. Once the ping is queued, `node->sentTime` records the last
+  * ping time; the first ping goes out as soon as `UCAN_NODE_TIME_SENT` is clear. A ping that
+  * finds no free bulk mailbox leaves both untouched, so the next call tries again instead of
+  * waiting a whole interval.
   *
-  * @retval UCAN_OK              Handshake processed successfully.
-  * @retval UCAN_INVALID_PARAM   Null pointer input.
-  * @retval UCAN_ERROR_UNKNOWN_ID Received StdId not found or unexpected sender.
-  * @retval UCAN_ERROR           Handshake data value mismatch.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param node Pointer to the UCAN node information structure.
+  *
+  * @retval UCAN_OK              Ping was sent successfully.
+  * @retval UCAN_BUSY            Ping was not sent because the interval hasn't passed or no
+  *                              bulk mailbox was free.
+  * @retval UCAN_INVALID_PARAM   One or more parameters are NULL.
+  * @retval UCAN_ERROR           Called on a node that is not configured as master.
+  *
+  * @note Compiled only when master handshake support is enabled in ucan_config.h.
   */
-UCAN_StatusTypeDef uCAN_Runtime_UpdateHandshake(UCAN_NodeInfo* node, CAN_HandleTypeDef* hcan, uint32_t StdId, uint8_t aData[])
+#if UCAN_CFG_HAS_MASTER
+UCAN_StatusTypeDef uCAN_Runtime_SendPing(UCAN_Bus* buses, UCAN_NodeInfo* node)
 {
-    if(node == NULL || hcan == NULL)
+    if(buses == NULL || node == NULL)
     {
-        // Validate pointers
+        // check for null pointers to avoid crash
         return UCAN_INVALID_PARAM;
     }
 
-    switch (node->role) {
-        case UCAN_ROLE_MASTER:
-        {
-            // Master expects handshake responses from clients
-            UCAN_Client handshakeKey = {.id = StdId};
-            UCAN_Client* handshakeFound = bsearch(&handshakeKey, node->clients, node->clientCount, sizeof(UCAN_Client), uCAN_Runtime_CompareClientId);
-
-            if(handshakeFound == NULL)
-            {
-                // Unknown client ID
-                return UCAN_ERROR_UNKNOWN_ID;
-            }
+    if(!UCAN_NODE_IS_MASTER(node))
+    {
+        // only master nodes can send handshake pings
+        return UCAN_ERROR;
+    }
 
-            if(aData[0] != UCAN_HANDSHAKE_RESPONSE_VALUE)
-            {
-                // Invalid handshake response data
-                return UCAN_ERROR;
-            }
+    UCAN_Time now = uCAN_Runtime_Now(node->timebase);
 
-            // Update client's last response timestamp
-            handshakeFound->responseTick = HAL_GetTick();
-            break;
-        }
+    // check if handshake interval has elapsed since last ping
+    if(!(node->timeFlags & UCAN_NODE_TIME_SENT) ||
+       UCAN_TIME_SINCE(now, node->sentTime) >= uCAN_Runtime_MsToTime(node->timebase, UCAN_HANDSHAKE_INTERVAL_MS))
+    {
+        uint8_t request[UCAN_PING_DLC];
+        uint16_t caps = UCAN_CAPS_LOCAL(node);
+        UCAN_Client* capsRequest = NULL;
 
-        case UCAN_ROLE_CLIENT:
+        // ask the first connected client that has not reported its capabilities
+        for(uint32_t i = 0; i < node->clientCount; i++)
         {
-            // Client expects handshake requests from master
-            if(StdId != node->masterId)
+            if(node->clients[i].status == UCAN_CONN_ACTIVE && !node->clients[i].caps.valid)
             {
-                // Message not from master
-                return UCAN_ERROR_UNKNOWN_ID;
+                capsRequest = &node->clients[i];
+                break;
             }
+        }
 
-            if(aData[0] != UCAN_HANDSHAKE_REQUEST_VALUE)
-            {
-                // Invalid handshake request data
-                return UCAN_ERROR;
-            }
+        request[0] = UCAN_HANDSHAKE_REQUEST_VALUE;
+        request[UCAN_PING_VERSION] = UCAN_PROTOCOL_VERSION;
+        request[UCAN_PING_CAPS] = (uint8_t)(caps & 0xFFU);
+        request[UCAN_PING_CAPS + 1] = (uint8_t)(caps >> 8);
+        request[UCAN_PING_FLAGS] = (capsRequest != NULL) ? UCAN_PING_FLAG_CAPS_REQUEST : 0U;
+        request[UCAN_PING_CAPS_ID] = (capsRequest != NULL) ? (uint8_t)(capsRequest->id & 0xFFU) : 0U;
+        request[UCAN_PING_CAPS_ID + 1] = (capsRequest != NULL) ? (uint8_t)(capsRequest->id >> 8) : 0U;
 
-            // Update last sent tick before replying
-            node->sentTick = HAL_GetTick();
+        // transmit handshake ping with master's own ID
+        UCAN_StatusTypeDef status = uCAN_Runtime_SendFrame(buses, node->selfId, UCAN_PING_DLC, request);
 
-            // Send handshake reply (pong)
-            uCAN_Runtime_SendPong(hcan, node);
-            break;
+        if(status == UCAN_OK)
+        {
+            // the interval restarts only once the ping is queued
+            node->sentTime = now;
+            node->timeFlags |= UCAN_NODE_TIME_SENT;
+            node->capsRequested = capsRequest;
         }
 
-        case UCAN_ROLE_NONE:
-        default:
-            // No handshake processing for undefined roles
-            break;
+        return status;
     }
 
-    return UCAN_OK;
+    // interval not yet reached, skip sending
+    return UCAN_BUSY;
+}
+#endif /* UCAN_CFG_HAS_MASTER */
+
+#if UCAN_CFG_HAS_MEMBERSHIP && UCAN_CFG_HAS_MASTER
+/**
+  * @brief [INTERNAL] Broadcasts the master's bitmap of active clients.
+  *
+  * The bitmap is split into chunks of `UCAN_MEMBERSHIP_BITS_PER_FRAME` bits, each sent
+  * in one frame with the master's own CAN ID:
+  *   - byte 0: `UCAN_MEMBERSHIP_VALUE`
+  *   - byte 1: chunk index
+  *   - byte 2: hash of the master's sorted client list
+  *   - bytes 3..7: client bits, LSB first (bit i = i-th client of the chunk)
+  *
+  * Frames are only as long as the last chunk requires. A chunk that cannot be queued
+  * aborts the broadcast; it is repeated in full at the next interval.
+  *
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param node Pointer to the UCAN node structure.
+  *
+  * @retval UCAN_OK              All chunks queued.
+  * @retval UCAN_INVALID_PARAM   Null pointer provided.
+  * @retval UCAN_ERROR           A chunk could not be queued.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SendMembership(UCAN_Bus* buses, UCAN_NodeInfo* node)
+{
+    if(buses == NULL || node == NULL)
+    {
+        // Validate input pointers to prevent null dereference
+        return UCAN_INVALID_PARAM;
+    }
+
+    for(uint32_t first = 0, chunk = 0; first < node->clientCount; first += UCAN_MEMBERSHIP_BITS_PER_FRAME, chunk++)
+    {
+        uint8_t frame[8] = {UCAN_MEMBERSHIP_VALUE, (uint8_t)chunk, node->clientsHash, 0, 0, 0, 0, 0};
+        uint32_t bits = node->clientCount - first;
+
+        if(bits > UCAN_MEMBERSHIP_BITS_PER_FRAME)
+        {
+            bits = UCAN_MEMBERSHIP_BITS_PER_FRAME;
+        }
+
+        // Pack the chunk's client bits, LSB first
+        for(uint32_t i = 0; i < bits; i++)
+        {
+            if(UCAN_MEMBERSHIP_GET(node, first + i))
+            {
+                frame[UCAN_MEMBERSHIP_BITS + (i >> 3)] |= (uint8_t)(1U << (i & 7U));
+            }
+        }
+
+        if(uCAN_Runtime_SendFrame(buses, node->selfId, (uint8_t)(UCAN_MEMBERSHIP_BITS + ((bits + 7) >> 3)), frame) != UCAN_OK)
+        {
+            return UCAN_ERROR;
+        }
+    }
+
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_HAS_MEMBERSHIP && UCAN_CFG_HAS_MASTER */
+
+#if UCAN_CFG_HAS_MEMBERSHIP && UCAN_CFG_HAS_CLIENT
+/**
+  * @brief [INTERNAL] Applies one received membership broadcast chunk to the local view.
+  *
+  * Copies the chunk's client bits into `node->membership`. The bit positions refer to the
+  * clients array sorted by ID, which is identical on every node sharing the same client list.
+  * A chunk carrying the hash of a different list is rejected, its bits would name other
+  * clients; without applied chunks the view expires (see uCAN_IsClientActive()).
+  *
+  * @param node  Pointer to the UCAN node structure.
+  * @param aData Pointer to the received data bytes.
+  * @param dlc   Number of received data bytes.
+  *
+  * @retval UCAN_OK              Chunk applied.
+  * @retval UCAN_ERROR           Malformed chunk, or sent by a master with another client list.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_UpdateMembership(UCAN_NodeInfo* node, uint8_t aData[], uint8_t dlc)
+{
+    if(dlc < UCAN_MEMBERSHIP_BITS)
+    {
+        // Header missing
+        return UCAN_ERROR;
+    }
+
+    if(aData[UCAN_MEMBERSHIP_HASH] != node->clientsHash)
+    {
+        // Positions refer to another client list
+        return UCAN_ERROR;
+    }
+
+    uint32_t first = (uint32_t)aData[UCAN_MEMBERSHIP_CHUNK] * UCAN_MEMBERSHIP_BITS_PER_FRAME;
+    uint32_t bits = (uint32_t)(dlc - UCAN_MEMBERSHIP_BITS) * 8U;
+
+    for(uint32_t i = 0; i < bits && (first + i) < node->clientCount; i++)
+    {
+        if((aData[UCAN_MEMBERSHIP_BITS + (i >> 3)] >> (i & 7U)) & 1U)
+        {
+            UCAN_MEMBERSHIP_SET(node, first + i);
+        }
+        else
+        {
+            UCAN_MEMBERSHIP_CLEAR(node, first + i);
+        }
+    }
+
+    node->membershipTime = uCAN_Runtime_Now(node->timebase);
+    node->timeFlags |= UCAN_NODE_TIME_MEMBERSHIP;
+
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_HAS_MEMBERSHIP && UCAN_CFG_HAS_CLIENT */
+
+#if UCAN_CFG_HAS_CLIENT
+/**
+  * @brief [INTERNAL] Builds and sends a client response frame carrying the health record.
+  *
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param node  Pointer to the UCAN node structure.
+  * @param value First byte of the frame (response or announcement constant).
+  * @retval UCAN_StatusTypeDef Status of the transmission.
+  */
+static UCAN_StatusTypeDef uCAN_Runtime_SendResponse(UCAN_Bus* buses, UCAN_NodeInfo* node, uint8_t value)
+{
+    uint8_t response[UCAN_PONG_DIAG_DLC];
+    uint32_t esr = buses[0].hcan->Instance->ESR;
+    uint64_t uptime = uCAN_Runtime_Now(node->timebase) / ((uint64_t)node->timebase->countsPerMs * 1000U);
+
+    response[0] = value;                                                    // Response / announcement constant
+    response[UCAN_PONG_CPU_LOAD] = node->cpuLoad;                           // Application reported CPU load
+    response[UCAN_PONG_TEC] = (uint8_t)((esr & CAN_ESR_TEC) >> CAN_ESR_TEC_Pos);
+    response[UCAN_PONG_REC] = (uint8_t)((esr & CAN_ESR_REC) >> CAN_ESR_REC_Pos);
+    response[UCAN_PONG_DROPPED] = (node->droppedFrames > 0xFFU) ? 0xFFU : (uint8_t)node->droppedFrames;
+
+    if (uptime > 0xFFFFU)
+    {
+        uptime = 0xFFFFU;
+    }
+    response[UCAN_PONG_UPTIME] = (uint8_t)(uptime & 0xFFU);
+    response[UCAN_PONG_UPTIME + 1] = (uint8_t)(uptime >> 8);
+    response[UCAN_PONG_CONFIG_HASH] = node->configHash;
+
+    // Send the handshake response frame with the client's own CAN ID
+    return uCAN_Runtime_SendFrame(buses, node->selfId, UCAN_PONG_DIAG_DLC, response);
+}
+
+/**
+  * @brief [INTERNAL] Sends a handshake response ("pong") from a client node to the master.
+  *
+  * This function is intended for internal use within the UCAN core. It transmits a full
+  * 8-byte handshake response from a client node indicating active presence to the master.
+  * Only nodes configured as clients should call this function.
+  *
+  * The first byte is the response constant (`UCAN_HANDSHAKE_RESPONSE_VALUE`), the remaining
+  * bytes carry a compact health record at the `UCAN_PONG_xxx` offsets: CPU load, the
+  * controller's TEC/REC, dropped frame count, uptime and configuration hash. The frame is
+  * sent anyway, so the diagnostics cost no extra bus traffic.
+  *
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param node Pointer to the UCAN node structure.
+  *
+  * @retval UCAN_OK              Response packet sent successfully.
+  * @retval UCAN_INVALID_PARAM   Null pointer provided.
+  * @retval UCAN_ERROR           Node is not configured as a client.
+  *
+  * @note Compiled only when client handshake support is enabled in ucan_config.h.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SendPong(UCAN_Bus* buses, UCAN_NodeInfo* node)
+{
+    if(buses == NULL || node == NULL)
+    {
+        // Validate input pointers to prevent null dereference
+        return UCAN_INVALID_PARAM;
+    }
+
+    if(!UCAN_NODE_IS_CLIENT(node))
+    {
+        // Only client nodes are allowed to send handshake responses
+        return UCAN_ERROR;
+    }
+
+    return uCAN_Runtime_SendResponse(buses, node, UCAN_HANDSHAKE_RESPONSE_VALUE);
+}
+
+/**
+  * @brief [INTERNAL] Sends a capability frame from a client node to the master.
+  *
+  * Replaces the response to a ping that carries `UCAN_PING_FLAG_CAPS_REQUEST`. The frame
+  * holds `UCAN_HANDSHAKE_CAPS_VALUE`, the client's protocol version and its capabilities
+  * at the `UCAN_CAPS_xxx` offsets, and counts as a response for the connection tracking.
+  *
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param node Pointer to the UCAN node structure.
+  *
+  * @retval UCAN_StatusTypeDef Status of the transmission.
+  */
+static UCAN_StatusTypeDef uCAN_Runtime_SendCaps(UCAN_Bus* buses, UCAN_NodeInfo* node)
+{
+    uint8_t frame[UCAN_CAPS_DLC];
+    uint16_t caps = UCAN_CAPS_LOCAL(node);
+
+    frame[0] = UCAN_HANDSHAKE_CAPS_VALUE;
+    frame[UCAN_CAPS_VERSION] = UCAN_PROTOCOL_VERSION;
+    frame[UCAN_CAPS_BITS] = (uint8_t)(caps & 0xFFU);
+    frame[UCAN_CAPS_BITS + 1] = (uint8_t)(caps >> 8);
+
+    return uCAN_Runtime_SendFrame(buses, node->selfId, UCAN_CAPS_DLC, frame);
+}
+
+/**
+  * @brief [INTERNAL] Schedules a client's boot announcement after a randomized backoff.
+  *
+  * Right after startup every client announces itself instead of waiting for the master's
+  * next ping. To keep a network that powers up at once from hitting the bus with all
+  * announcements in the same millisecond, each client waits a pseudo-random delay of
+  * 0 to `UCAN_ANNOUNCE_BACKOFF_MAX_MS` ms, derived from its unique CAN ID and the
+  * current time (xorshift32).
+  *
+  * @param node Pointer to the UCAN node structure.
+  */
+void uCAN_Runtime_ScheduleAnnounce(UCAN_NodeInfo* node)
+{
+    UCAN_Time now = uCAN_Runtime_Now(node->timebase);
+    uint32_t seed = (node->selfId * 2654435761U) ^ (uint32_t)now ^ 0xA5A5A5A5U;
+
+    // xorshift32 round to spread neighbouring IDs
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    node->announceTime = now + uCAN_Runtime_MsToTime(node->timebase, seed % (UCAN_ANNOUNCE_BACKOFF_MAX_MS + 1U));
+    node->announcePending = 1;
+}
+
+/**
+  * @brief [INTERNAL] Sends a pending boot announcement once its backoff has elapsed.
+  *
+  * The announcement uses the pong frame layout, including the health record, with
+  * `UCAN_HANDSHAKE_ANNOUNCE_VALUE` as first byte. The master treats it like a response
+  * and marks the client ACTIVE immediately. If the frame cannot be queued the
+  * announcement stays pending and is retried on the next call.
+  *
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param node Pointer to the UCAN node structure.
+  *
+  * @retval UCAN_OK              Announcement sent.
+  * @retval UCAN_BUSY            Nothing pending or backoff not yet elapsed.
+  * @retval UCAN_ERROR           Node is not a client or transmission failed.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SendAnnounce(UCAN_Bus* buses, UCAN_NodeInfo* node)
+{
+    if(!node->announcePending || uCAN_Runtime_Now(node->timebase) < node->announceTime)
+    {
+        // nothing to do yet
+        return UCAN_BUSY;
+    }
+
+    if(!UCAN_NODE_IS_CLIENT(node))
+    {
+        // only clients announce themselves
+        node->announcePending = 0;
+        return UCAN_ERROR;
+    }
+
+    if(uCAN_Runtime_SendResponse(buses, node, UCAN_HANDSHAKE_ANNOUNCE_VALUE) != UCAN_OK)
+    {
+        // keep pending, retry next call
+        return UCAN_ERROR;
+    }
+
+    node->announcePending = 0;
+
+    return UCAN_OK;
+}
+
+/**
+  * @brief [INTERNAL] Sends the client's reply to the last ping, or retries one that found no mailbox.
+  *
+  * The reply is a capability frame if `node->replyPending` holds `UCAN_HANDSHAKE_CAPS_VALUE`,
+  * the handshake response (pong) otherwise. Replies are queued from the RX path, where the
+  * bulk mailboxes may all be taken by the application's own traffic; the reply then stays
+  * pending and uCAN_SendAll() / uCAN_Handshake() retry it, so the master does not time the
+  * client out for a busy moment. A retried reply reports a longer round trip.
+  *
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param node Pointer to the UCAN node structure.
+  *
+  * @retval UCAN_OK              Reply queued.
+  * @retval UCAN_BUSY            No reply pending, or still no free bulk mailbox.
+  * @retval UCAN_ERROR           Node is not a client or transmission failed.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SendReply(UCAN_Bus* buses, UCAN_NodeInfo* node)
+{
+    if(!node->replyPending)
+    {
+        // nothing to do
+        return UCAN_BUSY;
+    }
+
+    UCAN_StatusTypeDef status = (node->replyPending == UCAN_HANDSHAKE_CAPS_VALUE) ?
+        uCAN_Runtime_SendCaps(buses, node) :
+        uCAN_Runtime_SendPong(buses, node);
+
+    if(status != UCAN_BUSY)
+    {
+        // queued, or failed for a reason a retry cannot fix
+        node->replyPending = 0;
+    }
+
+    return status;
+}
+#endif /* UCAN_CFG_HAS_CLIENT */
+
+#if UCAN_CFG_RX_INDEX
+/**
+  * @brief [INTERNAL] Counts the set bits of a word.
+  * @param word Word to count.
+  * @retval uint32_t Number of set bits.
+  */
+static uint32_t uCAN_Runtime_PopCount(uint32_t word)
+{
+    // Bit counts of pairs, nibbles, then the sum of all bytes in the top byte
+    word = word - ((word >> 1) & 0x55555555U);
+    word = (word & 0x33333333U) + ((word >> 2) & 0x33333333U);
+    word = (word + (word >> 4)) & 0x0F0F0F0FU;
+
+    return (word * 0x01010101U) >> 24;
+}
+#endif
+
+/**
+  * @brief [INTERNAL] Finds the packet with the given ID in a packet holder.
+  *
+  * With a direct index (RX holder, UCAN_CFG_RX_INDEX) the lookup costs one bit
+  * test and a population count, independent of the number of packets: the ID's
+  * bit tells whether the packet exists and the number of set bits below it is
+  * its position in the sorted array. Otherwise the sorted array is searched.
+  *
+  * @param holder Pointer to a finalized packet holder.
+  * @param id     CAN identifier to look up.
+  * @retval UCAN_Packet* Matching packet, NULL if none.
+  */
+UCAN_Packet* uCAN_Runtime_FindPacket(UCAN_PacketHolder* holder, uint32_t id)
+{
+#if UCAN_CFG_RX_INDEX
+    const UCAN_IdIndex* index = holder->index;
+
+    if (index != NULL)
+    {
+        if (id >= UCAN_STD_ID_COUNT)
+        {
+            return NULL;
+        }
+
+        uint32_t word = index->bits[id >> 5];
+        uint32_t bit = 1U << (id & 31U);
+
+        if ((word & bit) == 0U)
+        {
+            return NULL;
+        }
+
+        return &holder->packets[index->rank[id >> 5] + uCAN_Runtime_PopCount(word & (bit - 1U))];
+    }
+#endif
+
+    UCAN_Packet packetKey = {.id = id};
+
+    return bsearch(&packetKey, holder->packets, holder->count, sizeof(UCAN_Packet), uCAN_Runtime_ComparePacketId);
+}
+
+/**
+  * @brief [INTERNAL] Updates RX packet data matching the received CAN ID.
+  *
+  * Looks up the RX packet with the given standard CAN ID (`StdId`) and, if found,
+  * hands the frame to it with `uCAN_Runtime_DeliverPacket()`.
+  *
+  * @param rxHolder  Pointer to the RX packet holder containing packet array.
+  * @param StdId     Standard CAN ID of the received message.
+  * @param aData     Array of received data bytes.
+  * @param dlc       Number of received data bytes.
+  * @param timestamp Reception timestamp in milliseconds, passed to the packet handler.
+  * @param time      Reception time on the handle's timebase, used by the statistics, triggers and latency tracing.
+  * @param hwTime    Extended hardware reception time in bit times, 0 if none (unused without UCAN_CFG_HW_TIMESTAMP).
+  *
+  * @retval UCAN_OK              Packet updated successfully.
+  * @retval UCAN_INVALID_PARAM   rxHolder is NULL.
+  * @retval UCAN_ERROR_UNKNOWN_ID No matching packet found for StdId.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_UpdatePacket(UCAN_PacketHolder* rxHolder, uint32_t StdId, uint8_t aData[], uint8_t dlc, uint32_t timestamp, UCAN_Time time, uint64_t hwTime)
+{
+    if(rxHolder == NULL)
+    {
+        // Null pointer guard
+        return UCAN_INVALID_PARAM;
+    }
+
+    // Direct index or binary search by ID
+    UCAN_Packet* packetFound = uCAN_Runtime_FindPacket(rxHolder, StdId);
+
+    if(packetFound == NULL)
+    {
+        // Packet with StdId not found
+        return UCAN_ERROR_UNKNOWN_ID;
+    }
+
+    return uCAN_Runtime_DeliverPacket(packetFound, aData, dlc, timestamp, time, hwTime);
+}
+
+/**
+  * @brief [INTERNAL] Hands a received frame to its RX packet.
+  *
+  * Stores the payload in the packet's group, overlay, raw slot or bound variables, feeds
+  * the attached statistics, timing and latency blocks, publishes it to the export
+  * region and invokes the packet's handler, if one is registered, directly on `aData`.
+  *
+  * @param packet    RX packet the frame belongs to.
+  * @param aData     Array of received data bytes.
+  * @param dlc       Number of received data bytes.
+  * @param timestamp Reception timestamp in milliseconds, passed to the packet handler.
+  * @param time      Reception time on the handle's timebase, used by the statistics, triggers and latency tracing.
+  * @param hwTime    Extended hardware reception time in bit times, 0 if none (unused without UCAN_CFG_HW_TIMESTAMP).
+  *
+  * @retval UCAN_OK              Packet updated successfully.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_DeliverPacket(UCAN_Packet* packet, const uint8_t aData[], uint8_t dlc, uint32_t timestamp, UCAN_Time time, uint64_t hwTime)
+{
+    if(packet->group != NULL)
+    {
+        // Grouped packet, publish through the group's double buffer
+        uCAN_Runtime_UpdateGroup(packet->group, packet->groupIndex, aData, packet->dlc);
+    }
+#if UCAN_CFG_OVERLAY
+    else if(packet->overlay != NULL)
+    {
+        // Whole payload in one copy into the bound struct
+        uCAN_Runtime_StoreOverlay(packet, aData);
+    }
+#endif
+#if UCAN_CFG_LAZY
+    else if(packet->lazy)
+    {
+        // Raw frame only, decoded when the application asks
+        uCAN_Runtime_StoreRaw(&packet->raw, aData, time);
+    }
+#endif
+    else
+    {
+        // Update packet data bytes from received data
+        for(int i = 0; i < packet->dlc; i++) {
+            *(packet->bits[i]) = aData[i];
+        }
+    }
+
+#if UCAN_CFG_LATENCY
+    // Trailer of a traced packet follows the bound bytes
+    if(packet->latency != NULL && dlc >= packet->dlc + UCAN_LATENCY_TRAILER_DLC)
+    {
+        uCAN_Runtime_RecordLatency(packet->latency, &aData[packet->dlc], time);
+    }
+#endif
+
+#if UCAN_CFG_STATS
+    // Feed attached signal statistics, if any
+    uCAN_Runtime_UpdateStats(packet->stats, aData, time);
+#endif
+
+#if UCAN_CFG_TRIGGER
+    // Check attached trigger conditions, hits go to the event queue
+    uCAN_Runtime_EvaluateTriggers(packet->triggers, packet->id, aData, time);
+#endif
+
+#if UCAN_CFG_HW_TIMESTAMP
+    // Frames of the redundant bus carry no time of the primary controller
+    if(hwTime != 0U)
+    {
+        uCAN_Runtime_UpdateTiming(&packet->timing, hwTime);
+    }
+#else
+    (void)hwTime;
+#endif
+
+#if UCAN_CFG_EXPORT
+    // Latest frame for readers of the shared-memory export region
+    if(packet->exportSlot != NULL)
+    {
+        uCAN_ExportPublish(packet->exportSlot, aData, dlc, time);
+    }
+#endif
+
+    // Hand the received bytes to the packet handler without copying
+    if(packet->handler != NULL)
+    {
+        packet->handler(aData, dlc, timestamp, packet->context);
+    }
+
+    return UCAN_OK;
+}
+
+#if UCAN_CFG_OVERLAY
+/**
+  * @brief [INTERNAL] Copies a payload of `dlc` bytes.
+  *
+  * A full 8-byte payload is copied with a constant size, which the compiler
+  * turns into two word loads and two word stores instead of a library call.
+  *
+  * @param dst Destination bytes.
+  * @param src Source bytes.
+  * @param dlc Number of bytes (0 to 8).
+  */
+static void uCAN_Runtime_CopyPayload(uint8_t* dst, const uint8_t* src, uint8_t dlc)
+{
+    if (dlc == 8U)
+    {
+        memcpy(dst, src, 8U);
+    }
+    else
+    {
+        memcpy(dst, src, dlc);
+    }
+}
+
+/**
+  * @brief [INTERNAL] Writes a payload into the overlay struct of a packet.
+  *
+  * Direct overlays are overwritten in place. Double-buffered overlays are
+  * written into the back buffer while `overlaySeq` is odd; making it even
+  * again turns the back buffer into the new front. Readers keep copying the
+  * front buffer during the write, so a single update never makes them retry.
+  *
+  * @param packet Packet with a bound overlay.
+  * @param data   Payload of `packet->dlc` bytes.
+  *
+  * @note Single writer: the RX path for RX packets, uCAN_OverlayWrite() for TX packets.
+  */
+void uCAN_Runtime_StoreOverlay(UCAN_Packet* packet, const uint8_t data[])
+{
+    if (!packet->overlayDouble)
+    {
+        uCAN_Runtime_CopyPayload(packet->overlay, data, packet->dlc);
+        return;
+    }
+
+    // Odd: back buffer is being written
+    uint32_t seq = packet->overlaySeq + 1U;
+    packet->overlaySeq = seq;
+    __DMB();
+
+    uCAN_Runtime_CopyPayload(packet->overlay + (((seq >> 1) + 1U) & 1U) * packet->dlc, data, packet->dlc);
+
+    // Even again: back buffer becomes the front
+    __DMB();
+    packet->overlaySeq = seq + 1U;
+}
+
+/**
+  * @brief [INTERNAL] Copies the current payload out of the overlay struct of a packet.
+  *
+  * Direct overlays are copied as they are. For double-buffered overlays the
+  * front buffer is copied; the copy can only be torn if the writer started
+  * writing that very buffer, i.e. began a second update after the one in
+  * progress. That is detected through `overlaySeq` and the copy retried.
+  *
+  * @param packet Packet with a bound overlay.
+  * @param data   Output buffer of at least `packet->dlc` bytes.
+  *
+  * @retval UCAN_OK              Consistent payload copied.
+  * @retval UCAN_BUSY            The overlay kept changing for UCAN_OVERLAY_READ_RETRIES attempts.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_LoadOverlay(const UCAN_Packet* packet, uint8_t data[])
+{
+    if (!packet->overlayDouble)
+    {
+        uCAN_Runtime_CopyPayload(data, packet->overlay, packet->dlc);
+        return UCAN_OK;
+    }
+
+    for (uint32_t attempt = 0; attempt < UCAN_OVERLAY_READ_RETRIES; attempt++)
+    {
+        uint32_t seq = packet->overlaySeq;
+        __DMB();
+
+        uCAN_Runtime_CopyPayload(data, packet->overlay + ((seq >> 1) & 1U) * packet->dlc, packet->dlc);
+
+        __DMB();
+
+        // The copied buffer is rewritten from the second update after the last completed one
+        if (packet->overlaySeq - (seq & ~1U) <= 2U)
+        {
+            return UCAN_OK;
+        }
+    }
+
+    return UCAN_BUSY;
+}
+#endif /* UCAN_CFG_OVERLAY */
+
+#if UCAN_CFG_LAZY
+/**
+  * @brief [INTERNAL] Stores a received frame in the raw slot of a lazy packet.
+  *
+  * The payload goes in as two word stores, whatever the number of signals,
+  * framed by two increments of the slot's sequence counter.
+  *
+  * @param slot  Raw slot of the packet.
+  * @param aData Received payload, 8 bytes of storage.
+  * @param time  Reception time on the handle's timebase.
+  *
+  * @note Single writer: the RX path.
+  */
+void uCAN_Runtime_StoreRaw(UCAN_RawSlot* slot, const uint8_t aData[], UCAN_Time time)
+{
+    // Odd: slot is being written
+    uint32_t seq = slot->seq + 1U;
+    slot->seq = seq;
+    __DMB();
+
+    memcpy(slot->word, aData, sizeof(slot->word));
+    slot->time = time;
+
+    // Even again: frame complete
+    __DMB();
+    slot->seq = seq + 1U;
+}
+
+/**
+  * @brief [INTERNAL] Copies the last frame out of the raw slot of a lazy packet.
+  *
+  * The copy is taken between two reads of the sequence counter and retried if
+  * the counter was odd or moved, i.e. if the RX path wrote the slot meanwhile.
+  *
+  * @param slot Raw slot of the packet.
+  * @param data Output buffer of 8 bytes.
+  * @param time Output reception time, may be NULL.
+  * @param seq  Output sequence number of the copied frame, 0 if none was received.
+  *
+  * @retval UCAN_OK              Consistent frame copied.
+  * @retval UCAN_BUSY            The slot kept changing for UCAN_RAW_READ_RETRIES attempts.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_LoadRaw(const UCAN_RawSlot* slot, uint8_t data[], UCAN_Time* time, uint32_t* seq)
+{
+    for (uint32_t attempt = 0; attempt < UCAN_RAW_READ_RETRIES; attempt++)
+    {
+        uint32_t before = slot->seq;
+        __DMB();
+
+        uint32_t word[2] = { slot->word[0], slot->word[1] };
+        UCAN_Time stamp = slot->time;
+
+        __DMB();
+
+        if (!(before & 1U) && slot->seq == before)
+        {
+            memcpy(data, word, sizeof(word));
+            if (time != NULL)
+            {
+                *time = stamp;
+            }
+            *seq = before;
+            return UCAN_OK;
+        }
+    }
+
+    return UCAN_BUSY;
+}
+#endif /* UCAN_CFG_LAZY */
+
+#if UCAN_CFG_HAS_MASTER || UCAN_CFG_HAS_CLIENT
+/**
+  * @brief [INTERNAL] Records the capabilities announced by a peer.
+  *
+  * The record is invalidated before and validated after the update, so a reader that
+  * sees `valid` set after a barrier reads a complete record.
+  *
+  * @param record  Capability record of the peer.
+  * @param node    Pointer to the UCAN node structure (source of the local capabilities).
+  * @param version Protocol version of the peer, 0 for a peer without negotiation.
+  * @param caps    Capabilities advertised by the peer.
+  */
+static void uCAN_Runtime_RecordCaps(UCAN_PeerCaps* record, const UCAN_NodeInfo* node, uint8_t version, uint16_t caps)
+{
+    record->valid = 0;
+    __DMB();
+    record->version = version;
+    record->caps = caps;
+    record->common = (uint16_t)(caps & UCAN_CAPS_LOCAL(node));
+    record->misses = 0;
+    __DMB();
+    record->valid = 1;
+}
+#endif
+
+/**
+  * @brief [INTERNAL] Process incoming handshake messages based on node role.
+  *
+  * For master nodes, updates the responseTime of the client matching the received StdId
+  * if the handshake response value matches. A boot announcement is accepted as a response
+  * and marks the client ACTIVE at once. Responses of full length additionally carry
+  * the client's health record, which is decoded into the client's `diag` field. Short
+  * (1-byte) responses from older clients are still accepted. A capability frame counts as a
+  * response and fills the client's `caps` record; after `UCAN_CAPS_LEGACY_MISSES` plain
+  * responses to capability requests in a row the client is recorded as version 0.
+  *
+  * For client nodes, verifies the message is from the master and the handshake request value,
+  * records the master's capabilities, then updates sentTime and sends a handshake reply, or a
+  * capability frame if the ping asks for it. Membership broadcasts from the master update the
+  * local membership view instead.
+  *
+  * @param node  Pointer to UCAN node info structure.
+  * @param buses Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param StdId Standard CAN ID of the received message.
+  * @param aData Pointer to received data bytes.
+  * @param dlc   Number of received data bytes.
+  * @param hwTime Extended hardware reception time in bit times, used for the round trip.
+  *
+  * @retval UCAN_OK              Handshake processed successfully.
+  * @retval UCAN_INVALID_PARAM   Null pointer input.
+  * @retval UCAN_ERROR_UNKNOWN_ID Received StdId not found or unexpected sender.
+  * @retval UCAN_ERROR           Handshake data value mismatch.
+  *
+  * @note Only the branches of the roles enabled in ucan_config.h are compiled.
+  */
+#if UCAN_CFG_HANDSHAKE
+UCAN_StatusTypeDef uCAN_Runtime_UpdateHandshake(UCAN_NodeInfo* node, UCAN_Bus* buses, uint32_t StdId, uint8_t aData[], uint8_t dlc, uint64_t hwTime)
+{
+    if(node == NULL || buses == NULL)
+    {
+        // Validate pointers
+        return UCAN_INVALID_PARAM;
+    }
+
+#if !UCAN_CFG_HW_TIMESTAMP || !UCAN_CFG_HAS_MASTER
+    // Round trips are only measured by a master with hardware timestamps
+    (void)hwTime;
+#endif
+
+#if UCAN_CFG_HAS_MASTER
+    if (UCAN_NODE_IS_MASTER(node))
+    {
+        // Master expects handshake responses from clients
+        UCAN_Client handshakeKey = {.id = StdId};
+        UCAN_Client* handshakeFound = bsearch(&handshakeKey, node->clients, node->clientCount, sizeof(UCAN_Client), uCAN_Runtime_CompareClientId);
+
+        if(handshakeFound == NULL)
+        {
+            // Unknown client ID
+            return UCAN_ERROR_UNKNOWN_ID;
+        }
+
+        if(dlc == 0 || (aData[0] != UCAN_HANDSHAKE_RESPONSE_VALUE && aData[0] != UCAN_HANDSHAKE_ANNOUNCE_VALUE &&
+                        aData[0] != UCAN_HANDSHAKE_CAPS_VALUE))
+        {
+            // Invalid handshake response data
+            return UCAN_ERROR;
+        }
+
+        // Decode piggybacked health record
+        if(dlc >= UCAN_PONG_DIAG_DLC)
+        {
+            UCAN_ClientDiag* diag = &handshakeFound->diag;
+
+            // Mark record as being written
+            handshakeFound->diagSeq++;
+            __DMB();
+
+            diag->cpuLoad = aData[UCAN_PONG_CPU_LOAD];
+            diag->tec = aData[UCAN_PONG_TEC];
+            diag->rec = aData[UCAN_PONG_REC];
+            diag->droppedFrames = aData[UCAN_PONG_DROPPED];
+            diag->uptime = (uint16_t)(aData[UCAN_PONG_UPTIME] | (aData[UCAN_PONG_UPTIME + 1] << 8));
+            diag->configHash = aData[UCAN_PONG_CONFIG_HASH];
+            diag->valid = 1;
+
+            // Record is consistent again
+            __DMB();
+            handshakeFound->diagSeq++;
+        }
+
+        if(aData[0] == UCAN_HANDSHAKE_CAPS_VALUE && dlc >= UCAN_CAPS_DLC)
+        {
+            // Capabilities requested by the last ping
+            uCAN_Runtime_RecordCaps(&handshakeFound->caps, node, aData[UCAN_CAPS_VERSION],
+                                    (uint16_t)(aData[UCAN_CAPS_BITS] | (aData[UCAN_CAPS_BITS + 1] << 8)));
+        }
+        else if(aData[0] == UCAN_HANDSHAKE_RESPONSE_VALUE && node->capsRequested == handshakeFound && !handshakeFound->caps.valid)
+        {
+            // Plain responses to its capability requests: client predates negotiation
+            if(++handshakeFound->caps.misses >= UCAN_CAPS_LEGACY_MISSES)
+            {
+                uCAN_Runtime_RecordCaps(&handshakeFound->caps, node, 0, 0);
+            }
+        }
+        else if(aData[0] == UCAN_HANDSHAKE_ANNOUNCE_VALUE)
+        {
+            // Rebooted client may run new firmware, ask again
+            handshakeFound->caps.valid = 0;
+            handshakeFound->caps.misses = 0;
+        }
+
+        // Update client's last response time, then mark it valid
+        handshakeFound->responseTime = uCAN_Runtime_Now(node->timebase);
+        __DMB();
+        handshakeFound->flags |= UCAN_CLIENT_FLAG_RESPONDED;
+
+#if UCAN_CFG_HW_TIMESTAMP
+        // Round trip from the ping leaving the controller to this response arriving
+        if(aData[0] != UCAN_HANDSHAKE_ANNOUNCE_VALUE && (node->timeFlags & UCAN_NODE_TIME_PING_HW) && hwTime > node->pingTime)
+        {
+            handshakeFound->diagSeq++;
+            __DMB();
+            handshakeFound->rtt = (uint32_t)(hwTime - node->pingTime);
+            __DMB();
+            handshakeFound->diagSeq++;
+        }
+#endif
+
+        if(aData[0] == UCAN_HANDSHAKE_ANNOUNCE_VALUE)
+        {
+            // Freshly booted client, operational without waiting for the next ping
+            handshakeFound->status = UCAN_CONN_ACTIVE;
+#if UCAN_CFG_HAS_MEMBERSHIP
+            UCAN_MEMBERSHIP_SET(node, (uint32_t)(handshakeFound - node->clients));
+#endif
+        }
+
+        UCAN_TRACE(UCAN_TRACE_HANDSHAKE, StdId);
+        return UCAN_OK;
+    }
+#endif
+
+#if UCAN_CFG_HAS_CLIENT
+    if (UCAN_NODE_IS_CLIENT(node))
+    {
+        // Client expects handshake requests from master
+        if(StdId != node->masterId)
+        {
+            // Message not from master
+            return UCAN_ERROR_UNKNOWN_ID;
+        }
+
+#if UCAN_CFG_HAS_MEMBERSHIP
+        if(dlc != 0 && aData[0] == UCAN_MEMBERSHIP_VALUE)
+        {
+            // Master's view of active clients
+            return uCAN_Runtime_UpdateMembership(node, aData, dlc);
+        }
+#endif
+
+        if(dlc == 0 || aData[0] != UCAN_HANDSHAKE_REQUEST_VALUE)
+        {
+            // Invalid handshake request data
+            return UCAN_ERROR;
+        }
+
+        // Record the ping before replying
+        node->sentTime = uCAN_Runtime_Now(node->timebase);
+        node->timeFlags |= UCAN_NODE_TIME_SENT;
+        UCAN_TRACE(UCAN_TRACE_HANDSHAKE, StdId);
+
+        if(dlc < UCAN_PING_DLC)
+        {
+            // Master predates capability negotiation
+            if(!node->masterCaps.valid || node->masterCaps.version != 0U)
+            {
+                uCAN_Runtime_RecordCaps(&node->masterCaps, node, 0, 0);
+            }
+
+            node->replyPending = UCAN_HANDSHAKE_RESPONSE_VALUE;
+            uCAN_Runtime_SendReply(buses, node);
+            return UCAN_OK;
+        }
+
+        uint16_t caps = (uint16_t)(aData[UCAN_PING_CAPS] | (aData[UCAN_PING_CAPS + 1] << 8));
+
+        if(!node->masterCaps.valid || node->masterCaps.version != aData[UCAN_PING_VERSION] || node->masterCaps.caps != caps)
+        {
+            uCAN_Runtime_RecordCaps(&node->masterCaps, node, aData[UCAN_PING_VERSION], caps);
+        }
+
+        uint32_t capsId = (uint32_t)(aData[UCAN_PING_CAPS_ID] | (aData[UCAN_PING_CAPS_ID + 1] << 8));
+
+        // Send capabilities if this client is asked for them, the handshake reply (pong) otherwise
+        node->replyPending = ((aData[UCAN_PING_FLAGS] & UCAN_PING_FLAG_CAPS_REQUEST) && capsId == node->selfId) ?
+            UCAN_HANDSHAKE_CAPS_VALUE : UCAN_HANDSHAKE_RESPONSE_VALUE;
+        uCAN_Runtime_SendReply(buses, node);
+        return UCAN_OK;
+    }
+#endif
+
+#if !UCAN_CFG_HAS_MASTER && !UCAN_CFG_HAS_CLIENT
+    // Handshake frames are ignored without a role
+    (void)StdId;
+    (void)aData;
+    (void)dlc;
+#endif
+
+    // No handshake processing for undefined roles
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_HANDSHAKE */
+
+/**
+  * @brief [INTERNAL] Extracts a single signal value from a raw CAN payload.
+  *
+  * Signals are laid out little-endian, matching the byte pointer mapping built
+  * by uCAN_Debug_FinalizePacket() on the Cortex-M target.
+  *
+  * @param aData  Pointer to the payload bytes.
+  * @param offset Byte offset of the signal inside the payload.
+  * @param type   Data type of the signal.
+  * @retval uint32_t Decoded signal value, zero for unknown types.
+  */
+uint32_t uCAN_Runtime_DecodeSignal(const uint8_t aData[], uint8_t offset, UCAN_DataType type)
+{
+    switch (type)
+    {
+        case UCAN_U8:
+            return aData[offset];
+
+        case UCAN_U16:
+            return (uint32_t)aData[offset] | ((uint32_t)aData[offset + 1] << 8);
+
+        case UCAN_U32:
+            return (uint32_t)aData[offset] | ((uint32_t)aData[offset + 1] << 8) |
+                   ((uint32_t)aData[offset + 2] << 16) | ((uint32_t)aData[offset + 3] << 24);
+
+        default:
+            return 0;
+    }
+}
+
+#if UCAN_CFG_STATS
+/**
+  * @brief [INTERNAL] Feeds a received payload into all statistics blocks of a packet.
+  *
+  * Each block observes one signal of the packet. The update is O(1) per block:
+  * min/max are compared, mean and the sum of squared deviations are advanced
+  * with Welford's algorithm, and the arrival timestamps are recorded for the
+  * rate estimate.
+  *
+  * A block restarts its window before accepting the sample when either the
+  * application requested a reset or the configured window size was reached.
+  *
+  * The sequence counter is odd while the block is being written, allowing
+  * uCAN_GetSignalStats() to detect and retry torn reads without disabling
+  * interrupts.
+  *
+  * @param stats Head of the packet's statistics list (may be NULL).
+  * @param aData Pointer to the received data bytes.
+  * @param time  Reception time on the handle's timebase.
+  */
+void uCAN_Runtime_UpdateStats(UCAN_SignalStats* stats, const uint8_t aData[], UCAN_Time time)
+{
+    for (; stats != NULL; stats = stats->next)
+    {
+        uint32_t value = uCAN_Runtime_DecodeSignal(aData, stats->offset, stats->type);
+
+        // Mark block as being written
+        stats->seq++;
+        __DMB();
+
+        // Restart window on request or when full
+        if (stats->resetRequest || (stats->windowSize != 0 && stats->count >= stats->windowSize))
+        {
+            stats->resetRequest = 0;
+            stats->count = 0;
+        }
+
+        if (stats->count == 0)
+        {
+            stats->min = value;
+            stats->max = value;
+            stats->mean = 0.0f;
+            stats->m2 = 0.0f;
+            stats->firstTime = time;
+        }
+
+        if (value < stats->min) stats->min = value;
+        if (value > stats->max) stats->max = value;
+
+        // Welford's online mean/variance update
+        stats->count++;
+        float delta = (float)value - stats->mean;
+        stats->mean += delta / (float)stats->count;
+        stats->m2 += delta * ((float)value - stats->mean);
+
+        stats->lastTime = time;
+
+        // Block is consistent again
+        __DMB();
+        stats->seq++;
+    }
+}
+#endif /* UCAN_CFG_STATS */
+
+#if UCAN_CFG_TRIGGER
+/**
+  * @brief [INTERNAL] Appends a trigger hit to the event queue of the handle.
+  *
+  * Same single-producer / single-consumer scheme as the monitor ring: the
+  * entry is complete before the barrier and the head update that publishes
+  * it. A full queue drops the new hit and counts it.
+  *
+  * @param queue   Event queue of the handle.
+  * @param trigger Trigger that fired.
+  * @param id      CAN identifier of the packet.
+  * @param value   Signal value that fired the trigger.
+  * @param time    Reception time on the handle's timebase.
+  */
+static void uCAN_Runtime_PushEvent(UCAN_EventQueue* queue, UCAN_Trigger* trigger, uint32_t id, uint32_t value, UCAN_Time time)
+{
+    uint32_t head = queue->head;
+
+    if ((head - queue->tail) >= queue->size)
+    {
+        // Queue full, keep the older hits
+        queue->overruns++;
+        return;
+    }
+
+    UCAN_TriggerEvent* event = &queue->events[head & (queue->size - 1U)];
+
+    event->trigger = trigger;
+    event->id = id;
+    event->value = value;
+    event->time = time;
+
+    // Entry is complete before the reader can see it
+    __DMB();
+    queue->head = head + 1U;
+}
+
+/**
+  * @brief [INTERNAL] Evaluates all triggers of a packet against a received payload.
+  *
+  * ABOVE and BELOW disarm when they fire and re-arm once the value has moved
+  * back past the threshold by the hysteresis, so a signal hovering around the
+  * limit produces one event per crossing instead of one per frame. DELTA
+  * fires when the value has moved far enough from the value of its last
+  * event; RISING and FALLING compare one bit with the previous frame.
+  *
+  * @param trigger Head of the packet's trigger list (may be NULL).
+  * @param id      CAN identifier of the packet.
+  * @param aData   Pointer to the received data bytes.
+  * @param time    Reception time on the handle's timebase.
+  */
+void uCAN_Runtime_EvaluateTriggers(UCAN_Trigger* trigger, uint32_t id, const uint8_t aData[], UCAN_Time time)
+{
+    for (; trigger != NULL; trigger = trigger->next)
+    {
+        uint32_t value = uCAN_Runtime_DecodeSignal(aData, trigger->offset, trigger->type);
+        uint8_t fire = 0;
+
+        switch (trigger->condition)
+        {
+            case UCAN_TRIGGER_ABOVE:
+                if (value > trigger->threshold)
+                {
+                    fire = trigger->armed;
+                    trigger->armed = 0;
+                }
+                else if ((trigger->threshold - value) >= trigger->hysteresis)
+                {
+                    trigger->armed = 1;
+                }
+                break;
+
+            case UCAN_TRIGGER_BELOW:
+                if (value < trigger->threshold)
+                {
+                    fire = trigger->armed;
+                    trigger->armed = 0;
+                }
+                else if ((value - trigger->threshold) >= trigger->hysteresis)
+                {
+                    trigger->armed = 1;
+                }
+                break;
+
+            case UCAN_TRIGGER_DELTA:
+            {
+                uint32_t change = (value > trigger->reference) ? (value - trigger->reference) : (trigger->reference - value);
+
+                if (trigger->primed && change != 0U && change >= trigger->threshold)
+                {
+                    fire = 1;
+                }
+
+                if (fire || !trigger->primed)
+                {
+                    trigger->reference = value;
+                }
+                break;
+            }
+
+            case UCAN_TRIGGER_RISING:
+            case UCAN_TRIGGER_FALLING:
+            {
+                uint32_t mask = 1UL << trigger->bit;
+                uint32_t edge = (trigger->condition == UCAN_TRIGGER_RISING) ? (value & ~trigger->reference) : (~value & trigger->reference);
+
+                fire = (trigger->primed && (edge & mask) != 0U);
+                trigger->reference = value;
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        trigger->primed = 1;
+
+        if (fire)
+        {
+            trigger->hits++;
+            uCAN_Runtime_PushEvent(trigger->queue, trigger, id, value, time);
+        }
+    }
+}
+#endif /* UCAN_CFG_TRIGGER */
+
+/**
+  * @brief [INTERNAL] Stores a received member frame into its signal group.
+  *
+  * The frame is written into the back buffer of the group. If the group has a
+  * sequence counter and the frame carries a different value than the set being
+  * assembled, the incomplete set is dropped and assembly restarts with this
+  * frame. Once every member has been received the buffers are swapped and the
+  * commit counter is advanced, publishing the set to uCAN_ReadGroup().
+  *
+  * @param group Pointer to the signal group.
+  * @param index Position of the member packet inside the group.
+  * @param aData Pointer to the received data bytes.
+  * @param dlc   Number of payload bytes to store.
+  */
+void uCAN_Runtime_UpdateGroup(UCAN_SignalGroup* group, uint8_t index, const uint8_t aData[], uint8_t dlc)
+{
+    uint8_t back = group->front ^ 1U;
+    uint8_t fullMask = (uint8_t)((1U << group->memberCount) - 1U);
+
+    if (group->seqByte != UCAN_GROUP_NO_SEQUENCE)
+    {
+        uint8_t seq = aData[group->seqByte];
+
+        // Frame belongs to a newer set, drop the incomplete one
+        if (group->pendingMask != 0 && seq != group->pendingSeq)
+        {
+            group->pendingMask = 0;
+        }
+
+        group->pendingSeq = seq;
+    }
+
+    // Assemble into the back buffer, the front stays untouched
+    for (uint8_t i = 0; i < dlc; i++)
+    {
+        group->frames[back][index][i] = aData[i];
+    }
+
+    group->pendingMask |= (uint8_t)(1U << index);
+
+    if (group->pendingMask == fullMask)
+    {
+        // Complete set, swap buffers and publish
+        __DMB();
+        group->front = back;
+        group->commitSeq++;
+        group->pendingMask = 0;
+    }
+}
+
+#if UCAN_CFG_MONITOR
+/**
+  * @brief [INTERNAL] Copies a received frame into the monitor capture ring.
+  *
+  * The ring is a single-producer / single-consumer queue: only the RX path
+  * advances head and only the reader advances tail, so neither side needs a
+  * lock. The entry is written completely before the barrier and the head
+  * update that publishes it. When the ring is full the new frame is dropped
+  * and counted, already captured frames are never overwritten.
+  *
+  * @param monitor Pointer to the monitor state.
+  * @param header  Pointer to the HAL RX header of the frame.
+  * @param aData   Pointer to the received data bytes.
+  * @param tick    Reception timestamp in milliseconds.
+  * @retval UCAN_StatusTypeDef UCAN_OK, or UCAN_BUSY if the ring was full.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_CaptureFrame(UCAN_Monitor* monitor, const CAN_RxHeaderTypeDef* header, const uint8_t aData[], uint32_t tick)
+{
+    uint32_t head = monitor->head;
+
+    if ((head - monitor->tail) >= monitor->size)
+    {
+        // Ring full, keep the older frames
+        monitor->overruns++;
+        return UCAN_BUSY;
+    }
+
+    UCAN_MonitorFrame* frame = &monitor->frames[head & (monitor->size - 1U)];
+
+    frame->flags = 0;
+
+    if (header->IDE == CAN_ID_EXT)
+    {
+        frame->id = header->ExtId;
+        frame->flags |= UCAN_MONITOR_FLAG_EXT;
+    }
+    else
+    {
+        frame->id = header->StdId;
+    }
+
+    if (header->RTR == CAN_RTR_REMOTE)
+    {
+        frame->flags |= UCAN_MONITOR_FLAG_RTR;
+    }
+
+    frame->tick = tick;
+    frame->timestamp = (uint16_t)header->Timestamp;
+    frame->dlc = (uint8_t)header->DLC;
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        frame->data[i] = aData[i];
+    }
+
+    // Publish the entry to the reader
+    __DMB();
+    monitor->head = head + 1U;
+
+    return UCAN_OK;
+}
+#endif /* UCAN_CFG_MONITOR */
+
+#if UCAN_CFG_REDUNDANT
+/**
+  * @brief [INTERNAL] Recognizes the later copy of a frame received on both buses of a redundant pair.
+  *
+  * Every accepted frame is remembered in a direct-mapped table indexed by a hash of
+  * its identifier (Fibonacci hashing). A frame is a duplicate if the slot holds the
+  * same identifier, accepted from the other bus, and
+  *  - a rolling counter equal to or up to UCAN_REDUNDANT_SEQ_SPAN - 1 behind the
+  *    remembered one, if the frame's RX packet has a counter (`seqByte`, or the
+  *    sequence number of a latency trailer), however fast the packet repeats and
+  *    even if one bus has delivered several frames before the other catches up;
+  *  - otherwise the same payload, no more than `window` ago. A packet repeating an
+  *    unchanged payload faster than that can then lose a frame, so fast packets
+  *    should carry a counter.
+  * Frames from the same bus are never duplicates, so a sender wired to one bus
+  * only and repeated identical frames are delivered as usual. Identifiers sharing a
+  * slot only evict each other, which can let a duplicate through but never drops a
+  * new frame.
+  *
+  * Both RX interrupts must run at the same priority, so that the table is never
+  * updated by two contexts at once.
+  *
+  * @param table  Duplicate filter of the handle (UCAN_DEDUP_SIZE slots).
+  * @param rxHolder RX packets of the handle, for the rolling counter of the frame's packet.
+  * @param bus    Index of the bus the frame was received on.
+  * @param header Pointer to the HAL RX header of the frame.
+  * @param aData  Pointer to the received data bytes.
+  * @param now    Reception time on the handle timebase.
+  * @param window Longest time between two copies of one frame, in timebase counts.
+  * @retval uint8_t Non-zero if the frame is a duplicate and must be discarded.
+  */
+uint8_t uCAN_Runtime_IsDuplicate(UCAN_DedupEntry table[], UCAN_PacketHolder* rxHolder, uint8_t bus, const CAN_RxHeaderTypeDef* header, const uint8_t aData[], UCAN_Time now, UCAN_Time window)
+{
+    uint32_t key = (header->IDE == CAN_ID_EXT) ? (header->ExtId | UCAN_DEDUP_KEY_EXT) : header->StdId;
+    uint8_t dlc = (header->DLC > 8U) ? 8U : (uint8_t)header->DLC;
+    uint8_t payload = (header->RTR == CAN_RTR_REMOTE) ? 0U : dlc;
+    UCAN_DedupEntry* entry = &table[(key * 2654435761U) >> (32U - UCAN_DEDUP_BITS)];
+
+    if (entry->bus != UCAN_DEDUP_EMPTY && entry->bus != bus && entry->key == key && entry->dlc == dlc)
+    {
+        UCAN_Packet* packet = (header->IDE == CAN_ID_STD) ? uCAN_Runtime_FindPacket(rxHolder, header->StdId) : NULL;
+        uint8_t seqByte = (packet != NULL && packet->seqByte <= payload) ? packet->seqByte : 0U;
+
+        if (seqByte != 0U ? ((uint8_t)(entry->data[seqByte - 1U] - aData[seqByte - 1U]) < UCAN_REDUNDANT_SEQ_SPAN) :
+            (UCAN_TIME_SINCE(now, entry->time) <= window && memcmp(entry->data, aData, payload) == 0))
+        {
+            // Second copy, the first one already went to the application
+            return 1;
+        }
+    }
+
+    entry->key = key;
+    entry->time = now;
+    entry->bus = bus;
+    entry->dlc = dlc;
+    memcpy(entry->data, aData, payload);
+
+    return 0;
+}
+#endif /* UCAN_CFG_REDUNDANT */
+
+#if UCAN_CFG_LATENCY
+/**
+  * @brief [INTERNAL] Appends the latency trailer to the payload of a traced TX packet.
+  *
+  * The trailer carries the producer's sequence number, the queue time (low 16 bits
+  * of the timebase in microseconds) and the producer stage, from the sample instant
+  * to now. The sample instant is the one marked with uCAN_LatencySample() if any,
+  * otherwise `latchTime`, otherwise now. The caller advances the sequence number
+  * once the frame is queued, so a frame retried after UCAN_BUSY keeps its number.
+  *
+  * @param latency   Latency block of the packet.
+  * @param data      Payload buffer of 8 bytes, the trailer is written after `dlc` bytes.
+  * @param dlc       Number of bound payload bytes.
+  * @param latchTime Time at which the payload was latched, 0 if it is read at send time.
+  * @retval uint8_t  Length of the frame including the trailer.
+  */
+uint8_t uCAN_Runtime_StampLatency(UCAN_LatencyStats* latency, uint8_t data[], uint8_t dlc, UCAN_Time latchTime)
+{
+    UCAN_Time now = uCAN_Runtime_Now(latency->timebase);
+    UCAN_Time sample = (latchTime != 0U) ? latchTime : now;
+
+    if (latency->sampled)
+    {
+        // Flag is set after the time, see uCAN_LatencySample()
+        __DMB();
+        sample = uCAN_Runtime_LoadTime(&latency->sampleTime);
+    }
+
+    uint32_t nowUs = (uint32_t)uCAN_Runtime_TimeToUs(latency->timebase, now);
+    uint64_t age = (uCAN_Runtime_TimeToUs(latency->timebase, UCAN_TIME_SINCE(now, sample)) + UCAN_LATENCY_AGE_UNIT_US / 2U) / UCAN_LATENCY_AGE_UNIT_US;
+    uint8_t* trailer = &data[dlc];
+
+    trailer[UCAN_LATENCY_SEQ] = latency->txSeq;
+    trailer[UCAN_LATENCY_STAMP] = (uint8_t)nowUs;
+    trailer[UCAN_LATENCY_STAMP + 1] = (uint8_t)(nowUs >> 8);
+    trailer[UCAN_LATENCY_AGE] = (age > 0xFFU) ? 0xFFU : (uint8_t)age;
+
+    return (uint8_t)(dlc + UCAN_LATENCY_TRAILER_DLC);
+}
+
+/**
+  * @brief [INTERNAL] Records the latency stages of a received traced frame.
+  *
+  * The producer stage is taken from the trailer. The bus stage runs from the
+  * producer's queue stamp to `time`; both are read from the shared timebase, so
+  * it is only meaningful if producer and consumer timebases run in step, and it
+  * wraps after 65.536 ms. A gap in the sequence numbers counts the missing frames
+  * as lost. The record is written between two increments of seq, so
+  * uCAN_Runtime_UseLatency() never takes a torn copy.
+  *
+  * @param latency Latency block of the RX packet.
+  * @param trailer Pointer to the UCAN_LATENCY_TRAILER_DLC trailer bytes.
+  * @param time    Reception time on the handle's timebase.
+  */
+void uCAN_Runtime_RecordLatency(UCAN_LatencyStats* latency, const uint8_t trailer[], UCAN_Time time)
+{
+    uint8_t seq = trailer[UCAN_LATENCY_SEQ];
+    uint16_t stamp = (uint16_t)(trailer[UCAN_LATENCY_STAMP] | ((uint16_t)trailer[UCAN_LATENCY_STAMP + 1] << 8));
+    uint16_t rxUs = (uint16_t)uCAN_Runtime_TimeToUs(latency->timebase, time);
+    uint8_t gap = (uint8_t)(seq - latency->rxSeq);
+
+    // Frames skipped by the producer's counter never arrived
+    if (latency->frames != 0U && gap > 1U)
+    {
+        latency->lost += gap - 1U;
+    }
+
+    latency->rxSeq = seq;
+    latency->frames++;
+
+    // Mark record as being written
+    latency->seq++;
+    __DMB();
+
+    latency->producerUs = (uint32_t)trailer[UCAN_LATENCY_AGE] * UCAN_LATENCY_AGE_UNIT_US;
+    latency->busUs = (uint16_t)(rxUs - stamp);
+    latency->rxTime = time;
+
+    // Record is consistent again
+    __DMB();
+    latency->seq++;
+}
+
+/**
+  * @brief [INTERNAL] Returns the histogram bucket of a latency.
+  * @param us Latency in microseconds.
+  * @retval uint8_t floor(log2(us)), 0 below 2 us, capped at the last bucket.
+  */
+static uint8_t uCAN_Runtime_LatencyBucket(uint32_t us)
+{
+    uint8_t bucket = 0;
+
+    while (us > 1U && bucket < UCAN_LATENCY_BUCKETS - 1U)
+    {
+        us >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+/**
+  * @brief [INTERNAL] Adds the last received frame of a traced packet to its latency statistics.
+  *
+  * Copies the record of the last frame (retrying while the RX path writes it),
+  * measures the consumer stage up to `now` and updates minimum, maximum and sum
+  * of every stage and the histogram of the total. Each frame is counted once,
+  * on its first use. Statistics are only written here, so this function and
+  * uCAN_GetLatency() must run in the same context.
+  *
+  * @param latency Latency block of the RX packet.
+  * @param now     Time at which the value is used.
+  *
+  * @retval UCAN_OK              Frame added to the statistics.
+  * @retval UCAN_NO_CHANGED_VAL  No frame received since the last use.
+  * @retval UCAN_BUSY            Record kept changing for UCAN_LATENCY_READ_RETRIES attempts.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_UseLatency(UCAN_LatencyStats* latency, UCAN_Time now)
+{
+    for (uint32_t attempt = 0; attempt < UCAN_LATENCY_READ_RETRIES; attempt++)
+    {
+        uint32_t seq = latency->seq;
+
+        if (seq & 1U)
+        {
+            // RX path is writing, try again
+            continue;
+        }
+        __DMB();
+
+        uint32_t stage[UCAN_LATENCY_STAGES];
+        stage[UCAN_LATENCY_PRODUCER] = latency->producerUs;
+        stage[UCAN_LATENCY_BUS] = latency->busUs;
+        UCAN_Time rxTime = latency->rxTime;
+
+        __DMB();
+        if (latency->seq != seq)
+        {
+            continue;
+        }
+
+        if (seq == latency->usedSeq)
+        {
+            // Same frame as the last use
+            return UCAN_NO_CHANGED_VAL;
+        }
+
+        latency->usedSeq = seq;
+
+        stage[UCAN_LATENCY_CONSUMER] = (uint32_t)uCAN_Runtime_TimeToUs(latency->timebase, UCAN_TIME_SINCE(now, rxTime));
+        stage[UCAN_LATENCY_TOTAL] = stage[UCAN_LATENCY_PRODUCER] + stage[UCAN_LATENCY_BUS] + stage[UCAN_LATENCY_CONSUMER];
+
+        for (uint8_t i = 0; i < UCAN_LATENCY_STAGES; i++)
+        {
+            UCAN_LatencySpan* span = &latency->spans[i];
+
+            if (latency->count == 0U || stage[i] < span->min)
+            {
+                span->min = stage[i];
+            }
+
+            if (latency->count == 0U || stage[i] > span->max)
+            {
+                span->max = stage[i];
+            }
+
+            span->sum += stage[i];
+        }
+
+        latency->histogram[uCAN_Runtime_LatencyBucket(stage[UCAN_LATENCY_TOTAL])]++;
+        latency->count++;
+
+        return UCAN_OK;
+    }
+
+    return UCAN_BUSY;
+}
+#endif /* UCAN_CFG_LATENCY */
+
+#if UCAN_CFG_HW_TIMESTAMP
+/**
+  * @brief [INTERNAL] Places a 16-bit hardware timestamp on the 64-bit timebase.
+  *
+  * The TTCM counter wraps every 65536 bit times, which can be shorter than the
+  * gap between two events. The counter value at `tick` is therefore predicted
+  * from the previous event and the elapsed milliseconds, and the event is
+  * placed at the value nearest to that prediction whose low 16 bits equal
+  * `raw`. The prediction only has to be right within half a wrap (32.7 ms at
+  * 1 Mbit/s), so the 1 ms tick resolution and interrupt latency are harmless.
+  *
+  * Must not be preempted by another caller on the same clock: RX and TX
+  * interrupts of one controller are expected to run at the same priority.
+  *
+  * @param clock Pointer to the hardware clock state.
+  * @param raw   16-bit TTCM timestamp of the event.
+  * @param tick  HAL tick (ms) at which the event is processed.
+  * @retval uint64_t Extended time in bit times.
+  */
+uint64_t uCAN_Runtime_ExtendTimestamp(UCAN_HwClock* clock, uint16_t raw, uint32_t tick)
+{
+    // Expected counter value from the elapsed milliseconds, never backwards
+    int32_t elapsed = (int32_t)(tick - clock->lastTick);
+
+    if (elapsed < 0)
+    {
+        elapsed = 0;
+    }
+
+    uint64_t predicted = clock->last + ((uint64_t)elapsed * clock->bitRate) / 1000U;
+
+    // Signed distance to the nearest value with the hardware low bits
+    int32_t diff = (int16_t)(uint16_t)(raw - (uint16_t)predicted);
+
+    if (diff < 0 && predicted < (uint64_t)(-diff))
+    {
+        // No earlier wrap exists right after startup
+        diff += 0x10000;
+    }
+
+    uint64_t time = (diff < 0) ? (predicted - (uint64_t)(-diff)) : (predicted + (uint64_t)diff);
+
+    clock->last = time;
+    clock->lastTick = tick;
+
+    return time;
+}
+
+/**
+  * @brief [INTERNAL] Records a timed event (RX frame or TX confirmation) of a packet.
+  *
+  * Keeps the time of the last event and the last, smallest and largest
+  * interval between events. Like the signal statistics, the sequence counter
+  * is odd while the block is written so readers can retry torn copies.
+  *
+  * @param timing Pointer to the packet's timing block.
+  * @param time   Extended time of the event in bit times.
+  */
+void uCAN_Runtime_UpdateTiming(UCAN_PacketTiming* timing, uint64_t time)
+{
+    // Mark block as being written
+    timing->seq++;
+    __DMB();
+
+    if (timing->count != 0)
+    {
+        uint32_t period = (uint32_t)(time - timing->time);
+
+        timing->period = period;
+
+        if (timing->count == 1 || period < timing->periodMin) timing->periodMin = period;
+        if (timing->count == 1 || period > timing->periodMax) timing->periodMax = period;
+    }
+
+    timing->time = time;
+    timing->count++;
+
+    // Block is consistent again
+    __DMB();
+    timing->seq++;
+}
+
+/**
+  * @brief [INTERNAL] Converts bit times of the hardware timebase to microseconds.
+  * @param clock Pointer to the hardware clock state.
+  * @param bits  Duration in bit times.
+  * @retval uint64_t Duration in microseconds.
+  */
+uint64_t uCAN_Runtime_BitsToUs(const UCAN_HwClock* clock, uint64_t bits)
+{
+    return (bits * clock->nsPerBit) / 1000U;
+}
+#endif /* UCAN_CFG_HW_TIMESTAMP */
+
+#if UCAN_CFG_SCHEDULE
+/**
+  * @brief [INTERNAL] Reads the schedule's microsecond clock.
+  *
+  * Uses the user time source if one is set, otherwise the low 32 bits of the
+  * handle timebase in microseconds, which wrap like a 32-bit 1 MHz timer.
+  *
+  * @param schedule Pointer to the compiled schedule.
+  * @retval uint32_t Current time in microseconds.
+  */
+static uint32_t uCAN_Runtime_ScheduleNow(UCAN_Schedule* schedule)
+{
+    if (schedule->nowUs != NULL)
+    {
+        return schedule->nowUs();
+    }
+
+    return (uint32_t)uCAN_Runtime_TimeToUs(schedule->timebase, uCAN_Runtime_Now(schedule->timebase));
+}
+
+/**
+  * @brief [INTERNAL] Starts a basic cycle on reception of the reference message.
+  *
+  * The RX interrupt fires after the last bit of the reference frame, so the
+  * cycle start is placed one reference frame length earlier, at its start of
+  * frame. The cycle counter carried in the first data byte keeps multi-cycle
+  * windows of all nodes aligned. The sequence counter is odd while the cycle
+  * reference is written, so uCAN_Runtime_RunSchedule() never uses a torn copy.
+  *
+  * @param schedule Pointer to the schedule.
+  * @param aData    Pointer to the received data bytes.
+  * @param dlc      Number of received data bytes.
+  *
+  * @retval UCAN_OK              Cycle started.
+  * @retval UCAN_INVALID_PARAM   schedule is NULL.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_SyncSchedule(UCAN_Schedule* schedule, uint8_t aData[], uint8_t dlc)
+{
+    if (schedule == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    uint32_t now = uCAN_Runtime_ScheduleNow(schedule);
+
+    // Mark cycle reference as being written
+    schedule->syncSeq++;
+    __DMB();
+
+    schedule->cycleStartUs = now - schedule->refLengthUs;
+    schedule->cycleCount = (dlc > 0) ? aData[0] : (uint8_t)(schedule->cycleCount + 1U);
+    schedule->cycles++;
+
+    // Cycle reference is consistent again
+    __DMB();
+    schedule->syncSeq++;
+
+    return UCAN_OK;
+}
+
+/**
+  * @brief [INTERNAL] Sends the reference message (time master) and all due windows.
+  *
+  * The time master starts a new basic cycle once the previous one has elapsed
+  * and sends the reference message carrying the cycle counter. Cycles follow
+  * each other back to back on the time source; after a stall longer than a
+  * cycle the master restarts from the current time instead of bursting.
+  *
+  * Every window whose offset has been reached in the current cycle is then
+  * processed in order. A window is used only in its own cycles (repeat and
+  * cycle offset). Its packet is sent if the frame still ends before the next
+  * window (or the end of the cycle) begins; otherwise the window is counted as
+  * missed, so a late tick never pushes a frame into another node's slot. The
+  * delay after the window start is recorded as the schedule jitter.
+  *
+  * A client that has not received a reference message yet, or has not seen
+  * one for two cycles, stays silent.
+  *
+  * @param buses    Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param schedule Pointer to the schedule.
+  * @param nextUs   Output time until the next window or the next cycle,
+  *                 suitable for reprogramming a one-shot timer.
+  *
+  * @retval UCAN_OK              All due windows processed.
+  * @retval UCAN_INVALID_PARAM   Null pointer input.
+  * @retval UCAN_NO_CONNECTION   Client without a valid cycle reference.
+  * @retval UCAN_BUSY            A cycle reference was being recorded, call again.
+  * @retval UCAN_ERROR           The reference message or a packet could not be queued.
+  */
+UCAN_StatusTypeDef uCAN_Runtime_RunSchedule(UCAN_Bus* buses, UCAN_Schedule* schedule, uint32_t* nextUs)
+{
+    if (buses == NULL || schedule == NULL || nextUs == NULL)
+    {
+        return UCAN_INVALID_PARAM;
+    }
+
+    UCAN_StatusTypeDef status = UCAN_OK;
+    uint32_t now = uCAN_Runtime_ScheduleNow(schedule);
+
+    *nextUs = 0;
+
+    if (schedule->timeMaster)
+    {
+        uint32_t elapsed = now - schedule->cycleStartUs;
+
+        if (schedule->cycles == 0 || elapsed >= schedule->cycleUs)
+        {
+            // Next basic cycle, restart from now after a stall
+            if (schedule->cycles == 0 || elapsed >= 2U * schedule->cycleUs)
+            {
+                schedule->cycleStartUs = now;
+            }
+            else
+            {
+                schedule->cycleStartUs += schedule->cycleUs;
+            }
+
+            uint8_t reference = ++schedule->cycleCount;
+
+            // Sole writer on the master, a new even value opens the cycle
+            schedule->syncSeq += 2U;
+            schedule->cycles++;
+
+            if (uCAN_Runtime_SendFrame(buses, schedule->referenceId, 1, &reference) != UCAN_OK)
+            {
+                status = UCAN_ERROR;
+            }
+        }
+    }
+
+    // Consistent copy of the cycle reference
+    uint32_t seq = schedule->syncSeq;
+
+    if (seq & 1U)
+    {
+        return UCAN_BUSY;
+    }
+    __DMB();
+
+    uint32_t cycleStart = schedule->cycleStartUs;
+    uint8_t cycle = schedule->cycleCount;
+
+    __DMB();
+    if (schedule->syncSeq != seq)
+    {
+        return UCAN_BUSY;
+    }
+
+    if (schedule->cycles == 0)
+    {
+        // No reference received yet
+        *nextUs = schedule->cycleUs;
+        return UCAN_NO_CONNECTION;
+    }
+
+    if (seq != schedule->seenSeq)
+    {
+        // New cycle, walk the windows from the start
+        schedule->seenSeq = seq;
+        schedule->nextWindow = 0;
+    }
+
+    uint32_t elapsed = now - cycleStart;
+
+    if (!schedule->timeMaster && elapsed >= 2U * schedule->cycleUs)
+    {
+        // Reference lost, never transmit without a valid cycle
+        *nextUs = schedule->cycleUs;
+        return UCAN_NO_CONNECTION;
+    }
+
+    while (schedule->nextWindow < schedule->windowCount &&
+           schedule->windows[schedule->nextWindow].offsetUs <= elapsed)
+    {
+        uint32_t index = schedule->nextWindow++;
+        UCAN_ScheduleWindow* window = &schedule->windows[index];
+
+        if (((uint8_t)(cycle - window->cycleOffset) & (window->repeat - 1U)) != 0)
+        {
+            // Window belongs to another cycle
+            continue;
+        }
+
+        uint32_t closeUs = (index + 1U < schedule->windowCount) ? schedule->windows[index + 1U].offsetUs : schedule->cycleUs;
+        uint32_t late = elapsed - window->offsetUs;
+
+        if (elapsed + window->lengthUs > closeUs)
+        {
+            // Too late, the frame would run into the next window
+            window->missed++;
+            continue;
+        }
+
+        window->lastLateUs = late;
+
+        if (late > window->maxLateUs)
+        {
+            window->maxLateUs = late;
+        }
+
+        if (uCAN_Runtime_SendPacket(buses, window->packet) != UCAN_OK)
+        {
+            status = UCAN_ERROR;
+        }
+    }
+
+    if (schedule->nextWindow < schedule->windowCount)
+    {
+        *nextUs = schedule->windows[schedule->nextWindow].offsetUs - elapsed;
+    }
+    else if (elapsed < schedule->cycleUs)
+    {
+        *nextUs = schedule->cycleUs - elapsed;
+    }
+    else
+    {
+        // Client past the cycle end, the next reference message restarts the walk
+        *nextUs = schedule->cycleUs;
+    }
+
+    return status;
+}
+#endif /* UCAN_CFG_SCHEDULE */
+
+#if UCAN_CFG_FAULT
+/**
+  * @brief [INTERNAL] Switches the injected clock drift of a timebase.
+  *
+  * The drift of the window that ends is folded into the offset first, so the
+  * handle time stays continuous across drift windows.
+  *
+  * @param timebase Pointer to the finalized timebase.
+  * @param now      Current time without injected drift.
+  * @param ppm      New drift in parts per million, 0 for none.
+  */
+static void uCAN_Runtime_SetDrift(UCAN_Timebase* timebase, UCAN_Time now, int32_t ppm)
+{
+    int32_t current = timebase->driftPpm;
+
+    if (ppm == current)
+    {
+        return;
+    }
+
+    timebase->driftPpm = 0;
+
+    if (current != 0)
+    {
+        timebase->driftOffset += ((int64_t)(now - timebase->driftStart) * current) / 1000000;
+    }
+
+    timebase->driftStart = now;
+    __DMB();
+    timebase->driftPpm = ppm;
+}
+
+/**
+  * @brief [INTERNAL] Tells whether a fault step applies to a frame and counts it.
+  * @param step Pointer to an active step.
+  * @param bus  Index of the bus the frame is on.
+  * @param id   CAN identifier of the frame.
+  * @retval uint8_t 1 if the step hits this frame, 0 otherwise.
+  */
+static uint8_t uCAN_Runtime_FaultHit(UCAN_FaultStep* step, uint8_t bus, uint32_t id)
+{
+    if ((step->busMask != 0U && !(step->busMask & (1U << bus))) ||
+        (step->id != UCAN_FAULT_ANY_ID && step->id != id))
+    {
+        return 0;
+    }
+
+    uint32_t seen = ++step->seen;
+
+    // Only every n-th matching frame
+    if (step->every > 1U && (seen % step->every) != 0U)
+    {
+        return 0;
+    }
+
+    step->hits++;
+    return 1;
+}
+
+/**
+  * @brief [INTERNAL] Resets a fault scenario and starts its clock.
+  * @param plan     Pointer to the scenario.
+  * @param timebase Pointer to the finalized timebase.
+  */
+void uCAN_Runtime_FaultStart(UCAN_FaultPlan* plan, UCAN_Timebase* timebase)
+{
+    plan->active = 0U;
+    plan->injected = 0U;
+    memset(&plan->connection, 0, sizeof(plan->connection));
+    memset(&plan->bus, 0, sizeof(plan->bus));
+
+    for (uint32_t n = 0; n < plan->stepCount; n++)
+    {
+        plan->steps[n].seen = 0U;
+        plan->steps[n].hits = 0U;
+    }
+
+    plan->startTime = uCAN_Runtime_Extend(timebase);
+}
+
+/**
+  * @brief [INTERNAL] Ends the injected clock drift of a stopped scenario.
+  * @param timebase Pointer to the finalized timebase.
+  */
+void uCAN_Runtime_FaultStop(UCAN_Timebase* timebase)
+{
+    uCAN_Runtime_SetDrift(timebase, uCAN_Runtime_Extend(timebase), 0);
+}
+
+/**
+  * @brief [INTERNAL] Opens and closes the step windows of a fault scenario.
+  *
+  * Windows are measured on the undrifted counter, so a drift step does not
+  * stretch the scenario itself. The drift of all active CLOCK_DRIFT steps is
+  * summed and applied to the timebase, and every active BABBLE step fills the
+  * free mailboxes of its buses.
+  *
+  * @param buses    Buses of the handle (UCAN_BUS_COUNT entries).
+  * @param plan     Pointer to the running scenario.
+  * @param timebase Pointer to the finalized timebase.
+  * @retval UCAN_Time Current time without injected drift.
+  */
+UCAN_Time uCAN_Runtime_FaultUpdate(UCAN_Bus* buses, UCAN_FaultPlan* plan, UCAN_Timebase* timebase)
+{
+    UCAN_Time now = uCAN_Runtime_Extend(timebase);
+    uint32_t elapsedMs = uCAN_Runtime_TimeToMs(timebase, now - plan->startTime);
+    uint32_t active = 0U;
+    int32_t ppm = 0;
+
+    for (uint32_t n = 0; n < plan->stepCount; n++)
+    {
+        UCAN_FaultStep* step = &plan->steps[n];
+
+        if (elapsedMs < step->startMs || (elapsedMs - step->startMs) >= step->durationMs)
+        {
+            continue;
+        }
+
+        active |= 1UL << n;
+
+        if (step->kind == UCAN_FAULT_CLOCK_DRIFT)
+        {
+            ppm += (int32_t)step->param;
+        }
+        else if (step->kind == UCAN_FAULT_BABBLE)
+        {
+            CAN_TxHeaderTypeDef txHeader;
+            uint32_t TxMailbox;
+            uint8_t data[8] = {0};
+
+            txHeader.StdId = (step->id == UCAN_FAULT_ANY_ID) ? 0U : step->id;
+            txHeader.DLC   = 8;
+            txHeader.IDE   = CAN_ID_STD;
+            txHeader.RTR   = CAN_RTR_DATA;
+            txHeader.TransmitGlobalTime = DISABLE;
+
+            // Foreign frames, kept out of the bus counters
+            for (uint8_t b = 0; b < UCAN_BUS_COUNT; b++)
+            {
+                if (buses[b].hcan == NULL || (step->busMask != 0U && !(step->busMask & (1U << b))))
+                {
+                    continue;
+                }
+
+                for (uint32_t k = 0; k < ((step->param != 0U) ? step->param : 1U); k++)
+                {
+                    if (HAL_CAN_GetTxMailboxesFreeLevel(buses[b].hcan) == 0U ||
+                        HAL_CAN_AddTxMessage(buses[b].hcan, &txHeader, data, &TxMailbox) != HAL_OK)
+                    {
+                        break;
+                    }
+
+                    step->hits++;
+                    plan->injected++;
+                }
+            }
+        }
+    }
+
+    uCAN_Runtime_SetDrift(timebase, now, ppm);
+    plan->active = active;
+
+    return now;
+}
+
+/**
+  * @brief [INTERNAL] Tells whether the running scenario holds a bus in bus-off.
+  * @param plan Pointer to the running scenario.
+  * @param bus  Index of the bus.
+  * @retval uint8_t 1 if an active BUS_OFF step covers the bus, 0 otherwise.
+  */
+uint8_t uCAN_Runtime_FaultBusOff(const UCAN_FaultPlan* plan, uint8_t bus)
+{
+    for (uint32_t active = plan->active, n = 0; active != 0U; active >>= 1, n++)
+    {
+        const UCAN_FaultStep* step = &plan->steps[n];
+
+        if ((active & 1U) && step->kind == UCAN_FAULT_BUS_OFF &&
+            (step->busMask == 0U || (step->busMask & (1U << bus))))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+  * @brief [INTERNAL] Applies the running scenario to a received frame.
+  *
+  * Called right after the frame was taken from the FIFO, before uCAN counts or
+  * processes it. A dropped frame leaves no trace but the step's hit counter,
+  * a frame arriving on a bus held in bus-off not even that.
+  *
+  * @param plan   Pointer to the running scenario.
+  * @param bus    Index of the bus the frame came from.
+  * @param header Header of the frame.
+  * @param data   Payload of the frame, corrupted in place.
+  * @retval uint8_t 1 if the frame must be discarded, 0 to process it.
+  */
+uint8_t uCAN_Runtime_FaultRx(UCAN_FaultPlan* plan, uint8_t bus, const CAN_RxHeaderTypeDef* header, uint8_t data[])
+{
+    uint32_t id = (header->IDE == CAN_ID_EXT) ? header->ExtId : header->StdId;
+    uint8_t drop = 0;
+
+    // Controller held in bus-off takes no part in the traffic
+    if (uCAN_Runtime_FaultBusOff(plan, bus))
+    {
+        return 1;
+    }
+
+    for (uint32_t active = plan->active, n = 0; active != 0U && !drop; active >>= 1, n++)
+    {
+        UCAN_FaultStep* step = &plan->steps[n];
+
+        if (!(active & 1U))
+        {
+            continue;
+        }
+
+        switch (step->kind)
+        {
+            case UCAN_FAULT_DROP_RX:
+                drop = uCAN_Runtime_FaultHit(step, bus, id);
+                break;
+
+            case UCAN_FAULT_CORRUPT_RX:
+            {
+                uint32_t index = (step->param >> 8) & 0x7U;
+                uint8_t mask = (uint8_t)step->param;
+
+                if (index < header->DLC && uCAN_Runtime_FaultHit(step, bus, id))
+                {
+                    data[index] ^= (mask != 0U) ? mask : 0xFFU;
+                    plan->injected++;
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    if (drop)
+    {
+        plan->injected++;
+    }
+
+    return drop;
+}
+
+/**
+  * @brief [INTERNAL] Applies the running scenario to a frame about to be queued.
+  * @param plan Pointer to the running scenario.
+  * @param bus  Index of the bus the frame is queued on.
+  * @param id   CAN identifier of the frame.
+  * @retval uint8_t 1 if the frame must be swallowed, 0 to queue it.
+  */
+uint8_t uCAN_Runtime_FaultTx(UCAN_FaultPlan* plan, uint8_t bus, uint32_t id)
+{
+    for (uint32_t active = plan->active, n = 0; active != 0U; active >>= 1, n++)
+    {
+        UCAN_FaultStep* step = &plan->steps[n];
+
+        if ((active & 1U) && step->kind == UCAN_FAULT_DROP_TX && uCAN_Runtime_FaultHit(step, bus, id))
+        {
+            plan->injected++;
+            return 1;
+        }
+    }
+
+    return 0;
 }
+#endif /* UCAN_CFG_FAULT */
 
 /**
   * @brief [INTERNAL] Compare two UCAN_Packet structs by their CAN ID.
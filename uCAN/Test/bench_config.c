@@ -0,0 +1,154 @@
+/**
+  ******************************************************************************
+  * @file    bench_config.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host benchmark of the per-call cost of one configuration.
+  *
+  * Built once per configuration of the `make size` report (see Makefile).
+  * Reports, in nanoseconds:
+  *  - uCAN_Update() on an empty FIFO, i.e. the readiness check and the FIFO
+  *    poll every API call and interrupt pays;
+  *  - uCAN_Update() per received 8-byte frame of a known packet.
+  *
+  * Every figure is the best of several runs.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define RX_PACKETS		8U
+#define CALLS			1000000U
+#define REPEAT			4000U
+#define RUNS			5U
+
+#ifndef BENCH_CONFIG
+#define BENCH_CONFIG	"default"
+#endif
+
+static CAN_HandleTypeDef hcan;
+static UCAN_HandleTypeDef ucan;
+static UCAN_Client clients[1] = { { .id = 0x020 } };
+static UCAN_Packet txPackets[1];
+static UCAN_Packet rxPackets[RX_PACKETS];
+static uint8_t txValue;
+static uint8_t bytes[RX_PACKETS][8];
+static volatile uint32_t sink;
+
+/**
+  * @brief  Starts a handle in the role fixed by UCAN_CFG_ROLE with 8 RX packets of 8 U8 signals.
+  */
+static void Setup(void)
+{
+    UCAN_PacketConfig txConfig[1] = {
+        { .id = 0x7E1, .item_count = 1, .items = { { &txValue, UCAN_U8 } } },
+    };
+    UCAN_PacketConfig rxConfig[RX_PACKETS];
+
+    HostCan_Reset();
+    memset(&ucan, 0, sizeof(ucan));
+    memset(rxConfig, 0, sizeof(rxConfig));
+
+    hcan.Instance = CAN1;
+    ucan.hcan = &hcan;
+#if (UCAN_CFG_ROLE == UCAN_CFG_ROLE_MASTER)
+    ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_MASTER, .selfId = 0x010, .clients = clients, .clientCount = 1 };
+#elif (UCAN_CFG_ROLE == UCAN_CFG_ROLE_CLIENT)
+    ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_CLIENT, .selfId = 0x020, .masterId = 0x010, .clients = clients, .clientCount = 1 };
+#else
+    ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_NONE, .selfId = 0x7E0, .clients = clients, .clientCount = 1 };
+#endif
+    ucan.txHolder = (UCAN_PacketHolder){ .packets = txPackets, .count = 1 };
+    ucan.rxHolder = (UCAN_PacketHolder){ .packets = rxPackets, .count = RX_PACKETS };
+
+    for (uint32_t k = 0; k < RX_PACKETS; k++)
+    {
+        rxConfig[k].id = 0x100U + k;
+        rxConfig[k].item_count = 8;
+
+        for (uint32_t i = 0; i < 8U; i++)
+        {
+            rxConfig[k].items[i].type = UCAN_U8;
+            rxConfig[k].items[i].ptr = &bytes[k][i];
+        }
+    }
+
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&ucan) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&ucan, &config) == UCAN_OK);
+}
+
+static double BenchEmpty(void)
+{
+    double best = 1e9;
+
+    for (uint32_t run = 0; run < RUNS; run++)
+    {
+        uint64_t t0 = uCAN_Test_Ns();
+
+        for (uint32_t i = 0; i < CALLS; i++)
+        {
+            sink += uCAN_Update(&ucan);
+        }
+
+        double ns = (double)(uCAN_Test_Ns() - t0) / CALLS;
+        best = (ns < best) ? ns : best;
+    }
+
+    return best;
+}
+
+static double BenchFrame(void)
+{
+    double best = 1e9;
+    uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    for (uint32_t run = 0; run < RUNS; run++)
+    {
+        uint64_t spent = 0;
+
+        for (uint32_t r = 0; r < REPEAT; r++)
+        {
+            for (uint32_t i = 0; i < HOST_CAN_FIFO_DEPTH; i++)
+            {
+                data[0] = (uint8_t)i;
+                HostCan_Inject(&hcan, 0x100U + (i % RX_PACKETS), 8, data);
+            }
+
+            uint64_t t0 = uCAN_Test_Ns();
+
+            for (uint32_t i = 0; i < HOST_CAN_FIFO_DEPTH; i++)
+            {
+                sink += uCAN_Update(&ucan);
+            }
+
+            spent += uCAN_Test_Ns() - t0;
+        }
+
+        double ns = (double)spent / ((double)REPEAT * HOST_CAN_FIFO_DEPTH);
+        best = (ns < best) ? ns : best;
+    }
+
+    return best;
+}
+
+int main(void)
+{
+    Setup();
+
+    // Every frame reaches its packet
+    uint8_t data[8] = { 9, 8, 7, 6, 5, 4, 3, 2 };
+    HostCan_Inject(&hcan, 0x103, 8, data);
+    UCAN_TEST_CHECK(uCAN_Update(&ucan) == UCAN_OK && memcmp(bytes[3], data, 8) == 0);
+
+    double empty = BenchEmpty();
+    double frame = BenchFrame();
+
+    printf("  config bench %-16s uCAN_Update empty FIFO %5.1f ns, per 8-byte frame %5.1f ns\n", BENCH_CONFIG, empty, frame);
+
+    return UCAN_TEST_RESULT("bench_config_" BENCH_CONFIG);
+}
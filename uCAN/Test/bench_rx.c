@@ -0,0 +1,282 @@
+/**
+  ******************************************************************************
+  * @file    bench_rx.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host benchmark of the RX path.
+  *
+  * Reports per-frame times of:
+  *  - the RX packet lookup and uCAN_Update() / uCAN_UpdateBatch() with 64 RX
+  *    packets and half of the frames carrying unknown identifiers; build with
+  *    UCAN_CFG_RX_INDEX=0 for the binary search baseline;
+  *  - storing an 8-byte frame through per-byte pointers and through a struct
+  *    overlay, ID lookup included;
+  *  - delivering a frame of an 8-signal packet eagerly and lazily.
+  *
+  * Every figure is the best of several runs, in nanoseconds per frame.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "ucan_runtime.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define RX_PACKETS		64U
+#define FRAMES			1024U
+#define REPEAT			2000U
+#define RUNS			5U
+
+typedef struct {
+    uint8_t b[8];
+} Payload;
+
+static CAN_HandleTypeDef hcan;
+static UCAN_Client clients[1] = { { .id = 0x7F0 } };
+static UCAN_PacketConfig txConfig[1];
+static UCAN_PacketConfig rxConfig[RX_PACKETS];
+static UCAN_Packet txPackets[1];
+static UCAN_Packet rxPackets[RX_PACKETS];
+static uint8_t txValue;
+static uint8_t bytes[RX_PACKETS][8];
+static Payload overlays[RX_PACKETS];
+static uint32_t ids[FRAMES];
+static UCAN_MonitorFrame frames[FRAMES];
+static volatile uint32_t sink;
+
+/**
+  * @brief  Starts a handle with 64 RX packets of 8 U8 signals (or one 8-byte overlay) on even IDs.
+  */
+static void Setup(UCAN_HandleTypeDef* ucan, uint8_t overlay, uint8_t lazy)
+{
+    HostCan_Reset();
+    memset(ucan, 0, sizeof(*ucan));
+    memset(rxConfig, 0, sizeof(rxConfig));
+
+    hcan.Instance = CAN1;
+    ucan->hcan = &hcan;
+    ucan->node.role = UCAN_ROLE_NONE;
+    ucan->node.selfId = 0x7E0;
+    ucan->node.clients = clients;
+    ucan->node.clientCount = 1;
+    ucan->txHolder.packets = txPackets;
+    ucan->txHolder.count = 1;
+    ucan->rxHolder.packets = rxPackets;
+    ucan->rxHolder.count = RX_PACKETS;
+
+    txConfig[0] = (UCAN_PacketConfig){ .id = 0x7E1, .item_count = 1, .items = { { .type = UCAN_U8, .ptr = &txValue } } };
+
+    for (uint32_t k = 0; k < RX_PACKETS; k++)
+    {
+        rxConfig[k].id = 0x100U + 2U * k;
+
+        if (overlay)
+        {
+            rxConfig[k].overlay = &overlays[k];
+            rxConfig[k].overlaySize = sizeof(Payload);
+            continue;
+        }
+
+        rxConfig[k].item_count = 8;
+        rxConfig[k].lazy = lazy;
+
+        for (uint32_t i = 0; i < 8U; i++)
+        {
+            rxConfig[k].items[i].type = UCAN_U8;
+            rxConfig[k].items[i].ptr = &bytes[k][i];
+        }
+    }
+
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(ucan) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(ucan, &config) == UCAN_OK);
+}
+
+static double Best(double a, double b)
+{
+    return (a < b) ? a : b;
+}
+
+static double BenchLookup(UCAN_HandleTypeDef* ucan)
+{
+    double best = 1e9;
+
+    for (uint32_t run = 0; run < RUNS; run++)
+    {
+        uint64_t t0 = uCAN_Test_Ns();
+
+        for (uint32_t r = 0; r < REPEAT; r++)
+        {
+            for (uint32_t i = 0; i < FRAMES; i++)
+            {
+                sink += (uCAN_Runtime_FindPacket(&ucan->rxHolder, ids[i]) != NULL);
+            }
+        }
+
+        best = Best(best, (double)(uCAN_Test_Ns() - t0) / ((double)REPEAT * FRAMES));
+    }
+
+    return best;
+}
+
+static double BenchUpdate(UCAN_HandleTypeDef* ucan)
+{
+    double best = 1e9;
+    uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    for (uint32_t run = 0; run < RUNS; run++)
+    {
+        uint64_t spent = 0;
+
+        for (uint32_t r = 0; r < REPEAT / 16U; r++)
+        {
+            for (uint32_t base = 0; base < FRAMES; base += HOST_CAN_FIFO_DEPTH)
+            {
+                for (uint32_t i = 0; i < HOST_CAN_FIFO_DEPTH; i++)
+                {
+                    HostCan_Inject(&hcan, ids[base + i], 8, data);
+                }
+
+                uint64_t t0 = uCAN_Test_Ns();
+
+                for (uint32_t i = 0; i < HOST_CAN_FIFO_DEPTH; i++)
+                {
+                    (void)uCAN_Update(ucan);
+                }
+
+                spent += uCAN_Test_Ns() - t0;
+            }
+        }
+
+        best = Best(best, (double)spent / ((double)(REPEAT / 16U) * FRAMES));
+    }
+
+    return best;
+}
+
+static double BenchBatch(UCAN_HandleTypeDef* ucan)
+{
+    double best = 1e9;
+
+    for (uint32_t run = 0; run < RUNS; run++)
+    {
+        uint64_t t0 = uCAN_Test_Ns();
+
+        for (uint32_t r = 0; r < REPEAT; r++)
+        {
+            (void)uCAN_UpdateBatch(ucan, frames, FRAMES);
+        }
+
+        best = Best(best, (double)(uCAN_Test_Ns() - t0) / ((double)REPEAT * FRAMES));
+    }
+
+    return best;
+}
+
+/**
+  * @brief  Stores 8-byte frames of known IDs, ID lookup included.
+  */
+static double BenchStore(UCAN_HandleTypeDef* ucan)
+{
+    double best = 1e9;
+    uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    for (uint32_t run = 0; run < RUNS; run++)
+    {
+        uint64_t t0 = uCAN_Test_Ns();
+
+        for (uint32_t r = 0; r < REPEAT; r++)
+        {
+            for (uint32_t i = 0; i < FRAMES; i++)
+            {
+                data[0] = (uint8_t)i;
+                (void)uCAN_Runtime_UpdatePacket(&ucan->rxHolder, 0x100U + 2U * (i % RX_PACKETS), data, 8, i, i, 0);
+            }
+        }
+
+        best = Best(best, (double)(uCAN_Test_Ns() - t0) / ((double)REPEAT * FRAMES));
+    }
+
+    return best;
+}
+
+/**
+  * @brief  Delivers 8-byte frames to an already looked-up packet.
+  */
+static double BenchDeliver(UCAN_HandleTypeDef* ucan)
+{
+    double best = 1e9;
+    uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    for (uint32_t run = 0; run < RUNS; run++)
+    {
+        uint64_t t0 = uCAN_Test_Ns();
+
+        for (uint32_t r = 0; r < REPEAT; r++)
+        {
+            for (uint32_t i = 0; i < FRAMES; i++)
+            {
+                data[0] = (uint8_t)i;
+                (void)uCAN_Runtime_DeliverPacket(&ucan->rxHolder.packets[i % RX_PACKETS], data, 8, i, i, 0);
+            }
+        }
+
+        best = Best(best, (double)(uCAN_Test_Ns() - t0) / ((double)REPEAT * FRAMES));
+    }
+
+    return best;
+}
+
+int main(void)
+{
+    UCAN_HandleTypeDef ucan;
+    uint32_t seed = 12345;
+
+    // Half known (even) and half unknown (odd) identifiers in random order
+    for (uint32_t i = 0; i < FRAMES; i++)
+    {
+        seed = seed * 1103515245U + 12345U;
+        ids[i] = 0x100U + 2U * ((seed >> 16) % RX_PACKETS) + (i & 1U);
+        memset(&frames[i], 0, sizeof(frames[i]));
+        frames[i].id = ids[i];
+        frames[i].dlc = 8;
+    }
+
+    Setup(&ucan, 0, 0);
+
+    // The lookup must agree with the configuration for every standard ID
+    for (uint32_t id = 0; id < 0x800U; id++)
+    {
+        UCAN_Packet* packet = uCAN_Runtime_FindPacket(&ucan.rxHolder, id);
+        uint8_t known = (id >= 0x100U && id < 0x100U + 2U * RX_PACKETS && (id & 1U) == 0U);
+
+        UCAN_TEST_CHECK(known ? (packet != NULL && packet->id == id) : (packet == NULL));
+    }
+
+    // Remote frames of a known ID leave the packet untouched in both RX paths
+    UCAN_MonitorFrame remote = { .id = 0x100, .dlc = 8, .flags = UCAN_MONITOR_FLAG_RTR, .data = { 0xEE } };
+    UCAN_TEST_CHECK(uCAN_UpdateBatch(&ucan, &remote, 1) == UCAN_OK && bytes[0][0] == 0U);
+    HostCan_InjectRemote(&hcan, 0x100, 8);
+    UCAN_TEST_CHECK(uCAN_Update(&ucan) == UCAN_OK && bytes[0][0] == 0U);
+
+    double lookup = BenchLookup(&ucan);
+    double update = BenchUpdate(&ucan);
+    double batch = BenchBatch(&ucan);
+    double perByte = BenchStore(&ucan);
+    double eager = BenchDeliver(&ucan);
+
+    Setup(&ucan, 1, 0);
+    double overlay = BenchStore(&ucan);
+
+    Setup(&ucan, 0, 1);
+    double lazy = BenchDeliver(&ucan);
+
+    printf("  rx bench (UCAN_CFG_RX_INDEX=%u, %u RX packets, half unknown IDs): lookup %.1f ns, uCAN_Update %.1f ns, uCAN_UpdateBatch %.1f ns per frame\n",
+           (unsigned)UCAN_CFG_RX_INDEX, (unsigned)RX_PACKETS, lookup, update, batch);
+    printf("  rx bench store 8-byte frame: per-byte %.1f ns, overlay %.1f ns; deliver 8-signal packet: eager %.1f ns, lazy %.1f ns\n",
+           perByte, overlay, eager, lazy);
+
+    return UCAN_TEST_RESULT("bench_rx");
+}
@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file    bench_sim.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host benchmark of the multi-threaded discrete-event simulator.
+  *
+  * Simulates BUSES buses of NODES uCAN handles (1024 nodes) for DURATION_US
+  * with host_sim.c, once per worker count up to the number of online CPUs
+  * (at least 1, 2 and 4), and reports simulated frames per wall-clock
+  * second and the speedup over one worker. Every run must give the digest of
+  * the one-worker run. Each figure is the best of RUNS runs.
+  *
+  ******************************************************************************
+  */
+
+#include <unistd.h>
+#include "host_sim.h"
+#include "ucan_test.h"
+
+#define BUSES			32U
+#define NODES			32U
+#define PERIOD_US		20000U
+#define JITTER_US		1000U
+#define DURATION_US		2000000U
+#define RUNS			3U
+
+/**
+  * @brief  Best of RUNS runs with `workers` worker threads.
+  */
+static HostSim_Result Bench(uint32_t workers)
+{
+    HostSim_Config config = { .buses = BUSES, .nodesPerBus = NODES, .workers = workers, .periodUs = PERIOD_US,
+                              .jitterUs = JITTER_US, .durationUs = DURATION_US, .seed = 1 };
+    HostSim_Result best = { 0 };
+
+    for (uint32_t r = 0; r < RUNS; r++)
+    {
+        HostSim_Result result;
+
+        UCAN_TEST_CHECK(HostSim_Run(&config, &result) == 0);
+
+        if (r == 0U || result.wallNs < best.wallNs)
+        {
+            best = result;
+        }
+    }
+
+    return best;
+}
+
+int main(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    HostSim_Result single = Bench(1);
+
+    UCAN_TEST_CHECK(single.refused == 0U && single.overruns == 0U);
+
+    printf("  sim bench: %u nodes on %u buses, %u ms simulated, %llu frames, %llu forwarded, %ld CPUs online\n",
+           (unsigned)(BUSES * NODES), (unsigned)BUSES, (unsigned)(DURATION_US / 1000U),
+           (unsigned long long)single.frames, (unsigned long long)single.forwarded, cpus);
+
+    for (uint32_t workers = 1; workers <= BUSES && (workers <= 4U || workers <= (uint32_t)cpus); workers *= 2U)
+    {
+        HostSim_Result result = (workers == 1U) ? single : Bench(workers);
+
+        UCAN_TEST_CHECK(result.digest == single.digest && result.frames == single.frames);
+
+        printf("  sim bench: %2u workers: %.0f simulated frames/s, %.2fx simulated time, speedup %.2f\n",
+               (unsigned)workers, (double)result.frames * 1e9 / (double)result.wallNs,
+               (double)DURATION_US * 1000.0 / (double)result.wallNs, (double)single.wallNs / (double)result.wallNs);
+    }
+
+    return UCAN_TEST_RESULT("bench_sim");
+}
@@ -0,0 +1,437 @@
+/**
+  ******************************************************************************
+  * @file    host_can.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Simulated bxCAN controllers implementing the host HAL stub.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "host_can.h"
+
+/**
+  * @brief  State of one simulated controller.
+  */
+typedef struct {
+    uint8_t started;						/*!< Non-zero between HAL_CAN_Start() and HAL_CAN_Stop() */
+    uint8_t bus;							/*!< Simulated bus the controller is attached to */
+    uint8_t manualTx;						/*!< Non-zero keeps frames in the mailboxes until HostCan_CompleteTx() */
+    uint8_t pending[3];						/*!< Non-zero while a mailbox holds a frame */
+    HostCan_Frame mailbox[3];				/*!< Frames waiting in the TX mailboxes */
+    uint16_t txStamp[3];					/*!< TTCM time of the last frame sent from each mailbox */
+    HostCan_Frame fifo[HOST_CAN_FIFO_DEPTH];	/*!< RX FIFO 0 */
+    uint32_t fifoHead;						/*!< Index of the oldest FIFO entry */
+    uint32_t fifoCount;						/*!< Number of FIFO entries */
+    uint32_t overruns;						/*!< Frames lost to a full FIFO */
+    HostCan_Frame sent[HOST_CAN_SENT_LOG];	/*!< Ring of transmitted frames */
+    uint32_t sentCount;						/*!< Number of transmitted frames */
+} HostCan_Controller;
+
+static CAN_TypeDef hostRegs[HOST_CAN_INSTANCES];
+static HostCan_Controller hostCan[HOST_CAN_INSTANCES];
+static uint32_t hostTick;
+static int32_t hostSofOffset;
+static void (*barrierHook)(void);
+static void (*transmitHook)(CAN_TypeDef* instance, const HostCan_Frame* frame);
+static uint8_t inBarrierHook;
+
+CAN_TypeDef* const CAN1 = &hostRegs[0];
+CAN_TypeDef* const CAN2 = &hostRegs[1];
+CAN_TypeDef* const CAN3 = &hostRegs[2];
+
+static HostCan_Controller* Controller(const CAN_HandleTypeDef* hcan)
+{
+    return &hostCan[hcan->Instance - hostRegs];
+}
+
+/**
+  * @brief  16-bit TTCM counter value of a frame starting now.
+  */
+static uint16_t Ttcm(void)
+{
+    return (uint16_t)((int64_t)hostTick * HOST_CAN_BITS_PER_MS + hostSofOffset);
+}
+
+static void Receive(HostCan_Controller* ctrl, const HostCan_Frame* frame)
+{
+    if (ctrl->fifoCount == HOST_CAN_FIFO_DEPTH)
+    {
+        ctrl->overruns++;
+        return;
+    }
+
+    ctrl->fifo[(ctrl->fifoHead + ctrl->fifoCount) % HOST_CAN_FIFO_DEPTH] = *frame;
+    ctrl->fifoCount++;
+}
+
+/**
+  * @brief  Puts a frame on the bus of `sender`: every other started controller receives it.
+  */
+static void Transmit(HostCan_Controller* sender, uint32_t mailbox, const HostCan_Frame* frame)
+{
+    HostCan_Frame onWire = *frame;
+
+    onWire.header.Timestamp = Ttcm();
+    sender->txStamp[mailbox] = (uint16_t)onWire.header.Timestamp;
+    sender->sent[sender->sentCount % HOST_CAN_SENT_LOG] = onWire;
+    sender->sentCount++;
+
+    if (transmitHook != NULL)
+    {
+        transmitHook(&hostRegs[sender - hostCan], &onWire);
+        return;
+    }
+
+    for (uint32_t i = 0; i < HOST_CAN_INSTANCES; i++)
+    {
+        if (&hostCan[i] != sender && hostCan[i].started && hostCan[i].bus == sender->bus)
+        {
+            Receive(&hostCan[i], &onWire);
+        }
+    }
+}
+
+void HostCan_Reset(void)
+{
+    memset(hostRegs, 0, sizeof(hostRegs));
+    memset(hostCan, 0, sizeof(hostCan));
+    hostTick = 0;
+    hostSofOffset = 0;
+    barrierHook = NULL;
+    transmitHook = NULL;
+
+    // 500 kbit/s at 42 MHz: prescaler 6, 1 + 11 + 2 time quanta
+    for (uint32_t i = 0; i < HOST_CAN_INSTANCES; i++)
+    {
+        hostRegs[i].BTR = CAN_BS1_11TQ | CAN_BS2_2TQ | (5U << CAN_BTR_BRP_Pos);
+    }
+}
+
+CAN_TypeDef* HostCan_Instance(uint32_t index)
+{
+    return &hostRegs[index];
+}
+
+void HostCan_Advance(uint32_t ms)
+{
+    hostTick += ms;
+}
+
+void HostCan_SetSofOffset(int32_t bits)
+{
+    hostSofOffset = bits;
+}
+
+void HostCan_SetBus(CAN_HandleTypeDef* hcan, uint8_t bus)
+{
+    Controller(hcan)->bus = bus;
+}
+
+void HostCan_SetManualTx(CAN_HandleTypeDef* hcan, uint8_t manual)
+{
+    Controller(hcan)->manualTx = manual;
+}
+
+/**
+  * @brief  Pending mailbox bxCAN sends first: the highest priority (lowest ID).
+  * @retval Mailbox number, -1 if none is pending.
+  */
+static int NextMailbox(const HostCan_Controller* ctrl)
+{
+    int next = -1;
+
+    for (int m = 0; m < 3; m++)
+    {
+        if (ctrl->pending[m] && (next < 0 || ctrl->mailbox[m].header.StdId < ctrl->mailbox[next].header.StdId))
+        {
+            next = m;
+        }
+    }
+
+    return next;
+}
+
+uint32_t HostCan_CompleteTx(CAN_HandleTypeDef* hcan, uint32_t count)
+{
+    HostCan_Controller* ctrl = Controller(hcan);
+    uint32_t done = 0;
+
+    while (done < count)
+    {
+        int next = NextMailbox(ctrl);
+
+        if (next < 0)
+        {
+            break;
+        }
+
+        (void)HostCan_CompleteMailbox(hcan, (uint32_t)next);
+        done++;
+    }
+
+    return done;
+}
+
+uint8_t HostCan_CompleteMailbox(CAN_HandleTypeDef* hcan, uint32_t mailbox)
+{
+    HostCan_Controller* ctrl = Controller(hcan);
+
+    if (mailbox >= 3U || !ctrl->pending[mailbox])
+    {
+        return 0;
+    }
+
+    ctrl->pending[mailbox] = 0;
+    Transmit(ctrl, mailbox, &ctrl->mailbox[mailbox]);
+
+    return 1;
+}
+
+int32_t HostCan_NextTx(const CAN_HandleTypeDef* hcan, HostCan_Frame* frame)
+{
+    const HostCan_Controller* ctrl = Controller(hcan);
+    int next = NextMailbox(ctrl);
+
+    if (next >= 0)
+    {
+        *frame = ctrl->mailbox[next];
+    }
+
+    return next;
+}
+
+void HostCan_SetTransmitHook(void (*hook)(CAN_TypeDef* instance, const HostCan_Frame* frame))
+{
+    transmitHook = hook;
+}
+
+void HostCan_Inject(CAN_HandleTypeDef* hcan, uint32_t id, uint8_t dlc, const uint8_t data[])
+{
+    HostCan_Frame frame;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.header.StdId = id;
+    frame.header.IDE = CAN_ID_STD;
+    frame.header.RTR = CAN_RTR_DATA;
+    frame.header.DLC = dlc;
+    frame.header.Timestamp = Ttcm();
+
+    if (data != NULL)
+    {
+        memcpy(frame.data, data, dlc);
+    }
+
+    Receive(Controller(hcan), &frame);
+}
+
+void HostCan_InjectRemote(CAN_HandleTypeDef* hcan, uint32_t id, uint8_t dlc)
+{
+    HostCan_Frame frame;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.header.StdId = id;
+    frame.header.IDE = CAN_ID_STD;
+    frame.header.RTR = CAN_RTR_REMOTE;
+    frame.header.DLC = dlc;
+    frame.header.Timestamp = Ttcm();
+
+    // Stale bytes, as the bxCAN data registers may hold for a remote frame
+    memset(frame.data, 0xEE, sizeof(frame.data));
+
+    Receive(Controller(hcan), &frame);
+}
+
+uint32_t HostCan_SentCount(const CAN_HandleTypeDef* hcan)
+{
+    return Controller(hcan)->sentCount;
+}
+
+const HostCan_Frame* HostCan_Sent(const CAN_HandleTypeDef* hcan, uint32_t index)
+{
+    return &Controller(hcan)->sent[index % HOST_CAN_SENT_LOG];
+}
+
+uint32_t HostCan_Overruns(const CAN_HandleTypeDef* hcan)
+{
+    return Controller(hcan)->overruns;
+}
+
+void HostCan_SetBarrierHook(void (*hook)(void))
+{
+    barrierHook = hook;
+}
+
+/* HAL functions -------------------------------------------------------------*/
+
+void HostCan_Barrier(void)
+{
+    __sync_synchronize();
+
+    if (barrierHook != NULL && !inBarrierHook)
+    {
+        inBarrierHook = 1;
+        barrierHook();
+        inBarrierHook = 0;
+    }
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return hostTick;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return 42000000U;
+}
+
+HAL_StatusTypeDef HAL_CAN_Init(CAN_HandleTypeDef* hcan)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_Start(CAN_HandleTypeDef* hcan)
+{
+    Controller(hcan)->started = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_Stop(CAN_HandleTypeDef* hcan)
+{
+    Controller(hcan)->started = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_ConfigFilter(CAN_HandleTypeDef* hcan, const CAN_FilterTypeDef* filter)
+{
+    // Every frame is accepted, uCAN sorts out unknown identifiers itself
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef* hcan, uint32_t its)
+{
+    hcan->Instance->IER |= its;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_DeactivateNotification(CAN_HandleTypeDef* hcan, uint32_t its)
+{
+    hcan->Instance->IER &= ~its;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef* hcan, const CAN_TxHeaderTypeDef* header, const uint8_t data[], uint32_t* mailbox)
+{
+    HostCan_Controller* ctrl = Controller(hcan);
+    HostCan_Frame frame;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.header.StdId = header->StdId;
+    frame.header.ExtId = header->ExtId;
+    frame.header.IDE = header->IDE;
+    frame.header.RTR = header->RTR;
+    frame.header.DLC = header->DLC;
+    memcpy(frame.data, data, (header->DLC <= 8U) ? header->DLC : 8U);
+
+    for (uint32_t m = 0; m < 3U; m++)
+    {
+        if (!ctrl->pending[m])
+        {
+            if (mailbox != NULL)
+            {
+                *mailbox = CAN_TX_MAILBOX0 << m;
+            }
+
+            // The identifier register keeps the ID after transmission
+            hcan->Instance->sTxMailBox[m].TIR = (header->StdId << CAN_TI0R_STID_Pos) | header->IDE;
+
+            if (ctrl->manualTx)
+            {
+                ctrl->mailbox[m] = frame;
+                ctrl->pending[m] = 1;
+            }
+            else
+            {
+                Transmit(ctrl, m, &frame);
+            }
+
+            return HAL_OK;
+        }
+    }
+
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_CAN_AbortTxRequest(CAN_HandleTypeDef* hcan, uint32_t mailboxes)
+{
+    HostCan_Controller* ctrl = Controller(hcan);
+
+    for (uint32_t m = 0; m < 3U; m++)
+    {
+        if (mailboxes & (CAN_TX_MAILBOX0 << m))
+        {
+            ctrl->pending[m] = 0;
+        }
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef* hcan, uint32_t fifo, CAN_RxHeaderTypeDef* header, uint8_t data[])
+{
+    HostCan_Controller* ctrl = Controller(hcan);
+
+    if (ctrl->fifoCount == 0U)
+    {
+        return HAL_ERROR;
+    }
+
+    const HostCan_Frame* frame = &ctrl->fifo[ctrl->fifoHead];
+
+    *header = frame->header;
+    memcpy(data, frame->data, 8);
+    ctrl->fifoHead = (ctrl->fifoHead + 1U) % HOST_CAN_FIFO_DEPTH;
+    ctrl->fifoCount--;
+
+    return HAL_OK;
+}
+
+uint32_t HAL_CAN_GetRxFifoFillLevel(const CAN_HandleTypeDef* hcan, uint32_t fifo)
+{
+    return Controller(hcan)->fifoCount;
+}
+
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(const CAN_HandleTypeDef* hcan)
+{
+    const HostCan_Controller* ctrl = Controller(hcan);
+
+    return 3U - ctrl->pending[0] - ctrl->pending[1] - ctrl->pending[2];
+}
+
+uint32_t HAL_CAN_GetTxTimestamp(const CAN_HandleTypeDef* hcan, uint32_t mailbox)
+{
+    const HostCan_Controller* ctrl = Controller(hcan);
+
+    return (mailbox == CAN_TX_MAILBOX0) ? ctrl->txStamp[0] : (mailbox == CAN_TX_MAILBOX1) ? ctrl->txStamp[1] : ctrl->txStamp[2];
+}
+
+uint32_t HAL_CAN_GetError(const CAN_HandleTypeDef* hcan)
+{
+    return hcan->ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_CAN_ResetError(CAN_HandleTypeDef* hcan)
+{
+    hcan->ErrorCode = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_RegisterCallback(CAN_HandleTypeDef* hcan, HAL_CAN_CallbackIDTypeDef id, void (*callback)(CAN_HandleTypeDef* hcan))
+{
+    return HAL_OK;
+}
+
+void HAL_CAN_IRQHandler(CAN_HandleTypeDef* hcan)
+{
+}
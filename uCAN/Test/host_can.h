@@ -0,0 +1,146 @@
+/**
+  ******************************************************************************
+  * @file    host_can.h
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Simulated bxCAN controllers behind the host HAL stub.
+  *
+  * host_can.c implements the HAL functions declared in stub/stm32f4xx_hal.h
+  * for HOST_CAN_INSTANCES controllers: CAN1..CAN3 and the further ones of
+  * HostCan_Instance(), for tests with more nodes. Every started controller
+  * sits on a simulated bus (bus 0 unless moved with HostCan_SetBus()); a frame
+  * leaving a TX mailbox is copied into the RX FIFO of every other started
+  * controller on the same bus.
+  *
+  * By default a queued frame leaves its mailbox at once. With
+  * HostCan_SetManualTx() frames stay in their mailboxes until the test
+  * transmits them with HostCan_CompleteTx(), which models a busy bus and
+  * lets tests fill the mailboxes.
+  *
+  * A transmit hook set with HostCan_SetTransmitHook() replaces the bus: the
+  * frame leaving a mailbox is handed to the hook, which routes it itself,
+  * e.g. the discrete-event simulator of host_sim.c. The controllers share no
+  * state then, so each one may be driven by its own thread.
+  *
+  * Time is HAL_GetTick(), advanced only by the test. Frames are stamped with
+  * the 16-bit TTCM counter of a 500 kbit/s bus, HOST_CAN_BITS_PER_MS bit
+  * times per tick plus the offset set with HostCan_SetSofOffset(), so it
+  * wraps every 131 ms like on the target.
+  *
+  ******************************************************************************
+  */
+
+#ifndef HOST_CAN
+#define HOST_CAN
+
+#include "stm32f4xx_hal.h"
+
+#ifndef HOST_CAN_INSTANCES
+#define HOST_CAN_INSTANCES				64U		/*!< Simulated controllers, CAN1..CAN3 are the first three */
+#endif
+
+#define HOST_CAN_FIFO_DEPTH				64U		/*!< RX FIFO entries per controller (the real bxCAN has 3) */
+
+#ifndef HOST_CAN_SENT_LOG
+#define HOST_CAN_SENT_LOG				1024U	/*!< Transmitted frames kept per controller for inspection */
+#endif
+
+#define HOST_CAN_BITS_PER_MS			500U	/*!< TTCM counter steps per tick, the bit rate set by HostCan_Reset() */
+
+/**
+  * @brief  Frame in a simulated FIFO, mailbox or transmit log.
+  */
+typedef struct {
+    CAN_RxHeaderTypeDef header;				/*!< Identifier, DLC, RTR and 16-bit timestamp */
+    uint8_t data[8];						/*!< Payload */
+} HostCan_Frame;
+
+/**
+  * @brief  Resets all controllers, buses, logs and the tick to their power-on state.
+  */
+void HostCan_Reset(void);
+
+/**
+  * @brief  Register block of controller number `index` (0 is CAN1), below HOST_CAN_INSTANCES.
+  */
+CAN_TypeDef* HostCan_Instance(uint32_t index);
+
+/**
+  * @brief  Advances HAL_GetTick() by `ms` milliseconds.
+  */
+void HostCan_Advance(uint32_t ms);
+
+/**
+  * @brief  Stamps the following frames `bits` bit times after the start of the current tick (negative: before).
+  * @note   Models the start of frame falling anywhere within a millisecond, or an
+  *         interrupt that runs late after it.
+  */
+void HostCan_SetSofOffset(int32_t bits);
+
+/**
+  * @brief  Moves a controller onto another simulated bus.
+  */
+void HostCan_SetBus(CAN_HandleTypeDef* hcan, uint8_t bus);
+
+/**
+  * @brief  Non-zero keeps queued frames in their mailboxes until HostCan_CompleteTx().
+  */
+void HostCan_SetManualTx(CAN_HandleTypeDef* hcan, uint8_t manual);
+
+/**
+  * @brief  Transmits up to `count` pending mailboxes, lowest identifier first.
+  * @retval Number of frames transmitted.
+  */
+uint32_t HostCan_CompleteTx(CAN_HandleTypeDef* hcan, uint32_t count);
+
+/**
+  * @brief  Copies the frame a controller would transmit next, lowest identifier first.
+  * @retval Its mailbox number, -1 if no mailbox is pending.
+  */
+int32_t HostCan_NextTx(const CAN_HandleTypeDef* hcan, HostCan_Frame* frame);
+
+/**
+  * @brief  Transmits the frame pending in mailbox `mailbox` (0 to 2).
+  * @retval Non-zero if the mailbox was pending.
+  * @note   Lets a bus model finish the frame that won arbitration even if a
+  *         frame with a lower identifier was queued meanwhile.
+  */
+uint8_t HostCan_CompleteMailbox(CAN_HandleTypeDef* hcan, uint32_t mailbox);
+
+/**
+  * @brief  Hands every transmitted frame to `hook` instead of the simulated buses, NULL restores them.
+  * @note   Set before the controllers start; `instance` is the register block of the sender.
+  */
+void HostCan_SetTransmitHook(void (*hook)(CAN_TypeDef* instance, const HostCan_Frame* frame));
+
+/**
+  * @brief  Puts a standard data frame into the RX FIFO of a controller.
+  */
+void HostCan_Inject(CAN_HandleTypeDef* hcan, uint32_t id, uint8_t dlc, const uint8_t data[]);
+
+/**
+  * @brief  Puts a standard remote frame requesting `dlc` bytes into the RX FIFO of a controller.
+  */
+void HostCan_InjectRemote(CAN_HandleTypeDef* hcan, uint32_t id, uint8_t dlc);
+
+/**
+  * @brief  Number of frames the controller has transmitted since the reset.
+  */
+uint32_t HostCan_SentCount(const CAN_HandleTypeDef* hcan);
+
+/**
+  * @brief  Transmitted frame number `index` (the last HOST_CAN_SENT_LOG are kept).
+  */
+const HostCan_Frame* HostCan_Sent(const CAN_HandleTypeDef* hcan, uint32_t index);
+
+/**
+  * @brief  Frames lost because the RX FIFO of the controller was full.
+  */
+uint32_t HostCan_Overruns(const CAN_HandleTypeDef* hcan);
+
+/**
+  * @brief  Calls `hook` after the fence of every __DMB(), NULL removes it.
+  * @note   The hook is not re-entered by barriers of the code it calls.
+  */
+void HostCan_SetBarrierHook(void (*hook)(void));
+
+#endif
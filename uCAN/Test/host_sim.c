@@ -0,0 +1,578 @@
+/**
+  ******************************************************************************
+  * @file    host_sim.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Multi-threaded discrete-event simulation of many uCAN nodes.
+  *
+  * See host_sim.h for the network, the bus model and the synchronization of
+  * the workers.
+  *
+  ******************************************************************************
+  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "ucan.h"
+#include "host_sim.h"
+
+#define US_PER_BIT			(1000U / HOST_CAN_BITS_PER_MS)
+
+#define EVENT_FRAME_END		0U		/*!< Frame on the bus complete, delivered to the other nodes */
+#define EVENT_ARRIVAL		1U		/*!< Forwarded frame reaches the gateway of the bus */
+#define EVENT_TICK			2U		/*!< Period of a node elapsed, it sends its packet */
+
+#define EVENT_KEY(kind, n)	(((kind) << 24) | ((n) & 0xFFFFFFU))
+#define EVENT_KIND(key)		((key) >> 24)
+
+/**
+  * @brief  Pending event of a bus.
+  * @note   Events at the same time run in key order: frame end, arrivals in
+  *         the order they were forwarded, node ticks by node number.
+  */
+typedef struct {
+    uint64_t time;							/*!< Simulated time in microseconds */
+    uint32_t key;							/*!< Kind in the top byte, node (tick, frame end) or forward number below */
+    uint32_t value;							/*!< EVENT_ARRIVAL: forwarded value, EVENT_FRAME_END: mailbox of the frame */
+} Event;
+
+/**
+  * @brief  Frame forwarded by the gateway of the previous bus.
+  */
+typedef struct {
+    uint64_t time;							/*!< Arrival time at the gateway of this bus */
+    uint32_t seq;							/*!< Forward number on the previous bus */
+    uint32_t value;							/*!< Value of the forwarded signal */
+} Forward;
+
+/**
+  * @brief  Single-producer / single-consumer ring of forwarded frames into one bus.
+  * @note   head is written by the worker of the previous bus only, tail by the
+  *         worker of this bus only; each on its own cache line.
+  */
+typedef struct {
+    Forward entries[HOST_SIM_QUEUE_SIZE];	/*!< Ring storage */
+    uint32_t head __attribute__((aligned(64)));	/*!< Free-running write index */
+    uint32_t tail __attribute__((aligned(64)));	/*!< Free-running read index */
+} Queue;
+
+/**
+  * @brief  One simulated node: controller, handle and bound variables.
+  */
+typedef struct {
+    CAN_HandleTypeDef hcan;
+    UCAN_HandleTypeDef ucan;
+    UCAN_Client clients[1];
+    UCAN_Packet tx[2];						/*!< Own packet, gateway packet on node 0 */
+    UCAN_Packet rx[3];						/*!< Previous and next neighbour, gateway packet on other nodes */
+    uint32_t txSeq;
+    uint32_t txValue;
+    uint32_t gwSeq;
+    uint32_t gwValue;
+    uint32_t rxSeq[3];
+    uint32_t rxValue[3];
+    uint32_t rng;							/*!< xorshift32 state */
+} Node;
+
+/**
+  * @brief  One simulated bus and its event list, owned by one worker.
+  */
+typedef struct {
+    Node* nodes;							/*!< nodesPerBus nodes */
+    uint32_t index;							/*!< Bus number */
+    Event* heap;							/*!< Binary min-heap of pending events, one frame end at most */
+    uint32_t heapCount;
+    uint32_t heapSize;
+    uint8_t busy;							/*!< Non-zero while a frame is on the bus */
+    uint32_t forwardSeq;					/*!< Frames forwarded to the next bus */
+    uint64_t digest;						/*!< Hash of the frames on this bus */
+    uint64_t frames;
+    uint64_t received;
+    uint64_t refused;
+    uint64_t overruns;
+    Queue inbound;							/*!< Frames forwarded into this bus */
+} Bus;
+
+static const HostSim_Config* simConfig;
+static Bus* simBuses;
+static pthread_barrier_t simBarrier;
+static uint64_t simWindows;
+static __thread uint64_t simNowUs;
+
+/**
+  * @brief  Timebase counter of every handle: the simulated time of the calling worker.
+  */
+static uint32_t SimCounter(void)
+{
+    return (uint32_t)simNowUs;
+}
+
+static uint64_t WallNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t Random(uint32_t* state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+static uint64_t Mix(uint64_t hash, uint64_t value)
+{
+    // FNV-1a over the 8 bytes of value
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        hash = (hash ^ ((value >> (8U * i)) & 0xFFU)) * 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+static uint8_t Earlier(const Event* a, const Event* b)
+{
+    return a->time < b->time || (a->time == b->time && a->key < b->key);
+}
+
+static void Push(Bus* bus, uint64_t time, uint32_t key, uint32_t value)
+{
+    if (bus->heapCount == bus->heapSize)
+    {
+        bus->overruns++;
+        return;
+    }
+
+    uint32_t i = bus->heapCount++;
+    Event event = { time, key, value };
+
+    while (i > 0U && Earlier(&event, &bus->heap[(i - 1U) / 2U]))
+    {
+        bus->heap[i] = bus->heap[(i - 1U) / 2U];
+        i = (i - 1U) / 2U;
+    }
+
+    bus->heap[i] = event;
+}
+
+static Event Pop(Bus* bus)
+{
+    Event top = bus->heap[0];
+    Event last = bus->heap[--bus->heapCount];
+    uint32_t i = 0;
+
+    for (;;)
+    {
+        uint32_t child = 2U * i + 1U;
+
+        if (child >= bus->heapCount)
+        {
+            break;
+        }
+
+        if (child + 1U < bus->heapCount && Earlier(&bus->heap[child + 1U], &bus->heap[child]))
+        {
+            child++;
+        }
+
+        if (!Earlier(&bus->heap[child], &last))
+        {
+            break;
+        }
+
+        bus->heap[i] = bus->heap[child];
+        i = child;
+    }
+
+    if (bus->heapCount > 0U)
+    {
+        bus->heap[i] = last;
+    }
+
+    return top;
+}
+
+/**
+  * @brief  Producer side: queues a forwarded frame into the next bus.
+  * @retval 0 if the ring was full.
+  */
+static uint8_t Forward_Put(Queue* queue, const Forward* forward)
+{
+    uint32_t head = queue->head;
+    uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail == HOST_SIM_QUEUE_SIZE)
+    {
+        return 0;
+    }
+
+    queue->entries[head % HOST_SIM_QUEUE_SIZE] = *forward;
+    __atomic_store_n(&queue->head, head + 1U, __ATOMIC_RELEASE);
+
+    return 1;
+}
+
+/**
+  * @brief  Consumer side: moves every forwarded frame into the event list of the bus.
+  */
+static void Forward_Drain(Bus* bus)
+{
+    Queue* queue = &bus->inbound;
+    uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = queue->tail;
+
+    for (; tail != head; tail++)
+    {
+        const Forward* forward = &queue->entries[tail % HOST_SIM_QUEUE_SIZE];
+
+        Push(bus, forward->time, EVENT_KEY(EVENT_ARRIVAL, forward->seq), forward->value);
+    }
+
+    __atomic_store_n(&queue->tail, tail, __ATOMIC_RELEASE);
+}
+
+/**
+  * @brief  Starts the next frame if the bus is idle: the pending mailbox with the lowest identifier wins.
+  */
+static void Arbitrate(Bus* bus)
+{
+    HostCan_Frame frame;
+    uint32_t bestId = UINT32_MAX;
+    uint32_t bestNode = 0;
+    int32_t bestMailbox = -1;
+    uint8_t bestDlc = 0;
+
+    if (bus->busy)
+    {
+        return;
+    }
+
+    for (uint32_t n = 0; n < simConfig->nodesPerBus; n++)
+    {
+        int32_t mailbox = HostCan_NextTx(&bus->nodes[n].hcan, &frame);
+
+        if (mailbox >= 0 && frame.header.StdId < bestId)
+        {
+            bestId = frame.header.StdId;
+            bestNode = n;
+            bestMailbox = mailbox;
+            bestDlc = (uint8_t)frame.header.DLC;
+        }
+    }
+
+    if (bestMailbox >= 0)
+    {
+        bus->busy = 1;
+        Push(bus, simNowUs + UCAN_FRAME_BITS(bestDlc) * US_PER_BIT, EVENT_KEY(EVENT_FRAME_END, bestNode), (uint32_t)bestMailbox);
+    }
+}
+
+/**
+  * @brief  Non-zero if node `n` of a bus has an RX packet for `id`.
+  */
+static uint8_t Binds(uint32_t n, uint32_t id)
+{
+    uint32_t count = simConfig->nodesPerBus;
+
+    return id == HOST_SIM_NODE_ID((n + count - 1U) % count) || id == HOST_SIM_NODE_ID((n + 1U) % count) ||
+           (id == HOST_SIM_GATEWAY_ID && n != 0U);
+}
+
+/**
+  * @brief  Transmit hook of host_can: hands a finished frame to the other nodes of its bus.
+  */
+static void Deliver(CAN_TypeDef* instance, const HostCan_Frame* frame)
+{
+    uint32_t index = (uint32_t)(instance - HostCan_Instance(0));
+    uint32_t count = simConfig->nodesPerBus;
+    Bus* bus = &simBuses[index / count];
+    uint32_t sender = index % count;
+    uint32_t id = frame->header.StdId;
+    uint64_t data;
+
+    memcpy(&data, frame->data, sizeof(data));
+    bus->frames++;
+    bus->digest = Mix(Mix(Mix(bus->digest, simNowUs), id), data);
+
+    for (uint32_t n = 0; n < count; n++)
+    {
+        Node* node = &bus->nodes[n];
+
+        if (n == sender)
+        {
+            continue;
+        }
+
+        HostCan_Inject(&node->hcan, id, (uint8_t)frame->header.DLC, frame->data);
+
+        // RX interrupt at the end of the frame
+        while (HAL_CAN_GetRxFifoFillLevel(&node->hcan, CAN_RX_FIFO0) > 0U)
+        {
+            UCAN_StatusTypeDef status = uCAN_Update(&node->ucan);
+
+            if (Binds(n, id))
+            {
+                bus->received += (status == UCAN_OK);
+                bus->refused += (status != UCAN_OK);
+            }
+        }
+
+        // Gateway: packet of node 1 continues on the next bus, as received by uCAN
+        if (n == 0U && id == HOST_SIM_NODE_ID(1U))
+        {
+            Forward forward = { simNowUs + HOST_SIM_GATEWAY_DELAY_US, bus->forwardSeq, node->rxValue[1] };
+            Bus* next = &simBuses[(bus->index + 1U) % simConfig->buses];
+
+            bus->forwardSeq++;
+            bus->overruns += !Forward_Put(&next->inbound, &forward);
+        }
+    }
+}
+
+static void RunEvent(Bus* bus, const Event* event)
+{
+    uint32_t n = event->key & 0xFFFFFFU;
+
+    simNowUs = event->time;
+
+    switch (EVENT_KIND(event->key))
+    {
+        case EVENT_FRAME_END:
+            // Mailbox that won arbitration, whatever was queued since
+            bus->busy = 0;
+            (void)HostCan_CompleteMailbox(&bus->nodes[n].hcan, event->value);
+            break;
+
+        case EVENT_ARRIVAL:
+        {
+            Node* gateway = &bus->nodes[0];
+
+            gateway->gwSeq++;
+            gateway->gwValue = event->value;
+            bus->refused += (uCAN_Send(&gateway->ucan, HOST_SIM_GATEWAY_ID) != UCAN_OK);
+            break;
+        }
+
+        default:
+        {
+            Node* node = &bus->nodes[n];
+            uint32_t jitter = (simConfig->jitterUs != 0U) ? Random(&node->rng) % (simConfig->jitterUs + 1U) : 0U;
+
+            node->txSeq++;
+            node->txValue = Random(&node->rng);
+            bus->refused += (uCAN_Send(&node->ucan, HOST_SIM_NODE_ID(n)) != UCAN_OK);
+            Push(bus, event->time + simConfig->periodUs + jitter, event->key, 0);
+            break;
+        }
+    }
+
+    Arbitrate(bus);
+}
+
+/**
+  * @brief  Worker thread: runs its block of buses window by window.
+  */
+static void* Worker(void* arg)
+{
+    uint32_t worker = (uint32_t)(uintptr_t)arg;
+    uint32_t first = worker * simConfig->buses / simConfig->workers;
+    uint32_t last = (worker + 1U) * simConfig->buses / simConfig->workers;
+
+    for (uint64_t start = 0; start < simConfig->durationUs; start += HOST_SIM_GATEWAY_DELAY_US)
+    {
+        uint64_t end = start + HOST_SIM_GATEWAY_DELAY_US;
+
+        if (end > simConfig->durationUs)
+        {
+            end = simConfig->durationUs;
+        }
+
+        // Everything forwarded before this window arrives at `end` or later
+        for (uint32_t b = first; b < last; b++)
+        {
+            Bus* bus = &simBuses[b];
+
+            Forward_Drain(bus);
+
+            while (bus->heapCount > 0U && bus->heap[0].time < end)
+            {
+                Event event = Pop(bus);
+                RunEvent(bus, &event);
+            }
+        }
+
+        if (worker == 0U)
+        {
+            simWindows++;
+        }
+
+        (void)pthread_barrier_wait(&simBarrier);
+    }
+
+    return NULL;
+}
+
+/**
+  * @brief  Starts node `n` of bus `b` on its own controller.
+  * @retval Status of uCAN_Start().
+  */
+static UCAN_StatusTypeDef StartNode(Bus* bus, uint32_t n)
+{
+    uint32_t count = simConfig->nodesPerBus;
+    Node* node = &bus->nodes[n];
+    uint32_t global = bus->index * count + n;
+
+    node->hcan.Instance = HostCan_Instance(global);
+    node->clients[0].id = 0x7F0;
+    node->rng = (simConfig->seed ^ (0x9E3779B9U * (global + 1U))) | 1U;
+
+    node->ucan.hcan = &node->hcan;
+    node->ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_NONE, .selfId = 0x7E0, .clients = node->clients, .clientCount = 1 };
+    node->ucan.timebase = (UCAN_Timebase){ .read = SimCounter, .frequency = 1000000U };
+    node->ucan.txHolder = (UCAN_PacketHolder){ .packets = node->tx, .count = (n == 0U) ? 2U : 1U };
+    node->ucan.rxHolder = (UCAN_PacketHolder){ .packets = node->rx, .count = (n == 0U) ? 2U : 3U };
+
+    UCAN_PacketConfig txConfig[2] = {
+        { .id = HOST_SIM_NODE_ID(n), .item_count = 2, .items = { { &node->txSeq, UCAN_U32 }, { &node->txValue, UCAN_U32 } } },
+        { .id = HOST_SIM_GATEWAY_ID, .item_count = 2, .items = { { &node->gwSeq, UCAN_U32 }, { &node->gwValue, UCAN_U32 } } },
+    };
+    UCAN_PacketConfig rxConfig[3] = {
+        { .id = HOST_SIM_NODE_ID((n + count - 1U) % count), .item_count = 2,
+          .items = { { &node->rxSeq[0], UCAN_U32 }, { &node->rxValue[0], UCAN_U32 } } },
+        { .id = HOST_SIM_NODE_ID((n + 1U) % count), .item_count = 2,
+          .items = { { &node->rxSeq[1], UCAN_U32 }, { &node->rxValue[1], UCAN_U32 } } },
+        { .id = HOST_SIM_GATEWAY_ID, .item_count = 2, .items = { { &node->rxSeq[2], UCAN_U32 }, { &node->rxValue[2], UCAN_U32 } } },
+    };
+    UCAN_Config config = { txConfig, rxConfig };
+
+    // Frames stay in the mailboxes until they win the bus
+    HostCan_SetManualTx(&node->hcan, 1);
+
+    UCAN_StatusTypeDef status = uCAN_Init(&node->ucan);
+
+    return (status != UCAN_OK) ? status : uCAN_Start(&node->ucan, &config);
+}
+
+int32_t HostSim_Run(const HostSim_Config* config, HostSim_Result* result)
+{
+    if (config == NULL || result == NULL || config->buses == 0U || config->nodesPerBus < 3U ||
+        config->nodesPerBus > HOST_SIM_MAX_NODES_PER_BUS || (uint64_t)config->buses * config->nodesPerBus > HOST_CAN_INSTANCES ||
+        config->workers == 0U || config->workers > config->buses || config->periodUs == 0U || config->durationUs == 0U)
+    {
+        return -1;
+    }
+
+    int32_t status = 0;
+    uint32_t count = config->nodesPerBus;
+    // Ticks, one frame end, forwards of a few windows
+    uint32_t heapSize = count + 1U + 4U * HOST_SIM_QUEUE_SIZE;
+
+    simConfig = config;
+    simWindows = 0;
+    simNowUs = 0;
+    // Queue indices on their own cache lines
+    simBuses = aligned_alloc(64, config->buses * sizeof(Bus));
+    Node* nodes = calloc((size_t)config->buses * count, sizeof(Node));
+    Event* heaps = calloc((size_t)config->buses * heapSize, sizeof(Event));
+    pthread_t* threads = calloc(config->workers, sizeof(pthread_t));
+
+    if (simBuses == NULL || nodes == NULL || heaps == NULL || threads == NULL)
+    {
+        status = -1;
+    }
+
+    if (simBuses != NULL)
+    {
+        memset(simBuses, 0, config->buses * sizeof(Bus));
+    }
+
+    HostCan_Reset();
+    HostCan_SetTransmitHook(Deliver);
+
+    for (uint32_t b = 0; status == 0 && b < config->buses; b++)
+    {
+        Bus* bus = &simBuses[b];
+
+        bus->index = b;
+        bus->nodes = &nodes[(size_t)b * count];
+        bus->heap = &heaps[(size_t)b * heapSize];
+        bus->heapSize = heapSize;
+        bus->digest = 0xCBF29CE484222325ULL;
+
+        for (uint32_t n = 0; status == 0 && n < count; n++)
+        {
+            status = (StartNode(bus, n) == UCAN_OK) ? 0 : -1;
+
+            // First period starts at a random phase
+            Push(bus, Random(&bus->nodes[n].rng) % config->periodUs, EVENT_KEY(EVENT_TICK, n), 0);
+        }
+    }
+
+    memset(result, 0, sizeof(*result));
+
+    if (status == 0)
+    {
+        uint64_t startNs = WallNs();
+
+        (void)pthread_barrier_init(&simBarrier, NULL, config->workers);
+
+        for (uint32_t w = 1; w < config->workers; w++)
+        {
+            (void)pthread_create(&threads[w], NULL, Worker, (void*)(uintptr_t)w);
+        }
+
+        (void)Worker((void*)(uintptr_t)0U);
+
+        for (uint32_t w = 1; w < config->workers; w++)
+        {
+            (void)pthread_join(threads[w], NULL);
+        }
+
+        (void)pthread_barrier_destroy(&simBarrier);
+        result->wallNs = WallNs() - startNs;
+        result->windows = simWindows;
+        result->digest = 0xCBF29CE484222325ULL;
+
+        for (uint32_t b = 0; b < config->buses; b++)
+        {
+            Bus* bus = &simBuses[b];
+
+            result->frames += bus->frames;
+            result->received += bus->received;
+            result->forwarded += bus->forwardSeq;
+            result->refused += bus->refused;
+            result->overruns += bus->overruns;
+            result->digest = Mix(result->digest, bus->digest);
+
+            // Last values the handles decoded
+            for (uint32_t n = 0; n < count; n++)
+            {
+                const Node* node = &bus->nodes[n];
+
+                result->overruns += HostCan_Overruns(&node->hcan);
+
+                for (uint32_t i = 0; i < 3U; i++)
+                {
+                    result->digest = Mix(Mix(result->digest, node->rxSeq[i]), node->rxValue[i]);
+                }
+            }
+        }
+    }
+
+    HostCan_SetTransmitHook(NULL);
+    free(threads);
+    free(heaps);
+    free(nodes);
+    free(simBuses);
+    simBuses = NULL;
+
+    return status;
+}
@@ -0,0 +1,89 @@
+/**
+  ******************************************************************************
+  * @file    host_sim.h
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Multi-threaded discrete-event simulation of many uCAN nodes.
+  *
+  * Runs `buses` simulated CAN buses of `nodesPerBus` uCAN handles each on
+  * the controllers of host_can.c, e.g. 32 buses of 32 nodes for a network of
+  * 1024 handles. Every node sends one 8-byte packet per period and receives
+  * those of its two neighbours on the bus. Node 0 of every bus is a gateway:
+  * it forwards the packet of node 1 to the next bus, where node 0 of that bus
+  * sends it again, so the buses form a ring.
+  *
+  * Each bus is a discrete-event model: frames wait in the TX mailboxes of
+  * their controller, win arbitration by identifier when the bus is idle, and
+  * reach the RX FIFOs of the other nodes UCAN_FRAME_BITS() bit times later at
+  * 500 kbit/s, where uCAN_Update() takes them at once. Node time comes from
+  * the timebase of the handle, a microsecond counter of the simulated time.
+  *
+  * The buses are split into contiguous blocks, one per worker thread. The
+  * only traffic between buses is the gateway path, which takes
+  * HOST_SIM_GATEWAY_DELAY_US, so the workers advance in conservative windows
+  * of that length: within a window no bus can receive anything a bus of
+  * another worker sends in the same window, and a barrier separates the
+  * windows. Forwarded frames travel through one single-producer /
+  * single-consumer lock-free queue per bus, filled by the worker of the
+  * previous bus and emptied by the worker of the bus at the start of every
+  * window.
+  *
+  * Events of a bus are ordered by time and then by a key that does not
+  * depend on thread timing, and the random phases and jitter come from one
+  * generator per node seeded from `seed`, so a run gives the same frames at
+  * the same times, and the same HostSim_Result.digest, for any number of
+  * workers.
+  *
+  * Build with HOST_CAN_INSTANCES of at least buses * nodesPerBus, and a small
+  * HOST_CAN_SENT_LOG to keep the controllers compact.
+  *
+  ******************************************************************************
+  */
+
+#ifndef HOST_SIM
+#define HOST_SIM
+
+#include <stdint.h>
+#include "host_can.h"
+
+#define HOST_SIM_MAX_NODES_PER_BUS		64U		/*!< Node packets use IDs 0x100 to 0x13F */
+#define HOST_SIM_NODE_ID(node)			(0x100U + (node))	/*!< Packet sent by node `node` of a bus */
+#define HOST_SIM_GATEWAY_ID				0x0F0U	/*!< Packet a gateway sends for a forwarded frame */
+#define HOST_SIM_GATEWAY_DELAY_US		1000U	/*!< Forwarding delay of a gateway, the length of a window */
+#define HOST_SIM_QUEUE_SIZE				64U		/*!< Entries of the queue into each bus, a power of two */
+
+/**
+  * @brief  Network and run parameters.
+  */
+typedef struct {
+    uint32_t buses;							/*!< Simulated buses, joined into a ring by their gateways */
+    uint32_t nodesPerBus;					/*!< uCAN handles per bus, 3 to HOST_SIM_MAX_NODES_PER_BUS */
+    uint32_t workers;						/*!< Worker threads, 1 to buses */
+    uint32_t periodUs;						/*!< Transmit period of every node */
+    uint32_t jitterUs;						/*!< Largest random delay added to each period */
+    uint32_t durationUs;					/*!< Simulated time */
+    uint32_t seed;							/*!< Seed of the per-node random generators */
+} HostSim_Config;
+
+/**
+  * @brief  Totals of a run.
+  */
+typedef struct {
+    uint64_t frames;						/*!< Frames transmitted on all buses */
+    uint64_t received;						/*!< Frames uCAN_Update() delivered to an RX packet */
+    uint64_t forwarded;						/*!< Frames carried to the next bus by the gateways */
+    uint64_t refused;						/*!< uCAN_Send() or uCAN_Update() calls that did not return UCAN_OK */
+    uint64_t overruns;						/*!< Frames lost to a full RX FIFO or gateway queue */
+    uint64_t windows;						/*!< Synchronization windows run */
+    uint64_t digest;						/*!< Hash of every frame, its time and the received values, the same for any worker count */
+    uint64_t wallNs;						/*!< Wall-clock time of the run */
+} HostSim_Result;
+
+/**
+  * @brief  Builds the network on reset controllers and runs it.
+  * @param  config Network and run parameters.
+  * @param  result Totals of the run.
+  * @retval 0 on success, -1 if the parameters are invalid or a handle failed to start.
+  */
+int32_t HostSim_Run(const HostSim_Config* config, HostSim_Result* result);
+
+#endif
@@ -0,0 +1,189 @@
+/**
+  ******************************************************************************
+  * @file    stm32f4xx_hal.h
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host stand-in for the parts of the STM32F4 HAL used by uCAN.
+  *
+  * Only the types, constants and functions the library touches are declared,
+  * with the layouts and bit positions of the real HAL where uCAN reads them
+  * (BTR, ESR, TX mailbox identifier register). The functions are implemented
+  * by the simulated controller in host_can.c.
+  *
+  * Interrupt masking is a no-op and __DMB() is a full compiler and CPU fence,
+  * so code that is correct on the target stays correct between host threads.
+  * __DMB() also runs the hook set with HostCan_SetBarrierHook(), which lets a
+  * test play an interrupt at exactly that point of the code under test.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32F4XX_HAL_STUB
+#define STM32F4XX_HAL_STUB
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef USE_HAL_CAN_REGISTER_CALLBACKS
+#define USE_HAL_CAN_REGISTER_CALLBACKS	0U
+#endif
+
+#define __weak							__attribute__((weak))
+#define assert_param(expr)				((void)0U)
+
+#define __DMB()							HostCan_Barrier()
+#define __disable_irq()					((void)0)
+#define __enable_irq()					((void)0)
+#define __get_PRIMASK()					0U
+#define __set_PRIMASK(x)				((void)(x))
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef enum { DISABLE = 0, ENABLE = 1 } FunctionalState;
+
+/* Registers -----------------------------------------------------------------*/
+
+typedef struct {
+    volatile uint32_t TIR, TDTR, TDLR, TDHR;
+} CAN_TxMailBox_TypeDef;
+
+typedef struct {
+    volatile uint32_t MCR, MSR, TSR, RF0R, RF1R, IER, ESR, BTR;
+    uint32_t reserved[88];
+    CAN_TxMailBox_TypeDef sTxMailBox[3];
+} CAN_TypeDef;
+
+extern CAN_TypeDef* const CAN1;
+extern CAN_TypeDef* const CAN2;
+extern CAN_TypeDef* const CAN3;
+
+#define CAN1							CAN1
+#define CAN2							CAN2
+#define CAN3							CAN3
+
+#define CAN_BTR_BRP_Pos					0U
+#define CAN_BTR_BRP						(0x3FFU << CAN_BTR_BRP_Pos)
+#define CAN_BTR_TS1_Pos					16U
+#define CAN_BTR_TS1						(0xFU << CAN_BTR_TS1_Pos)
+#define CAN_BTR_TS2_Pos					20U
+#define CAN_BTR_TS2						(0x7U << CAN_BTR_TS2_Pos)
+#define CAN_BS1_11TQ					(10U << CAN_BTR_TS1_Pos)
+#define CAN_BS2_2TQ						(1U << CAN_BTR_TS2_Pos)
+
+#define CAN_ESR_EWGF					(1U << 0)
+#define CAN_ESR_EPVF					(1U << 1)
+#define CAN_ESR_BOFF					(1U << 2)
+#define CAN_ESR_TEC_Pos					16U
+#define CAN_ESR_TEC						(0xFFU << CAN_ESR_TEC_Pos)
+#define CAN_ESR_REC_Pos					24U
+#define CAN_ESR_REC						(0xFFU << CAN_ESR_REC_Pos)
+
+#define CAN_TI0R_IDE					(1U << 2)
+#define CAN_TI0R_EXID_Pos				3U
+#define CAN_TI0R_EXID					(0x3FFFFU << CAN_TI0R_EXID_Pos)
+#define CAN_TI0R_STID_Pos				21U
+#define CAN_TI0R_STID					(0x7FFU << CAN_TI0R_STID_Pos)
+
+/* HAL types -----------------------------------------------------------------*/
+
+typedef struct {
+    uint32_t Prescaler, Mode, SyncJumpWidth, TimeSeg1, TimeSeg2;
+    FunctionalState TimeTriggeredMode, AutoBusOff, AutoWakeUp, AutoRetransmission, ReceiveFifoLocked, TransmitFifoPriority;
+} CAN_InitTypeDef;
+
+typedef struct __CAN_HandleTypeDef {
+    CAN_TypeDef* Instance;
+    CAN_InitTypeDef Init;
+    volatile uint32_t State;
+    volatile uint32_t ErrorCode;
+} CAN_HandleTypeDef;
+
+typedef struct {
+    uint32_t FilterIdHigh, FilterIdLow, FilterMaskIdHigh, FilterMaskIdLow;
+    uint32_t FilterFIFOAssignment, FilterBank, FilterMode, FilterScale, FilterActivation, SlaveStartFilterBank;
+} CAN_FilterTypeDef;
+
+typedef struct {
+    uint32_t StdId, ExtId, IDE, RTR, DLC;
+    FunctionalState TransmitGlobalTime;
+} CAN_TxHeaderTypeDef;
+
+typedef struct {
+    uint32_t StdId, ExtId, IDE, RTR, DLC, Timestamp, FilterMatchIndex;
+} CAN_RxHeaderTypeDef;
+
+typedef enum {
+    HAL_CAN_TX_MAILBOX0_COMPLETE_CB_ID,
+    HAL_CAN_TX_MAILBOX1_COMPLETE_CB_ID,
+    HAL_CAN_TX_MAILBOX2_COMPLETE_CB_ID,
+    HAL_CAN_RX_FIFO0_MSG_PENDING_CB_ID,
+    HAL_CAN_ERROR_CB_ID
+} HAL_CAN_CallbackIDTypeDef;
+
+#define CAN_MODE_NORMAL					0U
+#define CAN_MODE_SILENT					(1U << 31)
+
+#define CAN_RX_FIFO0					0U
+#define CAN_RX_FIFO1					1U
+#define CAN_ID_STD						0U
+#define CAN_ID_EXT						4U
+#define CAN_RTR_DATA					0U
+#define CAN_RTR_REMOTE					2U
+#define CAN_TX_MAILBOX0					1U
+#define CAN_TX_MAILBOX1					2U
+#define CAN_TX_MAILBOX2					4U
+
+#define CAN_IT_TX_MAILBOX_EMPTY			(1U << 0)
+#define CAN_IT_RX_FIFO0_MSG_PENDING		(1U << 1)
+#define CAN_IT_RX_FIFO0_FULL			(1U << 2)
+#define CAN_IT_RX_FIFO0_OVERRUN			(1U << 3)
+#define CAN_IT_ERROR_WARNING			(1U << 8)
+#define CAN_IT_ERROR_PASSIVE			(1U << 9)
+#define CAN_IT_BUSOFF					(1U << 10)
+#define CAN_IT_LAST_ERROR_CODE			(1U << 11)
+#define CAN_IT_ERROR					(1U << 15)
+
+#define CAN_FLAG_FOV0					0x1U
+#define CAN_ERROR_BOF					0x4U
+#define CAN_ERROR_RX_FOV0				0x200U
+
+#define CAN_FILTER_DISABLE				0U
+#define CAN_FILTER_ENABLE				1U
+#define CAN_FILTER_FIFO0				0U
+#define CAN_FILTERSCALE_16BIT			0U
+#define CAN_FILTERSCALE_32BIT			1U
+#define CAN_FILTERMODE_IDMASK			0U
+#define CAN_FILTERMODE_IDLIST			1U
+
+#define __HAL_CAN_GET_FLAG(h, f)		(((h)->Instance->RF0R & (f)) != 0U)
+#define __HAL_CAN_CLEAR_FLAG(h, f)		((h)->Instance->RF0R &= ~(f))
+
+/* HAL functions (host_can.c) ------------------------------------------------*/
+
+void HostCan_Barrier(void);
+uint32_t HAL_GetTick(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+
+HAL_StatusTypeDef HAL_CAN_Init(CAN_HandleTypeDef* hcan);
+HAL_StatusTypeDef HAL_CAN_Start(CAN_HandleTypeDef* hcan);
+HAL_StatusTypeDef HAL_CAN_Stop(CAN_HandleTypeDef* hcan);
+HAL_StatusTypeDef HAL_CAN_ConfigFilter(CAN_HandleTypeDef* hcan, const CAN_FilterTypeDef* filter);
+HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef* hcan, uint32_t its);
+HAL_StatusTypeDef HAL_CAN_DeactivateNotification(CAN_HandleTypeDef* hcan, uint32_t its);
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef* hcan, const CAN_TxHeaderTypeDef* header, const uint8_t data[], uint32_t* mailbox);
+HAL_StatusTypeDef HAL_CAN_AbortTxRequest(CAN_HandleTypeDef* hcan, uint32_t mailboxes);
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef* hcan, uint32_t fifo, CAN_RxHeaderTypeDef* header, uint8_t data[]);
+uint32_t HAL_CAN_GetRxFifoFillLevel(const CAN_HandleTypeDef* hcan, uint32_t fifo);
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(const CAN_HandleTypeDef* hcan);
+uint32_t HAL_CAN_GetTxTimestamp(const CAN_HandleTypeDef* hcan, uint32_t mailbox);
+uint32_t HAL_CAN_GetError(const CAN_HandleTypeDef* hcan);
+HAL_StatusTypeDef HAL_CAN_ResetError(CAN_HandleTypeDef* hcan);
+HAL_StatusTypeDef HAL_CAN_RegisterCallback(CAN_HandleTypeDef* hcan, HAL_CAN_CallbackIDTypeDef id, void (*callback)(CAN_HandleTypeDef* hcan));
+void HAL_CAN_IRQHandler(CAN_HandleTypeDef* hcan);
+
+/* Callbacks of HAL_CAN_IRQHandler(), defined by uCAN with UCAN_CFG_HAL_CALLBACKS */
+void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef* hcan);
+void HAL_CAN_ErrorCallback(CAN_HandleTypeDef* hcan);
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef* hcan);
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef* hcan);
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef* hcan);
+
+#endif
@@ -0,0 +1,219 @@
+/**
+  ******************************************************************************
+  * @file    test_bringup.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the time from power-on until every client is ACTIVE.
+  *
+  * A master and CLIENTS clients share one simulated bus and run one step per
+  * millisecond. Checks that:
+  *  - when the whole network powers up together, every client is ACTIVE on
+  *    the master within UCAN_ANNOUNCE_BACKOFF_MAX_MS;
+  *  - clients powering up after the master has sent its first ping are
+  *    ACTIVE through their boot announcements alone, well before the next
+  *    ping is due (UCAN_HANDSHAKE_INTERVAL_MS);
+  *  - the randomized backoff spreads the announcements over several
+  *    milliseconds instead of sending them all at once, and never past
+  *    UCAN_ANNOUNCE_BACKOFF_MAX_MS.
+  *
+  * The measured bring-up times are printed.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define CLIENTS			16U
+#define MASTER_ID		0x010U
+#define CLIENT_ID(i)	(0x020U + (i))
+
+/**
+  * @brief  Node with one TX packet, its client list and HAL handle.
+  */
+typedef struct {
+    CAN_HandleTypeDef hcan;
+    UCAN_HandleTypeDef ucan;
+    UCAN_Client clients[CLIENTS];
+    UCAN_Packet tx[1];
+    UCAN_Packet rx[1];
+    uint8_t txValue;
+    uint8_t rxValue;
+} Node;
+
+static Node nodes[1U + CLIENTS];
+
+/**
+  * @brief  Starts node `n` on controller `n`: the master for 0, client n - 1 otherwise.
+  */
+static void Start(uint32_t n)
+{
+    Node* node = &nodes[n];
+    uint32_t selfId = (n == 0U) ? MASTER_ID : CLIENT_ID(n - 1U);
+
+    memset(node, 0, sizeof(*node));
+    node->hcan.Instance = HostCan_Instance(n);
+
+    for (uint32_t i = 0; i < CLIENTS; i++)
+    {
+        node->clients[i].id = CLIENT_ID(i);
+    }
+
+    node->ucan.hcan = &node->hcan;
+    node->ucan.node = (UCAN_NodeInfo){ .role = (n == 0U) ? UCAN_ROLE_MASTER : UCAN_ROLE_CLIENT, .selfId = selfId,
+                                       .masterId = MASTER_ID, .clients = node->clients, .clientCount = CLIENTS };
+    node->ucan.txHolder = (UCAN_PacketHolder){ .packets = node->tx, .count = 1 };
+    node->ucan.rxHolder = (UCAN_PacketHolder){ .packets = node->rx, .count = 1 };
+
+    UCAN_PacketConfig txConfig[1] = {
+        { .id = selfId + 0x100U, .item_count = 1, .items = { { &node->txValue, UCAN_U8 } } },
+    };
+    UCAN_PacketConfig rxConfig[1] = {
+        { .id = 0x7F0, .item_count = 1, .items = { { &node->rxValue, UCAN_U8 } } },
+    };
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&node->ucan) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&node->ucan, &config) == UCAN_OK);
+}
+
+static uint32_t ActiveClients(void)
+{
+    uint32_t active = 0;
+
+    for (uint32_t i = 0; i < CLIENTS; i++)
+    {
+        active += (uCAN_IsClientActive(&nodes[0].ucan, CLIENT_ID(i)) == UCAN_OK);
+    }
+
+    return active;
+}
+
+static uint32_t PingsSent(void)
+{
+    uint32_t pings = 0;
+
+    for (uint32_t i = 0; i < HostCan_SentCount(&nodes[0].hcan); i++)
+    {
+        pings += (HostCan_Sent(&nodes[0].hcan, i)->data[0] == UCAN_HANDSHAKE_REQUEST_VALUE);
+    }
+
+    return pings;
+}
+
+/**
+  * @brief  Runs the started nodes for one millisecond.
+  * @retval Non-zero if a client sent its announcement in this millisecond.
+  */
+static uint8_t Step(uint32_t started)
+{
+    uint8_t announced = 0;
+
+    HostCan_Advance(1);
+
+    for (uint32_t n = 0; n < started; n++)
+    {
+        uint32_t seen = HostCan_SentCount(&nodes[n].hcan);
+
+        (void)uCAN_SendAll(&nodes[n].ucan);
+        (void)uCAN_Handshake(&nodes[n].ucan);
+
+        for (; n != 0U && seen < HostCan_SentCount(&nodes[n].hcan); seen++)
+        {
+            announced |= (HostCan_Sent(&nodes[n].hcan, seen)->data[0] == UCAN_HANDSHAKE_ANNOUNCE_VALUE);
+        }
+    }
+
+    for (uint32_t n = 0; n < started; n++)
+    {
+        while (HAL_CAN_GetRxFifoFillLevel(&nodes[n].hcan, CAN_RX_FIFO0) > 0U)
+        {
+            (void)uCAN_Update(&nodes[n].ucan);
+        }
+    }
+
+    return announced;
+}
+
+static void TestPowerOnTogether(void)
+{
+    uint32_t allActiveMs = 0;
+
+    HostCan_Reset();
+
+    // Whole network powers up in the same millisecond, the master pings at once
+    for (uint32_t n = 0; n <= CLIENTS; n++)
+    {
+        Start(n);
+    }
+
+    UCAN_TEST_CHECK(ActiveClients() == 0U);
+
+    for (uint32_t t = 1; t < UCAN_HANDSHAKE_INTERVAL_MS && allActiveMs == 0U; t++)
+    {
+        (void)Step(1U + CLIENTS);
+        allActiveMs = (ActiveClients() == CLIENTS) ? t : 0U;
+    }
+
+    UCAN_TEST_CHECK(allActiveMs != 0U && allActiveMs <= UCAN_ANNOUNCE_BACKOFF_MAX_MS + 1U);
+
+    printf("  bring-up, all nodes powered together: master + %u clients all ACTIVE after %u ms\n",
+           (unsigned)CLIENTS, (unsigned)allActiveMs);
+}
+
+static void TestClientsAfterMaster(void)
+{
+    uint32_t announceSlots = 0;
+    uint32_t lastAnnounce = 0;
+    uint32_t allActiveMs = 0;
+
+    HostCan_Reset();
+
+    // Master up first and past its first ping
+    Start(0);
+
+    for (uint32_t t = 0; t < 50U; t++)
+    {
+        (void)Step(1);
+    }
+
+    UCAN_TEST_CHECK(PingsSent() == 1U);
+
+    // Clients power up together, the next ping is due in 450 ms
+    for (uint32_t n = 1; n <= CLIENTS; n++)
+    {
+        Start(n);
+    }
+
+    for (uint32_t t = 1; t < UCAN_HANDSHAKE_INTERVAL_MS && allActiveMs == 0U; t++)
+    {
+        if (Step(1U + CLIENTS))
+        {
+            announceSlots++;
+            lastAnnounce = t;
+        }
+
+        allActiveMs = (ActiveClients() == CLIENTS) ? t : 0U;
+    }
+
+    // ACTIVE through the announcements alone, without waiting for a ping
+    UCAN_TEST_CHECK(PingsSent() == 1U);
+    UCAN_TEST_CHECK(allActiveMs != 0U && allActiveMs <= UCAN_ANNOUNCE_BACKOFF_MAX_MS + 1U);
+    UCAN_TEST_CHECK(allActiveMs < UCAN_HANDSHAKE_INTERVAL_MS / 10U);
+
+    // Backoff spreads the announcements, within its bound
+    UCAN_TEST_CHECK(announceSlots > 1U);
+    UCAN_TEST_CHECK(lastAnnounce <= UCAN_ANNOUNCE_BACKOFF_MAX_MS + 1U);
+
+    printf("  bring-up, %u clients after the master: all ACTIVE %u ms after power-on (next ping was %u ms away), announcements in %u distinct ms\n",
+           (unsigned)CLIENTS, (unsigned)allActiveMs, (unsigned)(UCAN_HANDSHAKE_INTERVAL_MS - 50U), (unsigned)announceSlots);
+}
+
+int main(void)
+{
+    TestPowerOnTogether();
+    TestClientsAfterMaster();
+
+    return UCAN_TEST_RESULT("test_bringup");
+}
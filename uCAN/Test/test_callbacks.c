@@ -0,0 +1,114 @@
+/**
+  ******************************************************************************
+  * @file    test_callbacks.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the controller registry behind the HAL callbacks.
+  *
+  * Built with UCAN_CFG_HAL_CALLBACKS=1. Frames are injected into the RX FIFOs
+  * and handed to uCAN through HAL_CAN_RxFifo0MsgPendingCallback(), as
+  * HAL_CAN_IRQHandler() would. Checks that:
+  *  - a second handle on a controller that is already driven is refused
+  *    with UCAN_ERROR_DUPLICATE_ID and leaves the first handle in charge;
+  *  - the first handle can be started again;
+  *  - handles on different controllers each get the frames of their own.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define RX_ID			0x120U
+
+/**
+  * @brief  Node with one TX and one RX packet, its HAL handle and the bound variables.
+  */
+typedef struct {
+    CAN_HandleTypeDef hcan;
+    UCAN_HandleTypeDef ucan;
+    UCAN_Client clients[1];
+    UCAN_Packet tx[1];
+    UCAN_Packet rx[1];
+    uint8_t txValue;
+    uint8_t rxValue;
+} Node;
+
+static Node first;
+static Node second;
+static Node third;
+
+/**
+  * @brief  Initializes and starts a node on a controller.
+  * @retval Status of uCAN_Start().
+  */
+static UCAN_StatusTypeDef Start(Node* node, CAN_TypeDef* instance, uint32_t selfId)
+{
+    memset(node, 0, sizeof(*node));
+
+    node->hcan.Instance = instance;
+    node->clients[0].id = 0x7F0;
+    node->ucan.hcan = &node->hcan;
+    node->ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_NONE, .selfId = selfId, .clients = node->clients, .clientCount = 1 };
+    node->ucan.txHolder = (UCAN_PacketHolder){ .packets = node->tx, .count = 1 };
+    node->ucan.rxHolder = (UCAN_PacketHolder){ .packets = node->rx, .count = 1 };
+
+    UCAN_PacketConfig txConfig[1] = {
+        { .id = selfId + 1U, .item_count = 1, .items = { { &node->txValue, UCAN_U8 } } },
+    };
+    UCAN_PacketConfig rxConfig[1] = {
+        { .id = RX_ID, .item_count = 1, .items = { { &node->rxValue, UCAN_U8 } } },
+    };
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&node->ucan) == UCAN_OK);
+    return uCAN_Start(&node->ucan, &config);
+}
+
+/**
+  * @brief  Delivers one frame to a controller's FIFO and raises its RX callback.
+  */
+static void Receive(CAN_HandleTypeDef* hcan, uint8_t value)
+{
+    HostCan_Inject(hcan, RX_ID, 1, &value);
+    HAL_CAN_RxFifo0MsgPendingCallback(hcan);
+}
+
+static void TestOneHandlePerController(void)
+{
+    HostCan_Reset();
+
+    UCAN_TEST_CHECK(Start(&first, CAN1, 0x700) == UCAN_OK);
+
+    // CAN1 is taken, the callbacks keep reaching the first handle
+    UCAN_TEST_CHECK(Start(&second, CAN1, 0x710) == UCAN_ERROR_DUPLICATE_ID);
+    Receive(&first.hcan, 0x11);
+    UCAN_TEST_CHECK(first.rxValue == 0x11);
+    UCAN_TEST_CHECK(second.rxValue == 0U);
+
+    // A frame for the refused handle's HAL handle finds no owner and stays in the FIFO
+    Receive(&second.hcan, 0x22);
+    UCAN_TEST_CHECK(second.rxValue == 0U);
+    UCAN_TEST_CHECK(HAL_CAN_GetRxFifoFillLevel(&second.hcan, CAN_RX_FIFO0) == 1U);
+    HAL_CAN_RxFifo0MsgPendingCallback(&first.hcan);
+    UCAN_TEST_CHECK(first.rxValue == 0x22);
+
+    // The owner itself may start again
+    UCAN_TEST_CHECK(Start(&first, CAN1, 0x700) == UCAN_OK);
+    Receive(&first.hcan, 0x33);
+    UCAN_TEST_CHECK(first.rxValue == 0x33);
+
+    // Another controller gets its own handle
+    UCAN_TEST_CHECK(Start(&third, CAN2, 0x720) == UCAN_OK);
+    Receive(&third.hcan, 0x44);
+    UCAN_TEST_CHECK(third.rxValue == 0x44);
+    UCAN_TEST_CHECK(first.rxValue == 0x33);
+}
+
+int main(void)
+{
+    TestOneHandlePerController();
+
+    return UCAN_TEST_RESULT("test_callbacks");
+}
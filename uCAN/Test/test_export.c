@@ -0,0 +1,288 @@
+/**
+  ******************************************************************************
+  * @file    test_export.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the shared-memory export region.
+  *
+  * Built with UCAN_CFG_EXPORT=1. Frames are injected on a simulated bus and
+  * read back from the region through the reader functions only, as another
+  * program mapping the same memory would. Checks that:
+  *  - uCAN_Start() lays out one descriptor per RX packet, sorted by ID, with
+  *    the offset and size of every signal, and rejects a misaligned or
+  *    undersized region;
+  *  - uCAN_ExportFind(), uCAN_ExportRead() and uCAN_ExportSignalValue()
+  *    return the latest payload, its reception time and its signal values,
+  *    and an unreceived packet or unknown ID reads as such;
+  *  - uCAN_ExportOpen() rejects a layout being rebuilt (odd generation), a
+  *    mapping smaller than the tables, a foreign magic and writer table
+  *    sizes that differ, and every uCAN_Start() moves the generation;
+  *  - under a thread receiving frames as fast as it can, every copy a reader
+  *    gets is one single frame.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include <pthread.h>
+#include "ucan.h"
+#include "ucan_export.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define COUNTER_ID		0x110U
+#define MIXED_ID		0x120U
+#define SPEED_ID		0x130U
+#define RX_PACKETS		3U
+#define REGION_SIZE		UCAN_EXPORT_REGION_SIZE(RX_PACKETS)
+#define STRESS_FRAMES	200000U
+
+static CAN_HandleTypeDef hcan;
+static UCAN_HandleTypeDef ucan;
+static UCAN_Client clients[1] = { { .id = 0x7F0 } };
+static UCAN_Packet txPackets[1];
+static UCAN_Packet rxPackets[RX_PACKETS];
+static uint8_t txValue;
+
+// COUNTER_ID: counter (U32); MIXED_ID: a (U8), b (U16), c (U32); SPEED_ID: speed (U16)
+static uint32_t counter;
+static uint8_t a;
+static uint16_t b;
+static uint32_t c;
+static uint16_t speed;
+
+// One word more than the region, to try a misaligned start
+static uint64_t regionMem[(REGION_SIZE + 7U) / 8U + 1U];
+static uint64_t copyMem[sizeof(regionMem) / 8U];
+static volatile uint8_t writerDone;
+
+/**
+  * @brief  Starts a handle exporting into `region`, RX packets configured out of ID order.
+  * @retval Status of uCAN_Start().
+  */
+static UCAN_StatusTypeDef Start(void* region, uint32_t size)
+{
+    memset(&ucan, 0, sizeof(ucan));
+
+    hcan.Instance = CAN1;
+    ucan.hcan = &hcan;
+    ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_NONE, .selfId = 0x7E0, .clients = clients, .clientCount = 1 };
+    ucan.txHolder = (UCAN_PacketHolder){ .packets = txPackets, .count = 1 };
+    ucan.rxHolder = (UCAN_PacketHolder){ .packets = rxPackets, .count = RX_PACKETS };
+    ucan.exports = (UCAN_Export){ .region = region, .size = size };
+
+    UCAN_PacketConfig txConfig[1] = {
+        { .id = 0x7E1, .item_count = 1, .items = { { &txValue, UCAN_U8 } } },
+    };
+    UCAN_PacketConfig rxConfig[RX_PACKETS] = {
+        { .id = SPEED_ID, .item_count = 1, .items = { { &speed, UCAN_U16 } } },
+        { .id = MIXED_ID, .item_count = 3, .items = { { &a, UCAN_U8 }, { &b, UCAN_U16 }, { &c, UCAN_U32 } } },
+        { .id = COUNTER_ID, .item_count = 1, .items = { { &counter, UCAN_U32 } } },
+    };
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&ucan) == UCAN_OK);
+
+    return uCAN_Start(&ucan, &config);
+}
+
+static void Receive(uint32_t id, uint8_t dlc, const uint8_t data[])
+{
+    HostCan_Inject(&hcan, id, dlc, data);
+    UCAN_TEST_CHECK(uCAN_Update(&ucan) == UCAN_OK);
+}
+
+static void TestLayout(void)
+{
+    HostCan_Reset();
+
+    UCAN_TEST_CHECK(Start((uint8_t*)regionMem + 4, REGION_SIZE) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(Start(regionMem, REGION_SIZE - 1U) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(Start(regionMem, REGION_SIZE) == UCAN_OK);
+
+    const UCAN_ExportHeader* header = (const UCAN_ExportHeader*)regionMem;
+    UCAN_TEST_CHECK(uCAN_ExportOpen(regionMem, REGION_SIZE) != 0U);
+    UCAN_TEST_CHECK(header->count == RX_PACKETS && header->frequency == 1000U);
+
+    // Sorted by ID whatever the configuration order
+    UCAN_TEST_CHECK(uCAN_ExportFind(regionMem, COUNTER_ID) == 0);
+    UCAN_TEST_CHECK(uCAN_ExportFind(regionMem, MIXED_ID) == 1);
+    UCAN_TEST_CHECK(uCAN_ExportFind(regionMem, SPEED_ID) == 2);
+    UCAN_TEST_CHECK(uCAN_ExportFind(regionMem, 0x125) == -1);
+
+    const UCAN_ExportDesc* desc = uCAN_ExportDescriptor(regionMem, 1);
+    UCAN_TEST_CHECK(desc->id == MIXED_ID && desc->dlc == 7U && desc->signalCount == 3U);
+    UCAN_TEST_CHECK(desc->signals[0].offset == 0U && desc->signals[0].size == 1U);
+    UCAN_TEST_CHECK(desc->signals[1].offset == 1U && desc->signals[1].size == 2U);
+    UCAN_TEST_CHECK(desc->signals[2].offset == 3U && desc->signals[2].size == 4U);
+}
+
+static void TestRead(void)
+{
+    UCAN_ExportFrame frame;
+
+    HostCan_Reset();
+    UCAN_TEST_CHECK(Start(regionMem, REGION_SIZE) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_ExportOpen(regionMem, REGION_SIZE) != 0U);
+
+    int32_t mixed = uCAN_ExportFind(regionMem, MIXED_ID);
+    int32_t speedIndex = uCAN_ExportFind(regionMem, SPEED_ID);
+
+    // Nothing received yet, index past the table
+    UCAN_TEST_CHECK(uCAN_ExportRead(regionMem, (uint32_t)mixed, &frame) == 0);
+    UCAN_TEST_CHECK(uCAN_ExportRead(regionMem, RX_PACKETS, &frame) == -1);
+
+    const uint8_t first[7] = { 0x11, 0x34, 0x12, 0x78, 0x56, 0x34, 0x12 };
+    const uint8_t second[7] = { 0xFF, 0xFF, 0xFF, 0xEF, 0xBE, 0xAD, 0xDE };
+
+    HostCan_Advance(25);
+    Receive(MIXED_ID, sizeof(first), first);
+
+    UCAN_TEST_CHECK(uCAN_ExportRead(regionMem, (uint32_t)mixed, &frame) == 1);
+    UCAN_TEST_CHECK(frame.seq == 2U && frame.dlc == 7U && frame.time == 25U);
+    UCAN_TEST_CHECK(memcmp(frame.data, first, sizeof(first)) == 0);
+
+    const UCAN_ExportDesc* desc = uCAN_ExportDescriptor(regionMem, (uint32_t)mixed);
+    UCAN_TEST_CHECK(uCAN_ExportSignalValue(desc, &frame, 0) == 0x11U);
+    UCAN_TEST_CHECK(uCAN_ExportSignalValue(desc, &frame, 1) == 0x1234U);
+    UCAN_TEST_CHECK(uCAN_ExportSignalValue(desc, &frame, 2) == 0x12345678U);
+    UCAN_TEST_CHECK(uCAN_ExportSignalValue(desc, &frame, 3) == 0U);
+
+    // Same values as the bound variables
+    UCAN_TEST_CHECK(a == 0x11U && b == 0x1234U && c == 0x12345678U);
+
+    // Latest frame replaces the previous one, other slots untouched
+    HostCan_Advance(10);
+    Receive(MIXED_ID, sizeof(second), second);
+
+    UCAN_TEST_CHECK(uCAN_ExportRead(regionMem, (uint32_t)mixed, &frame) == 1);
+    UCAN_TEST_CHECK(frame.seq == 4U && frame.time == 35U);
+    UCAN_TEST_CHECK(uCAN_ExportSignalValue(desc, &frame, 1) == 0xFFFFU);
+    UCAN_TEST_CHECK(uCAN_ExportSignalValue(desc, &frame, 2) == 0xDEADBEEFU);
+    UCAN_TEST_CHECK(uCAN_ExportRead(regionMem, (uint32_t)speedIndex, &frame) == 0);
+}
+
+static void TestOpen(void)
+{
+    HostCan_Reset();
+    UCAN_TEST_CHECK(Start(regionMem, REGION_SIZE) == UCAN_OK);
+
+    const UCAN_ExportHeader* header = (const UCAN_ExportHeader*)regionMem;
+    uint32_t generation = uCAN_ExportOpen(regionMem, REGION_SIZE);
+    UCAN_TEST_CHECK(generation != 0U && (generation & 1U) == 0U && header->generation == generation);
+
+    // Mapping too small for the header or for the slot table
+    UCAN_TEST_CHECK(uCAN_ExportOpen(regionMem, sizeof(UCAN_ExportHeader) - 1U) == 0U);
+    UCAN_TEST_CHECK(uCAN_ExportOpen(regionMem, REGION_SIZE - 1U) == 0U);
+    UCAN_TEST_CHECK(uCAN_ExportOpen(regionMem, REGION_SIZE - RX_PACKETS * sizeof(UCAN_ExportSlot)) == 0U);
+    UCAN_TEST_CHECK(uCAN_ExportOpen(NULL, REGION_SIZE) == 0U);
+
+    // Foreign magic, and a writer built with other table entry sizes
+    UCAN_ExportHeader* copy = (UCAN_ExportHeader*)copyMem;
+
+    memcpy(copyMem, regionMem, REGION_SIZE);
+    copy->magic[0] = 'x';
+    UCAN_TEST_CHECK(uCAN_ExportOpen(copyMem, REGION_SIZE) == 0U);
+
+    memcpy(copyMem, regionMem, REGION_SIZE);
+    copy->slotSize += 8U;
+    UCAN_TEST_CHECK(uCAN_ExportOpen(copyMem, REGION_SIZE) == 0U);
+
+    // Layout being rebuilt: odd generation until the writer commits
+    UCAN_TEST_CHECK(uCAN_ExportBegin(regionMem, REGION_SIZE, RX_PACKETS, 1000U) == REGION_SIZE);
+    UCAN_TEST_CHECK((header->generation & 1U) != 0U);
+    UCAN_TEST_CHECK(uCAN_ExportOpen(regionMem, REGION_SIZE) == 0U);
+    uCAN_ExportCommit(regionMem);
+    UCAN_TEST_CHECK(uCAN_ExportOpen(regionMem, REGION_SIZE) == generation + 2U);
+
+    // A restart publishes a new generation, the slots start empty
+    UCAN_ExportFrame frame;
+    uint8_t data[2] = { 0x10, 0x27 };
+
+    Receive(SPEED_ID, sizeof(data), data);
+    UCAN_TEST_CHECK(Start(regionMem, REGION_SIZE) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_ExportOpen(regionMem, REGION_SIZE) == generation + 4U);
+    UCAN_TEST_CHECK(uCAN_ExportRead(regionMem, (uint32_t)uCAN_ExportFind(regionMem, SPEED_ID), &frame) == 0);
+}
+
+/**
+  * @brief  Tells whether a copied frame of COUNTER_ID is one single frame: n in every byte.
+  */
+static uint8_t Consistent(const UCAN_ExportFrame* frame)
+{
+    for (uint32_t i = 1; i < 8U; i++)
+    {
+        if (frame->data[i] != frame->data[0])
+        {
+            return 0;
+        }
+    }
+
+    return frame->dlc == 8U;
+}
+
+static void* Writer(void* arg)
+{
+    for (uint32_t n = 1; n <= STRESS_FRAMES; n++)
+    {
+        uint8_t data[8];
+
+        memset(data, (uint8_t)n, sizeof(data));
+        Receive(COUNTER_ID, sizeof(data), data);
+    }
+
+    writerDone = 1;
+    return NULL;
+}
+
+static void TestConcurrentReader(void)
+{
+    HostCan_Reset();
+    UCAN_TEST_CHECK(Start(regionMem, REGION_SIZE) == UCAN_OK);
+
+    pthread_t writer;
+    uint32_t index = (uint32_t)uCAN_ExportFind(regionMem, COUNTER_ID);
+    uint32_t copied = 0;
+    uint32_t retried = 0;
+    uint32_t torn = 0;
+    uint32_t lastSeq = 0;
+    uint32_t backwards = 0;
+
+    writerDone = 0;
+    UCAN_TEST_CHECK(pthread_create(&writer, NULL, Writer, NULL) == 0);
+
+    while (!writerDone)
+    {
+        UCAN_ExportFrame frame;
+        int32_t status = uCAN_ExportRead(regionMem, index, &frame);
+
+        if (status == 1)
+        {
+            copied++;
+            torn += !Consistent(&frame);
+            backwards += (frame.seq < lastSeq);
+            lastSeq = frame.seq;
+        }
+
+        retried += (status == -1);
+    }
+
+    pthread_join(writer, NULL);
+
+    UCAN_ExportFrame last;
+    UCAN_TEST_CHECK(uCAN_ExportRead(regionMem, index, &last) == 1);
+    UCAN_TEST_CHECK(torn == 0U && backwards == 0U);
+    UCAN_TEST_CHECK(last.seq == 2U * STRESS_FRAMES && last.data[0] == (uint8_t)STRESS_FRAMES && Consistent(&last));
+
+    printf("  concurrent reader: %u frames published, %u copied, %u gave up, %u torn\n",
+           (unsigned)STRESS_FRAMES, (unsigned)copied, (unsigned)retried, (unsigned)torn);
+}
+
+int main(void)
+{
+    TestLayout();
+    TestRead();
+    TestOpen();
+    TestConcurrentReader();
+
+    return UCAN_TEST_RESULT("test_export");
+}
@@ -0,0 +1,323 @@
+/**
+  ******************************************************************************
+  * @file    test_fault.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the fault injection layer and its detect/recover figures.
+  *
+  * Built with UCAN_CFG_FAULT=1. A master and a client share one simulated bus
+  * and run one step per millisecond. Each scenario runs on the master. Checks that:
+  *  - dropped RX frames time the client out on the master, and detection and
+  *    recovery times follow from the handshake timeout and interval;
+  *  - a bus held in bus-off queues nothing, is reported as UCAN_BUS_FAILED
+  *    and is detected and cleared within one poll;
+  *  - corrupted RX bytes, every n-th dropped TX frame and babbled frames hit
+  *    exactly the frames their step selects;
+  *  - clock drift speeds up the handle time only inside its window and never
+  *    lets it jump back.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "ucan_runtime.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define MASTER_ID		0x010U
+#define CLIENT_ID		0x020U
+#define MASTER_TX_ID	0x200U
+#define EVENT_ID		0x201U
+#define BABBLE_ID		0x001U
+
+static CAN_HandleTypeDef hcanMaster;
+static CAN_HandleTypeDef hcanClient;
+static UCAN_HandleTypeDef master;
+static UCAN_HandleTypeDef client;
+
+static UCAN_Client masterClients[1];
+static UCAN_Client clientClients[1];
+static UCAN_Packet packets[4][2];
+static uint8_t masterValues[3];
+static uint8_t clientValues[3];
+
+/**
+  * @brief  Starts a master with two TX packets and a client receiving them.
+  */
+static void Setup(void)
+{
+    HostCan_Reset();
+    memset(&master, 0, sizeof(master));
+    memset(&client, 0, sizeof(client));
+    memset(masterClients, 0, sizeof(masterClients));
+    memset(clientClients, 0, sizeof(clientClients));
+    memset(masterValues, 0, sizeof(masterValues));
+    memset(clientValues, 0, sizeof(clientValues));
+
+    hcanMaster.Instance = CAN1;
+    hcanClient.Instance = CAN2;
+    masterClients[0].id = CLIENT_ID;
+    clientClients[0].id = CLIENT_ID;
+
+    master.hcan = &hcanMaster;
+    master.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_MASTER, .selfId = MASTER_ID, .clients = masterClients, .clientCount = 1 };
+    master.txHolder = (UCAN_PacketHolder){ .packets = packets[0], .count = 2 };
+    master.rxHolder = (UCAN_PacketHolder){ .packets = packets[1], .count = 1 };
+
+    client.hcan = &hcanClient;
+    client.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_CLIENT, .selfId = CLIENT_ID, .masterId = MASTER_ID, .clients = clientClients, .clientCount = 1 };
+    client.txHolder = (UCAN_PacketHolder){ .packets = packets[2], .count = 1 };
+    client.rxHolder = (UCAN_PacketHolder){ .packets = packets[3], .count = 2 };
+
+    UCAN_PacketConfig masterTx[2] = {
+        { .id = MASTER_TX_ID, .item_count = 2, .items = { { &masterValues[0], UCAN_U8 }, { &masterValues[1], UCAN_U8 } } },
+        { .id = EVENT_ID, .item_count = 1, .items = { { &masterValues[2], UCAN_U8 } } },
+    };
+    UCAN_PacketConfig clientTx[1] = {
+        { .id = 0x300, .item_count = 1, .items = { { &clientValues[2], UCAN_U8 } } },
+    };
+    UCAN_PacketConfig clientRx[2] = {
+        { .id = MASTER_TX_ID, .item_count = 2, .items = { { &clientValues[0], UCAN_U8 }, { &clientValues[1], UCAN_U8 } } },
+        { .id = EVENT_ID, .item_count = 1, .items = { { &clientValues[2], UCAN_U8 } } },
+    };
+    UCAN_Config masterConfig = { masterTx, clientTx };
+    UCAN_Config clientConfig = { clientTx, clientRx };
+
+    UCAN_TEST_CHECK(uCAN_Init(&master) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&master, &masterConfig) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Init(&client) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&client, &clientConfig) == UCAN_OK);
+}
+
+static void Drain(UCAN_HandleTypeDef* ucan)
+{
+    while (HAL_CAN_GetRxFifoFillLevel(ucan->hcan, CAN_RX_FIFO0) > 0U)
+    {
+        (void)uCAN_Update(ucan);
+    }
+}
+
+/**
+  * @brief  Runs both nodes for one millisecond.
+  */
+static void Step(void)
+{
+    HostCan_Advance(1);
+    (void)uCAN_SendAll(&master);
+    (void)uCAN_SendAll(&client);
+    Drain(&client);
+    Drain(&master);
+    (void)uCAN_Handshake(&client);
+    (void)uCAN_Handshake(&master);
+}
+
+/**
+  * @brief  Runs both nodes until the master has seen the client for a few pings.
+  */
+static void Connect(void)
+{
+    for (uint32_t t = 0; t < 3U * UCAN_HANDSHAKE_INTERVAL_MS; t++)
+    {
+        Step();
+    }
+
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&master, CLIENT_ID) == UCAN_OK);
+}
+
+/**
+  * @brief  Runs a scenario on the master until uCAN_FaultPoll() reports final results.
+  * @retval Milliseconds the scenario took.
+  */
+static uint32_t Run(UCAN_FaultPlan* plan)
+{
+    uint32_t ms = 0;
+
+    UCAN_TEST_CHECK(uCAN_FaultStart(&master, plan) == UCAN_OK);
+
+    do
+    {
+        Step();
+        ms++;
+    } while (uCAN_FaultPoll(&master) == UCAN_BUSY && ms < 20000U);
+
+    UCAN_TEST_CHECK(ms < 20000U);
+    UCAN_TEST_CHECK(uCAN_FaultStart(&master, NULL) == UCAN_OK);
+
+    return ms;
+}
+
+static void TestDropRx(void)
+{
+    Setup();
+    Connect();
+
+    UCAN_FaultStep steps[] = {
+        { .kind = UCAN_FAULT_DROP_RX, .startMs = 100, .durationMs = 1500, .id = UCAN_FAULT_ANY_ID },
+    };
+    UCAN_FaultPlan plan = { .steps = steps, .stepCount = 1 };
+
+    uint32_t ms = Run(&plan);
+
+    // One episode, seen by the handshake monitor only
+    UCAN_TEST_CHECK(plan.connection.episodes == 1U && plan.connection.detected == 1U && plan.connection.recovered == 1U);
+    UCAN_TEST_CHECK(plan.bus.detected == 0U);
+    UCAN_TEST_CHECK(steps[0].hits > 0U && plan.injected == steps[0].hits);
+
+    // Last response came at most one interval before the window
+    UCAN_TEST_CHECK(plan.connection.lastDetectUs >= (UCAN_HANDSHAKE_TIMEOUT_MS - UCAN_HANDSHAKE_INTERVAL_MS) * 1000U);
+    UCAN_TEST_CHECK(plan.connection.lastDetectUs <= (UCAN_HANDSHAKE_TIMEOUT_MS + 1U) * 1000U);
+
+    // Back with the response to the next ping
+    UCAN_TEST_CHECK(plan.connection.lastRecoverUs <= (UCAN_HANDSHAKE_INTERVAL_MS + 1U) * 1000U);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&master, CLIENT_ID) == UCAN_OK);
+
+    printf("  drop rx: detected after %u us, recovered after %u us, %u frames dropped, %u ms\n",
+           (unsigned)plan.connection.lastDetectUs, (unsigned)plan.connection.lastRecoverUs, (unsigned)steps[0].hits, (unsigned)ms);
+}
+
+static void TestBusOff(void)
+{
+    Setup();
+    Connect();
+
+    UCAN_FaultStep steps[] = {
+        { .kind = UCAN_FAULT_BUS_OFF, .startMs = 10, .durationMs = 300 },
+    };
+    UCAN_FaultPlan plan = { .steps = steps, .stepCount = 1 };
+    UCAN_BusHealth health;
+
+    UCAN_TEST_CHECK(uCAN_FaultStart(&master, &plan) == UCAN_OK);
+
+    for (uint32_t t = 0; t < 20U; t++)
+    {
+        Step();
+        (void)uCAN_FaultPoll(&master);
+    }
+
+    // Nothing leaves the controller while it is held in bus-off
+    uint32_t sent = HostCan_SentCount(&hcanMaster);
+    masterValues[2] = 0x77;
+    UCAN_TEST_CHECK(uCAN_Send(&master, EVENT_ID) != UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_GetBusHealth(&master, 0, &health) == UCAN_OK && health.status == UCAN_BUS_FAILED);
+
+    for (uint32_t t = 0; t < 200U; t++)
+    {
+        Step();
+        (void)uCAN_FaultPoll(&master);
+    }
+
+    UCAN_TEST_CHECK(HostCan_SentCount(&hcanMaster) == sent);
+
+    for (uint32_t t = 0; uCAN_FaultPoll(&master) == UCAN_BUSY && t < 20000U; t++)
+    {
+        Step();
+    }
+
+    UCAN_TEST_CHECK(plan.bus.episodes == 1U && plan.bus.detected == 1U && plan.bus.recovered == 1U);
+    UCAN_TEST_CHECK(plan.bus.lastDetectUs <= 1000U && plan.bus.lastRecoverUs <= 1000U);
+    UCAN_TEST_CHECK(uCAN_GetBusHealth(&master, 0, &health) == UCAN_OK && health.status == UCAN_BUS_OK);
+    UCAN_TEST_CHECK(uCAN_Send(&master, EVENT_ID) == UCAN_OK && HostCan_SentCount(&hcanMaster) > sent);
+    UCAN_TEST_CHECK(uCAN_FaultStart(&master, NULL) == UCAN_OK);
+}
+
+static void TestFrameFaults(void)
+{
+    Setup();
+
+    UCAN_FaultStep steps[] = {
+        { .kind = UCAN_FAULT_CORRUPT_RX, .startMs = 0, .durationMs = 1000, .id = MASTER_TX_ID, .param = (1U << 8) | 0x0FU },
+        { .kind = UCAN_FAULT_DROP_TX, .startMs = 0, .durationMs = 1000, .id = EVENT_ID, .every = 2 },
+        { .kind = UCAN_FAULT_BABBLE, .startMs = 0, .durationMs = 10, .id = BABBLE_ID, .param = 3 },
+    };
+    UCAN_FaultPlan plan = { .steps = steps, .stepCount = 3 };
+
+    // Corruption applies to what the client receives
+    UCAN_TEST_CHECK(uCAN_FaultStart(&client, &plan) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_FaultPoll(&client) == UCAN_BUSY);
+
+    masterValues[0] = 0x55;
+    masterValues[1] = 0x55;
+    UCAN_TEST_CHECK(uCAN_Send(&master, MASTER_TX_ID) == UCAN_OK);
+    Drain(&client);
+    UCAN_TEST_CHECK(clientValues[0] == 0x55 && clientValues[1] == 0x5A);
+    UCAN_TEST_CHECK(steps[0].hits == 1U);
+    UCAN_TEST_CHECK(uCAN_FaultStart(&client, NULL) == UCAN_OK);
+
+    // Dropped and babbled frames on what the master sends
+    UCAN_TEST_CHECK(uCAN_FaultStart(&master, &plan) == UCAN_OK);
+    uint32_t seen = HostCan_SentCount(&hcanMaster);
+    uint32_t events = 0;
+    uint32_t babbled = 0;
+
+    for (uint32_t i = 0; i < 10U; i++)
+    {
+        (void)uCAN_FaultPoll(&master);
+        masterValues[2] = (uint8_t)i;
+        UCAN_TEST_CHECK(uCAN_Send(&master, EVENT_ID) == UCAN_OK);
+        HostCan_Advance(1);
+    }
+
+    for (; seen < HostCan_SentCount(&hcanMaster); seen++)
+    {
+        events += (HostCan_Sent(&hcanMaster, seen)->header.StdId == EVENT_ID);
+        babbled += (HostCan_Sent(&hcanMaster, seen)->header.StdId == BABBLE_ID);
+    }
+
+    // Every second event is lost but reported as sent, three babbled frames per poll
+    UCAN_TEST_CHECK(events == 5U && steps[1].hits == 5U);
+    UCAN_TEST_CHECK(babbled == 30U && steps[2].hits == 30U);
+    UCAN_TEST_CHECK(plan.injected == 35U);
+    UCAN_TEST_CHECK(uCAN_FaultStart(&master, NULL) == UCAN_OK);
+}
+
+static void TestClockDrift(void)
+{
+    Setup();
+
+    UCAN_FaultStep steps[] = {
+        { .kind = UCAN_FAULT_CLOCK_DRIFT, .startMs = 0, .durationMs = 1000, .param = 100000 },
+    };
+    UCAN_FaultPlan plan = { .steps = steps, .stepCount = 1 };
+
+    UCAN_TEST_CHECK(uCAN_FaultStart(&master, &plan) == UCAN_OK);
+    UCAN_Time start = uCAN_Runtime_Now(&master.timebase);
+    UCAN_Time last = start;
+    uint8_t monotonic = 1;
+
+    for (uint32_t t = 0; t < 2000U; t++)
+    {
+        HostCan_Advance(1);
+        (void)uCAN_FaultPoll(&master);
+
+        UCAN_Time now = uCAN_Runtime_Now(&master.timebase);
+        monotonic &= (now >= last);
+        last = now;
+
+        if (t == 999U)
+        {
+            // 10 % fast inside the window
+            uint32_t ms = uCAN_Runtime_TimeToMs(&master.timebase, now - start);
+            UCAN_TEST_CHECK(ms >= 1098U && ms <= 1101U);
+        }
+    }
+
+    // Normal pace after the window, the drift is kept
+    uint32_t ms = uCAN_Runtime_TimeToMs(&master.timebase, last - start);
+    UCAN_TEST_CHECK(ms >= 2098U && ms <= 2101U);
+    UCAN_TEST_CHECK(monotonic);
+
+    // Out of range drift is refused
+    steps[0].param = (uint32_t)1000000;
+    UCAN_TEST_CHECK(uCAN_FaultStart(&master, &plan) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(uCAN_FaultStart(&master, NULL) == UCAN_OK);
+}
+
+int main(void)
+{
+    TestDropRx();
+    TestBusOff();
+    TestFrameFaults();
+    TestClockDrift();
+
+    return UCAN_TEST_RESULT("test_fault");
+}
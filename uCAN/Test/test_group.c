@@ -0,0 +1,241 @@
+/**
+  ******************************************************************************
+  * @file    test_group.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the consistent copy of multi-packet signal groups.
+  *
+  * A group of two RX packets carries one sample: four signal bytes and a
+  * sequence counter each, every byte of set n holding n. Checks that:
+  *  - a set is published once both members with the same counter arrived,
+  *    and a member with a newer counter restarts the set;
+  *  - a set published while uCAN_ReadGroup() copies (played from the
+  *    barrier hook in place of the RX interrupt) is never mixed into the
+  *    application variables: the read is retried, and on UCAN_BUSY the
+  *    variables still hold the previous set;
+  *  - under a thread receiving sets as fast as it can, every read leaves
+  *    the variables holding one single set.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include <pthread.h>
+#include "ucan.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define MEMBER_A_ID		0x140U
+#define MEMBER_B_ID		0x141U
+#define STRESS_SETS		200000U
+
+static CAN_HandleTypeDef hcan;
+static UCAN_HandleTypeDef ucan;
+
+static UCAN_Client clients[1] = { { .id = 0x7F0 } };
+static UCAN_SignalGroup groups[1];
+static UCAN_Packet txPackets[1];
+static UCAN_Packet rxPackets[2];
+static uint8_t txValue;
+static uint8_t values[2][5];
+static uint32_t hookCalls;
+static uint32_t hookPublishAt;
+static uint8_t hookSet;
+static volatile uint8_t writerDone;
+
+/**
+  * @brief  Starts a handle with the two member packets in one group, sequence counter in byte 4.
+  */
+static void Setup(void)
+{
+    HostCan_Reset();
+    memset(&ucan, 0, sizeof(ucan));
+    memset(groups, 0, sizeof(groups));
+    memset(values, 0, sizeof(values));
+
+    hcan.Instance = CAN1;
+    ucan.hcan = &hcan;
+    ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_NONE, .selfId = 0x7E0, .clients = clients, .clientCount = 1 };
+    ucan.txHolder = (UCAN_PacketHolder){ .packets = txPackets, .count = 1 };
+    ucan.rxHolder = (UCAN_PacketHolder){ .packets = rxPackets, .count = 2 };
+
+    groups[0] = (UCAN_SignalGroup){ .ids = { MEMBER_A_ID, MEMBER_B_ID }, .memberCount = 2, .seqByte = 4 };
+    ucan.groups = groups;
+    ucan.groupCount = 1;
+
+    UCAN_PacketConfig txConfig[1] = {
+        { .id = 0x7E1, .item_count = 1, .items = { { &txValue, UCAN_U8 } } },
+    };
+    UCAN_PacketConfig rxConfig[2] = {
+        { .id = MEMBER_A_ID, .item_count = 5, .items = { { &values[0][0], UCAN_U8 }, { &values[0][1], UCAN_U8 },
+          { &values[0][2], UCAN_U8 }, { &values[0][3], UCAN_U8 }, { &values[0][4], UCAN_U8 } } },
+        { .id = MEMBER_B_ID, .item_count = 5, .items = { { &values[1][0], UCAN_U8 }, { &values[1][1], UCAN_U8 },
+          { &values[1][2], UCAN_U8 }, { &values[1][3], UCAN_U8 }, { &values[1][4], UCAN_U8 } } },
+    };
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&ucan) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&ucan, &config) == UCAN_OK);
+}
+
+/**
+  * @brief  Receives one member frame of set `n`, as the RX interrupt would.
+  */
+static void Receive(uint32_t id, uint8_t n)
+{
+    uint8_t data[5];
+
+    memset(data, n, sizeof(data));
+    HostCan_Inject(&hcan, id, sizeof(data), data);
+    (void)uCAN_Update(&ucan);
+}
+
+static void Publish(uint8_t n)
+{
+    Receive(MEMBER_A_ID, n);
+    Receive(MEMBER_B_ID, n);
+}
+
+/**
+  * @retval Non-zero if every bound variable holds set `n`.
+  */
+static uint8_t Holds(uint8_t n)
+{
+    for (uint32_t k = 0; k < 2U; k++)
+    {
+        for (uint32_t i = 0; i < 5U; i++)
+        {
+            if (values[k][i] != n)
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/**
+  * @retval Non-zero if every bound variable holds the same set.
+  */
+static uint8_t Consistent(void)
+{
+    return Holds(values[0][0]);
+}
+
+/**
+  * @brief  Barrier hook publishing the next set at barrier number hookPublishAt (every barrier if 0).
+  */
+static void PublishFromBarrier(void)
+{
+    hookCalls++;
+
+    if (hookPublishAt == 0U || hookCalls == hookPublishAt)
+    {
+        Publish(++hookSet);
+    }
+}
+
+static void TestAssembly(void)
+{
+    Setup();
+
+    // Nothing before the first complete set
+    UCAN_TEST_CHECK(uCAN_ReadGroup(&ucan, &groups[0]) == UCAN_NO_CHANGED_VAL);
+    Receive(MEMBER_A_ID, 1);
+    UCAN_TEST_CHECK(uCAN_ReadGroup(&ucan, &groups[0]) == UCAN_NO_CHANGED_VAL);
+    Receive(MEMBER_B_ID, 1);
+    UCAN_TEST_CHECK(uCAN_ReadGroup(&ucan, &groups[0]) == UCAN_OK && Holds(1));
+    UCAN_TEST_CHECK(uCAN_ReadGroup(&ucan, &groups[0]) == UCAN_NO_CHANGED_VAL);
+
+    // Member of a newer set drops the incomplete one
+    Receive(MEMBER_A_ID, 2);
+    Receive(MEMBER_B_ID, 3);
+    UCAN_TEST_CHECK(uCAN_ReadGroup(&ucan, &groups[0]) == UCAN_NO_CHANGED_VAL && Holds(1));
+    Receive(MEMBER_A_ID, 3);
+    UCAN_TEST_CHECK(uCAN_ReadGroup(&ucan, &groups[0]) == UCAN_OK && Holds(3));
+}
+
+static void TestPublishDuringRead(void)
+{
+    Setup();
+    Publish(1);
+    UCAN_TEST_CHECK(uCAN_ReadGroup(&ucan, &groups[0]) == UCAN_OK && Holds(1));
+
+    // One set published between the snapshot and its check: retried, newest set copied
+    Publish(2);
+    hookSet = 2;
+    hookCalls = 0;
+    hookPublishAt = 2;
+    HostCan_SetBarrierHook(PublishFromBarrier);
+    UCAN_TEST_CHECK(uCAN_ReadGroup(&ucan, &groups[0]) == UCAN_OK && Holds(3));
+    HostCan_SetBarrierHook(NULL);
+    UCAN_TEST_CHECK(hookCalls > 2U);
+
+    // A set published at every barrier: no attempt succeeds and the previous set is kept
+    Publish(4);
+    hookSet = 4;
+    hookCalls = 0;
+    hookPublishAt = 0;
+    HostCan_SetBarrierHook(PublishFromBarrier);
+    UCAN_TEST_CHECK(uCAN_ReadGroup(&ucan, &groups[0]) == UCAN_BUSY);
+    HostCan_SetBarrierHook(NULL);
+    UCAN_TEST_CHECK(Holds(3));
+
+    // Once the bus calms down the latest set is copied
+    UCAN_TEST_CHECK(uCAN_ReadGroup(&ucan, &groups[0]) == UCAN_OK && Holds(hookSet));
+}
+
+static void* Writer(void* arg)
+{
+    for (uint32_t n = 1; n <= STRESS_SETS; n++)
+    {
+        Publish((uint8_t)n);
+    }
+
+    writerDone = 1;
+    return NULL;
+}
+
+static void TestConcurrentReader(void)
+{
+    Setup();
+
+    pthread_t writer;
+    uint32_t reads = 0;
+    uint32_t copied = 0;
+    uint32_t busy = 0;
+    uint32_t torn = 0;
+
+    writerDone = 0;
+    UCAN_TEST_CHECK(pthread_create(&writer, NULL, Writer, NULL) == 0);
+
+    while (!writerDone)
+    {
+        UCAN_StatusTypeDef status = uCAN_ReadGroup(&ucan, &groups[0]);
+
+        reads++;
+        copied += (status == UCAN_OK);
+        busy += (status == UCAN_BUSY);
+        torn += !Consistent();
+    }
+
+    pthread_join(writer, NULL);
+
+    // The last set may already have been copied inside the loop
+    UCAN_StatusTypeDef last = uCAN_ReadGroup(&ucan, &groups[0]);
+
+    UCAN_TEST_CHECK(torn == 0U);
+    UCAN_TEST_CHECK((last == UCAN_OK || last == UCAN_NO_CHANGED_VAL) && Holds((uint8_t)STRESS_SETS));
+
+    printf("  concurrent reader: %u sets published, %u reads, %u copied, %u busy, %u torn\n",
+           (unsigned)STRESS_SETS, (unsigned)reads, (unsigned)copied, (unsigned)busy, (unsigned)torn);
+}
+
+int main(void)
+{
+    TestAssembly();
+    TestPublishDuringRead();
+    TestConcurrentReader();
+
+    return UCAN_TEST_RESULT("test_group");
+}
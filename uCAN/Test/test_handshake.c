@@ -0,0 +1,168 @@
+/**
+  ******************************************************************************
+  * @file    test_handshake.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of capability negotiation among several clients.
+  *
+  * A master, a current client and a legacy client share one simulated bus.
+  * The legacy client predates negotiation: its plain responses are injected
+  * after every ping. Checks that:
+  *  - each ping asks one client for its capabilities, so the current client
+  *    sends a single capability frame and keeps answering with pongs while
+  *    the legacy client is still being asked;
+  *  - the legacy client is recorded as version 0 after UCAN_CAPS_LEGACY_MISSES
+  *    plain responses, after which pings stop asking.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define MASTER_ID		0x010U
+#define CLIENT_ID		0x020U
+#define LEGACY_ID		0x030U
+
+static CAN_HandleTypeDef hcanMaster;
+static CAN_HandleTypeDef hcanClient;
+static UCAN_HandleTypeDef master;
+static UCAN_HandleTypeDef client;
+
+static UCAN_Client masterClients[2];
+static UCAN_Client clientClients[1];
+static UCAN_Packet packets[4][1];
+static uint8_t masterValue;
+static uint8_t clientValue;
+
+/**
+  * @brief  Starts a master knowing both clients and the current client, one TX packet each.
+  */
+static void Setup(void)
+{
+    HostCan_Reset();
+    memset(&master, 0, sizeof(master));
+    memset(&client, 0, sizeof(client));
+    memset(masterClients, 0, sizeof(masterClients));
+    memset(clientClients, 0, sizeof(clientClients));
+
+    hcanMaster.Instance = CAN1;
+    hcanClient.Instance = CAN2;
+    masterClients[0].id = CLIENT_ID;
+    masterClients[1].id = LEGACY_ID;
+    clientClients[0].id = CLIENT_ID;
+
+    master.hcan = &hcanMaster;
+    master.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_MASTER, .selfId = MASTER_ID, .clients = masterClients, .clientCount = 2 };
+    master.txHolder = (UCAN_PacketHolder){ .packets = packets[0], .count = 1 };
+    master.rxHolder = (UCAN_PacketHolder){ .packets = packets[1], .count = 1 };
+
+    client.hcan = &hcanClient;
+    client.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_CLIENT, .selfId = CLIENT_ID, .masterId = MASTER_ID, .clients = clientClients, .clientCount = 1 };
+    client.txHolder = (UCAN_PacketHolder){ .packets = packets[2], .count = 1 };
+    client.rxHolder = (UCAN_PacketHolder){ .packets = packets[3], .count = 1 };
+
+    UCAN_PacketConfig masterTx[1] = {
+        { .id = 0x200, .item_count = 1, .items = { { &masterValue, UCAN_U8 } } },
+    };
+    UCAN_PacketConfig clientTx[1] = {
+        { .id = 0x300, .item_count = 1, .items = { { &clientValue, UCAN_U8 } } },
+    };
+    UCAN_Config masterConfig = { masterTx, clientTx };
+    UCAN_Config clientConfig = { clientTx, masterTx };
+
+    UCAN_TEST_CHECK(uCAN_Init(&master) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&master, &masterConfig) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Init(&client) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&client, &clientConfig) == UCAN_OK);
+}
+
+static void Drain(UCAN_HandleTypeDef* ucan)
+{
+    while (HAL_CAN_GetRxFifoFillLevel(ucan->hcan, CAN_RX_FIFO0) > 0U)
+    {
+        (void)uCAN_Update(ucan);
+    }
+}
+
+static void TestCapsAskedOneClientAtATime(void)
+{
+    Setup();
+
+    uint8_t legacyPong[8] = { UCAN_HANDSHAKE_RESPONSE_VALUE };
+    uint32_t seenMaster = 0;
+    uint32_t seenClient = 0;
+    uint32_t asked[2] = { 0 };
+    uint32_t pongs = 0;
+    uint32_t caps = 0;
+    uint32_t duration = 10U * UCAN_HANDSHAKE_INTERVAL_MS;
+
+    for (uint32_t t = 0; t < duration; t++)
+    {
+        HostCan_Advance(1);
+        (void)uCAN_SendAll(&master);
+        (void)uCAN_SendAll(&client);
+        (void)uCAN_Handshake(&client);
+        (void)uCAN_Handshake(&master);
+        Drain(&client);
+
+        // Legacy client answers every ping plainly, whatever it asks for
+        for (; seenMaster < HostCan_SentCount(&hcanMaster); seenMaster++)
+        {
+            const HostCan_Frame* frame = HostCan_Sent(&hcanMaster, seenMaster);
+
+            if (frame->data[0] != UCAN_HANDSHAKE_REQUEST_VALUE)
+            {
+                continue;
+            }
+
+            UCAN_TEST_CHECK(frame->header.DLC == UCAN_PING_DLC);
+
+            if (frame->data[UCAN_PING_FLAGS] & UCAN_PING_FLAG_CAPS_REQUEST)
+            {
+                uint32_t id = frame->data[UCAN_PING_CAPS_ID] | (frame->data[UCAN_PING_CAPS_ID + 1] << 8);
+                asked[(id == CLIENT_ID) ? 0 : 1]++;
+            }
+
+            HostCan_Inject(&hcanMaster, LEGACY_ID, sizeof(legacyPong), legacyPong);
+        }
+
+        for (; seenClient < HostCan_SentCount(&hcanClient); seenClient++)
+        {
+            const HostCan_Frame* frame = HostCan_Sent(&hcanClient, seenClient);
+
+            pongs += (frame->data[0] == UCAN_HANDSHAKE_RESPONSE_VALUE);
+            caps += (frame->data[0] == UCAN_HANDSHAKE_CAPS_VALUE);
+        }
+
+        Drain(&master);
+    }
+
+    // Current client reported once, the legacy one was asked until it counted as version 0
+    UCAN_TEST_CHECK(caps == 1U);
+    UCAN_TEST_CHECK(asked[0] == 1U);
+    UCAN_TEST_CHECK(asked[1] == UCAN_CAPS_LEGACY_MISSES);
+
+    // Every other ping was answered with a pong
+    UCAN_TEST_CHECK(pongs + caps + 1U >= duration / UCAN_HANDSHAKE_INTERVAL_MS);
+
+    UCAN_PeerCaps peer;
+    UCAN_TEST_CHECK(uCAN_GetPeerCaps(&master, CLIENT_ID, &peer) == UCAN_OK && peer.version == UCAN_PROTOCOL_VERSION);
+    UCAN_TEST_CHECK(uCAN_GetPeerCaps(&master, LEGACY_ID, &peer) == UCAN_OK && peer.version == 0U);
+
+    UCAN_ClientDiag diag;
+    UCAN_TEST_CHECK(uCAN_GetClientDiag(&master, CLIENT_ID, &diag) == UCAN_OK && diag.valid);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&master, CLIENT_ID) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&master, LEGACY_ID) == UCAN_OK);
+
+    printf("  caps negotiation: %u ms, %u pongs, %u caps, legacy asked %u times\n",
+           (unsigned)duration, (unsigned)pongs, (unsigned)caps, (unsigned)asked[1]);
+}
+
+int main(void)
+{
+    TestCapsAskedOneClientAtATime();
+
+    return UCAN_TEST_RESULT("test_handshake");
+}
@@ -0,0 +1,352 @@
+/**
+  ******************************************************************************
+  * @file    test_log.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host round-trip test and compression benchmark of the binary log codec.
+  *
+  * Covers the stream header, varint time deltas at every length boundary,
+  * identifier dictionary hits and collisions, remote and extended frames,
+  * hardware timestamps, truncated input at every length and malformed
+  * records. The benchmark encodes a periodic traffic mix and reports the
+  * bytes per frame and the encode/decode time per frame.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include <stdlib.h>
+#include "ucan_log.h"
+#include "ucan_test.h"
+
+/**
+  * @brief  Dictionary slot of a key, same Fibonacci hashing as ucan_log.c.
+  */
+static uint32_t Slot(uint32_t key)
+{
+    return (key * 2654435761U) >> (32U - UCAN_LOG_DICT_BITS);
+}
+
+static UCAN_MonitorFrame Frame(uint32_t id, uint32_t tick, uint8_t dlc, uint8_t flags)
+{
+    UCAN_MonitorFrame frame;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.id = id;
+    frame.tick = tick;
+    frame.dlc = dlc;
+    frame.flags = flags;
+    frame.timestamp = (uint16_t)(tick * 7U);
+
+    for (uint8_t i = 0; i < 8U; i++)
+    {
+        frame.data[i] = (uint8_t)(id + tick + i);
+    }
+
+    return frame;
+}
+
+static int SameFrame(const UCAN_MonitorFrame* a, const UCAN_MonitorFrame* b, uint8_t hwTimestamps)
+{
+    uint8_t payload = (a->flags & UCAN_MONITOR_FLAG_RTR) ? 0U : a->dlc;
+
+    return a->id == b->id && a->tick == b->tick && a->dlc == b->dlc && a->flags == b->flags &&
+           (!hwTimestamps || a->timestamp == b->timestamp) && memcmp(a->data, b->data, payload) == 0;
+}
+
+/**
+  * @brief  Encodes frames into one stream and decodes it again, record by record.
+  */
+static void RoundTrip(const UCAN_MonitorFrame* frames, uint32_t count, uint8_t hwTimestamps)
+{
+    static uint8_t stream[1U << 20];
+    static uint32_t length[1U << 16];
+    UCAN_LogContext enc, dec;
+    uint32_t used = uCAN_LogWriteHeader(stream, sizeof(stream));
+
+    uCAN_LogInit(&enc);
+    enc.hwTimestamps = hwTimestamps;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        length[i] = uCAN_LogEncode(&enc, &frames[i], stream + used, sizeof(stream) - used);
+        UCAN_TEST_CHECK(length[i] != 0U && length[i] <= UCAN_LOG_MAX_RECORD);
+        used += length[i];
+    }
+
+    uint32_t pos = uCAN_LogReadHeader(stream, used);
+    UCAN_TEST_CHECK(pos == UCAN_LOG_HEADER_SIZE);
+    uCAN_LogInit(&dec);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        UCAN_MonitorFrame out;
+        int32_t n = uCAN_LogDecode(&dec, stream + pos, used - pos, &out);
+
+        UCAN_TEST_CHECK(n == (int32_t)length[i]);
+        UCAN_TEST_CHECK(SameFrame(&frames[i], &out, hwTimestamps));
+
+        if (n <= 0)
+        {
+            return;
+        }
+
+        pos += (uint32_t)n;
+    }
+
+    UCAN_TEST_CHECK(pos == used);
+}
+
+static void TestHeader(void)
+{
+    uint8_t buf[8];
+
+    UCAN_TEST_CHECK(uCAN_LogWriteHeader(buf, 3) == 0U);
+    UCAN_TEST_CHECK(uCAN_LogWriteHeader(buf, sizeof(buf)) == UCAN_LOG_HEADER_SIZE);
+    UCAN_TEST_CHECK(uCAN_LogReadHeader(buf, 3) == 0U);
+    UCAN_TEST_CHECK(uCAN_LogReadHeader(buf, 4) == UCAN_LOG_HEADER_SIZE);
+
+    buf[3] = UCAN_LOG_VERSION + 1U;
+    UCAN_TEST_CHECK(uCAN_LogReadHeader(buf, 4) == 0U);
+}
+
+static void TestVarint(void)
+{
+    // Deltas on both sides of every 7-bit boundary, then the 32-bit wrap
+    static const uint32_t deltas[] = {
+        0U, 1U, 127U, 128U, 16383U, 16384U, 2097151U, 2097152U,
+        268435455U, 268435456U, 0xFFFFFFFFU, 5U
+    };
+    static const uint32_t deltaLen[] = { 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 1 };
+    UCAN_MonitorFrame frames[12];
+    UCAN_LogContext enc;
+    uint8_t out[UCAN_LOG_MAX_RECORD];
+    uint32_t tick = 0;
+
+    uCAN_LogInit(&enc);
+
+    for (uint32_t i = 0; i < 12U; i++)
+    {
+        tick += deltas[i];
+        frames[i] = Frame(0x123, tick, 8, 0);
+
+        // tag + delta + ID (raw once, then a dictionary slot) + payload
+        uint32_t expected = 1U + deltaLen[i] + (i == 0U ? 2U : 1U) + 8U;
+        UCAN_TEST_CHECK(uCAN_LogEncode(&enc, &frames[i], out, sizeof(out)) == expected);
+    }
+
+    RoundTrip(frames, 12, 0);
+    RoundTrip(frames, 12, 1);
+}
+
+static void TestDictionary(void)
+{
+    // Two standard IDs sharing one slot evict each other
+    uint32_t a = 0x100;
+    uint32_t b = a + 1U;
+
+    while (Slot(b) != Slot(a))
+    {
+        b++;
+    }
+
+    UCAN_MonitorFrame frames[] = {
+        Frame(a, 1, 8, 0), Frame(a, 2, 8, 0), Frame(b, 3, 8, 0), Frame(a, 4, 8, 0),
+        Frame(b, 5, 8, 0), Frame(b, 6, 8, 0),
+        // Same number as standard and extended ID, kept apart in the dictionary
+        Frame(a, 7, 2, UCAN_MONITOR_FLAG_EXT), Frame(a, 8, 2, UCAN_MONITOR_FLAG_EXT), Frame(a, 9, 2, 0),
+        // Remote frames carry no payload
+        Frame(0x7FF, 10, 8, UCAN_MONITOR_FLAG_RTR), Frame(0x1FFFFFFF, 11, 0, UCAN_MONITOR_FLAG_EXT | UCAN_MONITOR_FLAG_RTR),
+    };
+    static const uint8_t hit[] = { 0, 1, 0, 0, 0, 1, 0, 1, 0, 0, 0 };
+    UCAN_LogContext enc;
+    uint8_t out[UCAN_LOG_MAX_RECORD];
+    uint32_t count = sizeof(frames) / sizeof(frames[0]);
+
+    uCAN_LogInit(&enc);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        UCAN_TEST_CHECK(uCAN_LogEncode(&enc, &frames[i], out, sizeof(out)) != 0U);
+        UCAN_TEST_CHECK(((out[0] & 0x80U) != 0U) == hit[i]);
+    }
+
+    RoundTrip(frames, count, 0);
+    RoundTrip(frames, count, 1);
+}
+
+static void TestRandom(void)
+{
+    static UCAN_MonitorFrame frames[20000];
+    uint32_t tick = 0;
+
+    srand(1);
+
+    for (uint32_t i = 0; i < 20000U; i++)
+    {
+        uint8_t flags = (uint8_t)(rand() & (UCAN_MONITOR_FLAG_EXT | UCAN_MONITOR_FLAG_RTR));
+        uint32_t id = (flags & UCAN_MONITOR_FLAG_EXT) ? ((uint32_t)rand() & 0x1FFFFFFFU) % 200U * 0x10001U
+                                                      : (uint32_t)rand() % 300U;
+
+        tick += (rand() % 8 == 0) ? (uint32_t)rand() : (uint32_t)rand() % 40U;
+        frames[i] = Frame(id, tick, (uint8_t)(rand() % 9), flags);
+    }
+
+    RoundTrip(frames, 20000, 0);
+    RoundTrip(frames, 20000, 1);
+}
+
+static void TestTruncated(void)
+{
+    UCAN_MonitorFrame frames[] = {
+        Frame(0x123, 300, 8, 0), Frame(0x123, 20000, 8, 0), Frame(0x1ABCDEF, 20001, 5, UCAN_MONITOR_FLAG_EXT),
+        Frame(0x1ABCDEF, 20002, 3, UCAN_MONITOR_FLAG_EXT | UCAN_MONITOR_FLAG_RTR),
+    };
+    UCAN_LogContext enc, dec;
+    uint8_t out[4][UCAN_LOG_MAX_RECORD];
+    uint32_t len[4];
+
+    for (uint8_t hw = 0; hw < 2U; hw++)
+    {
+        uCAN_LogInit(&enc);
+        enc.hwTimestamps = hw;
+
+        for (uint32_t i = 0; i < 4U; i++)
+        {
+            len[i] = uCAN_LogEncode(&enc, &frames[i], out[i], sizeof(out[i]));
+        }
+
+        uCAN_LogInit(&dec);
+
+        for (uint32_t i = 0; i < 4U; i++)
+        {
+            UCAN_LogContext before = dec;
+            UCAN_MonitorFrame frame;
+
+            // Every prefix is incomplete and leaves the decoder untouched
+            for (uint32_t cut = 0; cut < len[i]; cut++)
+            {
+                UCAN_TEST_CHECK(uCAN_LogDecode(&dec, out[i], cut, &frame) == 0);
+                UCAN_TEST_CHECK(memcmp(&before, &dec, sizeof(dec)) == 0);
+            }
+
+            UCAN_TEST_CHECK(uCAN_LogDecode(&dec, out[i], len[i], &frame) == (int32_t)len[i]);
+            UCAN_TEST_CHECK(SameFrame(&frames[i], &frame, hw));
+        }
+    }
+
+    // A record that does not fit leaves the encoder untouched
+    uCAN_LogInit(&enc);
+    UCAN_LogContext before = enc;
+    UCAN_TEST_CHECK(uCAN_LogEncode(&enc, &frames[0], out[0], 13) == 0U);
+    UCAN_TEST_CHECK(memcmp(&before, &enc, sizeof(enc)) == 0);
+}
+
+static void TestMalformed(void)
+{
+    UCAN_LogContext dec;
+    UCAN_MonitorFrame frame;
+
+    // DLC above 8
+    static const uint8_t badDlc[] = { 0x09, 0x00, 0x23, 0x01 };
+    uCAN_LogInit(&dec);
+    UCAN_TEST_CHECK(uCAN_LogDecode(&dec, badDlc, sizeof(badDlc), &frame) == -1);
+
+    // Dictionary hit on an empty slot
+    static const uint8_t emptySlot[] = { 0x80, 0x00, 0x05 };
+    uCAN_LogInit(&dec);
+    UCAN_TEST_CHECK(uCAN_LogDecode(&dec, emptySlot, sizeof(emptySlot), &frame) == -1);
+
+    // Dictionary slot beyond the dictionary
+    static const uint8_t bigSlot[] = { 0x80, 0x00, UCAN_LOG_DICT_SIZE };
+    uCAN_LogInit(&dec);
+    UCAN_TEST_CHECK(uCAN_LogDecode(&dec, bigSlot, sizeof(bigSlot), &frame) == -1);
+
+    // Varint longer than 5 bytes
+    static const uint8_t longDelta[] = { 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x23, 0x01 };
+    uCAN_LogInit(&dec);
+    UCAN_TEST_CHECK(uCAN_LogDecode(&dec, longDelta, sizeof(longDelta), &frame) == -1);
+
+    // Fifth varint byte carrying bits beyond 32
+    static const uint8_t wideDelta[] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F, 0x23, 0x01 };
+    uCAN_LogInit(&dec);
+    UCAN_TEST_CHECK(uCAN_LogDecode(&dec, wideDelta, sizeof(wideDelta), &frame) == -1);
+
+    // Standard slot referenced from an extended record
+    static const uint8_t rawStd[] = { 0x00, 0x01, 0x23, 0x01 };
+    uint8_t extHit[] = { 0xC0, 0x01, (uint8_t)Slot(0x123) };
+    uCAN_LogInit(&dec);
+    UCAN_TEST_CHECK(uCAN_LogDecode(&dec, rawStd, sizeof(rawStd), &frame) == 4);
+    UCAN_TEST_CHECK(uCAN_LogDecode(&dec, extHit, sizeof(extHit), &frame) == -1);
+}
+
+/**
+  * @brief  Encodes and decodes a periodic traffic mix and prints size and speed.
+  */
+static void Benchmark(uint8_t hwTimestamps)
+{
+    enum { FRAMES = 200000 };
+    static UCAN_MonitorFrame frames[FRAMES];
+    static uint8_t stream[FRAMES * UCAN_LOG_MAX_RECORD];
+    // 24 standard IDs at 10/20/100 ms, 4 extended IDs at 50 ms, DLC 8 or 4
+    static const uint32_t period[] = { 10, 10, 10, 10, 10, 10, 10, 10, 20, 20, 20, 20, 20, 20, 20, 20,
+                                       100, 100, 100, 100, 100, 100, 100, 100, 50, 50, 50, 50 };
+    uint32_t count = 0;
+
+    for (uint32_t tick = 0; count < FRAMES; tick++)
+    {
+        for (uint32_t k = 0; k < 28U && count < FRAMES; k++)
+        {
+            if (tick % period[k] == 0U)
+            {
+                uint8_t ext = (k >= 24U);
+                frames[count++] = Frame(ext ? 0x18FF0000U + k : 0x100U + 0x10U * k, tick, (k & 1U) ? 4U : 8U,
+                                        ext ? UCAN_MONITOR_FLAG_EXT : 0U);
+            }
+        }
+    }
+
+    UCAN_LogContext ctx;
+    uint32_t used = 0;
+
+    uCAN_LogInit(&ctx);
+    ctx.hwTimestamps = hwTimestamps;
+    uint64_t t0 = uCAN_Test_Ns();
+
+    for (uint32_t i = 0; i < FRAMES; i++)
+    {
+        used += uCAN_LogEncode(&ctx, &frames[i], stream + used, sizeof(stream) - used);
+    }
+
+    uint64_t t1 = uCAN_Test_Ns();
+    uint32_t pos = 0;
+    UCAN_MonitorFrame out;
+
+    uCAN_LogInit(&ctx);
+
+    for (uint32_t i = 0; i < FRAMES; i++)
+    {
+        pos += (uint32_t)uCAN_LogDecode(&ctx, stream + pos, used - pos, &out);
+    }
+
+    uint64_t t2 = uCAN_Test_Ns();
+    UCAN_TEST_CHECK(pos == used);
+
+    printf("  log bench (hw timestamps %s): %.2f bytes/frame vs %u raw (%.1f%%), encode %.1f ns, decode %.1f ns per frame\n",
+           hwTimestamps ? "on" : "off", (double)used / FRAMES, (unsigned)sizeof(UCAN_MonitorFrame),
+           100.0 * used / ((double)FRAMES * sizeof(UCAN_MonitorFrame)),
+           (double)(t1 - t0) / FRAMES, (double)(t2 - t1) / FRAMES);
+}
+
+int main(void)
+{
+    TestHeader();
+    TestVarint();
+    TestDictionary();
+    TestRandom();
+    TestTruncated();
+    TestMalformed();
+    Benchmark(0);
+    Benchmark(1);
+
+    return UCAN_TEST_RESULT("test_log");
+}
@@ -0,0 +1,210 @@
+/**
+  ******************************************************************************
+  * @file    test_membership.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the membership view held by clients.
+  *
+  * A master and two clients share one simulated bus and run one step per
+  * millisecond. Checks that:
+  *  - the master's broadcasts give both clients the same view of who is
+  *    ACTIVE;
+  *  - once the master goes silent the view of a client expires after
+  *    UCAN_HANDSHAKE_LOST_MS and every peer reads as absent, and it comes
+  *    back with the next broadcast;
+  *  - a client with a different client list rejects the broadcasts, whose
+  *    bit positions it cannot interpret, and never reports a peer ACTIVE.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define MASTER_ID		0x010U
+#define CLIENT_A_ID		0x020U
+#define CLIENT_B_ID		0x030U
+#define OTHER_ID		0x040U
+
+/**
+  * @brief  Node with one TX packet, its client list and HAL handle.
+  */
+typedef struct {
+    CAN_HandleTypeDef hcan;
+    UCAN_HandleTypeDef ucan;
+    UCAN_Client clients[3];
+    UCAN_Packet tx[1];
+    UCAN_Packet rx[1];
+    uint8_t txValue;
+    uint8_t rxValue;
+    uint32_t rejected;
+} Node;
+
+static Node master;
+static Node clientA;
+static Node clientB;
+static uint8_t masterAlive;
+
+/**
+  * @brief  Starts a node; `clientCount` of CLIENT_A_ID, CLIENT_B_ID, OTHER_ID form its client list.
+  */
+static void Start(Node* node, CAN_TypeDef* instance, UCAN_NodeRole role, uint32_t selfId, uint32_t clientCount)
+{
+    static const uint32_t ids[3] = { CLIENT_A_ID, CLIENT_B_ID, OTHER_ID };
+
+    memset(node, 0, sizeof(*node));
+    node->hcan.Instance = instance;
+
+    for (uint32_t i = 0; i < clientCount; i++)
+    {
+        node->clients[i].id = ids[i];
+    }
+
+    node->ucan.hcan = &node->hcan;
+    node->ucan.node = (UCAN_NodeInfo){ .role = role, .selfId = selfId, .masterId = MASTER_ID, .clients = node->clients, .clientCount = clientCount };
+    node->ucan.txHolder = (UCAN_PacketHolder){ .packets = node->tx, .count = 1 };
+    node->ucan.rxHolder = (UCAN_PacketHolder){ .packets = node->rx, .count = 1 };
+
+    UCAN_PacketConfig txConfig[1] = {
+        { .id = selfId + 0x100U, .item_count = 1, .items = { { &node->txValue, UCAN_U8 } } },
+    };
+    UCAN_PacketConfig rxConfig[1] = {
+        { .id = 0x7F0, .item_count = 1, .items = { { &node->rxValue, UCAN_U8 } } },
+    };
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&node->ucan) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&node->ucan, &config) == UCAN_OK);
+}
+
+static void Setup(uint32_t clientBListSize)
+{
+    HostCan_Reset();
+    Start(&master, CAN1, UCAN_ROLE_MASTER, MASTER_ID, 2);
+    Start(&clientA, CAN2, UCAN_ROLE_CLIENT, CLIENT_A_ID, 2);
+    Start(&clientB, CAN3, UCAN_ROLE_CLIENT, CLIENT_B_ID, clientBListSize);
+    masterAlive = 1;
+}
+
+static void Poll(Node* node)
+{
+    (void)uCAN_SendAll(&node->ucan);
+
+    while (HAL_CAN_GetRxFifoFillLevel(&node->hcan, CAN_RX_FIFO0) > 0U)
+    {
+        node->rejected += (uCAN_Update(&node->ucan) == UCAN_ERROR);
+    }
+
+    (void)uCAN_Handshake(&node->ucan);
+}
+
+/**
+  * @brief  Runs every node for one millisecond; a dead master neither sends nor reads.
+  */
+static void Step(void)
+{
+    HostCan_Advance(1);
+
+    if (masterAlive)
+    {
+        Poll(&master);
+    }
+    else
+    {
+        // Frames to a dead controller are lost
+        while (HAL_CAN_GetRxFifoFillLevel(&master.hcan, CAN_RX_FIFO0) > 0U)
+        {
+            CAN_RxHeaderTypeDef header;
+            uint8_t data[8];
+            (void)HAL_CAN_GetRxMessage(&master.hcan, CAN_RX_FIFO0, &header, data);
+        }
+    }
+
+    Poll(&clientA);
+    Poll(&clientB);
+}
+
+static void Run(uint32_t ms)
+{
+    for (uint32_t t = 0; t < ms; t++)
+    {
+        Step();
+    }
+}
+
+static void TestMasterLoss(void)
+{
+    Setup(2);
+
+    // No broadcast applied yet, nobody is known ACTIVE
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&clientB.ucan, CLIENT_A_ID) == UCAN_NO_CONNECTION);
+
+    Run(3U * UCAN_MEMBERSHIP_INTERVAL_MS);
+
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&master.ucan, CLIENT_A_ID) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&clientB.ucan, CLIENT_A_ID) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&clientA.ucan, CLIENT_B_ID) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&clientB.ucan, OTHER_ID) == UCAN_ERROR_UNKNOWN_ID);
+    UCAN_TEST_CHECK(clientA.rejected == 0U && clientB.rejected == 0U);
+
+    // Master dies
+    masterAlive = 0;
+    uint32_t expiredAfter = 0;
+
+    while (uCAN_IsClientActive(&clientB.ucan, CLIENT_A_ID) == UCAN_OK && expiredAfter < 10000U)
+    {
+        Step();
+        expiredAfter++;
+    }
+
+    // Last broadcast came at most one interval before the master died
+    UCAN_TEST_CHECK(expiredAfter >= UCAN_HANDSHAKE_LOST_MS - UCAN_MEMBERSHIP_INTERVAL_MS);
+    UCAN_TEST_CHECK(expiredAfter <= UCAN_HANDSHAKE_LOST_MS);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&clientA.ucan, CLIENT_B_ID) == UCAN_NO_CONNECTION);
+
+    // Stays expired while the master is away
+    Run(UCAN_HANDSHAKE_LOST_MS);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&clientB.ucan, CLIENT_A_ID) == UCAN_NO_CONNECTION);
+
+    // Master back: view restored with its next broadcast
+    masterAlive = 1;
+    uint32_t restoredAfter = 0;
+
+    while (uCAN_IsClientActive(&clientB.ucan, CLIENT_A_ID) != UCAN_OK && restoredAfter < 10000U)
+    {
+        Step();
+        restoredAfter++;
+    }
+
+    // Clients timed out on the master meanwhile: one ping to see them, one broadcast to share it
+    UCAN_TEST_CHECK(restoredAfter <= UCAN_HANDSHAKE_INTERVAL_MS + UCAN_MEMBERSHIP_INTERVAL_MS);
+
+    printf("  master loss: view expired %u ms after the master died, restored %u ms after it came back\n",
+           (unsigned)expiredAfter, (unsigned)restoredAfter);
+}
+
+static void TestClientListMismatch(void)
+{
+    // Client B knows a client the others do not, its bit positions differ
+    Setup(3);
+    Run(3U * UCAN_MEMBERSHIP_INTERVAL_MS);
+
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&master.ucan, CLIENT_B_ID) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&clientA.ucan, CLIENT_B_ID) == UCAN_OK);
+    UCAN_TEST_CHECK(clientA.rejected == 0U);
+
+    // Every broadcast rejected, no peer reported ACTIVE
+    UCAN_TEST_CHECK(clientB.rejected >= 2U);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&clientB.ucan, CLIENT_A_ID) == UCAN_NO_CONNECTION);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&clientB.ucan, CLIENT_B_ID) == UCAN_NO_CONNECTION);
+    UCAN_TEST_CHECK(clientB.ucan.node.membership[0] == 0U);
+}
+
+int main(void)
+{
+    TestMasterLoss();
+    TestClientListMismatch();
+
+    return UCAN_TEST_RESULT("test_membership");
+}
@@ -0,0 +1,185 @@
+/**
+  ******************************************************************************
+  * @file    test_redundant.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the duplicate filter of redundant dual-bus operation.
+  *
+  * A handle with a primary and a redundant controller receives frames on both
+  * buses, injected straight into the RX FIFOs. Checks that:
+  *  - a packet with a rolling counter delivers every frame once, even when it
+  *    repeats an unchanged value every millisecond or one bus runs a few
+  *    frames ahead of the other;
+  *  - every frame still arrives when only one bus carries traffic;
+  *  - a packet without a counter drops the second copy of a payload within
+  *    UCAN_REDUNDANT_WINDOW_MS and takes it again once the window has passed.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define COUNTED_ID		0x120U
+#define PLAIN_ID		0x130U
+
+static CAN_HandleTypeDef hcan1;
+static CAN_HandleTypeDef hcan2;
+static UCAN_HandleTypeDef ucan;
+
+static UCAN_Client clients[1] = { { .id = 0x7F0 } };
+static UCAN_Packet txPackets[1];
+static UCAN_Packet rxPackets[2];
+static uint8_t txValue;
+static uint16_t torque;
+static uint8_t alive;
+static uint8_t plain;
+static uint32_t countedFrames;
+static uint32_t plainFrames;
+
+static void CountFrame(const uint8_t* payload, uint8_t dlc, uint32_t ts, void* ctx)
+{
+    (*(uint32_t*)ctx)++;
+}
+
+/**
+  * @brief  Starts a handle on CAN1 and CAN2 with one RX packet carrying a counter in byte 2 and one without.
+  */
+static void Setup(void)
+{
+    HostCan_Reset();
+    memset(&ucan, 0, sizeof(ucan));
+    countedFrames = 0;
+    plainFrames = 0;
+
+    hcan1.Instance = CAN1;
+    hcan2.Instance = CAN2;
+    ucan.hcan = &hcan1;
+    ucan.hcanRedundant = &hcan2;
+    ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_NONE, .selfId = 0x7E0, .clients = clients, .clientCount = 1 };
+    ucan.txHolder = (UCAN_PacketHolder){ .packets = txPackets, .count = 1 };
+    ucan.rxHolder = (UCAN_PacketHolder){ .packets = rxPackets, .count = 2 };
+
+    UCAN_PacketConfig txConfig[1] = {
+        { .id = 0x7E1, .item_count = 1, .items = { { &txValue, UCAN_U8 } } },
+    };
+    UCAN_PacketConfig rxConfig[2] = {
+        { .id = COUNTED_ID, .item_count = 2, .items = { { &torque, UCAN_U16 }, { &alive, UCAN_U8 } },
+          .handler = CountFrame, .context = &countedFrames, .seqByte = UCAN_SEQ_BYTE(2) },
+        { .id = PLAIN_ID, .item_count = 1, .items = { { &plain, UCAN_U8 } },
+          .handler = CountFrame, .context = &plainFrames },
+    };
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&ucan) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&ucan, &config) == UCAN_OK);
+}
+
+static void Drain(void)
+{
+    while (HAL_CAN_GetRxFifoFillLevel(&hcan1, CAN_RX_FIFO0) > 0U || HAL_CAN_GetRxFifoFillLevel(&hcan2, CAN_RX_FIFO0) > 0U)
+    {
+        (void)uCAN_Update(&ucan);
+    }
+}
+
+static void TestFastUnchangedFrames(void)
+{
+    Setup();
+
+    // 1 kHz frames of a constant torque, both copies inside the window every time
+    for (uint32_t i = 0; i < 100U; i++)
+    {
+        uint8_t data[3] = { 0x34, 0x12, (uint8_t)i };
+
+        HostCan_Advance(1);
+        HostCan_Inject((i & 1U) ? &hcan2 : &hcan1, COUNTED_ID, 3, data);
+        HostCan_Inject((i & 1U) ? &hcan1 : &hcan2, COUNTED_ID, 3, data);
+        Drain();
+    }
+
+    UCAN_TEST_CHECK(countedFrames == 100U);
+    UCAN_TEST_CHECK(torque == 0x1234U && alive == 99U);
+
+    UCAN_BusHealth bus1;
+    UCAN_BusHealth bus2;
+    UCAN_TEST_CHECK(uCAN_GetBusHealth(&ucan, 0, &bus1) == UCAN_OK && uCAN_GetBusHealth(&ucan, 1, &bus2) == UCAN_OK);
+    UCAN_TEST_CHECK(bus1.rxDuplicates + bus2.rxDuplicates == 100U);
+
+    // Several frames in a row on one bus before the copies follow on the other
+    uint8_t first[3] = { 0x34, 0x12, 100 };
+    uint8_t second[3] = { 0x34, 0x12, 101 };
+    HostCan_Inject(&hcan1, COUNTED_ID, 3, first);
+    HostCan_Inject(&hcan1, COUNTED_ID, 3, second);
+    Drain();
+    HostCan_Inject(&hcan2, COUNTED_ID, 3, first);
+    HostCan_Inject(&hcan2, COUNTED_ID, 3, second);
+    Drain();
+
+    // Both late copies are behind the counter of the first bus
+    UCAN_TEST_CHECK(countedFrames == 102U);
+
+    // Counter running ahead on the lagging bus is a new frame again
+    uint8_t third[3] = { 0x34, 0x12, 102 };
+    HostCan_Inject(&hcan2, COUNTED_ID, 3, third);
+    Drain();
+    HostCan_Inject(&hcan1, COUNTED_ID, 3, third);
+    Drain();
+    UCAN_TEST_CHECK(countedFrames == 103U);
+}
+
+static void TestSingleBus(void)
+{
+    Setup();
+
+    // Second bus lost: repeated payloads on one bus are never copies
+    for (uint32_t i = 0; i < 100U; i++)
+    {
+        uint8_t data[3] = { 0x34, 0x12, (uint8_t)i };
+        uint8_t value = 7;
+
+        HostCan_Advance(1);
+        HostCan_Inject(&hcan1, COUNTED_ID, 3, data);
+        HostCan_Inject(&hcan1, PLAIN_ID, 1, &value);
+        Drain();
+    }
+
+    UCAN_TEST_CHECK(countedFrames == 100U);
+    UCAN_TEST_CHECK(plainFrames == 100U);
+}
+
+static void TestPayloadWindow(void)
+{
+    Setup();
+
+    uint8_t value = 7;
+
+    // Copy within the window is dropped
+    HostCan_Inject(&hcan1, PLAIN_ID, 1, &value);
+    HostCan_Advance(UCAN_REDUNDANT_WINDOW_MS);
+    HostCan_Inject(&hcan2, PLAIN_ID, 1, &value);
+    Drain();
+    UCAN_TEST_CHECK(plainFrames == 1U);
+
+    // Same payload after the window is a new frame
+    HostCan_Advance(UCAN_REDUNDANT_WINDOW_MS + 1U);
+    HostCan_Inject(&hcan1, PLAIN_ID, 1, &value);
+    Drain();
+    UCAN_TEST_CHECK(plainFrames == 2U);
+
+    // Changed payload on the other bus is a new frame
+    value = 8;
+    HostCan_Inject(&hcan2, PLAIN_ID, 1, &value);
+    Drain();
+    UCAN_TEST_CHECK(plainFrames == 3U && plain == 8U);
+}
+
+int main(void)
+{
+    TestFastUnchangedFrames();
+    TestSingleBus();
+    TestPayloadWindow();
+
+    return UCAN_TEST_RESULT("test_redundant");
+}
@@ -0,0 +1,399 @@
+/**
+  ******************************************************************************
+  * @file    test_schedule.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the time-triggered transmit schedule.
+  *
+  * A time master and a client share one simulated bus and a fake microsecond
+  * time source, advanced in steps of STEP_US. The client reads the reference
+  * message one frame length after it was sent, as the RX interrupt after its
+  * last bit would, so both place the cycle at the same time. Checks that:
+  *  - the master starts a basic cycle every cycleUs and a client without a
+  *    reference stays silent;
+  *  - every window fires at its offset, in the cycles its repeat and
+  *    cycleOffset select, and uCAN_SendAll() never sends scheduled packets;
+  *  - a late tick is reported in lastLateUs and maxLateUs, and a tick too
+  *    late for the frame to end before the next window counts the window as
+  *    missed instead of sending;
+  *  - the client goes silent once the reference is lost and resumes with the
+  *    next reference.
+  *
+  * Built a second time as test_schedule_latency with UCAN_CFG_LATENCY=1,
+  * which also checks that the window of a traced packet is sized for the
+  * frame with its latency trailer, and rejected where only the bare payload
+  * would fit.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define REFERENCE_ID	0x080U
+#define CYCLE_US		1000U
+#define STEP_US			10U
+#define WINDOWS			3U
+
+/**
+  * @brief  Node with its schedule, up to three TX packets and HAL handle.
+  */
+typedef struct {
+    CAN_HandleTypeDef hcan;
+    UCAN_HandleTypeDef ucan;
+    UCAN_Schedule schedule;
+    UCAN_ScheduleWindow windows[WINDOWS];
+    UCAN_Packet tx[WINDOWS];
+    UCAN_Packet rx[WINDOWS];
+    uint8_t txValues[WINDOWS];
+    uint8_t rxValues[WINDOWS];
+    uint32_t seen;
+} Node;
+
+static Node master;
+static Node client;
+static UCAN_Client clients[1] = { { .id = 0x7F0 } };
+static uint32_t fakeUs;
+static uint8_t masterAlive;
+static uint32_t referenceAt;
+
+// Client windows: every cycle, odd cycles, every fourth cycle from cycle 2
+static const UCAN_ScheduleWindow clientWindows[WINDOWS] = {
+    { .id = 0x300, .offsetUs = 200, .repeat = 1, .cycleOffset = 0 },
+    { .id = 0x301, .offsetUs = 400, .repeat = 2, .cycleOffset = 1 },
+    { .id = 0x302, .offsetUs = 600, .repeat = 4, .cycleOffset = 2 },
+};
+
+// Client frames per window, frames off their offset or cycle
+static uint32_t clientSent[WINDOWS];
+static uint32_t misplaced;
+
+// Client ticks skipped in cycle skipCycle between skipFromUs and skipToUs
+static uint8_t skipCycle;
+static uint32_t skipFromUs;
+static uint32_t skipToUs;
+
+static uint32_t NowUs(void)
+{
+    return fakeUs;
+}
+
+/**
+  * @brief  Starts a node; the master has one window at 800 us, the client the clientWindows.
+  */
+static void Start(Node* node, CAN_TypeDef* instance, uint8_t timeMaster)
+{
+    memset(node, 0, sizeof(*node));
+    node->hcan.Instance = instance;
+
+    node->ucan.hcan = &node->hcan;
+    node->ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_NONE, .selfId = 0x7E0, .clients = clients, .clientCount = 1 };
+    node->ucan.schedule = &node->schedule;
+
+    UCAN_PacketConfig txConfig[WINDOWS];
+    UCAN_PacketConfig rxConfig[WINDOWS];
+    uint32_t txCount = timeMaster ? 1U : WINDOWS;
+    uint32_t rxCount = timeMaster ? WINDOWS : 1U;
+
+    memset(txConfig, 0, sizeof(txConfig));
+    memset(rxConfig, 0, sizeof(rxConfig));
+
+    if (timeMaster)
+    {
+        node->windows[0] = (UCAN_ScheduleWindow){ .id = 0x200, .offsetUs = 800, .repeat = 1 };
+    }
+    else
+    {
+        memcpy(node->windows, clientWindows, sizeof(clientWindows));
+    }
+
+    for (uint32_t i = 0; i < WINDOWS; i++)
+    {
+        uint32_t masterId = 0x200U;
+        uint32_t clientId = clientWindows[i].id;
+
+        txConfig[i] = (UCAN_PacketConfig){ .id = timeMaster ? masterId : clientId, .item_count = 1, .items = { { &node->txValues[i], UCAN_U8 } } };
+        rxConfig[i] = (UCAN_PacketConfig){ .id = timeMaster ? clientId : masterId, .item_count = 1, .items = { { &node->rxValues[i], UCAN_U8 } } };
+    }
+
+    node->ucan.txHolder = (UCAN_PacketHolder){ .packets = node->tx, .count = txCount };
+    node->ucan.rxHolder = (UCAN_PacketHolder){ .packets = node->rx, .count = rxCount };
+    node->schedule = (UCAN_Schedule){ .referenceId = REFERENCE_ID, .cycleUs = CYCLE_US, .timeMaster = timeMaster, .nowUs = NowUs,
+                                      .windows = node->windows, .windowCount = timeMaster ? 1U : WINDOWS };
+
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&node->ucan) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&node->ucan, &config) == UCAN_OK);
+}
+
+static void Setup(void)
+{
+    HostCan_Reset();
+    fakeUs = 0;
+    referenceAt = 0;
+    misplaced = 0;
+    skipCycle = 0;
+    memset(clientSent, 0, sizeof(clientSent));
+
+    Start(&master, CAN1, 1);
+    Start(&client, CAN2, 0);
+    masterAlive = 1;
+
+    // 65 bit times at 500 kbit/s
+    UCAN_TEST_CHECK(client.schedule.refLengthUs == UCAN_FRAME_BITS(1U) * 2U);
+}
+
+static void Drain(Node* node)
+{
+    while (HAL_CAN_GetRxFifoFillLevel(&node->hcan, CAN_RX_FIFO0) > 0U)
+    {
+        (void)uCAN_Update(&node->ucan);
+    }
+}
+
+/**
+  * @brief  Checks the frames the client sent in this step against its windows.
+  */
+static void RecordClient(void)
+{
+    uint32_t elapsed = fakeUs - master.schedule.cycleStartUs;
+    uint8_t cycle = master.schedule.cycleCount;
+
+    for (; client.seen < HostCan_SentCount(&client.hcan); client.seen++)
+    {
+        uint32_t id = HostCan_Sent(&client.hcan, client.seen)->header.StdId;
+
+        for (uint32_t w = 0; w < WINDOWS; w++)
+        {
+            const UCAN_ScheduleWindow* window = &clientWindows[w];
+
+            if (id == window->id)
+            {
+                clientSent[w]++;
+                misplaced += (elapsed < window->offsetUs || ((uint8_t)(cycle - window->cycleOffset) & (window->repeat - 1U)) != 0);
+            }
+        }
+    }
+}
+
+/**
+  * @brief  Advances the time source by STEP_US and runs both nodes.
+  * @retval Status of the client's uCAN_ScheduleTick(), UCAN_OK if it was skipped.
+  */
+static UCAN_StatusTypeDef Step(void)
+{
+    UCAN_StatusTypeDef status = UCAN_OK;
+    uint32_t nextUs;
+
+    fakeUs += STEP_US;
+
+    if (masterAlive)
+    {
+        uint32_t sent = HostCan_SentCount(&master.hcan);
+
+        (void)uCAN_ScheduleTick(&master.ucan, &nextUs);
+
+        for (; sent < HostCan_SentCount(&master.hcan); sent++)
+        {
+            if (HostCan_Sent(&master.hcan, sent)->header.StdId == REFERENCE_ID)
+            {
+                // Received by the client after its last bit
+                referenceAt = fakeUs + master.schedule.refLengthUs;
+            }
+        }
+
+        Drain(&master);
+    }
+
+    if (referenceAt != 0U && fakeUs >= referenceAt)
+    {
+        referenceAt = 0;
+        Drain(&client);
+    }
+
+    uint32_t elapsed = fakeUs - master.schedule.cycleStartUs;
+
+    if (!(master.schedule.cycleCount == skipCycle && elapsed >= skipFromUs && elapsed < skipToUs))
+    {
+        status = uCAN_ScheduleTick(&client.ucan, &nextUs);
+    }
+
+    RecordClient();
+
+    return status;
+}
+
+static void Run(uint32_t cycles)
+{
+    for (uint32_t i = 0; i < cycles * (CYCLE_US / STEP_US); i++)
+    {
+        (void)Step();
+    }
+}
+
+static void TestWindows(void)
+{
+    uint32_t nextUs;
+
+    Setup();
+
+    // No reference yet: the client stays silent
+    masterAlive = 0;
+    UCAN_TEST_CHECK(uCAN_ScheduleTick(&client.ucan, &nextUs) == UCAN_NO_CONNECTION && nextUs == CYCLE_US);
+    Run(2);
+    UCAN_TEST_CHECK(HostCan_SentCount(&client.hcan) == 0U);
+
+    // Scheduled packets never leave through uCAN_SendAll()
+    (void)uCAN_SendAll(&client.ucan);
+    UCAN_TEST_CHECK(HostCan_SentCount(&client.hcan) == 0U);
+
+    // 16 basic cycles, cycle counter 1 to 16
+    masterAlive = 1;
+    Run(16);
+
+    UCAN_TEST_CHECK(master.schedule.cycles == 16U && client.schedule.cycles == 16U);
+    UCAN_TEST_CHECK(client.schedule.cycleStartUs == master.schedule.cycleStartUs);
+    UCAN_TEST_CHECK(HostCan_SentCount(&master.hcan) == 2U * 16U);
+    UCAN_TEST_CHECK(clientSent[0] == 16U && clientSent[1] == 8U && clientSent[2] == 4U);
+    UCAN_TEST_CHECK(misplaced == 0U);
+
+    for (uint32_t w = 0; w < WINDOWS; w++)
+    {
+        UCAN_TEST_CHECK(client.windows[w].lastLateUs == 0U && client.windows[w].maxLateUs == 0U && client.windows[w].missed == 0U);
+    }
+
+    UCAN_TEST_CHECK(master.windows[0].missed == 0U);
+}
+
+static void TestLateAndMissed(void)
+{
+    UCAN_ScheduleWindow* first = &client.windows[0];
+
+    // Tick 50 us late: the frame still ends before the next window
+    skipCycle = (uint8_t)(master.schedule.cycleCount + 1U);
+    skipFromUs = first->offsetUs;
+    skipToUs = first->offsetUs + 45U;
+    Run(1);
+
+    UCAN_TEST_CHECK(clientSent[0] == 17U && first->lastLateUs == 50U && first->maxLateUs == 50U && first->missed == 0U);
+
+    // On time again, the largest delay is kept
+    Run(1);
+    UCAN_TEST_CHECK(clientSent[0] == 18U && first->lastLateUs == 0U && first->maxLateUs == 50U);
+
+    // Tick 80 us late: 280 + 130 us runs into the window at 400 us, missed
+    skipCycle = (uint8_t)(master.schedule.cycleCount + 1U);
+    skipToUs = first->offsetUs + 80U;
+    Run(1);
+
+    UCAN_TEST_CHECK(clientSent[0] == 18U && first->missed == 1U && first->maxLateUs == 50U);
+    UCAN_TEST_CHECK(client.windows[1].missed == 0U && client.windows[2].missed == 0U);
+    UCAN_TEST_CHECK(misplaced == 0U);
+
+    skipCycle = 0;
+
+    printf("  schedule: window 0x%03X sent %u times, lastLateUs %u, maxLateUs %u, missed %u\n",
+           (unsigned)first->id, (unsigned)clientSent[0], (unsigned)first->lastLateUs, (unsigned)first->maxLateUs, (unsigned)first->missed);
+}
+
+static void TestReferenceLoss(void)
+{
+    UCAN_StatusTypeDef status = UCAN_OK;
+    uint32_t silentFromUs = 0;
+
+    // Master stops, the client sends nothing more
+    masterAlive = 0;
+    uint32_t sent = HostCan_SentCount(&client.hcan);
+    uint32_t lostAt = master.schedule.cycleStartUs;
+
+    for (uint32_t i = 0; i < 10U * (CYCLE_US / STEP_US); i++)
+    {
+        status = Step();
+
+        if (status == UCAN_NO_CONNECTION && silentFromUs == 0U)
+        {
+            silentFromUs = fakeUs - lostAt;
+        }
+    }
+
+    UCAN_TEST_CHECK(HostCan_SentCount(&client.hcan) == sent);
+    UCAN_TEST_CHECK(status == UCAN_NO_CONNECTION);
+    UCAN_TEST_CHECK(silentFromUs == 2U * CYCLE_US);
+
+    // Master back: the next reference restarts the client's windows
+    masterAlive = 1;
+    uint32_t before = clientSent[0];
+    Run(4);
+
+    UCAN_TEST_CHECK(clientSent[0] == before + 4U);
+    UCAN_TEST_CHECK(misplaced == 0U);
+
+    printf("  schedule: reference lost, client reports no connection %u us after the last cycle start\n", (unsigned)silentFromUs);
+}
+
+#if UCAN_CFG_LATENCY
+/**
+  * @brief  Starts a client with one traced 4-byte packet in a window at 200 us.
+  * @retval Status of uCAN_Start().
+  */
+static UCAN_StatusTypeDef StartTraced(uint32_t cycleUs)
+{
+    static UCAN_LatencyStats latency;
+
+    memset(&client, 0, sizeof(client));
+    client.hcan.Instance = CAN2;
+    client.ucan.hcan = &client.hcan;
+    client.ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_NONE, .selfId = 0x7E0, .clients = clients, .clientCount = 1 };
+    client.ucan.schedule = &client.schedule;
+    client.ucan.txHolder = (UCAN_PacketHolder){ .packets = client.tx, .count = 1 };
+    client.ucan.rxHolder = (UCAN_PacketHolder){ .packets = client.rx, .count = 1 };
+    client.windows[0] = (UCAN_ScheduleWindow){ .id = 0x300, .offsetUs = 200, .repeat = 1 };
+    client.schedule = (UCAN_Schedule){ .referenceId = REFERENCE_ID, .cycleUs = cycleUs, .nowUs = NowUs,
+                                       .windows = client.windows, .windowCount = 1 };
+
+    UCAN_PacketConfig txConfig[1] = {
+        { .id = 0x300, .item_count = 4, .items = { { &client.txValues[0], UCAN_U8 }, { &client.txValues[1], UCAN_U8 },
+          { &client.txValues[2], UCAN_U8 }, { &client.rxValues[0], UCAN_U8 } }, .latency = &latency },
+    };
+    UCAN_PacketConfig rxConfig[1] = {
+        { .id = 0x200, .item_count = 1, .items = { { &client.rxValues[1], UCAN_U8 } } },
+    };
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&client.ucan) == UCAN_OK);
+
+    return uCAN_Start(&client.ucan, &config);
+}
+
+static void TestLatencyTrailer(void)
+{
+    uint32_t bare = UCAN_FRAME_BITS(4U) * 2U;
+    uint32_t traced = UCAN_FRAME_BITS(4U + UCAN_LATENCY_TRAILER_DLC) * 2U;
+
+    HostCan_Reset();
+
+    // Room for the 4 payload bytes, not for the trailer behind them
+    UCAN_TEST_CHECK(StartTraced(200U + bare + (traced - bare) / 2U) == UCAN_INVALID_PARAM);
+
+    // Window sized for all 8 bytes on the wire
+    UCAN_TEST_CHECK(StartTraced(200U + traced) == UCAN_OK);
+    UCAN_TEST_CHECK(client.windows[0].lengthUs == traced);
+}
+#endif
+
+int main(void)
+{
+    TestWindows();
+    TestLateAndMissed();
+    TestReferenceLoss();
+
+#if UCAN_CFG_LATENCY
+    TestLatencyTrailer();
+
+    return UCAN_TEST_RESULT("test_schedule_latency");
+#else
+    return UCAN_TEST_RESULT("test_schedule");
+#endif
+}
@@ -0,0 +1,129 @@
+/**
+  ******************************************************************************
+  * @file    test_sim.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the multi-threaded discrete-event simulator.
+  *
+  * Runs a ring of BUSES buses of NODES uCAN handles with host_sim.c. Checks
+  * that:
+  *  - every node sends once per period, every frame reaches the RX packets
+  *    bound to it, and the gateways carry the frames of node 1 around the
+  *    ring, with no refused call and no overrun;
+  *  - one, two, three and one worker per bus give the same frames at the
+  *    same times and the same decoded values (same digest and totals), and
+  *    so does a second run with the same seed;
+  *  - another seed gives another run;
+  *  - invalid parameters are rejected.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "host_sim.h"
+#include "ucan_test.h"
+
+#define BUSES			6U
+#define NODES			8U
+#define PERIOD_US		10000U
+#define JITTER_US		500U
+#define DURATION_US		500000U
+
+static HostSim_Config Config(uint32_t workers, uint32_t seed)
+{
+    return (HostSim_Config){ .buses = BUSES, .nodesPerBus = NODES, .workers = workers, .periodUs = PERIOD_US,
+                             .jitterUs = JITTER_US, .durationUs = DURATION_US, .seed = seed };
+}
+
+static uint8_t Same(const HostSim_Result* a, const HostSim_Result* b)
+{
+    return a->digest == b->digest && a->frames == b->frames && a->received == b->received &&
+           a->forwarded == b->forwarded && a->refused == b->refused && a->overruns == b->overruns &&
+           a->windows == b->windows;
+}
+
+static void TestTraffic(HostSim_Result* reference)
+{
+    HostSim_Config config = Config(1, 1);
+
+    UCAN_TEST_CHECK(HostSim_Run(&config, reference) == 0);
+    UCAN_TEST_CHECK(reference->refused == 0U && reference->overruns == 0U);
+    UCAN_TEST_CHECK(reference->windows == DURATION_US / HOST_SIM_GATEWAY_DELAY_US);
+
+    // Node 1 of every bus sends a frame per period, each one is forwarded
+    uint64_t nodes = BUSES * NODES;
+    uint64_t leastPerNode = DURATION_US / (PERIOD_US + JITTER_US);
+    uint64_t mostPerNode = DURATION_US / PERIOD_US + 1U;
+
+    UCAN_TEST_CHECK(reference->forwarded >= BUSES * leastPerNode && reference->forwarded <= BUSES * mostPerNode);
+
+    // Own frames reach both neighbours, gateway frames every node but the gateway;
+    // forwards still in flight at the end were not sent again
+    uint64_t gatewayFrames = (reference->received - 2U * reference->frames) / (NODES - 3U);
+    uint64_t nodeFrames = reference->frames - gatewayFrames;
+
+    UCAN_TEST_CHECK(reference->received == 2U * nodeFrames + (NODES - 1U) * gatewayFrames);
+    UCAN_TEST_CHECK(nodeFrames >= nodes * leastPerNode && nodeFrames <= nodes * mostPerNode);
+    UCAN_TEST_CHECK(gatewayFrames <= reference->forwarded && gatewayFrames + 2U * BUSES >= reference->forwarded);
+}
+
+static void TestDeterminism(const HostSim_Result* reference)
+{
+    static const uint32_t workers[] = { 1, 2, 3, BUSES };
+    HostSim_Result result;
+
+    for (uint32_t i = 0; i < sizeof(workers) / sizeof(workers[0]); i++)
+    {
+        HostSim_Config config = Config(workers[i], 1);
+
+        UCAN_TEST_CHECK(HostSim_Run(&config, &result) == 0);
+        UCAN_TEST_CHECK(Same(&result, reference));
+    }
+
+    HostSim_Config other = Config(2, 2);
+
+    UCAN_TEST_CHECK(HostSim_Run(&other, &result) == 0);
+    UCAN_TEST_CHECK(result.digest != reference->digest);
+
+    printf("  sim: %u nodes on %u buses, %llu frames, %llu forwarded, same digest with 1, 2, 3 and %u workers\n",
+           (unsigned)(BUSES * NODES), (unsigned)BUSES, (unsigned long long)reference->frames,
+           (unsigned long long)reference->forwarded, (unsigned)BUSES);
+}
+
+static void TestInvalid(void)
+{
+    HostSim_Result result;
+    HostSim_Config config = Config(1, 1);
+
+    UCAN_TEST_CHECK(HostSim_Run(NULL, &result) == -1);
+
+    config.workers = 0;
+    UCAN_TEST_CHECK(HostSim_Run(&config, &result) == -1);
+    config.workers = BUSES + 1U;
+    UCAN_TEST_CHECK(HostSim_Run(&config, &result) == -1);
+
+    config = Config(1, 1);
+    config.nodesPerBus = 2;
+    UCAN_TEST_CHECK(HostSim_Run(&config, &result) == -1);
+    config.nodesPerBus = HOST_SIM_MAX_NODES_PER_BUS + 1U;
+    UCAN_TEST_CHECK(HostSim_Run(&config, &result) == -1);
+
+    // More nodes than simulated controllers
+    config = Config(1, 1);
+    config.buses = HOST_CAN_INSTANCES / NODES + 1U;
+    UCAN_TEST_CHECK(HostSim_Run(&config, &result) == -1);
+
+    config = Config(1, 1);
+    config.periodUs = 0;
+    UCAN_TEST_CHECK(HostSim_Run(&config, &result) == -1);
+}
+
+int main(void)
+{
+    HostSim_Result reference;
+
+    TestTraffic(&reference);
+    TestDeterminism(&reference);
+    TestInvalid();
+
+    return UCAN_TEST_RESULT("test_sim");
+}
@@ -0,0 +1,180 @@
+/**
+  ******************************************************************************
+  * @file    test_timing.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the 64-bit extension of the hardware timestamps.
+  *
+  * Built with UCAN_CFG_HW_TIMESTAMP=1. The simulated controllers stamp frames
+  * with the 16-bit TTCM counter of a 500 kbit/s bus, which wraps every
+  * 131 ms. Checks that:
+  *  - uCAN_Runtime_ExtendTimestamp() snaps every event to its true time
+  *    across gaps of less than one wrap, just over one wrap and many wraps,
+  *    while the event is processed up to just under half a wrap late, and
+  *    right after startup when no earlier wrap exists;
+  *  - a tick running backwards does not move the prediction backwards, and
+  *    processing more than half a wrap late misplaces the event by exactly
+  *    one wrap (the documented limit);
+  *  - uCAN_GetPacketTiming() reports the time, period and jitter of RX
+  *    frames and of TX confirmations of uCAN_TxComplete() whose periods are
+  *    longer than a wrap, in microseconds.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "ucan_runtime.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define RX_ID			0x100U
+#define TX_ID			0x200U
+#define WRAP_BITS		0x10000U
+#define HALF_WRAP_MS	(WRAP_BITS / 2U / HOST_CAN_BITS_PER_MS)
+#define US_PER_BIT		(1000U / HOST_CAN_BITS_PER_MS)
+
+static CAN_HandleTypeDef hcan;
+static UCAN_HandleTypeDef ucan;
+static UCAN_Client clients[1] = { { .id = 0x7F0 } };
+static UCAN_Packet txPackets[1];
+static UCAN_Packet rxPackets[1];
+static uint8_t txValue;
+static uint8_t rxValue;
+
+/**
+  * @brief  Extends the event at bit time `bits`, processed `lateMs` after its millisecond.
+  * @retval Non-zero if the event was placed at `bits`.
+  */
+static uint8_t Extends(UCAN_HwClock* clock, uint64_t bits, uint32_t lateMs)
+{
+    uint32_t tick = (uint32_t)(bits / HOST_CAN_BITS_PER_MS) + lateMs;
+
+    return uCAN_Runtime_ExtendTimestamp(clock, (uint16_t)bits, tick) == bits;
+}
+
+static void TestExtend(void)
+{
+    UCAN_HwClock clock = { .bitRate = HOST_CAN_BITS_PER_MS * 1000U };
+    uint64_t bits = 0;
+
+    // Just before the first wrap, nothing earlier to snap back to
+    UCAN_TEST_CHECK(Extends(&clock, 0xFFF0U, 0));
+    bits = 0xFFF0U;
+
+    // Gaps of one bit, under one wrap, just over one wrap and many wraps
+    static const uint64_t gaps[] = { 1U, 500U, WRAP_BITS - 1U, WRAP_BITS + 1U, 3U * WRAP_BITS + 12345U, 1000000U, 30000000U };
+
+    for (uint32_t i = 0; i < sizeof(gaps) / sizeof(gaps[0]); i++)
+    {
+        bits += gaps[i];
+        UCAN_TEST_CHECK(Extends(&clock, bits, 0));
+    }
+
+    // Processed late, up to just under half a wrap, between events processed on time
+    for (uint32_t late = 1; late < HALF_WRAP_MS; late += 5U)
+    {
+        bits += 70000U + late;
+        UCAN_TEST_CHECK(Extends(&clock, bits, late));
+        bits += 70000U;
+        UCAN_TEST_CHECK(Extends(&clock, bits, 0));
+    }
+
+    // Processed in the same millisecond as the previous event, then with a tick behind it
+    bits += 300U;
+    UCAN_TEST_CHECK(Extends(&clock, bits, 0));
+    bits += 100U;
+    UCAN_TEST_CHECK(uCAN_Runtime_ExtendTimestamp(&clock, (uint16_t)bits, clock.lastTick - 10U) == bits);
+
+    // More than half a wrap late: placed one wrap later than it happened
+    bits += 1000U;
+    uint32_t tooLate = HALF_WRAP_MS + 5U;
+    uint32_t tick = (uint32_t)(bits / HOST_CAN_BITS_PER_MS) + tooLate;
+    UCAN_TEST_CHECK(uCAN_Runtime_ExtendTimestamp(&clock, (uint16_t)bits, tick) == bits + WRAP_BITS);
+}
+
+/**
+  * @brief  Starts a handle with one RX and one TX packet, clock started at tick 0.
+  */
+static void Setup(void)
+{
+    HostCan_Reset();
+    memset(&ucan, 0, sizeof(ucan));
+
+    hcan.Instance = CAN1;
+    ucan.hcan = &hcan;
+    ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_NONE, .selfId = 0x7E0, .clients = clients, .clientCount = 1 };
+    ucan.txHolder = (UCAN_PacketHolder){ .packets = txPackets, .count = 1 };
+    ucan.rxHolder = (UCAN_PacketHolder){ .packets = rxPackets, .count = 1 };
+
+    UCAN_PacketConfig txConfig[1] = {
+        { .id = TX_ID, .item_count = 1, .items = { { &txValue, UCAN_U8 } } },
+    };
+    UCAN_PacketConfig rxConfig[1] = {
+        { .id = RX_ID, .item_count = 1, .items = { { &rxValue, UCAN_U8 } } },
+    };
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&ucan) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&ucan, &config) == UCAN_OK);
+}
+
+static void TestPacketTiming(void)
+{
+    UCAN_PacketTimingResult result;
+    uint8_t data[1] = { 0 };
+
+    Setup();
+
+    UCAN_TEST_CHECK(uCAN_GetPacketTiming(&ucan, RX_ID, &result) == UCAN_NO_CHANGED_VAL);
+    UCAN_TEST_CHECK(uCAN_GetPacketTiming(&ucan, 0x300, &result) == UCAN_ERROR_UNKNOWN_ID);
+    UCAN_TEST_CHECK(uCAN_GetPacketTiming(&ucan, RX_ID, NULL) == UCAN_INVALID_PARAM);
+
+    // RX every 200 ms (longer than a wrap), start of frame alternately 0 and 150 bits into
+    // the millisecond, read up to 21 ms later
+    uint32_t tick = 0;
+
+    for (uint32_t k = 0; k < 8U; k++)
+    {
+        HostCan_Advance(200U - (tick % 200U));
+        tick = HAL_GetTick();
+        HostCan_SetSofOffset((k & 1U) ? 150 : 0);
+        HostCan_Inject(&hcan, RX_ID, 1, data);
+
+        HostCan_Advance(3U * k);
+        tick += 3U * k;
+        UCAN_TEST_CHECK(uCAN_Update(&ucan) == UCAN_OK);
+    }
+
+    UCAN_TEST_CHECK(uCAN_GetPacketTiming(&ucan, RX_ID, &result) == UCAN_OK);
+    UCAN_TEST_CHECK(result.count == 8U);
+    UCAN_TEST_CHECK(result.timeUs == 1600000U + 150U * US_PER_BIT);
+    UCAN_TEST_CHECK(result.periodUs == 200000U + 150U * US_PER_BIT);
+    UCAN_TEST_CHECK(result.periodMinUs == 200000U - 150U * US_PER_BIT);
+    UCAN_TEST_CHECK(result.periodMaxUs == 200000U + 150U * US_PER_BIT);
+    UCAN_TEST_CHECK(result.jitterUs == 2U * 150U * US_PER_BIT);
+
+    // TX every 600 ms, confirmed 5 ms after the frame from the mailbox timestamp
+    HostCan_SetSofOffset(0);
+
+    for (uint32_t k = 0; k < 4U; k++)
+    {
+        HostCan_Advance(300);
+        UCAN_TEST_CHECK(uCAN_Send(&ucan, TX_ID) == UCAN_OK);
+        HostCan_Advance(5);
+        UCAN_TEST_CHECK(uCAN_TxComplete(&ucan, CAN_TX_MAILBOX0) == UCAN_OK);
+        HostCan_Advance(295);
+    }
+
+    UCAN_TEST_CHECK(uCAN_GetPacketTiming(&ucan, TX_ID, &result) == UCAN_OK);
+    UCAN_TEST_CHECK(result.count == 4U);
+    UCAN_TEST_CHECK(result.periodUs == 600000U && result.jitterUs == 0U);
+    UCAN_TEST_CHECK(result.timeUs == (uint64_t)(HAL_GetTick() - 295U - 5U) * 1000U);
+}
+
+int main(void)
+{
+    TestExtend();
+    TestPacketTiming();
+
+    return UCAN_TEST_RESULT("test_timing");
+}
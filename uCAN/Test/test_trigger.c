@@ -0,0 +1,323 @@
+/**
+  ******************************************************************************
+  * @file    test_trigger.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the RX-path signal triggers and their event queue.
+  *
+  * One RX packet carries an ABOVE, a DELTA and a RISING trigger, a second one
+  * a BELOW and a FALLING trigger; frames are injected one by one. Checks
+  * that:
+  *  - ABOVE and BELOW fire on the first frame that already meets them, then
+  *    stay quiet until the value has moved back by the hysteresis;
+  *  - DELTA measures the change from the value of its last event, not from
+  *    the previous frame, and the first frame only primes it;
+  *  - RISING and FALLING only see edges of their own bit, never on the
+  *    first frame;
+  *  - uCAN_ReadEvents() returns hits oldest first with ID and value, and a
+  *    full queue keeps the older hits and counts the lost ones;
+  *  - uCAN_Start() rejects an edge bit outside the signal, limits the
+  *    signal's range cannot fire or re-arm, an unknown condition and a
+  *    missing or badly sized queue.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define LEVEL_ID		0x100U
+#define ALARM_ID		0x101U
+#define QUEUE_SIZE		4U
+
+static CAN_HandleTypeDef hcan;
+static UCAN_HandleTypeDef ucan;
+static UCAN_Client clients[1] = { { .id = 0x7F0 } };
+static UCAN_Packet txPackets[1];
+static UCAN_Packet rxPackets[2];
+static UCAN_TriggerEvent queue[QUEUE_SIZE];
+static uint8_t txValue;
+
+// LEVEL_ID: level (U8), position (U16), flags (U8); ALARM_ID: supply (U8), status (U32)
+static uint8_t level;
+static uint16_t position;
+static uint8_t flags;
+static uint8_t supply;
+static uint32_t status;
+
+static UCAN_Trigger above;
+static UCAN_Trigger delta;
+static UCAN_Trigger rising;
+static UCAN_Trigger below;
+static UCAN_Trigger falling;
+
+/**
+  * @brief  Starts a handle with the given triggers and queue size, NULL for no trigger on a signal.
+  * @retval Status of uCAN_Start().
+  */
+static UCAN_StatusTypeDef Start(UCAN_Trigger* onLevel, UCAN_Trigger* onPosition, UCAN_Trigger* onFlags, UCAN_Trigger* onStatus, uint32_t queueSize)
+{
+    HostCan_Reset();
+    memset(&ucan, 0, sizeof(ucan));
+
+    hcan.Instance = CAN1;
+    ucan.hcan = &hcan;
+    ucan.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_NONE, .selfId = 0x7E0, .clients = clients, .clientCount = 1 };
+    ucan.txHolder = (UCAN_PacketHolder){ .packets = txPackets, .count = 1 };
+    ucan.rxHolder = (UCAN_PacketHolder){ .packets = rxPackets, .count = 2 };
+    ucan.events = (UCAN_EventQueue){ .events = (queueSize != 0U) ? queue : NULL, .size = queueSize };
+
+    UCAN_PacketConfig txConfig[1] = {
+        { .id = 0x7E1, .item_count = 1, .items = { { &txValue, UCAN_U8 } } },
+    };
+    UCAN_PacketConfig rxConfig[2] = {
+        { .id = LEVEL_ID, .item_count = 3, .items = { { &level, UCAN_U8, .trigger = onLevel }, { &position, UCAN_U16, .trigger = onPosition },
+          { &flags, UCAN_U8, .trigger = onFlags } } },
+        { .id = ALARM_ID, .item_count = 2, .items = { { &supply, UCAN_U8, .trigger = &below }, { &status, UCAN_U32, .trigger = onStatus } } },
+    };
+    UCAN_Config config = { txConfig, rxConfig };
+
+    UCAN_TEST_CHECK(uCAN_Init(&ucan) == UCAN_OK);
+
+    return uCAN_Start(&ucan, &config);
+}
+
+static void SetupTriggers(void)
+{
+    above = (UCAN_Trigger){ .condition = UCAN_TRIGGER_ABOVE, .threshold = 100, .hysteresis = 10 };
+    delta = (UCAN_Trigger){ .condition = UCAN_TRIGGER_DELTA, .threshold = 50 };
+    rising = (UCAN_Trigger){ .condition = UCAN_TRIGGER_RISING, .bit = 3 };
+    below = (UCAN_Trigger){ .condition = UCAN_TRIGGER_BELOW, .threshold = 20, .hysteresis = 5 };
+    falling = (UCAN_Trigger){ .condition = UCAN_TRIGGER_FALLING, .bit = 31 };
+}
+
+static void SendLevel(uint8_t levelValue, uint16_t positionValue, uint8_t flagsValue)
+{
+    uint8_t data[4] = { levelValue, (uint8_t)positionValue, (uint8_t)(positionValue >> 8), flagsValue };
+
+    HostCan_Inject(&hcan, LEVEL_ID, sizeof(data), data);
+    UCAN_TEST_CHECK(uCAN_Update(&ucan) == UCAN_OK);
+}
+
+static void SendAlarm(uint8_t supplyValue, uint32_t statusValue)
+{
+    uint8_t data[5] = { supplyValue, (uint8_t)statusValue, (uint8_t)(statusValue >> 8), (uint8_t)(statusValue >> 16), (uint8_t)(statusValue >> 24) };
+
+    HostCan_Inject(&hcan, ALARM_ID, sizeof(data), data);
+    UCAN_TEST_CHECK(uCAN_Update(&ucan) == UCAN_OK);
+}
+
+/**
+  * @brief  Drains the queue.
+  * @retval Number of events read, the first `max` of them copied to `events`.
+  */
+static uint32_t Drain(UCAN_TriggerEvent* events, uint32_t max)
+{
+    UCAN_TriggerEvent scratch[QUEUE_SIZE];
+    uint32_t total = 0;
+    uint32_t count;
+
+    while (uCAN_ReadEvents(&ucan, scratch, QUEUE_SIZE, &count) == UCAN_OK)
+    {
+        for (uint32_t i = 0; i < count; i++, total++)
+        {
+            if (total < max)
+            {
+                events[total] = scratch[i];
+            }
+        }
+    }
+
+    return total;
+}
+
+static void TestFirstFrame(void)
+{
+    UCAN_TriggerEvent events[QUEUE_SIZE];
+    uint32_t count;
+
+    SetupTriggers();
+    UCAN_TEST_CHECK(Start(&above, &delta, &rising, &falling, QUEUE_SIZE) == UCAN_OK);
+
+    UCAN_TEST_CHECK(uCAN_ReadEvents(&ucan, events, QUEUE_SIZE, &count) == UCAN_NO_CHANGED_VAL && count == 0U);
+    UCAN_TEST_CHECK(uCAN_ReadEvents(&ucan, NULL, QUEUE_SIZE, &count) == UCAN_INVALID_PARAM);
+
+    // Level already above, edge bits already set, supply already below: only the levels fire
+    SendLevel(150, 1000, 0x08);
+    SendAlarm(10, 0x80000000U);
+
+    UCAN_TEST_CHECK(Drain(events, QUEUE_SIZE) == 2U);
+    UCAN_TEST_CHECK(events[0].trigger == &above && events[0].id == LEVEL_ID && events[0].value == 150U);
+    UCAN_TEST_CHECK(events[1].trigger == &below && events[1].id == ALARM_ID && events[1].value == 10U);
+    UCAN_TEST_CHECK(delta.hits == 0U && rising.hits == 0U && falling.hits == 0U);
+}
+
+static void TestHysteresis(void)
+{
+    UCAN_TriggerEvent events[QUEUE_SIZE];
+
+    // Continues from the first frame: level 150 fired, supply 10 fired
+    static const uint8_t levels[] = { 160, 99, 150, 91, 101, 90, 101 };
+    static const uint8_t fires[] = { 0, 0, 0, 0, 0, 0, 1 };
+
+    for (uint32_t i = 0; i < sizeof(levels); i++)
+    {
+        uint32_t hits = above.hits;
+
+        // 99 is not back by the hysteresis, 91 neither; 90 is
+        SendLevel(levels[i], 1000, 0x08);
+        UCAN_TEST_CHECK(above.hits - hits == fires[i]);
+    }
+
+    UCAN_TEST_CHECK(above.hits == 2U);
+
+    // BELOW the other way round: 24 is not back by 5, 25 is
+    SendAlarm(24, 0x80000000U);
+    SendAlarm(5, 0x80000000U);
+    UCAN_TEST_CHECK(below.hits == 1U);
+    SendAlarm(25, 0x80000000U);
+    SendAlarm(19, 0x80000000U);
+    UCAN_TEST_CHECK(below.hits == 2U);
+
+    UCAN_TEST_CHECK(Drain(events, QUEUE_SIZE) == 2U);
+    UCAN_TEST_CHECK(events[0].value == 101U && events[1].value == 19U);
+}
+
+static void TestDelta(void)
+{
+    UCAN_TriggerEvent events[QUEUE_SIZE];
+
+    // Primed with 1000 by the first frame; a slow drift is measured from the last event
+    static const uint16_t positions[] = { 1030, 1049, 1050, 1020, 1001, 1000, 1000 };
+    static const uint8_t fires[] = { 0, 0, 1, 0, 0, 1, 0 };
+
+    for (uint32_t i = 0; i < sizeof(positions) / sizeof(positions[0]); i++)
+    {
+        uint32_t hits = delta.hits;
+
+        SendLevel(50, positions[i], 0x08);
+        UCAN_TEST_CHECK(delta.hits - hits == fires[i]);
+    }
+
+    UCAN_TEST_CHECK(Drain(events, QUEUE_SIZE) == 2U);
+    UCAN_TEST_CHECK(events[0].trigger == &delta && events[0].value == 1050U);
+    UCAN_TEST_CHECK(events[1].trigger == &delta && events[1].value == 1000U);
+}
+
+static void TestEdges(void)
+{
+    // Bit 3 set since the first frame: clearing it and other bits never fires RISING
+    SendLevel(50, 1000, 0x0F);
+    SendLevel(50, 1000, 0x07);
+    UCAN_TEST_CHECK(rising.hits == 0U);
+    SendLevel(50, 1000, 0x0F);
+    SendLevel(50, 1000, 0x08);
+    SendLevel(50, 1000, 0xF8);
+    UCAN_TEST_CHECK(rising.hits == 1U);
+
+    // Bit 31 of the U32 status
+    SendAlarm(50, 0xFFFFFFFFU);
+    SendAlarm(50, 0x7FFFFFFFU);
+    SendAlarm(50, 0x00000000U);
+    UCAN_TEST_CHECK(falling.hits == 1U);
+
+    UCAN_TriggerEvent events[QUEUE_SIZE];
+    UCAN_TEST_CHECK(Drain(events, QUEUE_SIZE) == 2U);
+    UCAN_TEST_CHECK(events[0].trigger == &rising && events[0].value == 0x0FU);
+    UCAN_TEST_CHECK(events[1].trigger == &falling && events[1].value == 0x7FFFFFFFU);
+}
+
+static void TestOverrun(void)
+{
+    UCAN_TriggerEvent events[QUEUE_SIZE];
+
+    // Six level crossings without reading: the first four are kept
+    for (uint8_t i = 0; i < 6U; i++)
+    {
+        SendLevel(101 + i, 1000, 0x08);
+        SendLevel(50, 1000, 0x08);
+    }
+
+    UCAN_TEST_CHECK(above.hits == 2U + 6U);
+    UCAN_TEST_CHECK(ucan.events.overruns == 2U);
+    UCAN_TEST_CHECK(Drain(events, QUEUE_SIZE) == QUEUE_SIZE);
+
+    for (uint32_t i = 0; i < QUEUE_SIZE; i++)
+    {
+        UCAN_TEST_CHECK(events[i].value == 101U + i);
+    }
+
+    printf("  triggers: 6 hits into a queue of %u, %u read, %u lost\n",
+           (unsigned)QUEUE_SIZE, (unsigned)QUEUE_SIZE, (unsigned)ucan.events.overruns);
+
+    // Room again once read
+    SendLevel(200, 1000, 0x08);
+    UCAN_TEST_CHECK(Drain(events, QUEUE_SIZE) == 1U && events[0].value == 200U);
+    UCAN_TEST_CHECK(ucan.events.overruns == 2U);
+}
+
+/**
+  * @brief  Starts with one trigger on the U8 level, the U16 position or the U32 status.
+  */
+static UCAN_StatusTypeDef StartWith(UCAN_DataType type, UCAN_Trigger trigger)
+{
+    static UCAN_Trigger probe;
+
+    SetupTriggers();
+    probe = trigger;
+
+    return Start((type == UCAN_U8) ? &probe : NULL, (type == UCAN_U16) ? &probe : NULL, NULL,
+                 (type == UCAN_U32) ? &probe : NULL, QUEUE_SIZE);
+}
+
+static void TestValidation(void)
+{
+    // Edge bit inside the signal
+    UCAN_TEST_CHECK(StartWith(UCAN_U8, (UCAN_Trigger){ .condition = UCAN_TRIGGER_RISING, .bit = 7 }) == UCAN_OK);
+    UCAN_TEST_CHECK(StartWith(UCAN_U8, (UCAN_Trigger){ .condition = UCAN_TRIGGER_RISING, .bit = 8 }) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(StartWith(UCAN_U16, (UCAN_Trigger){ .condition = UCAN_TRIGGER_FALLING, .bit = 15 }) == UCAN_OK);
+    UCAN_TEST_CHECK(StartWith(UCAN_U16, (UCAN_Trigger){ .condition = UCAN_TRIGGER_FALLING, .bit = 16 }) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(StartWith(UCAN_U32, (UCAN_Trigger){ .condition = UCAN_TRIGGER_RISING, .bit = 31 }) == UCAN_OK);
+    UCAN_TEST_CHECK(StartWith(UCAN_U32, (UCAN_Trigger){ .condition = UCAN_TRIGGER_RISING, .bit = 32 }) == UCAN_INVALID_PARAM);
+
+    // ABOVE needs a value beyond the threshold and room below it to re-arm
+    UCAN_TEST_CHECK(StartWith(UCAN_U8, (UCAN_Trigger){ .condition = UCAN_TRIGGER_ABOVE, .threshold = 254, .hysteresis = 254 }) == UCAN_OK);
+    UCAN_TEST_CHECK(StartWith(UCAN_U8, (UCAN_Trigger){ .condition = UCAN_TRIGGER_ABOVE, .threshold = 255 }) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(StartWith(UCAN_U8, (UCAN_Trigger){ .condition = UCAN_TRIGGER_ABOVE, .threshold = 10, .hysteresis = 11 }) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(StartWith(UCAN_U32, (UCAN_Trigger){ .condition = UCAN_TRIGGER_ABOVE, .threshold = 0xFFFFFFFEU }) == UCAN_OK);
+    UCAN_TEST_CHECK(StartWith(UCAN_U32, (UCAN_Trigger){ .condition = UCAN_TRIGGER_ABOVE, .threshold = 0xFFFFFFFFU }) == UCAN_INVALID_PARAM);
+
+    // BELOW needs a value under the threshold and room above it to re-arm
+    UCAN_TEST_CHECK(StartWith(UCAN_U16, (UCAN_Trigger){ .condition = UCAN_TRIGGER_BELOW, .threshold = 1, .hysteresis = 65534 }) == UCAN_OK);
+    UCAN_TEST_CHECK(StartWith(UCAN_U16, (UCAN_Trigger){ .condition = UCAN_TRIGGER_BELOW, .threshold = 0 }) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(StartWith(UCAN_U16, (UCAN_Trigger){ .condition = UCAN_TRIGGER_BELOW, .threshold = 1, .hysteresis = 65535 }) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(StartWith(UCAN_U32, (UCAN_Trigger){ .condition = UCAN_TRIGGER_BELOW, .threshold = 0xFFFFFFFFU }) == UCAN_OK);
+    UCAN_TEST_CHECK(StartWith(UCAN_U32, (UCAN_Trigger){ .condition = UCAN_TRIGGER_BELOW, .threshold = 0xFFFFFFFFU, .hysteresis = 1 }) == UCAN_INVALID_PARAM);
+
+    // DELTA needs a reachable change
+    UCAN_TEST_CHECK(StartWith(UCAN_U8, (UCAN_Trigger){ .condition = UCAN_TRIGGER_DELTA, .threshold = 255 }) == UCAN_OK);
+    UCAN_TEST_CHECK(StartWith(UCAN_U8, (UCAN_Trigger){ .condition = UCAN_TRIGGER_DELTA, .threshold = 256 }) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(StartWith(UCAN_U32, (UCAN_Trigger){ .condition = UCAN_TRIGGER_DELTA, .threshold = 0xFFFFFFFFU }) == UCAN_OK);
+
+    // Unknown condition
+    UCAN_TEST_CHECK(StartWith(UCAN_U8, (UCAN_Trigger){ .condition = (UCAN_TriggerCondition)5 }) == UCAN_INVALID_PARAM);
+
+    // Event queue missing or not a power of two
+    SetupTriggers();
+    UCAN_TEST_CHECK(Start(NULL, NULL, NULL, NULL, 0) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(Start(NULL, NULL, NULL, NULL, 3) == UCAN_INVALID_PARAM);
+    UCAN_TEST_CHECK(Start(NULL, NULL, NULL, NULL, 2) == UCAN_OK);
+}
+
+int main(void)
+{
+    TestFirstFrame();
+    TestHysteresis();
+    TestDelta();
+    TestEdges();
+    TestOverrun();
+    TestValidation();
+
+    return UCAN_TEST_RESULT("test_trigger");
+}
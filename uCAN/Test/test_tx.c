@@ -0,0 +1,223 @@
+/**
+  ******************************************************************************
+  * @file    test_tx.c
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Host test of the TX mailbox classes and handshake frames under load.
+  *
+  * Built with UCAN_CFG_RESERVED_MAILBOXES=1. A master and a client share one
+  * simulated bus whose controllers only transmit when the test says so, so the
+  * application can keep every bulk mailbox busy. Checks that:
+  *  - a critical packet finds the reserved mailbox behind a full bulk backlog
+  *    and is the next frame on the bus;
+  *  - pings, pongs and capability frames are retried instead of being lost
+  *    when the bulk mailboxes are full, so the client stays ACTIVE and its
+  *    health record keeps updating while both nodes saturate the bus.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ucan.h"
+#include "host_can.h"
+#include "ucan_test.h"
+
+#define MASTER_ID		0x010U
+#define CLIENT_ID		0x020U
+#define CRITICAL_ID		0x008U
+
+static CAN_HandleTypeDef hcanMaster;
+static CAN_HandleTypeDef hcanClient;
+static UCAN_HandleTypeDef master;
+static UCAN_HandleTypeDef client;
+
+static UCAN_Client masterClients[1];
+static UCAN_Client clientClients[1];
+static UCAN_Packet packets[4][4];
+static uint8_t masterValues[4];
+static uint8_t clientValues[3];
+
+/**
+  * @brief  Starts a master with three bulk and one critical TX packet and a client with three bulk TX packets.
+  */
+static void Setup(void)
+{
+    HostCan_Reset();
+    memset(&master, 0, sizeof(master));
+    memset(&client, 0, sizeof(client));
+    memset(masterClients, 0, sizeof(masterClients));
+    memset(clientClients, 0, sizeof(clientClients));
+
+    hcanMaster.Instance = CAN1;
+    hcanClient.Instance = CAN2;
+    masterClients[0].id = CLIENT_ID;
+    clientClients[0].id = CLIENT_ID;
+
+    master.hcan = &hcanMaster;
+    master.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_MASTER, .selfId = MASTER_ID, .clients = masterClients, .clientCount = 1 };
+    master.txHolder = (UCAN_PacketHolder){ .packets = packets[0], .count = 4 };
+    master.rxHolder = (UCAN_PacketHolder){ .packets = packets[1], .count = 3 };
+
+    client.hcan = &hcanClient;
+    client.node = (UCAN_NodeInfo){ .role = UCAN_ROLE_CLIENT, .selfId = CLIENT_ID, .masterId = MASTER_ID, .clients = clientClients, .clientCount = 1 };
+    client.txHolder = (UCAN_PacketHolder){ .packets = packets[2], .count = 3 };
+    client.rxHolder = (UCAN_PacketHolder){ .packets = packets[3], .count = 4 };
+
+    UCAN_PacketConfig masterTx[4] = {
+        { .id = CRITICAL_ID, .item_count = 1, .items = { { &masterValues[3], UCAN_U8 } }, .critical = 1 },
+        { .id = 0x200, .item_count = 1, .items = { { &masterValues[0], UCAN_U8 } } },
+        { .id = 0x201, .item_count = 1, .items = { { &masterValues[1], UCAN_U8 } } },
+        { .id = 0x202, .item_count = 1, .items = { { &masterValues[2], UCAN_U8 } } },
+    };
+    UCAN_PacketConfig clientTx[3] = {
+        { .id = 0x300, .item_count = 1, .items = { { &clientValues[0], UCAN_U8 } } },
+        { .id = 0x301, .item_count = 1, .items = { { &clientValues[1], UCAN_U8 } } },
+        { .id = 0x302, .item_count = 1, .items = { { &clientValues[2], UCAN_U8 } } },
+    };
+    UCAN_Config masterConfig = { masterTx, clientTx };
+    UCAN_Config clientConfig = { clientTx, masterTx };
+
+    UCAN_TEST_CHECK(uCAN_Init(&master) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&master, &masterConfig) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Init(&client) == UCAN_OK);
+    UCAN_TEST_CHECK(uCAN_Start(&client, &clientConfig) == UCAN_OK);
+
+    HostCan_SetManualTx(&hcanMaster, 1);
+    HostCan_SetManualTx(&hcanClient, 1);
+}
+
+static void Drain(UCAN_HandleTypeDef* ucan)
+{
+    while (HAL_CAN_GetRxFifoFillLevel(ucan->hcan, CAN_RX_FIFO0) > 0U)
+    {
+        (void)uCAN_Update(ucan);
+    }
+}
+
+/**
+  * @brief  Handshake frames seen on the bus.
+  */
+typedef struct {
+    uint32_t pings;
+    uint32_t pongs;
+    uint32_t caps;
+} Handshakes;
+
+/**
+  * @brief  Counts the handshake frames among the frames a controller transmitted since `*seen`.
+  */
+static void CountHandshakes(const CAN_HandleTypeDef* hcan, uint32_t* seen, Handshakes* count)
+{
+    for (; *seen < HostCan_SentCount(hcan); (*seen)++)
+    {
+        const HostCan_Frame* frame = HostCan_Sent(hcan, *seen);
+
+        if (frame->header.StdId == MASTER_ID && frame->data[0] == UCAN_HANDSHAKE_REQUEST_VALUE)
+        {
+            count->pings++;
+        }
+        else if (frame->header.StdId == CLIENT_ID && frame->data[0] == UCAN_HANDSHAKE_RESPONSE_VALUE)
+        {
+            count->pongs++;
+        }
+        else if (frame->header.StdId == CLIENT_ID && frame->data[0] == UCAN_HANDSHAKE_CAPS_VALUE)
+        {
+            count->caps++;
+        }
+    }
+}
+
+static void TestCriticalBehindBacklog(void)
+{
+    Setup();
+
+    masterValues[3] = 0x5A;
+
+    // The round queues the ping and the critical packet, then the bulk packets
+    // find only the reserved mailbox free and wait
+    UCAN_TEST_CHECK(uCAN_SendAll(&master) == UCAN_BUSY);
+    UCAN_TEST_CHECK(HAL_CAN_GetTxMailboxesFreeLevel(&hcanMaster) == UCAN_CFG_RESERVED_MAILBOXES);
+    UCAN_TEST_CHECK(uCAN_SendAll(&master) == UCAN_BUSY);
+
+    // The reserved mailbox is still there for an event-driven critical frame
+    UCAN_TEST_CHECK(uCAN_Send(&master, CRITICAL_ID) == UCAN_OK);
+    UCAN_TEST_CHECK(HAL_CAN_GetTxMailboxesFreeLevel(&hcanMaster) == 0U);
+
+    // Lowest identifier of the node wins: it is the next frame on the bus
+    uint32_t before = HostCan_SentCount(&hcanMaster);
+    UCAN_TEST_CHECK(HostCan_CompleteTx(&hcanMaster, 1) == 1U);
+    UCAN_TEST_CHECK(HostCan_SentCount(&hcanMaster) == before + 1U);
+    UCAN_TEST_CHECK(HostCan_Sent(&hcanMaster, before)->header.StdId == CRITICAL_ID);
+    UCAN_TEST_CHECK(HostCan_Sent(&hcanMaster, before)->data[0] == 0x5A);
+}
+
+/**
+  * @brief  Runs both nodes for `ms` milliseconds with `perMs` frames per node leaving the bus each millisecond.
+  */
+static void RunLoaded(uint32_t ms, uint32_t perMs, uint32_t* activeMs, Handshakes* count)
+{
+    uint32_t seenMaster = HostCan_SentCount(&hcanMaster);
+    uint32_t seenClient = HostCan_SentCount(&hcanClient);
+
+    for (uint32_t t = 0; t < ms; t++)
+    {
+        HostCan_Advance(1);
+        masterValues[0]++;
+        clientValues[0]++;
+
+        (void)uCAN_SendAll(&master);
+        (void)uCAN_SendAll(&client);
+
+        (void)HostCan_CompleteTx(&hcanMaster, perMs);
+        (void)HostCan_CompleteTx(&hcanClient, perMs);
+        CountHandshakes(&hcanMaster, &seenMaster, count);
+        CountHandshakes(&hcanClient, &seenClient, count);
+
+        Drain(&client);
+        Drain(&master);
+
+        (void)uCAN_Handshake(&client);
+        (void)uCAN_Handshake(&master);
+
+        if (uCAN_IsClientActive(&master, CLIENT_ID) == UCAN_OK)
+        {
+            (*activeMs)++;
+        }
+    }
+}
+
+static void TestHandshakeUnderLoad(void)
+{
+    Setup();
+
+    // Both nodes try to send three frames per millisecond, the bus takes one of each
+    uint32_t activeMs = 0;
+    uint32_t duration = 20U * UCAN_HANDSHAKE_INTERVAL_MS;
+    Handshakes count = { 0 };
+    RunLoaded(duration, 1, &activeMs, &count);
+
+    // One ping per interval, each one answered
+    UCAN_TEST_CHECK(count.pings >= duration / UCAN_HANDSHAKE_INTERVAL_MS);
+    UCAN_TEST_CHECK(count.pongs + count.caps + 1U >= count.pings);
+    UCAN_TEST_CHECK(count.caps >= 1U);
+    UCAN_TEST_CHECK(uCAN_IsClientActive(&master, CLIENT_ID) == UCAN_OK);
+
+    // Active from the first response on, without a single timeout afterwards
+    UCAN_TEST_CHECK(activeMs + 2U * UCAN_HANDSHAKE_INTERVAL_MS >= duration);
+
+    // Health record and capabilities arrived
+    UCAN_ClientDiag diag;
+    UCAN_PeerCaps peer;
+    UCAN_TEST_CHECK(uCAN_GetClientDiag(&master, CLIENT_ID, &diag) == UCAN_OK && diag.valid);
+    UCAN_TEST_CHECK(uCAN_GetPeerCaps(&master, CLIENT_ID, &peer) == UCAN_OK && peer.valid);
+
+    printf("  tx under load: %u ms, client active for %u ms, %u pings, %u pongs, %u caps\n",
+           (unsigned)duration, (unsigned)activeMs, (unsigned)count.pings, (unsigned)count.pongs, (unsigned)count.caps);
+}
+
+int main(void)
+{
+    TestCriticalBehindBacklog();
+    TestHandshakeUnderLoad();
+
+    return UCAN_TEST_RESULT("test_tx");
+}
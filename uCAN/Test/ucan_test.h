@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    ucan_test.h
+  * @author  Hamza Enes Balahoroğlu
+  * @brief   Minimal check and timing helpers for the uCAN host tests.
+  *
+  * The host tests and benchmarks in this directory build with a desktop C
+  * compiler (see Makefile). A test program calls UCAN_TEST_CHECK() for every
+  * expectation and returns UCAN_TEST_RESULT() from main(), so the make target
+  * fails as soon as one expectation does not hold.
+  *
+  * @see     uCAN GitHub repository: https://github.com/hamza-enes-balahoroglu/uCAN.git
+  *
+  ******************************************************************************
+  */
+
+#ifndef UCAN_TEST
+#define UCAN_TEST
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+static unsigned ucanTestChecks;
+static unsigned ucanTestFailures;
+
+/**
+  * @brief Records one expectation, prints the location if it does not hold.
+  */
+#define UCAN_TEST_CHECK(cond)	do { \
+									ucanTestChecks++; \
+									if (!(cond)) \
+									{ \
+										ucanTestFailures++; \
+										printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+									} \
+								} while (0)
+
+/**
+  * @brief Prints the summary line and yields the exit code of the test program.
+  */
+#define UCAN_TEST_RESULT(name)	(printf("%s: %u checks, %u failed\n", (name), ucanTestChecks, ucanTestFailures), \
+								 ucanTestFailures != 0U)
+
+/**
+  * @brief  Monotonic host time in nanoseconds, for the benchmarks.
+  */
+static inline uint64_t uCAN_Test_Ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+#endif